@@ -42,6 +42,7 @@
 
 #include "allegro5/allegro_audio.h"
 #include "allegro5/internal/aintern_audio.h"
+#include "allegro5/internal/aintern_file.h"
 #include "acodec.h"
 #include "helper.h"
 
@@ -237,7 +238,7 @@ ALLEGRO_SAMPLE *_al_load_voc(const char *filename)
    ASSERT(filename);
    
    ALLEGRO_INFO("Loading VOC sample %s.\n", filename);
-   f = al_fopen(filename, "rb");
+   f = _al_fopen_for_loading(filename);
    if (!f) {
       ALLEGRO_WARN("Failed reading %s.\n", filename);
       return NULL;
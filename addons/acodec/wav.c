@@ -7,6 +7,7 @@
 
 #include "allegro5/allegro_audio.h"
 #include "allegro5/internal/aintern_audio.h"
+#include "allegro5/internal/aintern_file.h"
 #include "acodec.h"
 #include "helper.h"
 
@@ -291,7 +292,7 @@ ALLEGRO_SAMPLE *_al_load_wav(const char *filename)
    ALLEGRO_SAMPLE *spl;
    ASSERT(filename);
 
-   f = al_fopen(filename, "rb");
+   f = _al_fopen_for_loading(filename);
    if (!f)
       return NULL;
 
@@ -340,7 +341,7 @@ ALLEGRO_AUDIO_STREAM *_al_load_wav_audio_stream(const char *filename,
    ALLEGRO_AUDIO_STREAM *stream;
    ASSERT(filename);
 
-   f = al_fopen(filename, "rb");
+   f = _al_fopen_for_loading(filename);
    if (!f)
       return NULL;
 
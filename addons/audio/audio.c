@@ -49,6 +49,7 @@ ALLEGRO_AUDIO_DRIVER *_al_kcm_driver = NULL;
 #if defined(ALLEGRO_SDL)
    extern struct ALLEGRO_AUDIO_DRIVER _al_kcm_sdl_driver;
 #endif
+extern struct ALLEGRO_AUDIO_DRIVER _al_kcm_null_driver;
 
 /* Channel configuration helpers */
 
@@ -193,6 +194,9 @@ static ALLEGRO_AUDIO_DRIVER_ENUM get_config_audio_driver(void)
    if (0 == _al_stricmp(value, "DSOUND") || 0 == _al_stricmp(value, "DIRECTSOUND"))
       return ALLEGRO_AUDIO_DRIVER_DSOUND;
 
+   if (0 == _al_stricmp(value, "NULL"))
+      return ALLEGRO_AUDIO_DRIVER_NULL;
+
    return ALLEGRO_AUDIO_DRIVER_AUTODETECT;
 }
 
@@ -367,6 +371,14 @@ static bool do_install_audio(ALLEGRO_AUDIO_DRIVER_ENUM mode)
             return false;
          #endif
 
+      case ALLEGRO_AUDIO_DRIVER_NULL:
+         if (_al_kcm_null_driver.open() == 0) {
+            ALLEGRO_INFO("Using null driver\n");
+            _al_kcm_driver = &_al_kcm_null_driver;
+            return true;
+         }
+         return false;
+
       default:
          _al_set_error(ALLEGRO_INVALID_PARAM, "Invalid audio driver");
          return false;
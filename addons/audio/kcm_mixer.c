@@ -8,8 +8,10 @@
 /* Title: Mixer functions
  */
 
+#include <limits.h>
 #include <math.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "allegro5/allegro_audio.h"
 #include "allegro5/internal/aintern.h"
@@ -18,6 +20,11 @@
 
 ALLEGRO_DEBUG_CHANNEL("audio")
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+   #define MIXER_SSE2
+   #include <emmintrin.h>
+#endif
+
 
 typedef union {
    float f32[ALLEGRO_MAX_CHANNELS]; /* max: 7.1 */
@@ -336,15 +343,242 @@ static void NAME(void *source, void **vbuf, unsigned int *samples,            \
    (void)buffer_depth;                                                        \
 }
 
-MAKE_MIXER(read_to_mixer_point_float_32, point_spl32, float)
-MAKE_MIXER(read_to_mixer_linear_float_32, linear_spl32, float)
-MAKE_MIXER(read_to_mixer_cubic_float_32, cubic_spl32, float)
 MAKE_MIXER(read_to_mixer_point_int16_t_16, point_spl16, int16_t)
 MAKE_MIXER(read_to_mixer_linear_int16_t_16, linear_spl16, int16_t)
 
 #undef MAKE_MIXER
 
 
+/* Block mixing.
+ *
+ * Away from loop points and the end of the sample, the per-frame mixers
+ * above spend most of their time deciding that none of the special cases
+ * apply. The block mixers check that once for up to MIX_BLOCK_SIZE frames,
+ * interpolate all of them in one go, then apply the rechannel matrix to the
+ * whole block. The result is the same as that of the per-frame mixers.
+ */
+#define MIX_BLOCK_SIZE 128
+
+typedef struct MIX_BLOCK {
+   int first[MIX_BLOCK_SIZE];    /* first sample frame read for each frame */
+   float t[MIX_BLOCK_SIZE];      /* interpolation parameter of each frame */
+   int centre;                   /* offset of the current frame from first */
+   bool unit_step;               /* all t are 0, frames are consecutive */
+   float frames[MIX_BLOCK_SIZE * ALLEGRO_MAX_CHANNELS];
+} MIX_BLOCK;
+
+
+/* prepare_block:
+ *  Works out the positions of up to max_frames frames, stopping before the
+ *  first one the interpolator, which reads taps_before sample frames before
+ *  and taps_after sample frames after the current one, would have to treat
+ *  specially. Advances the sample position past them and returns how many
+ *  there are.
+ */
+static int prepare_block(ALLEGRO_SAMPLE_INSTANCE *spl, MIX_BLOCK *block,
+   int max_frames, int delta, int delta_error,
+   int taps_before, int taps_after, int stream_lag)
+{
+   int pos = spl->pos;
+   int error = spl->pos_bresenham_error;
+   int lower, upper;
+   int n;
+
+   if (spl->step <= 0)
+      return 0;
+
+   /* Where the current frame is, before streams add their lag. */
+   block->centre = taps_before;
+
+   switch (spl->loop) {
+      case ALLEGRO_PLAYMODE_ONCE:
+         lower = taps_before;
+         upper = spl->spl_data.len - taps_after;
+         break;
+
+      case ALLEGRO_PLAYMODE_LOOP:
+      case ALLEGRO_PLAYMODE_BIDIR:
+         lower = taps_before ? spl->loop_start + taps_before : 0;
+         upper = spl->loop_end - taps_after;
+         break;
+
+      default:
+         /* Streams are interpolated lagging behind the current position,
+          * and the data before the start of the buffer is always valid.
+          */
+         lower = INT_MIN;
+         upper = spl->spl_data.len;
+         taps_before += stream_lag;
+         break;
+   }
+
+   block->unit_step = (delta == 1 && delta_error == 0 && error == 0);
+
+   for (n = 0; n < max_frames && pos >= lower && pos < upper; n++) {
+      block->first[n] = pos - taps_before;
+      block->t[n] = (float)error / spl->step_denom;
+
+      pos += delta;
+      error += delta_error;
+      if (error >= spl->step_denom) {
+         pos++;
+         error -= spl->step_denom;
+      }
+   }
+
+   spl->pos = pos;
+   spl->pos_bresenham_error = error;
+
+   return n;
+}
+
+
+/* mix_block:
+ *  Adds n frames with maxc channels to a buffer with dest_maxc channels,
+ *  through the rechannel matrix. Sums are taken in the same order as in
+ *  MAKE_MIXER.
+ */
+static void mix_block(const float *s, int n, size_t maxc,
+   const float *matrix, float *buf, size_t dest_maxc)
+{
+   int k = 0;
+   size_t c;
+
+   if (maxc == 1 && dest_maxc == 2) {
+#ifdef MIXER_SSE2
+      const __m128 m = _mm_set_ps(matrix[1], matrix[0], matrix[1], matrix[0]);
+
+      for (; k + 4 <= n; k += 4) {
+         __m128 v = _mm_loadu_ps(s + k);
+         __m128 lo = _mm_unpacklo_ps(v, v);
+         __m128 hi = _mm_unpackhi_ps(v, v);
+         _mm_storeu_ps(buf, _mm_add_ps(_mm_loadu_ps(buf), _mm_mul_ps(lo, m)));
+         _mm_storeu_ps(buf + 4, _mm_add_ps(_mm_loadu_ps(buf + 4), _mm_mul_ps(hi, m)));
+         buf += 8;
+      }
+#endif
+      for (; k < n; k++) {
+         buf[0] += s[k] * matrix[0];
+         buf[1] += s[k] * matrix[1];
+         buf += 2;
+      }
+      return;
+   }
+
+   if (maxc == 2 && dest_maxc == 2) {
+#ifdef MIXER_SSE2
+      const __m128 m_left = _mm_set_ps(matrix[2], matrix[0], matrix[2], matrix[0]);
+      const __m128 m_right = _mm_set_ps(matrix[3], matrix[1], matrix[3], matrix[1]);
+
+      for (; k + 2 <= n; k += 2) {
+         __m128 v = _mm_loadu_ps(s + k * 2);
+         __m128 left = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 0, 0));
+         __m128 right = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 1, 1));
+         __m128 b = _mm_loadu_ps(buf);
+         b = _mm_add_ps(b, _mm_mul_ps(right, m_right));
+         b = _mm_add_ps(b, _mm_mul_ps(left, m_left));
+         _mm_storeu_ps(buf, b);
+         buf += 4;
+      }
+#endif
+      for (; k < n; k++) {
+         buf[0] += s[k * 2 + 1] * matrix[1];
+         buf[0] += s[k * 2] * matrix[0];
+         buf[1] += s[k * 2 + 1] * matrix[3];
+         buf[1] += s[k * 2] * matrix[2];
+         buf += 2;
+      }
+      return;
+   }
+
+   for (; k < n; k++) {
+      for (c = 0; c < dest_maxc; c++) {
+         /* From the last channel down, like the switch in MAKE_MIXER. */
+         size_t i = maxc;
+         while (i-- > 0)
+            *buf += s[i] * matrix[c*maxc + i];
+         buf++;
+      }
+      s += maxc;
+   }
+}
+
+
+/* Like MAKE_MIXER, for float mixer buffers, but mixes a block of frames at a
+ * time where possible. BLOCK_VALUES interpolates a block of frames, reading
+ * TAPS_BEFORE and TAPS_AFTER neighbouring sample frames, lagging STREAM_LAG
+ * frames behind for streams.
+ */
+#define MAKE_BLOCK_MIXER(NAME, NEXT_SAMPLE_VALUE, BLOCK_VALUES,               \
+   TAPS_BEFORE, TAPS_AFTER, STREAM_LAG)                                       \
+static void NAME(void *source, void **vbuf, unsigned int *samples,            \
+   ALLEGRO_AUDIO_DEPTH buffer_depth, size_t dest_maxc)                        \
+{                                                                             \
+   ALLEGRO_SAMPLE_INSTANCE *spl = (ALLEGRO_SAMPLE_INSTANCE *)source;          \
+   float *buf = *vbuf;                                                        \
+   size_t maxc = al_get_channel_count(spl->spl_data.chan_conf);               \
+   size_t samples_l = *samples;                                               \
+   int delta, delta_error;                                                    \
+   SAMP_BUF samp_buf;                                                         \
+   MIX_BLOCK block;                                                           \
+                                                                              \
+   BRESENHAM;                                                                 \
+                                                                              \
+   if (!spl->is_playing)                                                      \
+      return;                                                                 \
+                                                                              \
+   while (samples_l > 0) {                                                    \
+      int old_step = spl->step;                                               \
+      int n;                                                                  \
+                                                                              \
+      if (!fix_looped_position(spl))                                          \
+         return;                                                              \
+      if (old_step != spl->step) {                                            \
+         BRESENHAM;                                                           \
+      }                                                                       \
+                                                                              \
+      n = prepare_block(spl, &block, _ALLEGRO_MIN(samples_l, MIX_BLOCK_SIZE), \
+         delta, delta_error, TAPS_BEFORE, TAPS_AFTER, STREAM_LAG);            \
+                                                                              \
+      if (n > 0 && block.unit_step) {                                         \
+         /* Interpolating at t = 0 just returns the current sample frame. */  \
+         copy_block32(block.frames, spl,                                      \
+            (block.first[0] + block.centre) * maxc, n * maxc);                 \
+      }                                                                       \
+      else if (n > 0) {                                                       \
+         BLOCK_VALUES(block.frames, spl, maxc, block.first, block.t, n);      \
+      }                                                                       \
+      else {                                                                  \
+         /* Close to a loop point or the end, take a single step. */          \
+         memcpy(block.frames, NEXT_SAMPLE_VALUE(&samp_buf, spl, maxc),        \
+            maxc * sizeof(float));                                            \
+         spl->pos += delta;                                                   \
+         spl->pos_bresenham_error += delta_error;                             \
+         if (spl->pos_bresenham_error >= spl->step_denom) {                   \
+            spl->pos++;                                                       \
+            spl->pos_bresenham_error -= spl->step_denom;                      \
+         }                                                                    \
+         n = 1;                                                               \
+      }                                                                       \
+                                                                              \
+      mix_block(block.frames, n, maxc, spl->matrix, buf, dest_maxc);          \
+      buf += n * dest_maxc;                                                   \
+      samples_l -= n;                                                         \
+   }                                                                          \
+   fix_looped_position(spl);                                                  \
+   (void)buffer_depth;                                                        \
+}
+
+MAKE_BLOCK_MIXER(read_to_mixer_point_float_32, point_spl32, point_block32,
+   0, 0, 0)
+MAKE_BLOCK_MIXER(read_to_mixer_linear_float_32, linear_spl32, linear_block32,
+   0, 1, 1)
+MAKE_BLOCK_MIXER(read_to_mixer_cubic_float_32, cubic_spl32, cubic_block32,
+   1, 2, 2)
+
+#undef MAKE_BLOCK_MIXER
+
+
 /* _al_kcm_mixer_read:
  *  Mixes the streams attached to the mixer and writes additively to the
  *  specified buffer (or if *buf is NULL, indicating a voice, convert it and
@@ -0,0 +1,490 @@
+/*         ______   ___    ___
+ *        /\  _  \ /\_ \  /\_ \
+ *        \ \ \L\ \\//\ \ \//\ \      __     __   _ __   ___
+ *         \ \  __ \ \ \ \  \ \ \   /'__`\ /'_ `\/\`'__\/ __`\
+ *          \ \ \/\ \ \_\ \_ \_\ \_/\  __//\ \L\ \ \ \//\ \L\ \
+ *           \ \_\ \_\/\____\/\____\ \____\ \____ \ \_\\ \____/
+ *            \/_/\/_/\/____/\/____/\/____/\/___L\ \/_/ \/___/
+ *                                           /\____/
+ *                                           \_/__/
+ *
+ *      Null sound driver.
+ *
+ *      Mixes voices without a sound card, either in real time or as fast as
+ *      possible, and optionally writes the output to a WAV file. Useful on
+ *      headless machines, for benchmarking the mixer and for comparing the
+ *      output of test runs.
+ *
+ *      See readme.txt for copyright information.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "allegro5/allegro.h"
+#include "allegro5/internal/aintern.h"
+#include "allegro5/internal/aintern_audio.h"
+
+ALLEGRO_DEBUG_CHANNEL("null_audio")
+
+#define DEFAULT_BUFFER_SIZE   1024
+#define MIN_BUFFER_SIZE       16
+
+/* The RIFF chunk size, 36 bytes more than the data, must fit 32 bits. */
+#define MAX_WAV_DATA_SIZE     (0xFFFFFFFFu - 36)
+
+typedef struct NULL_VOICE {
+   /* Copied from the parent ALLEGRO_VOICE. Used for convenience. */
+   unsigned int len; /* in frames */
+   unsigned int frame_size; /* in bytes */
+
+   unsigned int buffer_size; /* in frames */
+   void *silence;
+
+   volatile bool stopped;
+   volatile bool stop;
+
+   ALLEGRO_FILE *wav;
+   uint32_t wav_data_size;
+
+   ALLEGRO_THREAD *update_thread;
+} NULL_VOICE;
+
+
+/* Settings from the [null] section of the system configuration. */
+static bool null_realtime;
+static unsigned int null_buffer_size;
+static char null_output[512];
+
+/* Only one voice at a time writes to the output file. */
+static NULL_VOICE *wav_owner;
+
+
+static int null_open(void)
+{
+   ALLEGRO_CONFIG *config = al_get_system_config();
+   const char *val;
+
+   null_realtime = true;
+   null_buffer_size = DEFAULT_BUFFER_SIZE;
+   null_output[0] = '\0';
+
+   val = al_get_config_value(config, "null", "mode");
+   if (val && 0 == _al_stricmp(val, "offline")) {
+      null_realtime = false;
+   }
+
+   val = al_get_config_value(config, "null", "buffer_size");
+   if (val && val[0] != '\0') {
+      int n = atoi(val);
+      if (n < MIN_BUFFER_SIZE)
+         n = MIN_BUFFER_SIZE;
+      null_buffer_size = n;
+   }
+
+   val = al_get_config_value(config, "null", "output");
+   if (val && val[0] != '\0') {
+      _al_sane_strncpy(null_output, val, sizeof(null_output));
+   }
+
+   ALLEGRO_INFO("%s mode, %u frames per update\n",
+      null_realtime ? "Real time" : "Offline", null_buffer_size);
+
+   return 0;
+}
+
+
+static void null_close(void)
+{
+}
+
+
+/* Writes a WAV header for data_size bytes of sample data. */
+static bool write_wav_header(ALLEGRO_VOICE *voice, ALLEGRO_FILE *f,
+   uint32_t data_size)
+{
+   const int channels = al_get_channel_count(voice->chan_conf);
+   const int bits = al_get_audio_depth_size(voice->depth) * 8;
+   const bool is_float = (voice->depth == ALLEGRO_AUDIO_DEPTH_FLOAT32);
+
+   al_fputs(f, "RIFF");
+   al_fwrite32le(f, 36 + data_size);
+   al_fputs(f, "WAVE");
+
+   al_fputs(f, "fmt ");
+   al_fwrite32le(f, 16);
+   al_fwrite16le(f, is_float ? 3 : 1);
+   al_fwrite16le(f, channels);
+   al_fwrite32le(f, voice->frequency);
+   al_fwrite32le(f, voice->frequency * channels * (bits / 8));
+   al_fwrite16le(f, channels * (bits / 8));
+   al_fwrite16le(f, bits);
+
+   al_fputs(f, "data");
+   al_fwrite32le(f, data_size);
+
+   return !al_ferror(f);
+}
+
+
+static void open_wav(ALLEGRO_VOICE *voice, NULL_VOICE *null_voice)
+{
+   if (null_output[0] == '\0' || wav_owner)
+      return;
+
+   /* These are the sample formats WAV files store as they are in memory. */
+   if (voice->depth != ALLEGRO_AUDIO_DEPTH_UINT8 &&
+         voice->depth != ALLEGRO_AUDIO_DEPTH_INT16 &&
+         voice->depth != ALLEGRO_AUDIO_DEPTH_FLOAT32) {
+      ALLEGRO_WARN("Can't write voice depth %d to '%s'.\n", voice->depth,
+         null_output);
+      return;
+   }
+
+   null_voice->wav = al_fopen(null_output, "wb");
+   if (!null_voice->wav) {
+      ALLEGRO_ERROR("Failed to open '%s'.\n", null_output);
+      return;
+   }
+
+   if (!write_wav_header(voice, null_voice->wav, 0)) {
+      ALLEGRO_ERROR("Failed to write to '%s'.\n", null_output);
+      al_fclose(null_voice->wav);
+      null_voice->wav = NULL;
+      return;
+   }
+
+   null_voice->wav_data_size = 0;
+   wav_owner = null_voice;
+   ALLEGRO_INFO("Writing output to '%s'\n", null_output);
+}
+
+
+static void close_wav(ALLEGRO_VOICE *voice, NULL_VOICE *null_voice)
+{
+   if (!null_voice->wav)
+      return;
+
+   /* Fill in the sizes now that they are known. */
+   if (!al_fseek(null_voice->wav, 0, ALLEGRO_SEEK_SET) ||
+         !write_wav_header(voice, null_voice->wav, null_voice->wav_data_size)) {
+      ALLEGRO_ERROR("Failed to finish '%s'.\n", null_output);
+   }
+
+   al_fclose(null_voice->wav);
+   null_voice->wav = NULL;
+   wav_owner = NULL;
+}
+
+
+static void write_wav(ALLEGRO_VOICE *voice, NULL_VOICE *null_voice,
+   const void *data, unsigned int frames)
+{
+   size_t bytes = frames * null_voice->frame_size;
+   size_t room;
+
+   if (!null_voice->wav)
+      return;
+
+   /* Stop at the largest size a WAV file can describe, in whole frames. */
+   room = MAX_WAV_DATA_SIZE - null_voice->wav_data_size;
+   room -= room % null_voice->frame_size;
+   if (bytes > room)
+      bytes = room;
+
+#ifdef ALLEGRO_BIG_ENDIAN
+   if (voice->depth != ALLEGRO_AUDIO_DEPTH_UINT8) {
+      /* WAV files are little endian. */
+      size_t n = bytes / 2;
+      size_t i;
+
+      if (voice->depth == ALLEGRO_AUDIO_DEPTH_INT16) {
+         const int16_t *s = data;
+         for (i = 0; i < n; i++)
+            al_fwrite16le(null_voice->wav, s[i]);
+      }
+      else {
+         const int32_t *s = data;
+         for (i = 0; i < n / 2; i++)
+            al_fwrite32le(null_voice->wav, s[i]);
+      }
+   }
+   else
+#endif
+   {
+      al_fwrite(null_voice->wav, data, bytes);
+   }
+   (void)voice;
+
+   null_voice->wav_data_size += bytes;
+
+   if (bytes == room) {
+      ALLEGRO_WARN("'%s' is full, not writing any more output.\n",
+         null_output);
+      close_wav(voice, null_voice);
+   }
+}
+
+
+static int null_load_voice(ALLEGRO_VOICE *voice, const void *data)
+{
+   NULL_VOICE *ex_data = voice->extra;
+
+   if (voice->attached_stream->loop == ALLEGRO_PLAYMODE_BIDIR) {
+      ALLEGRO_INFO("Backwards playing not supported by the driver.\n");
+      return -1;
+   }
+
+   voice->attached_stream->pos = 0;
+   ex_data->len = voice->attached_stream->spl_data.len;
+
+   return 0;
+   (void)data;
+}
+
+
+static void null_unload_voice(ALLEGRO_VOICE *voice)
+{
+   (void)voice;
+}
+
+
+static int null_start_voice(ALLEGRO_VOICE *voice)
+{
+   NULL_VOICE *ex_data = voice->extra;
+
+   /* We already hold voice->mutex. */
+   ex_data->stop = false;
+   al_signal_cond(voice->cond);
+
+   return 0;
+}
+
+
+static int null_stop_voice(ALLEGRO_VOICE *voice)
+{
+   NULL_VOICE *ex_data = voice->extra;
+
+   /* We already hold voice->mutex. Waiting on the condition releases it,
+    * so the update thread can finish a _al_voice_update call it is in.
+    */
+   ex_data->stop = true;
+   al_signal_cond(voice->cond);
+
+   if (!voice->is_streaming) {
+      voice->attached_stream->pos = 0;
+   }
+
+   while (!ex_data->stopped) {
+      al_wait_cond(voice->cond, voice->mutex);
+   }
+
+   return 0;
+}
+
+
+static bool null_voice_is_playing(const ALLEGRO_VOICE *voice)
+{
+   NULL_VOICE *ex_data = voice->extra;
+   return !ex_data->stopped;
+}
+
+
+static unsigned int null_get_voice_position(const ALLEGRO_VOICE *voice)
+{
+   return voice->attached_stream->pos;
+}
+
+
+static int null_set_voice_position(ALLEGRO_VOICE *voice, unsigned int val)
+{
+   voice->attached_stream->pos = val;
+   return 0;
+}
+
+
+/* Returns up to *frames frames of a non-streaming voice and advances its
+ * position past them.
+ */
+static const void *null_update_nonstream_voice(ALLEGRO_VOICE *voice,
+   unsigned int *frames)
+{
+   NULL_VOICE *null_voice = voice->extra;
+   ALLEGRO_SAMPLE_INSTANCE *spl = voice->attached_stream;
+   unsigned int pos = spl->pos;
+   const char *data;
+
+   if (pos >= null_voice->len) {
+      *frames = 0;
+      return NULL;
+   }
+
+   data = (const char *)spl->spl_data.buffer.ptr + pos * null_voice->frame_size;
+
+   if (pos + *frames >= null_voice->len) {
+      *frames = null_voice->len - pos;
+      spl->pos = 0;
+      if (spl->loop == ALLEGRO_PLAYMODE_ONCE) {
+         null_voice->stop = true;
+      }
+   }
+   else {
+      spl->pos = pos + *frames;
+   }
+
+   return data;
+}
+
+
+static void *null_update(ALLEGRO_THREAD *self, void *arg)
+{
+   ALLEGRO_VOICE *voice = arg;
+   NULL_VOICE *null_voice = voice->extra;
+   double next_time = al_get_time();
+
+   while (!al_get_thread_should_stop(self)) {
+      unsigned int frames = null_voice->buffer_size;
+      const void *data = NULL;
+
+      if (null_voice->stop && !null_voice->stopped) {
+         al_lock_mutex(voice->mutex);
+         null_voice->stopped = true;
+         al_signal_cond(voice->cond);
+         al_unlock_mutex(voice->mutex);
+      }
+
+      if (!null_voice->stop && null_voice->stopped) {
+         null_voice->stopped = false;
+         next_time = al_get_time();
+      }
+
+      if (null_voice->stopped) {
+         /* Nothing is consuming the output, so don't write any silence
+          * either. Wait for the voice being started again.
+          */
+         al_lock_mutex(voice->mutex);
+         while (null_voice->stop && !al_get_thread_should_stop(self)) {
+            al_wait_cond(voice->cond, voice->mutex);
+         }
+         al_unlock_mutex(voice->mutex);
+         continue;
+      }
+
+      if (voice->is_streaming) {
+         data = _al_voice_update(voice, voice->mutex, &frames);
+      }
+      else {
+         data = null_update_nonstream_voice(voice, &frames);
+      }
+
+      if (!data) {
+         data = null_voice->silence;
+         frames = null_voice->buffer_size;
+      }
+
+      write_wav(voice, null_voice, data, frames);
+
+      if (null_realtime) {
+         /* Keep to the clock of the imaginary sound card, without drifting
+          * from it when a rest takes longer than asked for.
+          */
+         double now;
+
+         next_time += (double)frames / voice->frequency;
+         now = al_get_time();
+         if (next_time > now)
+            al_rest(next_time - now);
+         else if (now - next_time > 1.0)
+            next_time = now;
+      }
+   }
+
+   return NULL;
+}
+
+
+static int null_allocate_voice(ALLEGRO_VOICE *voice)
+{
+   NULL_VOICE *ex_data;
+
+   ex_data = al_calloc(1, sizeof(NULL_VOICE));
+   if (!ex_data)
+      return 1;
+
+   ex_data->frame_size = al_get_channel_count(voice->chan_conf) *
+      al_get_audio_depth_size(voice->depth);
+   if (!ex_data->frame_size) {
+      al_free(ex_data);
+      return 1;
+   }
+
+   ex_data->buffer_size = null_buffer_size;
+   ex_data->silence = al_malloc(ex_data->buffer_size * ex_data->frame_size);
+   if (!ex_data->silence) {
+      al_free(ex_data);
+      return 1;
+   }
+   al_fill_silence(ex_data->silence, ex_data->buffer_size, voice->depth,
+      voice->chan_conf);
+
+   ex_data->stop = true;
+   ex_data->stopped = true;
+
+   open_wav(voice, ex_data);
+
+   voice->extra = ex_data;
+   ex_data->update_thread = al_create_thread(null_update, (void*)voice);
+   al_start_thread(ex_data->update_thread);
+
+   return 0;
+}
+
+
+static void null_deallocate_voice(ALLEGRO_VOICE *voice)
+{
+   NULL_VOICE *null_voice = voice->extra;
+
+   /* We do NOT hold the voice mutex here, so this does NOT result in a
+    * deadlock when null_update calls _al_voice_update.
+    */
+   al_lock_mutex(voice->mutex);
+   al_set_thread_should_stop(null_voice->update_thread);
+   al_broadcast_cond(voice->cond);
+   al_unlock_mutex(voice->mutex);
+   al_join_thread(null_voice->update_thread, NULL);
+   al_destroy_thread(null_voice->update_thread);
+
+   close_wav(voice, null_voice);
+
+   al_free(null_voice->silence);
+   al_free(voice->extra);
+   voice->extra = NULL;
+}
+
+
+ALLEGRO_AUDIO_DRIVER _al_kcm_null_driver =
+{
+   "null",
+
+   null_open,
+   null_close,
+
+   null_allocate_voice,
+   null_deallocate_voice,
+
+   null_load_voice,
+   null_unload_voice,
+
+   null_start_voice,
+   null_stop_voice,
+
+   null_voice_is_playing,
+
+   null_get_voice_position,
+   null_set_voice_position,
+
+   NULL,
+   NULL
+};
+
+/* vim: set sts=3 sw=3 et: */
@@ -47,6 +47,7 @@
 */
 typedef struct ALLEGRO_FONT ALLEGRO_FONT;
 typedef struct ALLEGRO_FONT_VTABLE ALLEGRO_FONT_VTABLE;
+typedef struct ALLEGRO_GLYPH ALLEGRO_GLYPH;
 
 struct ALLEGRO_FONT
 {
@@ -76,9 +77,45 @@ struct ALLEGRO_FONT_VTABLE
       int codepoint, int *bbx, int *bby, int *bbw, int *bbh));      
    ALLEGRO_FONT_METHOD(int, get_glyph_advance, (const ALLEGRO_FONT *font,
       int codepoint1, int codepoint2));
-      
+
+   /* Optional, may be NULL. get_cache_generation returns a number which
+    * changes whenever what get_glyph returns may have changed.
+    */
+   ALLEGRO_FONT_METHOD(bool, get_glyph, (const ALLEGRO_FONT *font,
+      int prev_codepoint, int codepoint, ALLEGRO_GLYPH *glyph));
+   ALLEGRO_FONT_METHOD(int, get_cache_generation, (const ALLEGRO_FONT *font));
+   /* Optional, may be NULL. Tells the font that glyphs on these bitmaps, as
+    * returned by get_glyph earlier, are being drawn again.
+    */
+   ALLEGRO_FONT_METHOD(void, touch_glyph_bitmaps, (const ALLEGRO_FONT *font,
+      ALLEGRO_BITMAP * const *bitmaps, int count));
+};
+
+#if defined(ALLEGRO_UNSTABLE) || defined(ALLEGRO_INTERNAL_UNSTABLE) || defined(ALLEGRO_FONT_SRC)
+/* Type: ALLEGRO_GLYPH
+ */
+struct ALLEGRO_GLYPH
+{
+   ALLEGRO_BITMAP *bitmap;
+   int x;
+   int y;
+   int w;
+   int h;
+   int kerning;
+   int offset_x;
+   int offset_y;
+   int advance;
 };
 
+/* Type: ALLEGRO_TEXT_LAYOUT
+ */
+typedef struct ALLEGRO_TEXT_LAYOUT ALLEGRO_TEXT_LAYOUT;
+
+/* Type: ALLEGRO_MULTILINE_LAYOUT
+ */
+typedef struct ALLEGRO_MULTILINE_LAYOUT ALLEGRO_MULTILINE_LAYOUT;
+#endif
+
 enum {
    ALLEGRO_NO_KERNING       = -1,
    ALLEGRO_ALIGN_LEFT       = 0,
@@ -148,6 +185,34 @@ ALLEGRO_FONT_FUNC(void, al_set_fallback_font, (ALLEGRO_FONT *font,
 ALLEGRO_FONT_FUNC(ALLEGRO_FONT *, al_get_fallback_font, (
    ALLEGRO_FONT *font));
 
+#if defined(ALLEGRO_UNSTABLE) || defined(ALLEGRO_INTERNAL_UNSTABLE) || defined(ALLEGRO_FONT_SRC)
+ALLEGRO_FONT_FUNC(bool, al_get_glyph, (const ALLEGRO_FONT *f,
+   int prev_codepoint, int codepoint, ALLEGRO_GLYPH *glyph));
+
+ALLEGRO_FONT_FUNC(ALLEGRO_TEXT_LAYOUT *, al_create_text_layout, (
+   const ALLEGRO_FONT *font, const ALLEGRO_USTR *ustr));
+ALLEGRO_FONT_FUNC(void, al_destroy_text_layout, (ALLEGRO_TEXT_LAYOUT *layout));
+ALLEGRO_FONT_FUNC(void, al_draw_text_layout, (ALLEGRO_TEXT_LAYOUT *layout,
+   ALLEGRO_COLOR color, float x, float y, int flags));
+ALLEGRO_FONT_FUNC(int, al_get_text_layout_width, (
+   const ALLEGRO_TEXT_LAYOUT *layout));
+ALLEGRO_FONT_FUNC(int, al_get_text_layout_height, (
+   const ALLEGRO_TEXT_LAYOUT *layout));
+ALLEGRO_FONT_FUNC(void, al_get_text_layout_dimensions, (
+   const ALLEGRO_TEXT_LAYOUT *layout,
+   int *bbx, int *bby, int *bbw, int *bbh));
+
+ALLEGRO_FONT_FUNC(ALLEGRO_MULTILINE_LAYOUT *, al_create_multiline_layout, (
+   const ALLEGRO_FONT *font, float max_width, const ALLEGRO_USTR *ustr));
+ALLEGRO_FONT_FUNC(void, al_destroy_multiline_layout, (
+   ALLEGRO_MULTILINE_LAYOUT *layout));
+ALLEGRO_FONT_FUNC(void, al_draw_multiline_layout, (
+   ALLEGRO_MULTILINE_LAYOUT *layout, ALLEGRO_COLOR color, float x, float y,
+   float line_height, int flags));
+ALLEGRO_FONT_FUNC(int, al_get_multiline_layout_line_count, (
+   const ALLEGRO_MULTILINE_LAYOUT *layout));
+#endif
+
 #ifdef __cplusplus
    }
 #endif
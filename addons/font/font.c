@@ -285,6 +285,33 @@ static bool color_get_glyph_dimensions(ALLEGRO_FONT const *f,
    return true;
 }
 
+static bool color_get_glyph(ALLEGRO_FONT const *f, int prev_codepoint,
+   int codepoint, ALLEGRO_GLYPH *glyph)
+{
+   ALLEGRO_BITMAP *g = _al_font_color_find_glyph(f, codepoint);
+   (void)prev_codepoint;
+
+   if (!g) {
+      if (f->fallback) {
+         return al_get_glyph(f->fallback, ALLEGRO_NO_KERNING, codepoint,
+            glyph);
+      }
+      return false;
+   }
+
+   glyph->bitmap = g;
+   glyph->x = 0;
+   glyph->y = 0;
+   glyph->w = al_get_bitmap_width(g);
+   glyph->h = al_get_bitmap_height(g);
+   glyph->kerning = 0;
+   glyph->offset_x = 0;
+   /* Centred vertically the same way as in color_render_char. */
+   glyph->offset_y = ((float)f->vtable->font_height(f) - glyph->h) / 2.0f;
+   glyph->advance = glyph->w;
+   return true;
+}
+
 static int color_get_glyph_advance(ALLEGRO_FONT const *f,
    int codepoint1, int codepoint2)
 {
@@ -317,7 +344,10 @@ ALLEGRO_FONT_VTABLE _al_font_vtable_color = {
     color_get_text_dimensions,
     color_get_font_ranges,
     color_get_glyph_dimensions,
-    color_get_glyph_advance
+    color_get_glyph_advance,
+    color_get_glyph,
+    NULL,
+    NULL
 };
 
 
@@ -14,5 +14,12 @@ typedef struct ALLEGRO_FONT_COLOR_DATA
 ALLEGRO_FONT *_al_load_bitmap_font(const char *filename,
    int size, int flags);
 
+void _al_wrap_ustr(const ALLEGRO_FONT *font, float max_width,
+   const ALLEGRO_USTR *ustr,
+   bool (*proc)(int line_num, int start, int end, void *extra),
+   void *extra);
+
+void _al_align_to_integer_pixel(float *x, float *y);
+
 
 #endif
@@ -27,6 +27,9 @@
 #include "allegro5/allegro_font.h"
 #include "allegro5/internal/aintern_dtor.h"
 #include "allegro5/internal/aintern_system.h"
+#include "allegro5/internal/aintern_vector.h"
+
+#include "font.h"
 
 /* If you call this, you're probably making a mistake. */
 /*
@@ -56,7 +59,7 @@ static void align_to_integer_pixel_inner(
    al_transform_coordinates(inv, x, y);
 }
 
-static void align_to_integer_pixel(float *x, float *y)
+void _al_align_to_integer_pixel(float *x, float *y)
 {
    ALLEGRO_TRANSFORM const *fwd;
    ALLEGRO_TRANSFORM inv;
@@ -89,7 +92,7 @@ void al_draw_ustr(const ALLEGRO_FONT *font,
    }
 
    if (flags & ALLEGRO_ALIGN_INTEGER)
-      align_to_integer_pixel(&x, &y);
+      _al_align_to_integer_pixel(&x, &y);
 
    font->vtable->render(font, color, ustr, x, y);
 }
@@ -154,7 +157,7 @@ void al_draw_justified_ustr(const ALLEGRO_FONT *font,
    if ((space <= 0) || (space > diff) || (num_words < 2)) {
       /* can't justify */
       if (flags & ALLEGRO_ALIGN_INTEGER)
-         align_to_integer_pixel(&x1, &y);
+         _al_align_to_integer_pixel(&x1, &y);
       font->vtable->render(font, color, ustr, x1, y);
       return; 
    }
@@ -402,109 +405,209 @@ int al_get_glyph_advance(const ALLEGRO_FONT *f, int codepoint1, int codepoint2)
    return f->vtable->get_glyph_advance(f, codepoint1, codepoint2);
 }
 
+/* Function: al_get_glyph
+ */
+bool al_get_glyph(const ALLEGRO_FONT *f, int prev_codepoint, int codepoint,
+   ALLEGRO_GLYPH *glyph)
+{
+   ASSERT(f);
+   ASSERT(glyph);
 
+   if (!f->vtable->get_glyph)
+      return false;
+   return f->vtable->get_glyph(f, prev_codepoint, codepoint, glyph);
+}
 
-/* This helper function helps splitting an ustr in several delimited parts.
- * It returns an ustr that refers to the next part of the string that
- * is delimited by the delimiters in delimiter.
- * Returns NULL at the end of the string.
- * Pos is updated to byte index of character after the delimiter or
- * to the end of the string.
+
+
+/* A place where a hard line may be broken into soft lines: a space or tab,
+ * or the end of the hard line.
  */
-static const ALLEGRO_USTR *ustr_split_next(const ALLEGRO_USTR *ustr,
-   ALLEGRO_USTR_INFO *info, int *pos, const char *delimiter)
+typedef struct WRAP_BREAK
 {
-   const ALLEGRO_USTR *result;
-   int end, size;
+   int pos;       /* Byte position of the space or tab. */
+   int width;     /* Width of the text from the start of the hard line
+                   * up to pos. */
+   int next_pen;  /* Pen position after the space or tab. */
+} WRAP_BREAK;
+
+
 
-   size = al_ustr_size(ustr);
-   if (*pos >= size) {
-      return NULL;
+/* Walk the glyphs of the hard line from start to end once, summing up their
+ * advances and kerning, and append a break to breaks for every space or tab
+ * and for the end of the line.
+ */
+static void find_breaks(const ALLEGRO_FONT *font, const ALLEGRO_USTR *ustr,
+   int start, int end, _AL_VECTOR *breaks)
+{
+   WRAP_BREAK *b;
+   int pos = start;
+   int ch_pos = start;
+   int pen = 0;
+   int width = 0;
+   int32_t ch = al_ustr_get_next(ustr, &pos);
+
+   while (ch >= 0 && ch_pos < end) {
+      int next_pos = pos;
+      int32_t nch = (next_pos < end) ? al_ustr_get_next(ustr, &pos) : -1;
+      int advance = al_get_glyph_advance(font, ch,
+         nch < 0 ? ALLEGRO_NO_KERNING : nch);
+
+      if (ch == ' ' || ch == '\t') {
+         b = _al_vector_alloc_back(breaks);
+         b->pos = ch_pos;
+         b->width = width;
+         b->next_pen = pen + advance;
+      }
+
+      /* A line ending before the next glyph has no kerning with it. */
+      if (nch < 0 || nch == ' ' || nch == '\t') {
+         width = pen + ((nch < 0) ? advance :
+            al_get_glyph_advance(font, ch, ALLEGRO_NO_KERNING));
+      }
+
+      pen += advance;
+      ch = nch;
+      ch_pos = next_pos;
    }
 
-   end = al_ustr_find_set_cstr(ustr, *pos, delimiter);
-   if (end == -1)
-      end = size;
+   b = _al_vector_alloc_back(breaks);
+   b->pos = end;
+   b->width = width;
+   b->next_pen = pen;
+}
+
 
-   result = al_ref_ustr(info, ustr, *pos, end);
-   /* Set pos to character AFTER delimiter */
-   al_ustr_next(ustr, &end);
-   (*pos) = end;
-   return result;
+
+/* Break the hard line from start to end into soft lines using the breaks
+ * from find_breaks, starting at index first. Each soft line ends at the
+ * last break which still lets it fit max_width, or at the first break if
+ * not even that fits. The space or tab at the break is dropped.
+ */
+static bool wrap_hard_line(float max_width, int start, int end,
+   const _AL_VECTOR *breaks, unsigned int first, int *line_num,
+   bool (*proc)(int line_num, int start, int end, void *extra),
+   void *extra)
+{
+   unsigned int num_breaks = _al_vector_size(breaks);
+   unsigned int i = first;
+   int line_start = start;
+   int line_pen = 0;
+
+   while (line_start < end) {
+      const WRAP_BREAK *prev = NULL;
+      const WRAP_BREAK *split = NULL;
+
+      for (; i < num_breaks; i++) {
+         const WRAP_BREAK *b = _al_vector_ref(breaks, i);
+         int width = (b->pos == line_start) ? 0 : b->width - line_pen;
+
+         if (width > max_width) {
+            if (prev) {
+               split = prev;
+            }
+            else {
+               /* A single word which does not fit is a line of its own. */
+               split = b;
+               i++;
+            }
+            break;
+         }
+         if (b->pos + 1 >= end) {
+            /* The rest of the hard line fits. */
+            break;
+         }
+         prev = b;
+      }
+
+      if (!split) {
+         return proc((*line_num)++, line_start, end, extra);
+      }
+      if (!proc((*line_num)++, line_start, split->pos, extra))
+         return false;
+      line_start = split->pos + 1;
+      line_pen = split->next_pen;
+   }
+
+   return true;
 }
 
 
 
-/* This returns the next "soft" line of text from ustr
- * that will fit in max_with using the font font, starting at pos *pos.
- * These are "soft" lines because they are broken up if needed at a space
- * or tab character.
- * This function updates pos if needed, and returns the next "soft" line,
- * or NULL if no more soft lines.
- * The soft line will not include the trailing space where the
- * line was split, but pos will be set to point to after that trailing
- * space so iteration can continue easily.
+/* Internal function: _al_wrap_ustr
+ *  Split ustr into lines as described for al_draw_multiline_ustr, calling
+ *  proc with the byte range of each line in ustr. Stops if proc returns
+ *  false.
+ *
+ *  Each hard line is measured in a single pass, so this takes time linear
+ *  in the length of the text rather than measuring each candidate soft line
+ *  again from its start.
  */
-static const ALLEGRO_USTR *get_next_soft_line(const ALLEGRO_USTR *ustr,
-   ALLEGRO_USTR_INFO *info, int *pos,
-   const ALLEGRO_FONT *font, float max_width)
+void _al_wrap_ustr(const ALLEGRO_FONT *font, float max_width,
+   const ALLEGRO_USTR *ustr,
+   bool (*proc)(int line_num, int start, int end, void *extra),
+   void *extra)
 {
-   const ALLEGRO_USTR *result = NULL;
-   const char *whitespace = " \t";
-   int old_end = 0;
-   int end = 0;
+   _AL_VECTOR breaks = _AL_VECTOR_INITIALIZER(WRAP_BREAK);
    int size = al_ustr_size(ustr);
-   bool first_word = true;
+   int start = 0;
+   int line_num = 0;
 
-   if (*pos >= size) {
-      return NULL;
-   }
+   while (start < size) {
+      int end = al_ustr_find_chr(ustr, start, '\n');
+      bool proceed;
 
-   end = *pos;
-   old_end = end;
-   do {
-      /* On to the next word. */
-      end = al_ustr_find_set_cstr(ustr, end, whitespace);
       if (end < 0)
          end = size;
 
-      /* Reference to the line that is being built. */
-      result = al_ref_ustr(info, ustr, *pos, end);
+      if (end == start) {
+         proceed = proc(line_num++, start, start, extra);
+      }
+      else {
+         unsigned int first = _al_vector_size(&breaks);
+         find_breaks(font, ustr, start, end, &breaks);
+         proceed = wrap_hard_line(max_width, start, end, &breaks, first,
+            &line_num, proc, extra);
+      }
+      if (!proceed)
+         break;
+
+      start = end + 1;
+   }
+
+   _al_vector_free(&breaks);
+}
+
+
+
+/* Helper struct for al_do_multiline_ustr. */
+typedef struct DO_MULTILINE_USTR_EXTRA {
+   const ALLEGRO_USTR *ustr;
+   bool (*callback)(int line_num, const ALLEGRO_USTR *line, void *extra);
+   void *extra;
+} DO_MULTILINE_USTR_EXTRA;
 
-      /* Check if the line is too long. If it is, return a soft line. */
-      if (al_get_ustr_width(font, result) > max_width) {
-         /* Corner case: a single word may not even fit the line.
-          * In that case, return the word/line anyway as the "soft line",
-          * the user can set a clip rectangle to cut it. */
 
-         if (first_word) {
-            /* Set pos to character AFTER end to allow easy iteration. */
-            al_ustr_next(ustr, &end);
-            *pos = end;
-            return result;
-         }
-         else {
-            /* Not first word, return old end position without the new word */
-            result = al_ref_ustr(info, ustr, *pos, old_end);
-            /* Set pos to character AFTER end to allow easy iteration. */
-            al_ustr_next(ustr, &old_end);
-            *pos = old_end;
-            return result;
-         }
-      }
-      first_word = false;
-      old_end    = end;
-      /* Skip the character at end which normally is whitespace. */
-      al_ustr_next(ustr, &end);
-   } while (end < size);
 
-   /* If we get here the whole ustr will fit.*/
-   result = al_ref_ustr(info, ustr, *pos, size);
-   *pos = size;
-   return result;
+/* The function do_multiline_ustr_cb is the helper callback that passes
+ * the lines found by _al_wrap_ustr to the callback of al_do_multiline_ustr.
+ */
+static bool do_multiline_ustr_cb(int line_num, int start, int end,
+   void *extra)
+{
+   DO_MULTILINE_USTR_EXTRA *s = extra;
+   ALLEGRO_USTR_INFO info;
+
+   if (start == end) {
+      /* Call the callback with empty string to indicate an empty line. */
+      return s->callback(line_num, al_ustr_empty_string(), s->extra);
+   }
+   return s->callback(line_num, al_ref_ustr(&info, s->ustr, start, end),
+      s->extra);
 }
 
 
+
 /* Function: al_do_multiline_ustr
  */
 void al_do_multiline_ustr(const ALLEGRO_FONT *font, float max_width,
@@ -512,41 +615,14 @@ void al_do_multiline_ustr(const ALLEGRO_FONT *font, float max_width,
    bool (*cb)(int line_num, const ALLEGRO_USTR * line, void *extra),
    void *extra)
 {
-   const char *linebreak  = "\n";
-   const ALLEGRO_USTR *hard_line, *soft_line;
-   ALLEGRO_USTR_INFO hard_line_info, soft_line_info;
-   int hard_line_pos = 0, soft_line_pos = 0;
-   int line_num = 0;
-   bool proceed;
-
-   /* For every "hard" line separated by a newline character... */
-   hard_line = ustr_split_next(ustr, &hard_line_info, &hard_line_pos,
-      linebreak);
-   while (hard_line) {
-      /* For every "soft" line in the "hard" line... */
-      soft_line_pos = 0;
-      soft_line =
-      get_next_soft_line(hard_line, &soft_line_info, &soft_line_pos, font,
-         max_width);
-      /* No soft line here because it's an empty hard line. */
-      if (!soft_line) {
-         /* Call the callback with empty string to indicate an empty line. */
-         proceed = cb(line_num, al_ustr_empty_string(), extra);
-         if (!proceed) return;
-         line_num ++;
-      }
-      while(soft_line) {
-         /* Call the callback on the next soft line. */
-         proceed = cb(line_num, soft_line, extra);
-         if (!proceed) return;
-         line_num++;
-
-         soft_line = get_next_soft_line(hard_line, &soft_line_info,
-            &soft_line_pos, font, max_width);
-      }
-      hard_line = ustr_split_next(ustr, &hard_line_info, &hard_line_pos,
-         linebreak);
-   }
+   DO_MULTILINE_USTR_EXTRA extra2;
+   ASSERT(font);
+   ASSERT(ustr);
+
+   extra2.ustr = ustr;
+   extra2.callback = cb;
+   extra2.extra = extra;
+   _al_wrap_ustr(font, max_width, ustr, do_multiline_ustr_cb, &extra2);
 }
 
 
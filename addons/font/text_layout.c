@@ -0,0 +1,430 @@
+/*         ______   ___    ___
+ *        /\  _  \ /\_ \  /\_ \
+ *        \ \ \L\ \\//\ \ \//\ \      __     __   _ __   ___
+ *         \ \  __ \ \ \ \  \ \ \   /'__`\ /'_ `\/\`'__\/ __`\
+ *          \ \ \/\ \ \_\ \_ \_\ \_/\  __//\ \L\ \ \ \//\ \L\ \
+ *           \ \_\ \_\/\____\/\____\ \____\ \____ \ \_\\ \____/
+ *            \/_/\/_/\/____/\/____/\/____/\/___L\ \/_/ \/___/
+ *                                           /\____/
+ *                                           \_/__/
+ *
+ *      Text layouts, strings prepared for drawing them repeatedly.
+ *
+ *      See readme.txt for copyright information.
+ */
+
+
+#include "allegro5/allegro.h"
+
+#include "allegro5/allegro_font.h"
+#include "allegro5/internal/aintern.h"
+#include "allegro5/internal/aintern_bitmap.h"
+#include "allegro5/internal/aintern_vector.h"
+
+#include "font.h"
+
+ALLEGRO_DEBUG_CHANNEL("font")
+
+
+struct ALLEGRO_TEXT_LAYOUT
+{
+   const ALLEGRO_FONT *font;
+   ALLEGRO_USTR *text;
+   _AL_VECTOR quads;  /* of _AL_BITMAP_QUAD, relative to the pen origin */
+   _AL_VECTOR draw_quads;  /* Copy of quads moved to where they are drawn. */
+   _AL_VECTOR bitmaps;  /* of ALLEGRO_BITMAP *, each one the quads use once */
+   bool use_quads;    /* Else the font can't give us its glyphs. */
+   _AL_VECTOR generations;  /* of FONT_GENERATION, for the fallback chain */
+   int width;
+   int bbx, bby, bbw, bbh;
+};
+
+
+struct ALLEGRO_MULTILINE_LAYOUT
+{
+   const ALLEGRO_FONT *font;
+   _AL_VECTOR lines;  /* of ALLEGRO_TEXT_LAYOUT * */
+};
+
+
+/* The quads may use glyph bitmaps of any font in the fallback chain, so
+ * the layout is only valid while none of them changed their cache.
+ */
+typedef struct FONT_GENERATION
+{
+   const ALLEGRO_FONT *font;
+   int generation;
+} FONT_GENERATION;
+
+
+typedef struct MULTILINE_LAYOUT_EXTRA
+{
+   ALLEGRO_MULTILINE_LAYOUT *layout;
+   const ALLEGRO_USTR *ustr;
+} MULTILINE_LAYOUT_EXTRA;
+
+
+
+static int get_generation(const ALLEGRO_FONT *font)
+{
+   if (font->vtable->get_cache_generation)
+      return font->vtable->get_cache_generation(font);
+   return 0;
+}
+
+
+
+static void get_generations(const ALLEGRO_FONT *font, _AL_VECTOR *generations)
+{
+   FONT_GENERATION *slot;
+
+   _al_vector_free(generations);
+   for (; font; font = font->fallback) {
+      slot = _al_vector_alloc_back(generations);
+      if (slot) {
+         slot->font = font;
+         slot->generation = get_generation(font);
+      }
+   }
+}
+
+
+
+static bool generations_changed(const ALLEGRO_TEXT_LAYOUT *layout)
+{
+   const ALLEGRO_FONT *font = layout->font;
+   unsigned int i;
+
+   for (i = 0; font; i++, font = font->fallback) {
+      FONT_GENERATION *slot;
+      if (i >= _al_vector_size(&layout->generations))
+         return true;
+      slot = _al_vector_ref(&layout->generations, i);
+      if (slot->font != font || slot->generation != get_generation(font))
+         return true;
+   }
+   return i != _al_vector_size(&layout->generations);
+}
+
+
+
+static void add_bitmap(ALLEGRO_TEXT_LAYOUT *layout, ALLEGRO_BITMAP *bitmap)
+{
+   unsigned int i;
+   ALLEGRO_BITMAP **slot;
+
+   for (i = 0; i < _al_vector_size(&layout->bitmaps); i++) {
+      slot = _al_vector_ref(&layout->bitmaps, i);
+      if (*slot == bitmap)
+         return;
+   }
+
+   slot = _al_vector_alloc_back(&layout->bitmaps);
+   if (slot)
+      *slot = bitmap;
+}
+
+
+
+/* Position the glyphs of the text the same way the font's render method
+ * would.
+ */
+static void shape_layout(ALLEGRO_TEXT_LAYOUT *layout)
+{
+   const ALLEGRO_FONT *font = layout->font;
+   ALLEGRO_GLYPH glyph;
+   int pos = 0;
+   int pen = 0;
+   int prev = ALLEGRO_NO_KERNING;
+   int32_t ch;
+
+   _al_vector_free(&layout->quads);
+   _al_vector_free(&layout->draw_quads);
+   _al_vector_free(&layout->bitmaps);
+   get_generations(font, &layout->generations);
+   layout->use_quads = (font->vtable->get_glyph != NULL);
+   if (!layout->use_quads)
+      return;
+
+   while ((ch = al_ustr_get_next(layout->text, &pos)) >= 0) {
+      if (!font->vtable->get_glyph(font, prev, ch, &glyph)) {
+         prev = ch;
+         continue;
+      }
+
+      pen += glyph.kerning;
+      if (glyph.bitmap) {
+         _AL_BITMAP_QUAD *quad = _al_vector_alloc_back(&layout->quads);
+         quad->bitmap = glyph.bitmap;
+         quad->sx = glyph.x;
+         quad->sy = glyph.y;
+         quad->sw = glyph.w;
+         quad->sh = glyph.h;
+         quad->dx = pen + glyph.offset_x;
+         quad->dy = glyph.offset_y;
+         add_bitmap(layout, glyph.bitmap);
+      }
+      pen += glyph.advance;
+      prev = ch;
+   }
+
+   /* Caching the later glyphs evicted some of the earlier ones. Draw with
+    * the font until the next time the layout is shaped.
+    */
+   if (generations_changed(layout)) {
+      ALLEGRO_DEBUG("Glyphs of text layout %p evicted while shaping\n",
+         layout);
+      _al_vector_free(&layout->quads);
+      _al_vector_free(&layout->bitmaps);
+      layout->use_quads = false;
+      return;
+   }
+
+   if (!_al_vector_is_empty(&layout->quads)) {
+      _al_vector_append_array(&layout->draw_quads,
+         _al_vector_size(&layout->quads),
+         _al_vector_ref_front(&layout->quads));
+   }
+}
+
+
+
+/* Function: al_create_text_layout
+ */
+ALLEGRO_TEXT_LAYOUT *al_create_text_layout(const ALLEGRO_FONT *font,
+   const ALLEGRO_USTR *ustr)
+{
+   ALLEGRO_TEXT_LAYOUT *layout;
+   ASSERT(font);
+   ASSERT(ustr);
+
+   layout = al_calloc(1, sizeof *layout);
+   if (!layout)
+      return NULL;
+
+   layout->font = font;
+   layout->text = al_ustr_dup(ustr);
+   if (!layout->text) {
+      al_free(layout);
+      return NULL;
+   }
+   _al_vector_init(&layout->quads, sizeof(_AL_BITMAP_QUAD));
+   _al_vector_init(&layout->draw_quads, sizeof(_AL_BITMAP_QUAD));
+   _al_vector_init(&layout->bitmaps, sizeof(ALLEGRO_BITMAP *));
+   _al_vector_init(&layout->generations, sizeof(FONT_GENERATION));
+
+   layout->width = font->vtable->text_length(font, layout->text);
+   font->vtable->get_text_dimensions(font, layout->text,
+      &layout->bbx, &layout->bby, &layout->bbw, &layout->bbh);
+
+   shape_layout(layout);
+
+   return layout;
+}
+
+
+
+/* Function: al_destroy_text_layout
+ */
+void al_destroy_text_layout(ALLEGRO_TEXT_LAYOUT *layout)
+{
+   if (!layout)
+      return;
+
+   _al_vector_free(&layout->quads);
+   _al_vector_free(&layout->draw_quads);
+   _al_vector_free(&layout->bitmaps);
+   _al_vector_free(&layout->generations);
+   al_ustr_free(layout->text);
+   al_free(layout);
+}
+
+
+
+/* Function: al_draw_text_layout
+ */
+void al_draw_text_layout(ALLEGRO_TEXT_LAYOUT *layout, ALLEGRO_COLOR color,
+   float x, float y, int flags)
+{
+   unsigned int i;
+   ASSERT(layout);
+
+   if (flags & ALLEGRO_ALIGN_CENTRE) {
+      /* Use integer division like al_draw_ustr. */
+      x -= layout->width / 2;
+   }
+   else if (flags & ALLEGRO_ALIGN_RIGHT) {
+      x -= layout->width;
+   }
+
+   if (flags & ALLEGRO_ALIGN_INTEGER)
+      _al_align_to_integer_pixel(&x, &y);
+
+   if (generations_changed(layout)) {
+      ALLEGRO_DEBUG("Shaping text layout %p again\n", layout);
+      shape_layout(layout);
+   }
+
+   if (!layout->use_quads) {
+      layout->font->vtable->render(layout->font, color, layout->text, x, y);
+      return;
+   }
+
+   if (_al_vector_is_empty(&layout->quads))
+      return;
+
+   /* Fonts which evict the least recently used glyphs otherwise only see
+    * the glyphs being used when the layout is shaped.
+    */
+   if (layout->font->vtable->touch_glyph_bitmaps) {
+      layout->font->vtable->touch_glyph_bitmaps(layout->font,
+         _al_vector_ref_front(&layout->bitmaps),
+         _al_vector_size(&layout->bitmaps));
+   }
+
+   for (i = 0; i < _al_vector_size(&layout->quads); i++) {
+      _AL_BITMAP_QUAD *quad = _al_vector_ref(&layout->quads, i);
+      _AL_BITMAP_QUAD *draw_quad = _al_vector_ref(&layout->draw_quads, i);
+      draw_quad->dx = x + quad->dx;
+      draw_quad->dy = y + quad->dy;
+      draw_quad->tint = color;
+   }
+   _al_draw_bitmap_quads(_al_vector_ref_front(&layout->draw_quads),
+      _al_vector_size(&layout->draw_quads));
+}
+
+
+
+/* Function: al_get_text_layout_width
+ */
+int al_get_text_layout_width(const ALLEGRO_TEXT_LAYOUT *layout)
+{
+   ASSERT(layout);
+   return layout->width;
+}
+
+
+
+/* Function: al_get_text_layout_height
+ */
+int al_get_text_layout_height(const ALLEGRO_TEXT_LAYOUT *layout)
+{
+   ASSERT(layout);
+   return al_get_font_line_height(layout->font);
+}
+
+
+
+/* Function: al_get_text_layout_dimensions
+ */
+void al_get_text_layout_dimensions(const ALLEGRO_TEXT_LAYOUT *layout,
+   int *bbx, int *bby, int *bbw, int *bbh)
+{
+   ASSERT(layout);
+
+   if (bbx) *bbx = layout->bbx;
+   if (bby) *bby = layout->bby;
+   if (bbw) *bbw = layout->bbw;
+   if (bbh) *bbh = layout->bbh;
+}
+
+
+
+
+static bool add_multiline_layout_line(int line_num, int start, int end,
+   void *extra)
+{
+   MULTILINE_LAYOUT_EXTRA *s = extra;
+   ALLEGRO_USTR_INFO info;
+   ALLEGRO_TEXT_LAYOUT **line;
+   (void)line_num;
+
+   line = _al_vector_alloc_back(&s->layout->lines);
+   *line = al_create_text_layout(s->layout->font,
+      al_ref_ustr(&info, s->ustr, start, end));
+   return *line != NULL;
+}
+
+
+
+/* Function: al_create_multiline_layout
+ */
+ALLEGRO_MULTILINE_LAYOUT *al_create_multiline_layout(const ALLEGRO_FONT *font,
+   float max_width, const ALLEGRO_USTR *ustr)
+{
+   ALLEGRO_MULTILINE_LAYOUT *layout;
+   MULTILINE_LAYOUT_EXTRA extra;
+   ALLEGRO_TEXT_LAYOUT **last;
+   ASSERT(font);
+   ASSERT(ustr);
+
+   layout = al_calloc(1, sizeof *layout);
+   if (!layout)
+      return NULL;
+
+   layout->font = font;
+   _al_vector_init(&layout->lines, sizeof(ALLEGRO_TEXT_LAYOUT *));
+
+   extra.layout = layout;
+   extra.ustr = ustr;
+   _al_wrap_ustr(font, max_width, ustr, add_multiline_layout_line, &extra);
+
+   last = _al_vector_is_empty(&layout->lines) ? NULL :
+      _al_vector_ref_back(&layout->lines);
+   if (last && !*last) {
+      al_destroy_multiline_layout(layout);
+      return NULL;
+   }
+
+   return layout;
+}
+
+
+
+/* Function: al_destroy_multiline_layout
+ */
+void al_destroy_multiline_layout(ALLEGRO_MULTILINE_LAYOUT *layout)
+{
+   unsigned int i;
+
+   if (!layout)
+      return;
+
+   for (i = 0; i < _al_vector_size(&layout->lines); i++) {
+      ALLEGRO_TEXT_LAYOUT **line = _al_vector_ref(&layout->lines, i);
+      al_destroy_text_layout(*line);
+   }
+   _al_vector_free(&layout->lines);
+   al_free(layout);
+}
+
+
+
+/* Function: al_draw_multiline_layout
+ */
+void al_draw_multiline_layout(ALLEGRO_MULTILINE_LAYOUT *layout,
+   ALLEGRO_COLOR color, float x, float y, float line_height, int flags)
+{
+   unsigned int i;
+   ASSERT(layout);
+
+   if (line_height < 1)
+      line_height = al_get_font_line_height(layout->font);
+
+   for (i = 0; i < _al_vector_size(&layout->lines); i++) {
+      ALLEGRO_TEXT_LAYOUT **line = _al_vector_ref(&layout->lines, i);
+      al_draw_text_layout(*line, color, x, y + line_height * i, flags);
+   }
+}
+
+
+
+/* Function: al_get_multiline_layout_line_count
+ */
+int al_get_multiline_layout_line_count(const ALLEGRO_MULTILINE_LAYOUT *layout)
+{
+   ASSERT(layout);
+   return _al_vector_size(&layout->lines);
+}
+
+/* vim: set sts=3 sw=3 et: */
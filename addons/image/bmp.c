@@ -18,12 +18,15 @@
  */
 
 
+#define ALLEGRO_INTERNAL_UNSTABLE
+
 #include <stdint.h>
 #include <string.h>
 
 #include "allegro5/allegro.h"
 #include "allegro5/allegro_image.h"
 #include "allegro5/internal/aintern_convert.h"
+#include "allegro5/internal/aintern_file.h"
 #include "allegro5/internal/aintern_image.h"
 
 #include "iio.h"
@@ -287,9 +290,9 @@ static void read_palette(int ncolors, PalEntry *pal, ALLEGRO_FILE *f,
  *  Support function for reading 16-bit little endian values
  *  from a memory buffer.
  */
-static uint16_t read_16le(void *buf)
+static uint16_t read_16le(const void *buf)
 {
-   unsigned char *ucbuf = (unsigned char *)buf;
+   const unsigned char *ucbuf = (const unsigned char *)buf;
 
    return ucbuf[0] | (ucbuf[1] << 8);
 }
@@ -300,9 +303,9 @@ static uint16_t read_16le(void *buf)
  *  Support function for reading 32-bit little endian values
  *  from a memory buffer.
  */
-static uint32_t read_32le(void *buf)
+static uint32_t read_32le(const void *buf)
 {
-   unsigned char *ucbuf = (unsigned char *)buf;
+   const unsigned char *ucbuf = (const unsigned char *)buf;
 
    return ucbuf[0] | (ucbuf[1] << 8) | (ucbuf[2] << 16) | (ucbuf[3] << 24);
 }
@@ -404,6 +407,30 @@ static void read_8bit_line(ALLEGRO_FILE *f, char *buf, char *data,
 
 
 
+/* read_line_bytes:
+ *  Support function returning the next bytes of a line. If the file is in
+ *  memory they are used from there, else they are read into buf, with
+ *  zeros for what is missing at the end of the file.
+ */
+static const char *read_line_bytes(ALLEGRO_FILE *f, char *buf,
+   size_t bytes_wanted)
+{
+   size_t size;
+   const char *mem = al_fpeek_buffer(f, &size);
+   size_t bytes_read;
+
+   if (mem && size >= bytes_wanted) {
+      al_fseek(f, bytes_wanted, ALLEGRO_SEEK_CUR);
+      return mem;
+   }
+
+   bytes_read = al_fread(f, buf, bytes_wanted);
+   memset(buf + bytes_read, 0, bytes_wanted - bytes_read);
+   return buf;
+}
+
+
+
 /* read_16_rgb_555_line:
  *  Support function for reading the 16 bit / RGB555 bitmap file format.
  */
@@ -414,13 +441,12 @@ static void read_16_rgb_555_line(ALLEGRO_FILE *f, char *buf, char *data,
    uint32_t *data32 = (uint32_t *)data;
    size_t bytes_wanted = (length + (length & 1)) * 2;
 
-   size_t bytes_read = al_fread(f, buf, bytes_wanted);
-   memset(buf + bytes_read, 0, bytes_wanted - bytes_read);
+   const char *src = read_line_bytes(f, buf, bytes_wanted);
 
    (void)premul;
 
    for (i = 0; i < length; ++i) {
-      uint16_t pixel = read_16le(buf + i*2);
+      uint16_t pixel = read_16le(src + i*2);
       data32[i] = ALLEGRO_CONVERT_RGB_555_TO_ABGR_8888_LE(pixel);
    }
 }
@@ -437,11 +463,10 @@ static void read_16_argb_1555_line(ALLEGRO_FILE *f, char *buf, char *data,
    uint32_t *data32 = (uint32_t *)data;
    size_t bytes_wanted = (length + (length & 1)) * 2;
 
-   size_t bytes_read = al_fread(f, buf, bytes_wanted);
-   memset(buf + bytes_read, 0, bytes_wanted - bytes_read);
+   const char *src = read_line_bytes(f, buf, bytes_wanted);
 
    for (i = 0; i < length; ++i) {
-      uint16_t pixel = read_16le(buf + i*2);
+      uint16_t pixel = read_16le(src + i*2);
       data32[i] = ALLEGRO_CONVERT_ARGB_1555_TO_ABGR_8888_LE(pixel);
 
       if (premul && (pixel & 0x8000))
@@ -461,13 +486,12 @@ static void read_16_rgb_565_line(ALLEGRO_FILE *f, char *buf, char *data,
    uint32_t *data32 = (uint32_t *)data;
    size_t bytes_wanted = (length + (length & 1)) * 2;
 
-   size_t bytes_read = al_fread(f, buf, bytes_wanted);
-   memset(buf + bytes_read, 0, bytes_wanted - bytes_read);
+   const char *src = read_line_bytes(f, buf, bytes_wanted);
 
    (void)premul;
 
    for (i = 0; i < length; i++) {
-      uint16_t pixel = read_16le(buf + i*2);
+      uint16_t pixel = read_16le(src + i*2);
       data32[i] = ALLEGRO_CONVERT_RGB_565_TO_ABGR_8888_LE(pixel);
    }
 }
@@ -481,19 +505,18 @@ static void read_24_rgb_888_line(ALLEGRO_FILE *f, char *buf, char *data,
    int length, bool premul)
 {
    int bi, i;
-   unsigned char *ucbuf = (unsigned char *)buf;
    uint32_t *data32 = (uint32_t *)data;
    size_t bytes_wanted = length * 3 + (length & 3);
 
-   size_t bytes_read = al_fread(f, buf, bytes_wanted);
-   memset(buf + bytes_read, 0, bytes_wanted - bytes_read);
+   const char *src = read_line_bytes(f, buf, bytes_wanted);
+   const unsigned char *ucsrc = (const unsigned char *)src;
 
    (void)premul;
 
    for (i = 0, bi = 0; i < (length & ~3); i += 4, bi += 3) {
-      uint32_t a = read_32le(buf + bi*4);     // BGRB [LE:BRGB]
-      uint32_t b = read_32le(buf + bi*4 + 4); // GRBG [LE:GBRG]
-      uint32_t c = read_32le(buf + bi*4 + 8); // RBGR [LE:RGBR]
+      uint32_t a = read_32le(src + bi*4);     // BGRB [LE:BRGB]
+      uint32_t b = read_32le(src + bi*4 + 4); // GRBG [LE:GBRG]
+      uint32_t c = read_32le(src + bi*4 + 8); // RBGR [LE:RGBR]
 
       uint32_t w = a;
       uint32_t x = (a >> 24) | (b << 8);
@@ -509,7 +532,7 @@ static void read_24_rgb_888_line(ALLEGRO_FILE *f, char *buf, char *data,
    bi *= 4;
 
    for (; i < length; i++, bi += 3) {
-      uint32_t pixel = ucbuf[bi] | (ucbuf[bi+1] << 8) | (ucbuf[bi+2] << 16);
+      uint32_t pixel = ucsrc[bi] | (ucsrc[bi+1] << 8) | (ucsrc[bi+2] << 16);
       data32[i] = ALLEGRO_CONVERT_RGB_888_TO_ABGR_8888_LE(pixel);
    }
 }
@@ -526,13 +549,12 @@ static void read_32_xrgb_8888_line(ALLEGRO_FILE *f, char *buf, char *data,
    uint32_t *data32 = (uint32_t *)data;
    size_t bytes_wanted = length * 4;
 
-   size_t bytes_read = al_fread(f, buf, bytes_wanted);
-   memset(buf + bytes_read, 0, bytes_wanted - bytes_read);
+   const char *src = read_line_bytes(f, buf, bytes_wanted);
 
    (void)premul;
 
    for (i = 0; i < length; i++) {
-      uint32_t pixel = read_32le(buf + i*4);
+      uint32_t pixel = read_32le(src + i*4);
       data32[i] = ALLEGRO_CONVERT_XRGB_8888_TO_ABGR_8888_LE(pixel);
    }
 }
@@ -549,13 +571,12 @@ static void read_32_rgbx_8888_line(ALLEGRO_FILE *f, char *buf, char *data,
    uint32_t *data32 = (uint32_t *)data;
    size_t bytes_wanted = length * 4;
 
-   size_t bytes_read = al_fread(f, buf, bytes_wanted);
-   memset(buf + bytes_read, 0, bytes_wanted - bytes_read);
+   const char *src = read_line_bytes(f, buf, bytes_wanted);
 
    (void)premul;
 
    for (i = 0; i < length; i++) {
-      uint32_t pixel = read_32le(buf + i*4);
+      uint32_t pixel = read_32le(src + i*4);
       data32[i] = ALLEGRO_CONVERT_RGBX_8888_TO_ABGR_8888_LE(pixel);
    }
 }
@@ -572,11 +593,10 @@ static void read_32_argb_8888_line(ALLEGRO_FILE *f, char *buf, char *data,
    uint32_t *data32 = (uint32_t *)data;
    size_t bytes_wanted = length * 4;
 
-   size_t bytes_read = al_fread(f, buf, bytes_wanted);
-   memset(buf + bytes_read, 0, bytes_wanted - bytes_read);
+   const char *src = read_line_bytes(f, buf, bytes_wanted);
 
    for (i = 0; i < length; i++) {
-      uint32_t pixel = read_32le(buf + i*4);
+      uint32_t pixel = read_32le(src + i*4);
       uint32_t a = (pixel & 0xFF000000U) >> 24;
       data32[i] = ALLEGRO_CONVERT_ARGB_8888_TO_ABGR_8888_LE(pixel);
 
@@ -600,11 +620,10 @@ static void read_32_rgba_8888_line(ALLEGRO_FILE *f, char *buf, char *data,
    uint32_t *data32 = (uint32_t *)data;
    size_t bytes_wanted = length * 4;
 
-   size_t bytes_read = al_fread(f, buf, bytes_wanted);
-   memset(buf + bytes_read, 0, bytes_wanted - bytes_read);
+   const char *src = read_line_bytes(f, buf, bytes_wanted);
 
    for (i = 0; i < length; i++) {
-      uint32_t pixel = read_32le(buf + i*4);
+      uint32_t pixel = read_32le(src + i*4);
       uint32_t a = (pixel & 0x000000FFU);
       data32[i] = ALLEGRO_CONVERT_RGBA_8888_TO_ABGR_8888_LE(pixel);
 
@@ -1589,7 +1608,7 @@ ALLEGRO_BITMAP *_al_load_bmp(const char *filename, int flags)
    ALLEGRO_BITMAP *bmp;
    ASSERT(filename);
 
-   f = al_fopen(filename, "rb");
+   f = _al_fopen_for_loading(filename);
    if (!f)
       return NULL;
 
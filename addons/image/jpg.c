@@ -2,6 +2,8 @@
  * by Elias Pschernig
  */
 
+#define ALLEGRO_INTERNAL_UNSTABLE
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <setjmp.h>
@@ -58,6 +60,17 @@ static void init_destination(j_compress_ptr cinfo)
 static boolean fill_input_buffer(j_decompress_ptr cinfo)
 {
    struct my_src_mgr *src = (void *)cinfo->src;
+   size_t size;
+   const JOCTET *mem = al_fpeek_buffer(src->fp, &size);
+
+   /* Decode straight from the file if it is in memory. */
+   if (mem && size > 0) {
+      src->pub.next_input_byte = mem;
+      src->pub.bytes_in_buffer = size;
+      al_fseek(src->fp, size, ALLEGRO_SEEK_CUR);
+      return 1;
+   }
+
    src->pub.next_input_byte = src->buffer;
    src->pub.bytes_in_buffer = al_fread(src->fp, src->buffer, BUFFER_SIZE);
    return 1;
@@ -1,5 +1,6 @@
 #include "allegro5/allegro.h"
 #include "allegro5/allegro_image.h"
+#include "allegro5/internal/aintern_file.h"
 #include "allegro5/internal/aintern_image.h"
 
 #include "iio.h"
@@ -258,7 +259,7 @@ ALLEGRO_BITMAP *_al_load_pcx(const char *filename, int flags)
    ALLEGRO_BITMAP *bmp;
    ASSERT(filename);
 
-   f = al_fopen(filename, "rb");
+   f = _al_fopen_for_loading(filename);
    if (!f)
       return NULL;
 
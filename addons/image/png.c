@@ -86,6 +86,53 @@ static int check_if_png(ALLEGRO_FILE *fp)
 
 
 
+/* Where the channels go in the 32-bit pixels of a locked bitmap. */
+typedef struct PIXEL_LAYOUT {
+   int r, g, b, a;
+} PIXEL_LAYOUT;
+
+
+
+/* get_pixel_layout:
+ *  Check if PNG pixels can be written straight into bitmaps of the given
+ *  format, and if so where each channel goes. This spares us converting
+ *  the bitmap from an intermediate format when it is unlocked.
+ */
+static bool get_pixel_layout(int format, PIXEL_LAYOUT *layout)
+{
+   switch (format) {
+      case ALLEGRO_PIXEL_FORMAT_ARGB_8888:
+         layout->a = 24; layout->r = 16; layout->g = 8; layout->b = 0;
+         return true;
+      case ALLEGRO_PIXEL_FORMAT_RGBA_8888:
+         layout->r = 24; layout->g = 16; layout->b = 8; layout->a = 0;
+         return true;
+      case ALLEGRO_PIXEL_FORMAT_ABGR_8888:
+         layout->a = 24; layout->b = 16; layout->g = 8; layout->r = 0;
+         return true;
+      case ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE:
+#ifdef ALLEGRO_BIG_ENDIAN
+         layout->r = 24; layout->g = 16; layout->b = 8; layout->a = 0;
+#else
+         layout->a = 24; layout->b = 16; layout->g = 8; layout->r = 0;
+#endif
+         return true;
+      default:
+         return false;
+   }
+}
+
+
+
+static INLINE uint32_t make_pixel(const PIXEL_LAYOUT *layout,
+   int r, int g, int b, int a)
+{
+   return ((uint32_t)r << layout->r) | ((uint32_t)g << layout->g) |
+      ((uint32_t)b << layout->b) | ((uint32_t)a << layout->a);
+}
+
+
+
 /* really_load_png:
  *  Worker routine, used by load_png and load_memory_png.
  */
@@ -107,6 +154,7 @@ static ALLEGRO_BITMAP *really_load_png(png_structp png_ptr, png_infop info_ptr,
    unsigned char *dest;
    bool premul = !(flags & ALLEGRO_NO_PREMULTIPLIED_ALPHA);
    bool index_only;
+   PIXEL_LAYOUT layout = {0, 0, 0, 0};
 
    ALLEGRO_ASSERT(png_ptr && info_ptr);
 
@@ -223,8 +271,12 @@ static ALLEGRO_BITMAP *really_load_png(png_structp png_ptr, png_infop info_ptr,
       index_only = true;
    }
    else {
-      lock = al_lock_bitmap(bmp, ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE,
-         ALLEGRO_LOCK_WRITEONLY);
+      int format = al_get_bitmap_format(bmp);
+      if (!get_pixel_layout(format, &layout)) {
+         format = ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE;
+         get_pixel_layout(format, &layout);
+      }
+      lock = al_lock_bitmap(bmp, format, ALLEGRO_LOCK_WRITEONLY);
       index_only = false;
    }
 
@@ -256,21 +308,20 @@ static ALLEGRO_BITMAP *really_load_png(png_structp png_ptr, png_infop info_ptr,
                else if (color_type & PNG_COLOR_MASK_PALETTE) {
                   for (i = 0; i < width; i++) {
                      int pix = ptr[0];
+                     int r = pal[pix].r;
+                     int g = pal[pix].g;
+                     int b = pal[pix].b;
+                     int a = 255;
                      ptr++;
-                     dest[0] = pal[pix].r;
-                     dest[1] = pal[pix].g;
-                     dest[2] = pal[pix].b;
                      if (pix < num_trans) {
-                        int a = trans[pix];
-                        dest[3] = a;
+                        a = trans[pix];
                         if (premul) {
-                           dest[0] = dest[0] * a / 255;
-                           dest[1] = dest[1] * a / 255;
-                           dest[2] = dest[2] * a / 255;
+                           r = r * a / 255;
+                           g = g * a / 255;
+                           b = b * a / 255;
                         }
-                     } else {
-                        dest[3] = 255;
                      }
+                     bmp_write32(dest, make_pixel(&layout, r, g, b, a));
                      dest += 4;
                   }
                }
@@ -278,10 +329,8 @@ static ALLEGRO_BITMAP *really_load_png(png_structp png_ptr, png_infop info_ptr,
                   for (i = 0; i < width; i++) {
                      int pix = ptr[0];
                      ptr++;
-                     *(dest++) = pix;
-                     *(dest++) = pix;
-                     *(dest++) = pix;
-                     *(dest++) = 255;
+                     bmp_write32(dest, make_pixel(&layout, pix, pix, pix, 255));
+                     dest += 4;
                   }
                }
                break;
@@ -290,10 +339,9 @@ static ALLEGRO_BITMAP *really_load_png(png_structp png_ptr, png_infop info_ptr,
                for (i = 0; i < width; i++) {
                   uint32_t pix = READ3BYTES(ptr);
                   ptr += 3;
-                  *(dest++) = pix & 0xff;
-                  *(dest++) = (pix >> 8) & 0xff;
-                  *(dest++) = (pix >> 16) & 0xff;
-                  *(dest++) = 255;
+                  bmp_write32(dest, make_pixel(&layout, pix & 0xff,
+                     (pix >> 8) & 0xff, (pix >> 16) & 0xff, 255));
+                  dest += 4;
                }
                break;
 
@@ -312,10 +360,8 @@ static ALLEGRO_BITMAP *really_load_png(png_structp png_ptr, png_infop info_ptr,
                      b = b * a / 255;
                   }
 
-                  *(dest++) = r;
-                  *(dest++) = g;
-                  *(dest++) = b;
-                  *(dest++) = a;
+                  bmp_write32(dest, make_pixel(&layout, r, g, b, a));
+                  dest += 4;
                }
                break;
 
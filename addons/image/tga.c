@@ -24,6 +24,7 @@
 
 #include "allegro5/allegro.h"
 #include "allegro5/allegro_image.h"
+#include "allegro5/internal/aintern_file.h"
 #include "allegro5/internal/aintern_image.h"
 #include "allegro5/internal/aintern_pixels.h"
 
@@ -546,7 +547,7 @@ ALLEGRO_BITMAP *_al_load_tga(const char *filename, int flags)
    ALLEGRO_BITMAP *bmp;
    ASSERT(filename);
 
-   f = al_fopen(filename, "rb");
+   f = _al_fopen_for_loading(filename);
    if (!f)
       return NULL;
 
@@ -1,5 +1,6 @@
 #include <allegro5/allegro.h>
 #include "allegro5/allegro_memfile.h"
+#include "allegro5/internal/aintern_file.h"
 
 typedef struct ALLEGRO_FILE_MEMFILE ALLEGRO_FILE_MEMFILE;
 
@@ -148,6 +149,17 @@ static off_t memfile_fsize(ALLEGRO_FILE *fp)
    return mf->size;
 }
 
+static const void *memfile_fpeek_buffer(ALLEGRO_FILE *fp, size_t *size)
+{
+   ALLEGRO_FILE_MEMFILE *mf = al_get_file_userdata(fp);
+
+   if (!mf->readable)
+      return NULL;
+
+   *size = mf->size - mf->pos;
+   return mf->mem + mf->pos;
+}
+
 static struct ALLEGRO_FILE_INTERFACE memfile_vtable = {
    NULL,    /* open */
    memfile_fclose,
@@ -192,6 +204,9 @@ ALLEGRO_FILE *al_open_memfile(void *mem, int64_t size, const char *mode)
    if (!memfile) {
       al_free(userdata);
    }
+   else {
+      _al_set_file_peek_buffer(memfile, memfile_fpeek_buffer);
+   }
 
    return memfile;
 }
@@ -159,6 +159,24 @@ typedef struct ALLEGRO_VERTEX_BUFFER ALLEGRO_VERTEX_BUFFER;
  */
 typedef struct ALLEGRO_INDEX_BUFFER ALLEGRO_INDEX_BUFFER;
 
+#if defined(ALLEGRO_UNSTABLE) || defined(ALLEGRO_INTERNAL_UNSTABLE) || defined(ALLEGRO_PRIMITIVES_SRC)
+/* Type: ALLEGRO_SHAPE
+ */
+typedef struct ALLEGRO_SHAPE ALLEGRO_SHAPE;
+
+/* Type: ALLEGRO_PRIM_INSTANCE
+ */
+typedef struct ALLEGRO_PRIM_INSTANCE ALLEGRO_PRIM_INSTANCE;
+
+struct ALLEGRO_PRIM_INSTANCE {
+  float x, y;
+  float scale_x, scale_y;
+  float angle;
+  ALLEGRO_COLOR color;
+  float u1, v1, u2, v2;
+};
+#endif
+
 ALLEGRO_PRIM_FUNC(uint32_t, al_get_allegro_primitives_version, (void));
 
 /*
@@ -170,6 +188,9 @@ ALLEGRO_PRIM_FUNC(int, al_draw_prim, (const void* vtxs, const ALLEGRO_VERTEX_DEC
 ALLEGRO_PRIM_FUNC(int, al_draw_indexed_prim, (const void* vtxs, const ALLEGRO_VERTEX_DECL* decl, ALLEGRO_BITMAP* texture, const int* indices, int num_vtx, int type));
 ALLEGRO_PRIM_FUNC(int, al_draw_vertex_buffer, (ALLEGRO_VERTEX_BUFFER* vertex_buffer, ALLEGRO_BITMAP* texture, int start, int end, int type));
 ALLEGRO_PRIM_FUNC(int, al_draw_indexed_buffer, (ALLEGRO_VERTEX_BUFFER* vertex_buffer, ALLEGRO_BITMAP* texture, ALLEGRO_INDEX_BUFFER* index_buffer, int start, int end, int type));
+#if defined(ALLEGRO_UNSTABLE) || defined(ALLEGRO_INTERNAL_UNSTABLE) || defined(ALLEGRO_PRIMITIVES_SRC)
+ALLEGRO_PRIM_FUNC(int, al_draw_vertex_buffer_instanced, (ALLEGRO_VERTEX_BUFFER* vertex_buffer, ALLEGRO_BITMAP* texture, int start, int end, int type, const ALLEGRO_PRIM_INSTANCE* instances, int num_instances));
+#endif
 
 ALLEGRO_PRIM_FUNC(ALLEGRO_VERTEX_DECL*, al_create_vertex_decl, (const ALLEGRO_VERTEX_ELEMENT* elements, int stride));
 ALLEGRO_PRIM_FUNC(void, al_destroy_vertex_decl, (ALLEGRO_VERTEX_DECL* decl));
@@ -245,6 +266,17 @@ ALLEGRO_PRIM_FUNC(void, al_draw_polygon, (const float* vertices, int vertex_coun
 ALLEGRO_PRIM_FUNC(void, al_draw_filled_polygon, (const float* vertices, int vertex_count, ALLEGRO_COLOR color));
 ALLEGRO_PRIM_FUNC(void, al_draw_filled_polygon_with_holes, (const float* vertices, const int* vertex_counts, ALLEGRO_COLOR color));
 
+#if defined(ALLEGRO_UNSTABLE) || defined(ALLEGRO_INTERNAL_UNSTABLE) || defined(ALLEGRO_PRIMITIVES_SRC)
+/*
+* Retained shapes
+*/
+ALLEGRO_PRIM_FUNC(ALLEGRO_SHAPE*, al_create_arc_shape, (float start_theta, float delta_theta, float thickness, int num_segments));
+ALLEGRO_PRIM_FUNC(ALLEGRO_SHAPE*, al_create_filled_pieslice_shape, (float start_theta, float delta_theta, int num_segments));
+ALLEGRO_PRIM_FUNC(void, al_destroy_shape, (ALLEGRO_SHAPE* shape));
+ALLEGRO_PRIM_FUNC(void, al_draw_shape, (ALLEGRO_SHAPE* shape, const ALLEGRO_TRANSFORM* transform, ALLEGRO_COLOR color));
+ALLEGRO_PRIM_FUNC(void, al_draw_shape_instances, (ALLEGRO_SHAPE* shape, const ALLEGRO_TRANSFORM* transforms, const ALLEGRO_COLOR* colors, int num_instances));
+#endif
+
 
 #ifdef __cplusplus
 }
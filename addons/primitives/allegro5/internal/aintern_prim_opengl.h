@@ -15,6 +15,7 @@ void* _al_lock_index_buffer_opengl(ALLEGRO_INDEX_BUFFER* buf);
 void _al_unlock_index_buffer_opengl(ALLEGRO_INDEX_BUFFER* buf);
 
 int _al_draw_vertex_buffer_opengl(ALLEGRO_BITMAP* target, ALLEGRO_BITMAP* texture, ALLEGRO_VERTEX_BUFFER* vertex_buffer, int start, int end, int type);
+int _al_draw_vertex_buffer_instanced_opengl(ALLEGRO_BITMAP* target, ALLEGRO_BITMAP* texture, ALLEGRO_VERTEX_BUFFER* vertex_buffer, int start, int end, int type, const ALLEGRO_PRIM_INSTANCE* instances, int num_instances);
 int _al_draw_indexed_buffer_opengl(ALLEGRO_BITMAP* target, ALLEGRO_BITMAP* texture, ALLEGRO_VERTEX_BUFFER* vertex_buffer, ALLEGRO_INDEX_BUFFER* index_buffer, int start, int end, int type);
 
 #endif
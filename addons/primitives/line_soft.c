@@ -37,14 +37,54 @@ typedef void (*shader_draw)(uintptr_t, int, int);
 typedef void (*shader_first)(uintptr_t, int, int, ALLEGRO_VERTEX*, ALLEGRO_VERTEX*);
 typedef void (*shader_step)(uintptr_t, int);
 
+/*
+The locked target and the blender resolved for it, set up once per line
+*/
+typedef struct {
+   ALLEGRO_BITMAP *bitmap;
+   _AL_BLENDER blender;
+} blend_target;
+
+static void init_blend_target(blend_target *t)
+{
+   ALLEGRO_BITMAP *bitmap = al_get_target_bitmap();
+   t->bitmap = bitmap;
+   if (bitmap->parent)
+      bitmap = bitmap->parent;
+   _al_init_blender(&t->blender, bitmap->locked_region.format);
+}
+
+static void blend_pixel(blend_target *t, int x, int y, ALLEGRO_COLOR *color)
+{
+   ALLEGRO_BITMAP *bitmap = t->bitmap;
+   uint8_t *data;
+
+   if (bitmap->parent) {
+      x += bitmap->xofs;
+      y += bitmap->yofs;
+      bitmap = bitmap->parent;
+   }
+
+   x -= bitmap->lock_x;
+   y -= bitmap->lock_y;
+   if (x < 0 || y < 0 || x >= bitmap->lock_w || y >= bitmap->lock_h)
+      return;
+
+   data = (uint8_t *)bitmap->lock_data
+      + y * bitmap->locked_region.pitch
+      + x * bitmap->locked_region.pixel_size;
+   t->blender.blend_span(&t->blender, color, data, 1);
+}
+
 typedef struct {
    ALLEGRO_COLOR color;
+   blend_target target;
 } state_solid_any_2d;
 
 static void shader_solid_any_draw_shade(uintptr_t state, int x, int y)
 {
    state_solid_any_2d* s = (state_solid_any_2d*)state;
-   al_put_blended_pixel(x, y, s->color);
+   blend_pixel(&s->target, x, y, &s->color);
 }
 
 static void shader_solid_any_draw_opaque(uintptr_t state, int x, int y)
@@ -57,6 +97,7 @@ static void shader_solid_any_first(uintptr_t state, int start_x, int start_y, AL
 {
    state_solid_any_2d* s = (state_solid_any_2d*)state;
    s->color = v1->color;
+   init_blend_target(&s->target);
 
    (void)start_x;
    (void)start_y;
@@ -111,6 +152,7 @@ static void shader_grad_any_first(uintptr_t state, int start_x, int start_y, ALL
    v1c = v1->color;
    v2c = v2->color;
 
+   init_blend_target(&st->solid.target);
    get_interpolation_parameters(start_x, start_y, v1, v2, &param, &minor_delta_param, &major_delta_param);
   
    diff.a = v2c.a - v1c.a;
@@ -179,6 +221,7 @@ typedef struct {
    float minor_dv;
    float major_du;
    float major_dv;
+   blend_target target;
 } state_texture_solid_any_2d;
 
 static void shader_texture_solid_any_draw_shade(uintptr_t state, int x, int y)
@@ -188,7 +231,7 @@ static void shader_texture_solid_any_draw_shade(uintptr_t state, int x, int y)
 
    ALLEGRO_COLOR color = al_get_pixel(s->texture, u, v);
    SHADE_COLORS(color, s->color)
-   al_put_blended_pixel(x, y, color);
+   blend_pixel(&s->target, x, y, &color);
 }
 
 static void shader_texture_solid_any_draw_shade_white(uintptr_t state, int x, int y)
@@ -196,7 +239,8 @@ static void shader_texture_solid_any_draw_shade_white(uintptr_t state, int x, in
    state_texture_solid_any_2d* s = (state_texture_solid_any_2d*)state;
    FIX_UV
 
-   al_put_blended_pixel(x, y, al_get_pixel(s->texture, u, v));
+   ALLEGRO_COLOR color = al_get_pixel(s->texture, u, v);
+   blend_pixel(&s->target, x, y, &color);
 }
 
 static void shader_texture_solid_any_draw_opaque(uintptr_t state, int x, int y)
@@ -228,6 +272,7 @@ static void shader_texture_solid_any_first(uintptr_t state, int start_x, int sta
 
    v1c = v1->color;
 
+   init_blend_target(&st->target);
    get_interpolation_parameters(start_x, start_y, v1, v2, &param, &minor_delta_param, &major_delta_param);
   
    st->w = al_get_bitmap_width(st->texture);
@@ -283,6 +328,7 @@ static void shader_texture_grad_any_first(uintptr_t state, int start_x, int star
    v1c = v1->color;
    v2c = v2->color;
 
+   init_blend_target(&st->solid.target);
    get_interpolation_parameters(start_x, start_y, v1, v2, &param, &minor_delta_param, &major_delta_param);
   
    st->solid.w = al_get_bitmap_width(st->solid.texture);
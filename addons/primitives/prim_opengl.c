@@ -23,11 +23,13 @@
 #include "allegro5/internal/aintern_prim_soft.h"
 #include "allegro5/platform/alplatf.h"
 #include "allegro5/internal/aintern_prim.h"
+#include <limits.h>
 
 #ifdef ALLEGRO_CFG_OPENGL
 
 #include "allegro5/allegro_opengl.h"
 #include "allegro5/internal/aintern_opengl.h"
+#include "allegro5/internal/aintern_shader.h"
 
 static void convert_storage(ALLEGRO_PRIM_STORAGE storage, GLenum* type, int* ncoord, bool* normalized)
 {
@@ -571,6 +573,149 @@ static int draw_prim_indexed_raw(ALLEGRO_BITMAP* target, ALLEGRO_BITMAP* texture
    return num_primitives;
 }
 
+#if defined ALLEGRO_CFG_OPENGL_PROGRAMMABLE_PIPELINE && !defined ALLEGRO_CFG_OPENGLES
+
+/* Draws all instances with one glDrawArraysInstanced call, the per-instance
+ * attributes streamed through a buffer of the display. Returns -1 if that's
+ * not possible, so the caller can expand the instances itself.
+ */
+static int draw_instanced_raw(ALLEGRO_BITMAP* target, ALLEGRO_BITMAP* texture,
+   ALLEGRO_VERTEX_BUFFER* vertex_buffer, int start, int end, int type,
+   const ALLEGRO_PRIM_INSTANCE* instances, int num_instances)
+{
+   static const char* const names[4] = {
+      _AL_SHADER_VAR_INSTANCE_TRANSFORM,
+      _AL_SHADER_VAR_INSTANCE_ANGLE,
+      _AL_SHADER_VAR_INSTANCE_COLOR,
+      _AL_SHADER_VAR_INSTANCE_UV
+   };
+   static const int sizes[4] = {4, 1, 4, 4};
+   static const size_t offsets[4] = {
+      offsetof(ALLEGRO_PRIM_INSTANCE, x),
+      offsetof(ALLEGRO_PRIM_INSTANCE, angle),
+      offsetof(ALLEGRO_PRIM_INSTANCE, color),
+      offsetof(ALLEGRO_PRIM_INSTANCE, u1)
+   };
+   ALLEGRO_DISPLAY *disp = _al_get_bitmap_display(target);
+   ALLEGRO_OGL_EXTRAS *o = disp->ogl_extras;
+   ALLEGRO_BITMAP *opengl_target = target;
+   ALLEGRO_BITMAP_EXTRA_OPENGL *extra;
+   ALLEGRO_SHADER *old_shader = target->shader;
+   ALLEGRO_SHADER *shader;
+   GLuint program;
+   GLint locs[4];
+   GLenum mode;
+   GLsizeiptr size;
+   int num_vtx = end - start;
+   int num_primitives;
+   int i;
+
+   if (!(disp->flags & ALLEGRO_PROGRAMMABLE_PIPELINE) ||
+       !al_get_opengl_extension_list()->ALLEGRO_GL_ARB_instanced_arrays ||
+       !al_get_opengl_extension_list()->ALLEGRO_GL_ARB_draw_instanced) {
+      return -1;
+   }
+
+   if ((size_t)num_instances > INT_MAX / sizeof(ALLEGRO_PRIM_INSTANCE))
+      return -1;
+   size = (GLsizeiptr)num_instances * sizeof(ALLEGRO_PRIM_INSTANCE);
+
+   /* A shader of the user's own wouldn't know about the instances. */
+   if (old_shader && old_shader != disp->default_shader)
+      return -1;
+
+   if (target->parent) {
+      opengl_target = target->parent;
+   }
+   extra = opengl_target->extra;
+
+   if ((!extra->is_backbuffer && disp->ogl_extras->opengl_target !=
+      opengl_target) || al_is_bitmap_locked(target)) {
+      return -1;
+   }
+
+   switch (type) {
+      case ALLEGRO_PRIM_LINE_LIST:
+         mode = GL_LINES;
+         num_primitives = num_vtx / 2;
+         break;
+      case ALLEGRO_PRIM_LINE_STRIP:
+         mode = GL_LINE_STRIP;
+         num_primitives = num_vtx - 1;
+         break;
+      case ALLEGRO_PRIM_LINE_LOOP:
+         mode = GL_LINE_LOOP;
+         num_primitives = num_vtx;
+         break;
+      case ALLEGRO_PRIM_TRIANGLE_LIST:
+         mode = GL_TRIANGLES;
+         num_primitives = num_vtx / 3;
+         break;
+      case ALLEGRO_PRIM_TRIANGLE_STRIP:
+         mode = GL_TRIANGLE_STRIP;
+         num_primitives = num_vtx - 2;
+         break;
+      case ALLEGRO_PRIM_TRIANGLE_FAN:
+         mode = GL_TRIANGLE_FAN;
+         num_primitives = num_vtx - 2;
+         break;
+      case ALLEGRO_PRIM_POINT_LIST:
+         mode = GL_POINTS;
+         num_primitives = num_vtx;
+         break;
+      default:
+         return -1;
+   }
+
+   shader = _al_get_instancing_shader(disp);
+   if (!shader || !al_use_shader(shader)) {
+      al_use_shader(old_shader);
+      return -1;
+   }
+   program = al_get_opengl_program_object(shader);
+
+   _al_opengl_set_blender(disp);
+   glBindBuffer(GL_ARRAY_BUFFER, (GLuint)vertex_buffer->common.handle);
+   setup_state(0, vertex_buffer->decl, texture);
+
+   /* Core profiles have no client-side arrays, so the instances go through
+    * a buffer kept with the display. Its old storage is orphaned first so
+    * the upload doesn't wait for draws still reading it.
+    */
+   if (o->instance_vbo == 0)
+      glGenBuffers(1, &o->instance_vbo);
+   glBindBuffer(GL_ARRAY_BUFFER, o->instance_vbo);
+   glBufferData(GL_ARRAY_BUFFER, size, NULL, GL_STREAM_DRAW);
+   glBufferSubData(GL_ARRAY_BUFFER, 0, size, instances);
+
+   for (i = 0; i < 4; i++) {
+      locs[i] = glGetAttribLocation(program, names[i]);
+      if (locs[i] < 0)
+         continue;
+      glVertexAttribPointer(locs[i], sizes[i], GL_FLOAT, false,
+         sizeof(ALLEGRO_PRIM_INSTANCE), (const void*)offsets[i]);
+      glEnableVertexAttribArray(locs[i]);
+      glVertexAttribDivisor(locs[i], 1);
+   }
+   glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+   glDrawArraysInstancedARB(mode, start, num_vtx, num_instances);
+
+   for (i = 0; i < 4; i++) {
+      if (locs[i] < 0)
+         continue;
+      glVertexAttribDivisor(locs[i], 0);
+      glDisableVertexAttribArray(locs[i]);
+   }
+
+   revert_state(texture);
+   al_use_shader(old_shader);
+
+   return num_primitives * num_instances;
+}
+
+#endif
+
 #endif /* ALLEGRO_CFG_OPENGL */
 
 int _al_draw_prim_opengl(ALLEGRO_BITMAP* target, ALLEGRO_BITMAP* texture, const void* vtxs, const ALLEGRO_VERTEX_DECL* decl, int start, int end, int type)
@@ -606,6 +751,24 @@ int _al_draw_vertex_buffer_opengl(ALLEGRO_BITMAP* target, ALLEGRO_BITMAP* textur
 #endif
 }
 
+int _al_draw_vertex_buffer_instanced_opengl(ALLEGRO_BITMAP* target, ALLEGRO_BITMAP* texture, ALLEGRO_VERTEX_BUFFER* vertex_buffer, int start, int end, int type, const ALLEGRO_PRIM_INSTANCE* instances, int num_instances)
+{
+#if defined ALLEGRO_CFG_OPENGL && defined ALLEGRO_CFG_OPENGL_PROGRAMMABLE_PIPELINE && !defined ALLEGRO_CFG_OPENGLES
+   return draw_instanced_raw(target, texture, vertex_buffer, start, end, type, instances, num_instances);
+#else
+   (void)target;
+   (void)texture;
+   (void)vertex_buffer;
+   (void)start;
+   (void)end;
+   (void)type;
+   (void)instances;
+   (void)num_instances;
+
+   return -1;
+#endif
+}
+
 int _al_draw_prim_indexed_opengl(ALLEGRO_BITMAP *target, ALLEGRO_BITMAP* texture, const void* vtxs, const ALLEGRO_VERTEX_DECL* decl, const int* indices, int num_vtx, int type)
 {
 #ifdef ALLEGRO_CFG_OPENGL
@@ -25,12 +25,50 @@
 #include "allegro5/internal/aintern_prim_soft.h"
 #include "allegro5/internal/aintern_prim.h"
 #include "allegro5/internal/aintern_tri_soft.h"
+#include "allegro5/internal/aintern_vector.h"
 
 /*
 The vertex cache allows for bulk transformation of vertices, for faster run speeds
 */
 #define LOCAL_VERTEX_CACHE  ALLEGRO_VERTEX vertex_cache[ALLEGRO_VERTEX_CACHE_SIZE]
 
+/*
+When the threaded rasterizer is enabled, the triangles are collected and then drawn
+all at once, in parallel
+*/
+typedef struct {
+   ALLEGRO_BITMAP* texture;
+   int threaded;
+   _AL_VECTOR vtx;
+} TRIANGLE_BATCH;
+
+static void init_triangle_batch(TRIANGLE_BATCH* batch, ALLEGRO_BITMAP* texture)
+{
+   batch->texture = texture;
+   batch->threaded = _al_soft_triangles_are_threaded();
+   _al_vector_init(&batch->vtx, sizeof(ALLEGRO_VERTEX));
+}
+
+static void add_triangle(TRIANGLE_BATCH* batch, ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX* v2, ALLEGRO_VERTEX* v3)
+{
+   if (batch->threaded) {
+      *(ALLEGRO_VERTEX*)_al_vector_alloc_back(&batch->vtx) = *v1;
+      *(ALLEGRO_VERTEX*)_al_vector_alloc_back(&batch->vtx) = *v2;
+      *(ALLEGRO_VERTEX*)_al_vector_alloc_back(&batch->vtx) = *v3;
+   } else {
+      _al_triangle_2d(batch->texture, v1, v2, v3);
+   }
+}
+
+static void flush_triangle_batch(TRIANGLE_BATCH* batch)
+{
+   if (!_al_vector_is_empty(&batch->vtx)) {
+      _al_draw_soft_triangles(batch->texture, _al_vector_ref_front(&batch->vtx),
+         _al_vector_size(&batch->vtx) / 3);
+   }
+   _al_vector_free(&batch->vtx);
+}
+
 static void convert_vtx(ALLEGRO_BITMAP* texture, const char* src, ALLEGRO_VERTEX* dest, const ALLEGRO_VERTEX_DECL* decl)
 {
    ALLEGRO_VERTEX_ELEMENT* e;
@@ -108,6 +146,7 @@ int _al_draw_prim_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const ALLEGRO_
    int use_cache;
    int stride = decl ? decl->stride : (int)sizeof(ALLEGRO_VERTEX);
    const ALLEGRO_TRANSFORM* global_trans = al_get_current_transform();
+   TRIANGLE_BATCH batch;
    
    num_primitives = 0;
    num_vtx = end - start;
@@ -115,6 +154,7 @@ int _al_draw_prim_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const ALLEGRO_
 
    if (texture)
       al_lock_bitmap(texture, ALLEGRO_PIXEL_FORMAT_ANY, ALLEGRO_LOCK_READONLY);
+   init_triangle_batch(&batch, texture);
       
    if (use_cache) {
       int ii;
@@ -199,7 +239,7 @@ int _al_draw_prim_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const ALLEGRO_
          if (use_cache) {
             int ii;
             for (ii = 0; ii < num_vtx - 2; ii += 3) {
-               _al_triangle_2d(texture, &vertex_cache[ii], &vertex_cache[ii + 1], &vertex_cache[ii + 2]);
+               add_triangle(&batch, &vertex_cache[ii], &vertex_cache[ii + 1], &vertex_cache[ii + 2]);
             }
          } else {
             int ii;
@@ -209,7 +249,7 @@ int _al_draw_prim_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const ALLEGRO_
                SET_VERTEX(v2, ii + 1);
                SET_VERTEX(v3, ii + 2);
                
-               _al_triangle_2d(texture, &v1, &v2, &v3);
+               add_triangle(&batch, &v1, &v2, &v3);
             }
          }
          num_primitives = num_vtx / 3;
@@ -219,7 +259,7 @@ int _al_draw_prim_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const ALLEGRO_
          if (use_cache) {
             int ii;
             for (ii = 2; ii < num_vtx; ii++) {
-               _al_triangle_2d(texture, &vertex_cache[ii - 2], &vertex_cache[ii - 1], &vertex_cache[ii]);
+               add_triangle(&batch, &vertex_cache[ii - 2], &vertex_cache[ii - 1], &vertex_cache[ii]);
             }
          } else {
             int ii;
@@ -230,7 +270,7 @@ int _al_draw_prim_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const ALLEGRO_
             for (ii = start + 2; ii < end; ii++) {
                SET_VERTEX(vtx[idx], ii);
                
-               _al_triangle_2d(texture, &vtx[0], &vtx[1], &vtx[2]);
+               add_triangle(&batch, &vtx[0], &vtx[1], &vtx[2]);
                idx = (idx + 1) % 3;
             }
          }
@@ -241,7 +281,7 @@ int _al_draw_prim_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const ALLEGRO_
          if (use_cache) {
             int ii;
             for (ii = 1; ii < num_vtx; ii++) {
-               _al_triangle_2d(texture, &vertex_cache[0], &vertex_cache[ii], &vertex_cache[ii - 1]);
+               add_triangle(&batch, &vertex_cache[0], &vertex_cache[ii], &vertex_cache[ii - 1]);
             }
          } else {
             int ii;
@@ -252,7 +292,7 @@ int _al_draw_prim_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const ALLEGRO_
             SET_VERTEX(vtx[0], start + 1);
             for (ii = start + 1; ii < end; ii++) {
                SET_VERTEX(vtx[idx], ii)
-               _al_triangle_2d(texture, &v0, &vtx[0], &vtx[1]);
+               add_triangle(&batch, &v0, &vtx[0], &vtx[1]);
                idx = 1 - idx;
             }
          }
@@ -278,6 +318,8 @@ int _al_draw_prim_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const ALLEGRO_
          break;
       };
    }
+
+   flush_triangle_batch(&batch);
    
    if(texture)
        al_unlock_bitmap(texture);
@@ -296,6 +338,7 @@ int _al_draw_prim_indexed_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const
    int ii;
    int stride = decl ? decl->stride : (int)sizeof(ALLEGRO_VERTEX);
    const ALLEGRO_TRANSFORM* global_trans = al_get_current_transform();
+   TRIANGLE_BATCH batch;
 
    num_primitives = 0;   
    use_cache = 1;
@@ -318,6 +361,7 @@ int _al_draw_prim_indexed_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const
 
    if (texture)
       al_lock_bitmap(texture, ALLEGRO_PIXEL_FORMAT_ANY, ALLEGRO_LOCK_READONLY);
+   init_triangle_batch(&batch, texture);
       
    if (use_cache) {
       int ii;
@@ -419,7 +463,7 @@ int _al_draw_prim_indexed_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const
                int idx1 = indices[ii] - min_idx;
                int idx2 = indices[ii + 1] - min_idx;
                int idx3 = indices[ii + 2] - min_idx;
-               _al_triangle_2d(texture, &vertex_cache[idx1], &vertex_cache[idx2], &vertex_cache[idx3]);
+               add_triangle(&batch, &vertex_cache[idx1], &vertex_cache[idx2], &vertex_cache[idx3]);
             }
          } else {
             int ii;
@@ -433,7 +477,7 @@ int _al_draw_prim_indexed_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const
                SET_VERTEX(v2, idx2);
                SET_VERTEX(v3, idx3);
                
-               _al_triangle_2d(texture, &v1, &v2, &v3);
+               add_triangle(&batch, &v1, &v2, &v3);
             }
          }
          num_primitives = num_vtx / 3;
@@ -446,7 +490,7 @@ int _al_draw_prim_indexed_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const
                int idx1 = indices[ii - 2] - min_idx;
                int idx2 = indices[ii - 1] - min_idx;
                int idx3 = indices[ii] - min_idx;
-               _al_triangle_2d(texture, &vertex_cache[idx1], &vertex_cache[idx2], &vertex_cache[idx3]);
+               add_triangle(&batch, &vertex_cache[idx1], &vertex_cache[idx2], &vertex_cache[idx3]);
             }
          } else {
             int ii;
@@ -457,7 +501,7 @@ int _al_draw_prim_indexed_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const
             for (ii = 2; ii < num_vtx; ii ++) {
                SET_VERTEX(vtx[idx], indices[ii]);
                
-               _al_triangle_2d(texture, &vtx[0], &vtx[1], &vtx[2]);
+               add_triangle(&batch, &vtx[0], &vtx[1], &vtx[2]);
                idx = (idx + 1) % 3;
             }
          }
@@ -471,7 +515,7 @@ int _al_draw_prim_indexed_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const
             for (ii = 1; ii < num_vtx; ii++) {
                int idx1 = indices[ii] - min_idx;
                int idx2 = indices[ii - 1] - min_idx;
-               _al_triangle_2d(texture, &vertex_cache[idx0], &vertex_cache[idx1], &vertex_cache[idx2]);
+               add_triangle(&batch, &vertex_cache[idx0], &vertex_cache[idx1], &vertex_cache[idx2]);
             }
          } else {
             int ii;
@@ -482,7 +526,7 @@ int _al_draw_prim_indexed_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const
             SET_VERTEX(vtx[0], indices[1]);
             for (ii = 2; ii < num_vtx; ii ++) {
                SET_VERTEX(vtx[idx], indices[ii])
-               _al_triangle_2d(texture, &v0, &vtx[0], &vtx[1]);
+               add_triangle(&batch, &v0, &vtx[0], &vtx[1]);
                idx = 1 - idx;
             }
          }
@@ -510,6 +554,8 @@ int _al_draw_prim_indexed_soft(ALLEGRO_BITMAP* texture, const void* vtxs, const
       };
    }
 
+   flush_triangle_batch(&batch);
+
    if(texture)
        al_unlock_bitmap(texture);
    
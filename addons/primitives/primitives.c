@@ -569,6 +569,179 @@ int al_draw_indexed_buffer(ALLEGRO_VERTEX_BUFFER* vertex_buffer,
    return ret;
 }
 
+/* Apply one instance to a copy of the vertices, the same way the instancing
+ * shader does.
+ */
+static void apply_instance(char* vtxs, const ALLEGRO_VERTEX_DECL* decl,
+   int num_vtx, const ALLEGRO_PRIM_INSTANCE* instance)
+{
+   ALLEGRO_VERTEX_ELEMENT pos = {ALLEGRO_PRIM_POSITION, ALLEGRO_PRIM_FLOAT_3, offsetof(ALLEGRO_VERTEX, x)};
+   ALLEGRO_VERTEX_ELEMENT tex = {ALLEGRO_PRIM_TEX_COORD_PIXEL, ALLEGRO_PRIM_FLOAT_2, offsetof(ALLEGRO_VERTEX, u)};
+   ALLEGRO_VERTEX_ELEMENT color = {ALLEGRO_PRIM_COLOR_ATTR, 0, offsetof(ALLEGRO_VERTEX, color)};
+   int stride = decl ? decl->stride : (int)sizeof(ALLEGRO_VERTEX);
+   float c = cosf(instance->angle);
+   float s = sinf(instance->angle);
+   float du = instance->u2 - instance->u1;
+   float dv = instance->v2 - instance->v1;
+   int ii;
+
+   if (decl) {
+      pos = decl->elements[ALLEGRO_PRIM_POSITION];
+      tex = decl->elements[ALLEGRO_PRIM_TEX_COORD];
+      if (!tex.attribute)
+         tex = decl->elements[ALLEGRO_PRIM_TEX_COORD_PIXEL];
+      color = decl->elements[ALLEGRO_PRIM_COLOR_ATTR];
+   }
+
+   for (ii = 0; ii < num_vtx; ii++) {
+      char* vtx = vtxs + ii * stride;
+
+      if (pos.attribute) {
+         float x, y;
+         if (pos.storage == ALLEGRO_PRIM_SHORT_2) {
+            short* ptr = (short*)(vtx + pos.offset);
+            x = ptr[0] * instance->scale_x;
+            y = ptr[1] * instance->scale_y;
+            ptr[0] = (short)floorf(instance->x + c * x - s * y + 0.5f);
+            ptr[1] = (short)floorf(instance->y + s * x + c * y + 0.5f);
+         }
+         else {
+            float* ptr = (float*)(vtx + pos.offset);
+            x = ptr[0] * instance->scale_x;
+            y = ptr[1] * instance->scale_y;
+            ptr[0] = instance->x + c * x - s * y;
+            ptr[1] = instance->y + s * x + c * y;
+         }
+      }
+
+      if (tex.attribute) {
+         if (tex.storage == ALLEGRO_PRIM_SHORT_2) {
+            short* ptr = (short*)(vtx + tex.offset);
+            ptr[0] = (short)floorf(instance->u1 + ptr[0] * du + 0.5f);
+            ptr[1] = (short)floorf(instance->v1 + ptr[1] * dv + 0.5f);
+         }
+         else {
+            float* ptr = (float*)(vtx + tex.offset);
+            ptr[0] = instance->u1 + ptr[0] * du;
+            ptr[1] = instance->v1 + ptr[1] * dv;
+         }
+      }
+
+      if (color.attribute) {
+         ALLEGRO_COLOR* ptr = (ALLEGRO_COLOR*)(vtx + color.offset);
+         ptr->r *= instance->color.r;
+         ptr->g *= instance->color.g;
+         ptr->b *= instance->color.b;
+         ptr->a *= instance->color.a;
+      }
+   }
+}
+
+/* How many vertices the fallback for instanced drawing copies at most before
+ * drawing them, which keeps its scratch memory bounded.
+ */
+#define MAX_INSTANCED_VERTICES 65536
+
+/* Fallback for instanced drawing, which copies the vertices for each
+ * instance. Lists are drawn with one call per batch of instances, other
+ * primitives with one call per instance.
+ */
+static int draw_buffer_instanced_soft(ALLEGRO_VERTEX_BUFFER* vertex_buffer,
+   ALLEGRO_BITMAP* texture, int start, int end, int type,
+   const ALLEGRO_PRIM_INSTANCE* instances, int num_instances)
+{
+   const ALLEGRO_VERTEX_DECL* decl = vertex_buffer->decl;
+   int stride = decl ? decl->stride : (int)sizeof(ALLEGRO_VERTEX);
+   int num_vtx = end - start;
+   int size = num_vtx * stride;
+   int per_call = 1;
+   int num_primitives = 0;
+   void* vtx;
+   char* base;
+   char* copies;
+   int ii, jj, n;
+
+   if (vertex_buffer->common.write_only || num_vtx <= 0) {
+      return 0;
+   }
+
+   if (type == ALLEGRO_PRIM_LINE_LIST || type == ALLEGRO_PRIM_TRIANGLE_LIST ||
+       type == ALLEGRO_PRIM_POINT_LIST) {
+      per_call = MAX_INSTANCED_VERTICES / num_vtx;
+      if (per_call < 1)
+         per_call = 1;
+      if (per_call > num_instances)
+         per_call = num_instances;
+   }
+
+   base = al_malloc((size_t)size * (1 + per_call));
+   if (!base) {
+      return 0;
+   }
+   copies = base + size;
+
+   vtx = al_lock_vertex_buffer(vertex_buffer, start, num_vtx, ALLEGRO_LOCK_READONLY);
+   ASSERT(vtx);
+   memcpy(base, vtx, size);
+   al_unlock_vertex_buffer(vertex_buffer);
+
+   for (ii = 0; ii < num_instances; ii += n) {
+      n = num_instances - ii;
+      if (n > per_call)
+         n = per_call;
+      for (jj = 0; jj < n; jj++) {
+         char* copy = copies + (size_t)jj * size;
+         memcpy(copy, base, size);
+         apply_instance(copy, decl, num_vtx, &instances[ii + jj]);
+      }
+      num_primitives += al_draw_prim(copies, decl, texture, 0,
+         num_vtx * n, type);
+   }
+
+   al_free(base);
+   return num_primitives;
+}
+
+/* Function: al_draw_vertex_buffer_instanced
+ */
+int al_draw_vertex_buffer_instanced(ALLEGRO_VERTEX_BUFFER* vertex_buffer,
+   ALLEGRO_BITMAP* texture, int start, int end, int type,
+   const ALLEGRO_PRIM_INSTANCE* instances, int num_instances)
+{
+   ALLEGRO_BITMAP *target;
+   int ret = -1;
+
+   ASSERT(addon_initialized);
+   ASSERT(end >= start);
+   ASSERT(start >= 0);
+   ASSERT(end <= al_get_vertex_buffer_size(vertex_buffer));
+   ASSERT(type >= 0 && type < ALLEGRO_PRIM_NUM_TYPES);
+   ASSERT(vertex_buffer);
+   ASSERT(!vertex_buffer->common.is_locked);
+   ASSERT(instances || num_instances <= 0);
+
+   if (num_instances <= 0 || end == start) {
+      return 0;
+   }
+
+   target = al_get_target_bitmap();
+
+   if (!(al_get_bitmap_flags(target) & ALLEGRO_MEMORY_BITMAP ||
+       (texture && al_get_bitmap_flags(texture) & ALLEGRO_MEMORY_BITMAP) ||
+       _al_pixel_format_is_compressed(al_get_bitmap_format(target)))) {
+      int flags = al_get_display_flags(al_get_current_display());
+      if (flags & ALLEGRO_OPENGL) {
+         ret = _al_draw_vertex_buffer_instanced_opengl(target, texture, vertex_buffer, start, end, type, instances, num_instances);
+      }
+   }
+
+   if (ret < 0) {
+      ret = draw_buffer_instanced_soft(vertex_buffer, texture, start, end, type, instances, num_instances);
+   }
+
+   return ret;
+}
+
 /* Function: al_get_vertex_buffer_size
  */
 int al_get_vertex_buffer_size(ALLEGRO_VERTEX_BUFFER* buffer)
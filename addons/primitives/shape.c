@@ -0,0 +1,363 @@
+/*         ______   ___    ___
+ *        /\  _  \ /\_ \  /\_ \
+ *        \ \ \L\ \\//\ \ \//\ \      __     __   _ __   ___
+ *         \ \  __ \ \ \ \  \ \ \   /'__`\ /'_ `\/\`'__\/ __`\
+ *          \ \ \/\ \ \_\ \_ \_\ \_/\  __//\ \L\ \ \ \//\ \L\ \
+ *           \ \_\ \_\/\____\/\____\ \____\ \____ \ \_\\ \____/
+ *            \/_/\/_/\/____/\/____/\/____/\/___L\ \/_/ \/___/
+ *                                           /\____/
+ *                                           \_/__/
+ *
+ *      Retained shapes, computed once and drawn many times.
+ *
+ *
+ *      See readme.txt for copyright information.
+ */
+
+#include "allegro5/allegro.h"
+#include "allegro5/allegro_primitives.h"
+#include "allegro5/internal/aintern.h"
+#include "allegro5/internal/aintern_bitmap.h"
+#include "allegro5/internal/aintern_display.h"
+#include "allegro5/internal/aintern_pixels.h"
+#include "allegro5/internal/aintern_prim.h"
+#include "allegro5/internal/aintern_system.h"
+#include <limits.h>
+
+#ifndef ALLEGRO_DIRECT3D
+#define ALLEGRO_DIRECT3D ALLEGRO_DIRECT3D_INTERNAL
+#endif
+
+ALLEGRO_DEBUG_CHANNEL("primitives")
+
+/* The geometry of a shape is a list of separate triangles or lines, so the
+ * vertices of many instances can simply be concatenated into one draw call.
+ */
+struct ALLEGRO_SHAPE {
+   ALLEGRO_VERTEX *vertices;   /* The shape itself, in white. */
+   int num_vertices;
+   int prim_type;              /* ALLEGRO_PRIM_TRIANGLE_LIST or LINE_LIST */
+
+   /* A copy of the vertices on the display which was current when the
+    * shape was created, if it supports vertex buffers. The vertices have
+    * the color the shape was last drawn with.
+    */
+   ALLEGRO_VERTEX_BUFFER *buffer;
+   ALLEGRO_COLOR buffer_color;
+   ALLEGRO_DISPLAY *display;
+   uint64_t display_serial;
+
+   /* Room for transformed instances when drawing them on the CPU. */
+   ALLEGRO_VERTEX *scratch;
+   int scratch_size;
+};
+
+
+
+static ALLEGRO_SHAPE *create_shape(int num_vertices, int prim_type)
+{
+   ALLEGRO_SHAPE *shape = al_calloc(1, sizeof *shape);
+   if (!shape)
+      return NULL;
+
+   shape->vertices = al_calloc(num_vertices, sizeof(ALLEGRO_VERTEX));
+   if (!shape->vertices) {
+      al_free(shape);
+      return NULL;
+   }
+   shape->num_vertices = num_vertices;
+   shape->prim_type = prim_type;
+   return shape;
+}
+
+
+
+/* Upload the finished shape into a vertex buffer if the current display
+ * can have one. Shapes work without it, so failing is fine.
+ */
+static ALLEGRO_SHAPE *finish_shape(ALLEGRO_SHAPE *shape)
+{
+   ALLEGRO_DISPLAY *display = al_get_current_display();
+   int i;
+
+   for (i = 0; i < shape->num_vertices; i++) {
+      shape->vertices[i].z = 0;
+      shape->vertices[i].color = al_map_rgb_f(1, 1, 1);
+   }
+
+   if (display &&
+         (al_get_display_flags(display) & (ALLEGRO_OPENGL | ALLEGRO_DIRECT3D))) {
+      shape->buffer = al_create_vertex_buffer(NULL, shape->vertices,
+         shape->num_vertices, ALLEGRO_PRIM_BUFFER_DYNAMIC);
+      shape->buffer_color = al_map_rgb_f(1, 1, 1);
+      shape->display = display;
+      shape->display_serial = display->serial;
+      if (!shape->buffer)
+         ALLEGRO_DEBUG("Shape %p has no vertex buffer\n", shape);
+   }
+
+   return shape;
+}
+
+
+
+/* Function: al_create_arc_shape
+ */
+ALLEGRO_SHAPE *al_create_arc_shape(float start_theta, float delta_theta,
+   float thickness, int num_segments)
+{
+   ALLEGRO_SHAPE *shape;
+   float *points;
+   int num_points = num_segments + 1;
+   int i;
+
+   ASSERT(num_segments > 0);
+
+   if (thickness > 0) {
+      /* Each segment is a quad between the outer and inner edge. */
+      shape = create_shape(6 * num_segments, ALLEGRO_PRIM_TRIANGLE_LIST);
+      points = al_malloc(4 * num_points * sizeof(float));
+   }
+   else {
+      shape = create_shape(2 * num_segments, ALLEGRO_PRIM_LINE_LIST);
+      points = al_malloc(2 * num_points * sizeof(float));
+   }
+   if (!shape || !points) {
+      al_destroy_shape(shape);
+      al_free(points);
+      return NULL;
+   }
+
+   al_calculate_arc(points, 2 * sizeof(float), 0, 0, 1, 1, start_theta,
+      delta_theta, thickness, num_points);
+
+   for (i = 0; i < num_segments; i++) {
+      if (thickness > 0) {
+         const float *p = points + 4 * i;
+         /* Outer and inner point of this and the next step. */
+         ALLEGRO_VERTEX *v = shape->vertices + 6 * i;
+         v[0].x = p[0]; v[0].y = p[1];
+         v[1].x = p[2]; v[1].y = p[3];
+         v[2].x = p[4]; v[2].y = p[5];
+         v[3].x = p[2]; v[3].y = p[3];
+         v[4].x = p[6]; v[4].y = p[7];
+         v[5].x = p[4]; v[5].y = p[5];
+      }
+      else {
+         const float *p = points + 2 * i;
+         ALLEGRO_VERTEX *v = shape->vertices + 2 * i;
+         v[0].x = p[0]; v[0].y = p[1];
+         v[1].x = p[2]; v[1].y = p[3];
+      }
+   }
+
+   al_free(points);
+   return finish_shape(shape);
+}
+
+
+
+/* Function: al_create_filled_pieslice_shape
+ */
+ALLEGRO_SHAPE *al_create_filled_pieslice_shape(float start_theta,
+   float delta_theta, int num_segments)
+{
+   ALLEGRO_SHAPE *shape;
+   float *points;
+   int num_points = num_segments + 1;
+   int i;
+
+   ASSERT(num_segments > 0);
+
+   shape = create_shape(3 * num_segments, ALLEGRO_PRIM_TRIANGLE_LIST);
+   points = al_malloc(2 * num_points * sizeof(float));
+   if (!shape || !points) {
+      al_destroy_shape(shape);
+      al_free(points);
+      return NULL;
+   }
+
+   al_calculate_arc(points, 2 * sizeof(float), 0, 0, 1, 1, start_theta,
+      delta_theta, 0, num_points);
+
+   for (i = 0; i < num_segments; i++) {
+      const float *p = points + 2 * i;
+      ALLEGRO_VERTEX *v = shape->vertices + 3 * i;
+      v[0].x = 0;    v[0].y = 0;
+      v[1].x = p[0]; v[1].y = p[1];
+      v[2].x = p[2]; v[2].y = p[3];
+   }
+
+   al_free(points);
+   return finish_shape(shape);
+}
+
+
+
+/* Whether the display the vertex buffer was made on still exists. Another
+ * display may have been created at the same address since, so its serial
+ * is compared too.
+ */
+static bool buffer_display_alive(ALLEGRO_SHAPE *shape)
+{
+   ALLEGRO_SYSTEM *system = al_get_system_driver();
+   unsigned int i;
+
+   if (!system)
+      return false;
+   for (i = 0; i < _al_vector_size(&system->displays); i++) {
+      ALLEGRO_DISPLAY **d = _al_vector_ref(&system->displays, i);
+      if (*d == shape->display)
+         return (*d)->serial == shape->display_serial;
+   }
+   return false;
+}
+
+
+
+/* Function: al_destroy_shape
+ */
+void al_destroy_shape(ALLEGRO_SHAPE *shape)
+{
+   if (!shape)
+      return;
+
+   if (shape->buffer) {
+      /* The buffer went away with the context of its display. */
+      if (buffer_display_alive(shape))
+         al_destroy_vertex_buffer(shape->buffer);
+      else
+         al_free(shape->buffer);
+   }
+   al_free(shape->scratch);
+   al_free(shape->vertices);
+   al_free(shape);
+}
+
+
+
+static bool color_equal(ALLEGRO_COLOR a, ALLEGRO_COLOR b)
+{
+   return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+
+
+
+/* Give the vertices in the vertex buffer another color. This is cheap
+ * compared to drawing each instance with its own call, and is not needed
+ * at all when all instances have the same color.
+ */
+static bool set_buffer_color(ALLEGRO_SHAPE *shape, ALLEGRO_COLOR color)
+{
+   ALLEGRO_VERTEX *v;
+   int i;
+
+   if (color_equal(shape->buffer_color, color))
+      return true;
+
+   v = al_lock_vertex_buffer(shape->buffer, 0, shape->num_vertices,
+      ALLEGRO_LOCK_WRITEONLY);
+   if (!v)
+      return false;
+   for (i = 0; i < shape->num_vertices; i++) {
+      v[i] = shape->vertices[i];
+      v[i].color = color;
+   }
+   al_unlock_vertex_buffer(shape->buffer);
+
+   shape->buffer_color = color;
+   return true;
+}
+
+
+
+/* Function: al_draw_shape
+ */
+void al_draw_shape(ALLEGRO_SHAPE *shape, const ALLEGRO_TRANSFORM *transform,
+   ALLEGRO_COLOR color)
+{
+   ALLEGRO_BITMAP *target = al_get_target_bitmap();
+   ALLEGRO_DISPLAY *display = _al_get_bitmap_display(target);
+   ASSERT(shape);
+   ASSERT(transform);
+
+   /* The vertex buffer can only be drawn on the display it was made for. */
+   if (shape->buffer && shape->display == display &&
+         shape->display_serial == display->serial &&
+         !(al_get_bitmap_flags(target) & ALLEGRO_MEMORY_BITMAP) &&
+         !_al_pixel_format_is_compressed(al_get_bitmap_format(target)) &&
+         set_buffer_color(shape, color)) {
+      ALLEGRO_TRANSFORM backup;
+      ALLEGRO_TRANSFORM t;
+
+      al_copy_transform(&backup, al_get_current_transform());
+      al_copy_transform(&t, transform);
+      al_compose_transform(&t, &backup);
+      al_use_transform(&t);
+      al_draw_vertex_buffer(shape->buffer, NULL, 0, shape->num_vertices,
+         shape->prim_type);
+      al_use_transform(&backup);
+      return;
+   }
+
+   al_draw_shape_instances(shape, transform, &color, 1);
+}
+
+
+
+/* Function: al_draw_shape_instances
+ */
+void al_draw_shape_instances(ALLEGRO_SHAPE *shape,
+   const ALLEGRO_TRANSFORM *transforms, const ALLEGRO_COLOR *colors,
+   int num_instances)
+{
+   ALLEGRO_VERTEX *dst;
+   int n;
+   int total;
+   int i, j;
+
+   ASSERT(shape);
+   ASSERT(transforms);
+   ASSERT(colors);
+
+   if (num_instances <= 0)
+      return;
+
+   n = shape->num_vertices;
+   if (num_instances > INT_MAX / n) {
+      ALLEGRO_ERROR("Too many instances of shape %p: %d\n", shape,
+         num_instances);
+      return;
+   }
+   total = n * num_instances;
+   if (total > shape->scratch_size) {
+      ALLEGRO_VERTEX *scratch = al_realloc(shape->scratch,
+         (size_t)total * sizeof(ALLEGRO_VERTEX));
+      if (!scratch)
+         return;
+      shape->scratch = scratch;
+      shape->scratch_size = total;
+   }
+
+   dst = shape->scratch;
+   for (i = 0; i < num_instances; i++) {
+      const ALLEGRO_TRANSFORM *t = &transforms[i];
+      ALLEGRO_COLOR color = colors[i];
+
+      for (j = 0; j < n; j++) {
+         const ALLEGRO_VERTEX *src = &shape->vertices[j];
+         dst->x = src->x;
+         dst->y = src->y;
+         dst->z = 0;
+         al_transform_coordinates_3d(t, &dst->x, &dst->y, &dst->z);
+         dst->u = 0;
+         dst->v = 0;
+         dst->color = color;
+         dst++;
+      }
+   }
+
+   al_draw_prim(shape->scratch, NULL, NULL, 0, total, shape->prim_type);
+}
+
+/* vim: set sts=3 sw=3 et: */
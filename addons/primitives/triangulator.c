@@ -19,6 +19,7 @@
 
 # include "allegro5/allegro.h"
 # include "allegro5/allegro_primitives.h"
+# include "allegro5/internal/aintern.h"
 # include "allegro5/internal/aintern_prim.h"
 # include "allegro5/internal/aintern_list.h"
 # include <float.h>
@@ -808,10 +809,18 @@ static void poly_do_triangulate(POLY* polygon)
 }
 
 
-/* Function: al_triangulate_polygon
- *  General triangulation function.
+/* Polygons with up to this many vertices, holes included, are ear clipped
+ * unless the system config says otherwise. */
+# define MAX_EAR_CLIPPING_VERTICES    64
+
+
+/*
+ *  Triangulate by ear clipping. This is quadratic in the number of
+ *  vertices, so it is only used for small polygons or when the
+ *  triangulator setting in the [primitives] section of the system config
+ *  asks for it.
  */
-bool al_triangulate_polygon(
+static bool poly_triangulate_ear_clipping(
    const float* vertices, size_t vertex_stride, const int* vertex_counts,
    void (*emit_triangle)(int, int, int, void*), void* userdata)
 {
@@ -867,4 +876,812 @@ bool al_triangulate_polygon(
    return ret;
 }
 
+/*
+ *  Monotone partition triangulator.
+ *
+ *  The polygon and its holes are swept from top to bottom together. At
+ *  split and merge vertices diagonals are added which cut the polygon into
+ *  pieces that are monotone in y, and each of those is triangulated in
+ *  linear time. See chapter 3 of "Computational Geometry: Algorithms and
+ *  Applications" by de Berg et al. Holes need no special treatment and the
+ *  whole thing is O(n log n).
+ *
+ *  Everything works on flat arrays indexed by the vertex index, taken from
+ *  one arena which is freed at once in the end.
+ *
+ *  The y axis is flipped internally, so the outline of a polygon given in
+ *  the documented order runs counter-clockwise and the inside of the
+ *  polygon is to the left of every edge. Vertices are swept in order of
+ *  decreasing y, then increasing x, then index.
+ */
+
+# define MONO_ARENA_MIN_BLOCK_SIZE   (64 * 1024)
+
+/* Roughly how much memory a vertex needs, so usually all of it comes from
+ * a single block. */
+# define MONO_ARENA_BYTES_PER_VERTEX 384
+
+# define MONO_ARENA_ALIGN(size)      (((size) + 15) & ~(size_t)15)
+
+typedef struct MONO_ARENA_BLOCK MONO_ARENA_BLOCK;
+
+struct MONO_ARENA_BLOCK {
+   MONO_ARENA_BLOCK*    next;
+   size_t               size;
+   size_t               used;
+};
+
+typedef struct MONO_ARENA {
+   MONO_ARENA_BLOCK*    blocks;
+   size_t               block_size;   /* Size of new blocks, at least. */
+} MONO_ARENA;
+
+typedef struct MONO_EVENT {
+   double   x, y;
+   int      vertex;
+} MONO_EVENT;
+
+/* One half of an edge of the partition, stored with the vertex it starts at. */
+typedef struct MONO_HALF_EDGE {
+   double   dx, dy;
+   int      to;
+} MONO_HALF_EDGE;
+
+typedef struct MONO_POLY {
+   MONO_ARENA  arena;
+   int         vertex_count;
+   double*     x;
+   double*     y;
+   int*        next;
+   int*        prev;
+   int*        rank;          /* Position in the sweep. */
+   int*        order;         /* Vertices in sweep order. */
+   int         order_count;
+
+   /* Edges are named after the vertex they start at. The edges with the
+    * inside of the polygon to their right which cross the sweep line are
+    * kept in a treap, ordered from left to right.
+    */
+   int*        helper;
+   char*       is_merge;
+   char*       in_tree;
+   int*        tree_left;
+   int*        tree_right;
+   int*        tree_parent;
+   uint32_t*   tree_priority;
+   int         tree_root;
+   uint32_t    random;
+
+   int*        diagonals;     /* Pairs of vertex indices. */
+   int         diagonal_count;
+
+   void        (*emit)(int, int, int, void*);
+   void*       userdata;
+} MONO_POLY;
+
+
+static void* mono_arena_alloc(MONO_ARENA* arena, size_t size)
+{
+   const size_t header = MONO_ARENA_ALIGN(sizeof(MONO_ARENA_BLOCK));
+   MONO_ARENA_BLOCK* block = arena->blocks;
+
+   size = MONO_ARENA_ALIGN(size);
+
+   if (!block || block->size - block->used < size) {
+      size_t block_size = size > arena->block_size ? size : arena->block_size;
+
+      block = al_malloc(header + block_size);
+      if (!block)
+         return NULL;
+
+      block->next = arena->blocks;
+      block->size = block_size;
+      block->used = 0;
+      arena->blocks = block;
+   }
+
+   block->used += size;
+   return (char*)block + header + block->used - size;
+}
+
+
+static void mono_arena_free(MONO_ARENA* arena)
+{
+   while (arena->blocks) {
+      MONO_ARENA_BLOCK* next = arena->blocks->next;
+      al_free(arena->blocks);
+      arena->blocks = next;
+   }
+}
+
+
+/*
+ *  Twice the signed area of the triangle (a, b, c), positive if it is
+ *  counter-clockwise.
+ */
+static double mono_cross(const MONO_POLY* poly, int a, int b, int c)
+{
+   return (poly->x[b] - poly->x[a]) * (poly->y[c] - poly->y[a]) -
+          (poly->y[b] - poly->y[a]) * (poly->x[c] - poly->x[a]);
+}
+
+
+static int mono_compare_events(const void* a, const void* b)
+{
+   const MONO_EVENT* ea = (const MONO_EVENT*)a;
+   const MONO_EVENT* eb = (const MONO_EVENT*)b;
+
+   if (ea->y != eb->y)
+      return ea->y > eb->y ? -1 : 1;
+   if (ea->x != eb->x)
+      return ea->x < eb->x ? -1 : 1;
+   return ea->vertex - eb->vertex;
+}
+
+
+/*
+ *  Whether the edge in the status tree is left of the vertex.
+ */
+static bool mono_edge_left_of(const MONO_POLY* poly, int edge, int vertex)
+{
+   return mono_cross(poly, edge, poly->next[edge], vertex) > 0;
+}
+
+
+static void mono_tree_rotate_up(MONO_POLY* poly, int node)
+{
+   int parent = poly->tree_parent[node];
+   int grand  = poly->tree_parent[parent];
+
+   if (poly->tree_left[parent] == node) {
+      poly->tree_left[parent] = poly->tree_right[node];
+      if (poly->tree_right[node] >= 0)
+         poly->tree_parent[poly->tree_right[node]] = parent;
+      poly->tree_right[node] = parent;
+   }
+   else {
+      poly->tree_right[parent] = poly->tree_left[node];
+      if (poly->tree_left[node] >= 0)
+         poly->tree_parent[poly->tree_left[node]] = parent;
+      poly->tree_left[node] = parent;
+   }
+
+   poly->tree_parent[parent] = node;
+   poly->tree_parent[node]   = grand;
+
+   if (grand < 0)
+      poly->tree_root = node;
+   else if (poly->tree_left[grand] == parent)
+      poly->tree_left[grand] = node;
+   else
+      poly->tree_right[grand] = node;
+}
+
+
+static void mono_tree_insert(MONO_POLY* poly, int edge)
+{
+   int parent = -1;
+   int node = poly->tree_root;
+   bool go_right = false;
+
+   while (node >= 0) {
+      double cross = mono_cross(poly, node, poly->next[node], edge);
+
+      /* The edges start at the same point, compare their other ends. */
+      if (cross == 0)
+         cross = mono_cross(poly, node, poly->next[node], poly->next[edge]);
+
+      parent   = node;
+      go_right = cross > 0;
+      node     = go_right ? poly->tree_right[node] : poly->tree_left[node];
+   }
+
+   /* xorshift */
+   poly->random ^= poly->random << 13;
+   poly->random ^= poly->random >> 17;
+   poly->random ^= poly->random << 5;
+
+   poly->tree_left[edge]     = -1;
+   poly->tree_right[edge]    = -1;
+   poly->tree_parent[edge]   = parent;
+   poly->tree_priority[edge] = poly->random;
+   poly->in_tree[edge]       = 1;
+
+   if (parent < 0)
+      poly->tree_root = edge;
+   else if (go_right)
+      poly->tree_right[parent] = edge;
+   else
+      poly->tree_left[parent] = edge;
+
+   while (poly->tree_parent[edge] >= 0 &&
+          poly->tree_priority[poly->tree_parent[edge]] < poly->tree_priority[edge])
+      mono_tree_rotate_up(poly, edge);
+}
+
+
+static void mono_tree_remove(MONO_POLY* poly, int edge)
+{
+   int parent;
+
+   if (!poly->in_tree[edge])
+      return;
+
+   /* Rotate the edge down until it is a leaf. */
+   for (;;) {
+      int left  = poly->tree_left[edge];
+      int right = poly->tree_right[edge];
+
+      if (left < 0 && right < 0)
+         break;
+
+      if (right < 0 || (left >= 0 && poly->tree_priority[left] > poly->tree_priority[right]))
+         mono_tree_rotate_up(poly, left);
+      else
+         mono_tree_rotate_up(poly, right);
+   }
+
+   parent = poly->tree_parent[edge];
+   if (parent < 0)
+      poly->tree_root = -1;
+   else if (poly->tree_left[parent] == edge)
+      poly->tree_left[parent] = -1;
+   else
+      poly->tree_right[parent] = -1;
+
+   poly->in_tree[edge] = 0;
+}
+
+
+/*
+ *  Find the edge directly left of the vertex, or -1 if there is none.
+ */
+static int mono_tree_find_left(const MONO_POLY* poly, int vertex)
+{
+   int node = poly->tree_root;
+   int best = -1;
+
+   while (node >= 0) {
+      if (mono_edge_left_of(poly, node, vertex)) {
+         best = node;
+         node = poly->tree_right[node];
+      }
+      else
+         node = poly->tree_left[node];
+   }
+
+   return best;
+}
+
+
+static void mono_add_diagonal(MONO_POLY* poly, int a, int b)
+{
+   if (a == b || poly->next[a] == b || poly->prev[a] == b)
+      return;
+
+   poly->diagonals[2 * poly->diagonal_count]     = a;
+   poly->diagonals[2 * poly->diagonal_count + 1] = b;
+   poly->diagonal_count++;
+}
+
+
+/*
+ *  Connect the vertex to the helper of an edge if that is a merge vertex.
+ */
+static void mono_connect_merge_helper(MONO_POLY* poly, int vertex, int edge)
+{
+   int helper = poly->helper[edge];
+
+   if (helper >= 0 && poly->is_merge[helper])
+      mono_add_diagonal(poly, vertex, helper);
+}
+
+
+/*
+ *  Sweep all vertices from top to bottom and add the diagonals which cut
+ *  the polygon into monotone pieces.
+ */
+static void mono_partition(MONO_POLY* poly)
+{
+   int i;
+
+   for (i = 0; i < poly->order_count; ++i) {
+
+      int vertex = poly->order[i];
+      int prev   = poly->prev[vertex];
+      int next   = poly->next[vertex];
+      bool prev_below = poly->rank[prev] > poly->rank[vertex];
+      bool next_below = poly->rank[next] > poly->rank[vertex];
+      bool convex = mono_cross(poly, prev, vertex, next) > 0;
+      int edge;
+
+      if (prev_below && next_below) {
+
+         /* Split vertex, connect it upwards. Start vertices need nothing. */
+         if (!convex) {
+
+            edge = mono_tree_find_left(poly, vertex);
+            if (edge >= 0) {
+
+               mono_add_diagonal(poly, vertex, poly->helper[edge]);
+               poly->helper[edge] = vertex;
+            }
+         }
+
+         mono_tree_insert(poly, vertex);
+         poly->helper[vertex] = vertex;
+      }
+      else if (!prev_below && !next_below) {
+
+         /* End vertex, or merge vertex to be connected downwards later. */
+         mono_connect_merge_helper(poly, vertex, prev);
+         mono_tree_remove(poly, prev);
+
+         if (!convex) {
+
+            poly->is_merge[vertex] = 1;
+
+            edge = mono_tree_find_left(poly, vertex);
+            if (edge >= 0) {
+
+               mono_connect_merge_helper(poly, vertex, edge);
+               poly->helper[edge] = vertex;
+            }
+         }
+      }
+      else if (!prev_below) {
+
+         /* Regular vertex on the left side of the inside. */
+         mono_connect_merge_helper(poly, vertex, prev);
+         mono_tree_remove(poly, prev);
+
+         mono_tree_insert(poly, vertex);
+         poly->helper[vertex] = vertex;
+      }
+      else {
+
+         /* Regular vertex on the right side of the inside. */
+         edge = mono_tree_find_left(poly, vertex);
+         if (edge >= 0) {
+
+            mono_connect_merge_helper(poly, vertex, edge);
+            poly->helper[edge] = vertex;
+         }
+      }
+   }
+}
+
+
+static int mono_compare_angles(const void* a, const void* b)
+{
+   const MONO_HALF_EDGE* ea = (const MONO_HALF_EDGE*)a;
+   const MONO_HALF_EDGE* eb = (const MONO_HALF_EDGE*)b;
+   int half_a = ea->dy < 0 || (ea->dy == 0 && ea->dx < 0);
+   int half_b = eb->dy < 0 || (eb->dy == 0 && eb->dx < 0);
+   double cross;
+
+   if (half_a != half_b)
+      return half_a - half_b;
+
+   cross = ea->dx * eb->dy - ea->dy * eb->dx;
+   return cross > 0 ? -1 : (cross < 0 ? 1 : 0);
+}
+
+
+static void mono_emit(MONO_POLY* poly, int a, int b, int c)
+{
+   if (mono_cross(poly, a, b, c) < 0)
+      poly->emit(a, c, b, poly->userdata);
+   else
+      poly->emit(a, b, c, poly->userdata);
+}
+
+
+/*
+ *  Triangulate a monotone piece given by its vertices in counter-clockwise
+ *  order. 'sorted', 'side' and 'stack' are scratch space for as many
+ *  entries.
+ */
+static void mono_triangulate_piece(MONO_POLY* poly, const int* piece, int count,
+   int* sorted, char* side, int* stack)
+{
+   int top = 0;
+   int bottom = 0;
+   int left, right;
+   int size;
+   int i, j;
+
+   if (count < 3)
+      return;
+
+   if (count == 3) {
+      mono_emit(poly, piece[0], piece[1], piece[2]);
+      return;
+   }
+
+   for (i = 1; i < count; ++i) {
+
+      if (poly->rank[piece[i]] < poly->rank[piece[top]])
+         top = i;
+      if (poly->rank[piece[i]] > poly->rank[piece[bottom]])
+         bottom = i;
+   }
+
+   if (top == bottom)
+      return;
+
+   /* Going counter-clockwise from the top runs down the left chain, going
+    * clockwise down the right one. Merge them into sweep order.
+    */
+   sorted[0] = piece[top];
+   side[0]   = 2;
+   left  = (top + 1) % count;
+   right = (top + count - 1) % count;
+   for (i = 1; left != bottom || right != bottom; ++i) {
+
+      if (left != bottom && (right == bottom || poly->rank[piece[left]] < poly->rank[piece[right]])) {
+
+         sorted[i] = piece[left];
+         side[i]   = 0;
+         left = (left + 1) % count;
+      }
+      else {
+
+         sorted[i] = piece[right];
+         side[i]   = 1;
+         right = (right + count - 1) % count;
+      }
+   }
+   sorted[i] = piece[bottom];
+   side[i]   = 2;
+
+   stack[0] = 0;
+   stack[1] = 1;
+   size = 2;
+
+   for (j = 2; j < count - 1; ++j) {
+
+      if (side[j] != side[stack[size - 1]]) {
+
+         /* Fan out to everything on the other chain. */
+         for (; size > 1; --size)
+            mono_emit(poly, sorted[j], sorted[stack[size - 1]], sorted[stack[size - 2]]);
+
+         stack[0] = j - 1;
+         stack[1] = j;
+         size = 2;
+      }
+      else {
+
+         /* Cut off what can be seen from this vertex on the same chain. */
+         int last = stack[--size];
+
+         while (size > 0) {
+
+            int other = stack[size - 1];
+            double cross;
+
+            if (side[j] == 0)
+               cross = mono_cross(poly, sorted[other], sorted[last], sorted[j]);
+            else
+               cross = mono_cross(poly, sorted[j], sorted[last], sorted[other]);
+
+            if (cross <= 0)
+               break;
+
+            mono_emit(poly, sorted[j], sorted[last], sorted[other]);
+            last = stack[--size];
+         }
+
+         stack[size++] = last;
+         stack[size++] = j;
+      }
+   }
+
+   for (; size > 1; --size)
+      mono_emit(poly, sorted[count - 1], sorted[stack[size - 1]], sorted[stack[size - 2]]);
+}
+
+
+/*
+ *  Walk the pieces the diagonals cut the polygon into and triangulate them.
+ */
+static bool mono_triangulate_pieces(MONO_POLY* poly)
+{
+   int vertex_count = poly->vertex_count;
+   int edge_count = 2 * poly->order_count + 2 * poly->diagonal_count;
+   int* first;
+   int* fill;
+   int* from;
+   MONO_HALF_EDGE* edges;
+   char* visited;
+   int* piece;
+   int* sorted;
+   char* side;
+   int* stack;
+   int i, j;
+
+   first   = mono_arena_alloc(&poly->arena, (vertex_count + 1) * sizeof(int));
+   fill    = mono_arena_alloc(&poly->arena, vertex_count * sizeof(int));
+   from    = mono_arena_alloc(&poly->arena, edge_count * sizeof(int));
+   edges   = mono_arena_alloc(&poly->arena, edge_count * sizeof(MONO_HALF_EDGE));
+   visited = mono_arena_alloc(&poly->arena, edge_count);
+   piece   = mono_arena_alloc(&poly->arena, edge_count * sizeof(int));
+   sorted  = mono_arena_alloc(&poly->arena, edge_count * sizeof(int));
+   side    = mono_arena_alloc(&poly->arena, edge_count);
+   stack   = mono_arena_alloc(&poly->arena, edge_count * sizeof(int));
+
+   if (!first || !fill || !from || !edges || !visited || !piece || !sorted || !side || !stack)
+      return false;
+
+   /* Lay out the edges leaving each vertex next to each other. */
+   memset(fill, 0, vertex_count * sizeof(int));
+   for (i = 0; i < poly->order_count; ++i)
+      fill[poly->order[i]] = 2;
+   for (i = 0; i < 2 * poly->diagonal_count; ++i)
+      fill[poly->diagonals[i]]++;
+
+   first[0] = 0;
+   for (i = 0; i < vertex_count; ++i) {
+      first[i + 1] = first[i] + fill[i];
+      fill[i] = first[i];
+   }
+
+# define MONO_ADD_HALF_EDGE(a, b)                                    \
+   do {                                                              \
+      int h = fill[a]++;                                             \
+      edges[h].dx = poly->x[b] - poly->x[a];                         \
+      edges[h].dy = poly->y[b] - poly->y[a];                         \
+      edges[h].to = (b);                                             \
+   } while (0)
+
+   for (i = 0; i < poly->order_count; ++i) {
+      int vertex = poly->order[i];
+      MONO_ADD_HALF_EDGE(vertex, poly->next[vertex]);
+      MONO_ADD_HALF_EDGE(vertex, poly->prev[vertex]);
+   }
+   for (i = 0; i < poly->diagonal_count; ++i) {
+      int a = poly->diagonals[2 * i];
+      int b = poly->diagonals[2 * i + 1];
+      MONO_ADD_HALF_EDGE(a, b);
+      MONO_ADD_HALF_EDGE(b, a);
+   }
+
+# undef MONO_ADD_HALF_EDGE
+
+   /* Sort the edges around each vertex counter-clockwise. Only the few
+    * vertices with diagonals have more than two.
+    */
+   for (i = 0; i < vertex_count; ++i) {
+
+      int degree = first[i + 1] - first[i];
+
+      if (degree > 2)
+         qsort(edges + first[i], degree, sizeof(MONO_HALF_EDGE), mono_compare_angles);
+
+      for (j = first[i]; j < first[i + 1]; ++j) {
+
+         from[j]    = i;
+         visited[j] = (edges[j].to == poly->prev[i]);
+      }
+   }
+
+   /* The inside is left of every half edge, so each piece is found by
+    * turning right as far as possible at every vertex.
+    */
+   for (i = 0; i < edge_count; ++i) {
+
+      int count = 0;
+      int edge = i;
+
+      if (visited[i])
+         continue;
+
+      do {
+         int vertex = edges[edge].to;
+         int back;
+
+         visited[edge] = 1;
+         piece[count++] = from[edge];
+
+         for (back = first[vertex]; back < first[vertex + 1]; ++back)
+            if (edges[back].to == from[edge])
+               break;
+         if (back == first[vertex + 1])
+            break;
+
+         edge = (back == first[vertex] ? first[vertex + 1] : back) - 1;
+      } while (edge != i && count < edge_count);
+
+      if (edge == i)
+         mono_triangulate_piece(poly, piece, count, sorted, side, stack);
+   }
+
+   return true;
+}
+
+
+static bool mono_triangulate(
+   const float* vertices, size_t vertex_stride, const int* vertex_counts,
+   void (*emit_triangle)(int, int, int, void*), void* userdata)
+{
+   MONO_POLY poly;
+   MONO_EVENT* events;
+   int vertex_count;
+   int ring_begin;
+   int i, j;
+   bool ret = false;
+
+   vertex_count = 0;
+   for (i = 0; vertex_counts[i] > 0; i++)
+      vertex_count += vertex_counts[i];
+   ASSERT(i > 0);
+
+   if (vertex_counts[0] < 3)
+      return true;
+
+   memset(&poly, 0, sizeof(poly));
+   poly.arena.block_size = MONO_ARENA_MIN_BLOCK_SIZE;
+   if (poly.arena.block_size < vertex_count * (size_t)MONO_ARENA_BYTES_PER_VERTEX)
+      poly.arena.block_size = vertex_count * (size_t)MONO_ARENA_BYTES_PER_VERTEX;
+   poly.vertex_count = vertex_count;
+   poly.tree_root    = -1;
+   poly.random       = 2463534242u;
+   poly.emit         = emit_triangle;
+   poly.userdata     = userdata;
+
+   poly.x             = mono_arena_alloc(&poly.arena, vertex_count * sizeof(double));
+   poly.y             = mono_arena_alloc(&poly.arena, vertex_count * sizeof(double));
+   poly.next          = mono_arena_alloc(&poly.arena, vertex_count * sizeof(int));
+   poly.prev          = mono_arena_alloc(&poly.arena, vertex_count * sizeof(int));
+   poly.rank          = mono_arena_alloc(&poly.arena, vertex_count * sizeof(int));
+   poly.order         = mono_arena_alloc(&poly.arena, vertex_count * sizeof(int));
+   poly.helper        = mono_arena_alloc(&poly.arena, vertex_count * sizeof(int));
+   poly.is_merge      = mono_arena_alloc(&poly.arena, vertex_count);
+   poly.in_tree       = mono_arena_alloc(&poly.arena, vertex_count);
+   poly.tree_left     = mono_arena_alloc(&poly.arena, vertex_count * sizeof(int));
+   poly.tree_right    = mono_arena_alloc(&poly.arena, vertex_count * sizeof(int));
+   poly.tree_parent   = mono_arena_alloc(&poly.arena, vertex_count * sizeof(int));
+   poly.tree_priority = mono_arena_alloc(&poly.arena, vertex_count * sizeof(uint32_t));
+   poly.diagonals     = mono_arena_alloc(&poly.arena, 4 * vertex_count * sizeof(int));
+   events             = mono_arena_alloc(&poly.arena, vertex_count * sizeof(MONO_EVENT));
+
+   if (!poly.x || !poly.y || !poly.next || !poly.prev || !poly.rank ||
+       !poly.order || !poly.helper || !poly.is_merge || !poly.in_tree ||
+       !poly.tree_left || !poly.tree_right || !poly.tree_parent ||
+       !poly.tree_priority || !poly.diagonals || !events)
+      goto done;
+
+   memset(poly.is_merge, 0, vertex_count);
+   memset(poly.in_tree, 0, vertex_count);
+
+   /* Link up the rings, leaving out repeated points and rings too small to
+    * have an inside, and make the outline run counter-clockwise and the
+    * holes clockwise. The kept vertices of a ring are collected in
+    * poly.order, which isn't needed until after that.
+    */
+   ring_begin = 0;
+   for (i = 0; vertex_counts[i] > 0; i++) {
+
+      int ring_size = vertex_counts[i];
+      int* ring = poly.order;
+      int kept = 0;
+      double area = 0;
+
+      for (j = 0; j < ring_size; ++j) {
+
+         int vertex = ring_begin + j;
+         const float* point = (const float*)((const char*)vertices + vertex * vertex_stride);
+
+         poly.x[vertex]      = point[0];
+         poly.y[vertex]      = -point[1];
+         poly.helper[vertex] = -1;
+         poly.rank[vertex]   = -1;
+
+         if (kept > 0 && poly.x[vertex] == poly.x[ring[kept - 1]] &&
+             poly.y[vertex] == poly.y[ring[kept - 1]])
+            continue;
+
+         ring[kept++] = vertex;
+      }
+
+      while (kept > 1 && poly.x[ring[kept - 1]] == poly.x[ring[0]] &&
+             poly.y[ring[kept - 1]] == poly.y[ring[0]])
+         kept--;
+
+      if (kept >= 3) {
+
+         for (j = 0; j < kept; ++j) {
+
+            int a = ring[j];
+            int b = ring[(j + 1) % kept];
+
+            area += poly.x[a] * poly.y[b] - poly.x[b] * poly.y[a];
+         }
+
+         for (j = 0; j < kept; ++j) {
+
+            int vertex = ring[j];
+            int next   = ring[(j + 1) % kept];
+            int prev   = ring[(j + kept - 1) % kept];
+
+            if ((i == 0) == (area >= 0)) {
+
+               poly.next[vertex] = next;
+               poly.prev[vertex] = prev;
+            }
+            else {
+
+               poly.next[vertex] = prev;
+               poly.prev[vertex] = next;
+            }
+
+            events[poly.order_count].x      = poly.x[vertex];
+            events[poly.order_count].y      = poly.y[vertex];
+            events[poly.order_count].vertex = vertex;
+            poly.order_count++;
+         }
+      }
+      else if (i == 0) {
+
+         /* Nothing to fill. */
+         ret = true;
+         goto done;
+      }
+
+      ring_begin += ring_size;
+   }
+
+   qsort(events, poly.order_count, sizeof(MONO_EVENT), mono_compare_events);
+   for (i = 0; i < poly.order_count; ++i) {
+
+      poly.order[i] = events[i].vertex;
+      poly.rank[events[i].vertex] = i;
+   }
+
+   mono_partition(&poly);
+   ret = mono_triangulate_pieces(&poly);
+
+done:
+   mono_arena_free(&poly.arena);
+   return ret;
+}
+
+
+/* Function: al_triangulate_polygon
+ *  General triangulation function.
+ */
+bool al_triangulate_polygon(
+   const float* vertices, size_t vertex_stride, const int* vertex_counts,
+   void (*emit_triangle)(int, int, int, void*), void* userdata)
+{
+   const char* triangulator = al_get_config_value(al_get_system_config(),
+      "primitives", "triangulator");
+   bool ear_clipping;
+
+   if (triangulator && 0 == _al_stricmp(triangulator, "ear_clipping")) {
+      ear_clipping = true;
+   }
+   else if (triangulator && 0 == _al_stricmp(triangulator, "monotone")) {
+      ear_clipping = false;
+   }
+   else {
+      /* Small polygons keep the triangles they always had, which is still
+       * cheap to do.
+       */
+      int num_vertices = 0;
+      int i;
+      for (i = 0; vertex_counts[i] > 0; i++)
+         num_vertices += vertex_counts[i];
+      ear_clipping = (num_vertices <= MAX_EAR_CLIPPING_VERTICES);
+   }
+
+   if (ear_clipping)
+      return poly_triangulate_ear_clipping(vertices, vertex_stride,
+         vertex_counts, emit_triangle, userdata);
+
+   return mono_triangulate(vertices, vertex_stride, vertex_counts,
+      emit_triangle, userdata);
+}
+
 /* vim: set sts=3 sw=3 et: */
@@ -11,6 +11,9 @@
 #define ALLEGRO_TTF_NO_KERNING  1
 #define ALLEGRO_TTF_MONOCHROME  2
 #define ALLEGRO_TTF_NO_AUTOHINT 4
+#if defined(ALLEGRO_UNSTABLE) || defined(ALLEGRO_INTERNAL_UNSTABLE) || defined(ALLEGRO_TTF_SRC)
+#define ALLEGRO_TTF_SDF         8
+#endif
 
 #if (defined ALLEGRO_MINGW32) || (defined ALLEGRO_MSVC) || (defined ALLEGRO_BCC32)
    #ifndef ALLEGRO_STATICLINK
@@ -42,6 +45,24 @@ ALLEGRO_TTF_FUNC(bool, al_init_ttf_addon, (void));
 ALLEGRO_TTF_FUNC(void, al_shutdown_ttf_addon, (void));
 ALLEGRO_TTF_FUNC(uint32_t, al_get_allegro_ttf_version, (void));
 
+#if defined(ALLEGRO_UNSTABLE) || defined(ALLEGRO_INTERNAL_UNSTABLE) || defined(ALLEGRO_TTF_SRC)
+/* Type: ALLEGRO_TTF_CACHE_STATS
+ */
+typedef struct ALLEGRO_TTF_CACHE_STATS ALLEGRO_TTF_CACHE_STATS;
+
+struct ALLEGRO_TTF_CACHE_STATS
+{
+   int pages;
+   int memory;
+   float fill_ratio;
+   int64_t hits;
+   int64_t misses;
+   int64_t evictions;
+};
+
+ALLEGRO_TTF_FUNC(bool, al_get_ttf_cache_stats, (ALLEGRO_FONT const *font, ALLEGRO_TTF_CACHE_STATS *stats));
+#endif
+
 #ifdef __cplusplus
    }
 #endif
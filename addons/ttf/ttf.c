@@ -1,18 +1,29 @@
+#define ALLEGRO_INTERNAL_UNSTABLE
+
 #include "allegro5/allegro.h"
 #ifdef ALLEGRO_CFG_OPENGL
 #include "allegro5/allegro_opengl.h"
 #endif
 #include "allegro5/internal/aintern.h"
+#include "allegro5/internal/aintern_bitmap.h"
+#include "allegro5/internal/aintern_file.h"
 #include "allegro5/internal/aintern_vector.h"
 
 #include "allegro5/allegro_ttf.h"
 #include "allegro5/internal/aintern_ttf_cfg.h"
 #include "allegro5/internal/aintern_dtor.h"
+#include "allegro5/internal/aintern_shader.h"
 #include "allegro5/internal/aintern_system.h"
+#include "allegro5/internal/aintern_thread.h"
+#include "allegro5/internal/aintern_workers.h"
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
+#include FT_SIZES_H
+#include FT_ADVANCES_H
 
+#include <limits.h>
+#include <math.h>
 #include <stdlib.h>
 
 ALLEGRO_DEBUG_CHANNEL("font")
@@ -43,13 +54,39 @@ typedef struct REGION
 } REGION;
 
 
+/* A segment of the skyline of a page: everything from x to x + w is free
+ * from y down.
+ */
+typedef struct SKYLINE_NODE
+{
+   int x;
+   int y;
+   int w;
+} SKYLINE_NODE;
+
+
+typedef struct TTF_PAGE
+{
+   ALLEGRO_BITMAP *bitmap;
+   _AL_VECTOR skyline;  /* of SKYLINE_NODE, sorted by x */
+   int used_area;
+   unsigned int last_used;
+   /* Async fonts: copy of the page in memory, and its part which still
+    * has to be uploaded.
+    */
+   unsigned char *staging;
+   int dirty_x1, dirty_y1, dirty_x2, dirty_y2;
+} TTF_PAGE;
+
+
 typedef struct ALLEGRO_TTF_GLYPH_DATA
 {
-   ALLEGRO_BITMAP *page_bitmap;
+   TTF_PAGE *page;
    REGION region;
    short offset_x;
    short offset_y;
    short advance;
+   bool pending;  /* Being rasterized on a worker thread. */
 } ALLEGRO_TTF_GLYPH_DATA;
 
 
@@ -60,37 +97,114 @@ typedef struct ALLEGRO_TTF_GLYPH_RANGE
 } ALLEGRO_TTF_GLYPH_RANGE;
 
 
+/* A FreeType face shared by all the fonts loaded from the same file. The
+ * whole file is kept in memory, so FreeType never has to go back to the
+ * ALLEGRO_FILE. Every font has its own FT_Size, which has to be activated
+ * before anything depending on the size is done with the face; the mutex
+ * makes that safe when the fonts are used from several threads.
+ */
+typedef struct TTF_FACE
+{
+   FT_Face face;
+   int face_index;
+   unsigned char *file_data;
+   size_t file_size;
+   ALLEGRO_FILE *file;   /* Set if file_data is the file's own memory. */
+   uint32_t hash;
+   char *filename;   /* Set if the face was found by name. */
+   time_t mtime;
+   int refcount;
+   _AL_MUTEX mutex;
+   /* How many fonts of the face have glyphs rasterized on worker threads.
+    * Changed with the mutex held.
+    */
+   int async_fonts;
+} TTF_FACE;
+
+
 typedef struct ALLEGRO_TTF_FONT_DATA
 {
+   TTF_FACE *shared;
    FT_Face face;
+   FT_Size size;
    int flags;
    _AL_VECTOR glyph_ranges;  /* sorted array of of ALLEGRO_TTF_GLYPH_RANGE */
 
-   _AL_VECTOR page_bitmaps;  /* of ALLEGRO_BITMAP pointers */
-   int page_pos_x;
-   int page_pos_y;
-   int page_line_height;
+   _AL_VECTOR pages;  /* of TTF_PAGE pointers */
+   TTF_PAGE *locked_page;
    ALLEGRO_LOCKED_REGION *page_lr;
 
-   FT_StreamRec stream;
-   ALLEGRO_FILE *file;
-   unsigned long base_offset;
-   unsigned long offset;
-
    int bitmap_format;
    int bitmap_flags;
 
    int min_page_size;
    int max_page_size;
 
+   /* Pages used least recently are evicted to stay below max_cache_memory
+    * (if not 0). The pages used since the last draw call ended are kept.
+    */
+   int max_cache_memory;
+   int cache_memory;
+   unsigned int use_tick;
+   int64_t hits;
+   int64_t misses;
+   int64_t evictions;
+
+   /* Changed whenever glyphs are evicted or pending glyphs are placed, so
+    * text layouts know to ask for their glyphs again.
+    */
+   int generation;
+
    bool skip_cache_misses;
+
+   /* With ALLEGRO_TTF_SDF the pages hold signed distance fields, which
+    * reach sdf_spread pixels beyond the outline of each glyph.
+    */
+   int sdf_spread;
+   ALLEGRO_BITMAP *sdf_scratch;  /* For drawing them without shaders. */
+
+   /* With async_glyphs, missing glyphs are rasterized on the worker
+    * threads and drawn blank until they are ready. Glyphs are put on the
+    * pages through staging copies of them in memory, and the dirty part of
+    * each page is uploaded with a single lock.
+    */
+   bool async;
+   _AL_MUTEX async_mutex;
+   _AL_COND async_cond;
+   int pending_glyphs;
+   _AL_VECTOR ready_glyphs;  /* of GLYPH_JOB pointers */
 } ALLEGRO_TTF_FONT_DATA;
 
 
+/* Glyphs are handed to the display in batches of this many. */
+#define QUAD_BATCH_SIZE 64
+
+typedef struct QUAD_BATCH
+{
+   _AL_BITMAP_QUAD quads[QUAD_BATCH_SIZE];
+   int count;
+} QUAD_BATCH;
+
+
+typedef struct GLYPH_JOB
+{
+   ALLEGRO_TTF_FONT_DATA *font_data;
+   int ft_index;
+   short offset_x;
+   short offset_y;
+   short advance;
+   int w, h;
+   unsigned char *pixels;  /* w * h in ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE */
+} GLYPH_JOB;
+
+
 /* globals */
 static bool ttf_inited;
 static FT_Library ft;
 static ALLEGRO_FONT_VTABLE vt;
+static ALLEGRO_FONT_VTABLE vt_sdf;
+static _AL_VECTOR faces = _AL_VECTOR_INITIALIZER(TTF_FACE *);
+static _AL_MUTEX faces_mutex = _AL_MUTEX_UNINITED;
 
 
 static INLINE int align4(int x)
@@ -103,6 +217,40 @@ static INLINE int align4(int x)
 }
 
 
+/* Lock the shared face and make the size of this font the active one. */
+static void lock_face(ALLEGRO_TTF_FONT_DATA const *data)
+{
+   _al_mutex_lock(&data->shared->mutex);
+   FT_Activate_Size(data->size);
+}
+
+
+static void unlock_face(ALLEGRO_TTF_FONT_DATA const *data)
+{
+   _al_mutex_unlock(&data->shared->mutex);
+}
+
+
+/* The character map belongs to the shared face too, which worker threads
+ * may be loading glyphs from. Without async fonts of the face there are no
+ * such threads, and no lock is needed. A worker of an async font only
+ * starts once that font queues a glyph, after its creation has returned.
+ */
+static int get_char_index(ALLEGRO_TTF_FONT_DATA const *data, int ch)
+{
+   int ft_index;
+
+   if (data->shared->async_fonts == 0)
+      return FT_Get_Char_Index(data->face, ch);
+
+   _al_mutex_lock(&data->shared->mutex);
+   ft_index = FT_Get_Char_Index(data->face, ch);
+   _al_mutex_unlock(&data->shared->mutex);
+
+   return ft_index;
+}
+
+
 /* Returns false if the glyph is invalid.
  */
 static bool get_glyph(ALLEGRO_TTF_FONT_DATA *data,
@@ -145,7 +293,7 @@ static bool get_glyph(ALLEGRO_TTF_FONT_DATA *data,
    *glyph = &range->glyphs[ft_index - range_start]; 
    
    /* If we're skipping cache misses and it isn't already cached, return it as invalid. */
-   if (data->skip_cache_misses && !(*glyph)->page_bitmap && (*glyph)->region.x >= 0) {
+   if (data->skip_cache_misses && !(*glyph)->page && (*glyph)->region.x >= 0) {
       return false;
    }
 
@@ -153,22 +301,130 @@ static bool get_glyph(ALLEGRO_TTF_FONT_DATA *data,
 }
 
 
+static void reset_dirty(TTF_PAGE *page)
+{
+   page->dirty_x1 = page->dirty_y1 = INT_MAX;
+   page->dirty_x2 = page->dirty_y2 = 0;
+}
+
+
+/* Copy the dirty part of the staging page to the page bitmap. */
+static void upload_staging(TTF_PAGE *page)
+{
+   ALLEGRO_LOCKED_REGION *lr;
+   int w = page->dirty_x2 - page->dirty_x1;
+   int h = page->dirty_y2 - page->dirty_y1;
+   int pitch = al_get_bitmap_width(page->bitmap) * 4;
+   int y;
+
+   if (!page->staging || w <= 0 || h <= 0)
+      return;
+
+   ALLEGRO_DEBUG("Uploading glyphs: %p %d %d %d %d\n", page->bitmap,
+      page->dirty_x1, page->dirty_y1, w, h);
+
+   lr = al_lock_bitmap_region(page->bitmap,
+      page->dirty_x1, page->dirty_y1, w, h,
+      ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE, ALLEGRO_LOCK_WRITEONLY);
+   if (lr) {
+      for (y = 0; y < h; y++) {
+         memcpy((char *)lr->data + y * lr->pitch,
+            page->staging + (page->dirty_y1 + y) * pitch + page->dirty_x1 * 4,
+            w * 4);
+      }
+      al_unlock_bitmap(page->bitmap);
+   }
+
+   reset_dirty(page);
+}
+
+
 static void unlock_current_page(ALLEGRO_TTF_FONT_DATA *data)
 {
+   unsigned int i;
+
+   for (i = 0; i < _al_vector_size(&data->pages); i++) {
+      TTF_PAGE **page = _al_vector_ref(&data->pages, i);
+      upload_staging(*page);
+   }
+
    if (data->page_lr) {
-      ALLEGRO_BITMAP **back = _al_vector_ref_back(&data->page_bitmaps);
-      ASSERT(al_is_bitmap_locked(*back));
-      al_unlock_bitmap(*back);
+      ALLEGRO_BITMAP *bitmap = data->locked_page->bitmap;
+      ASSERT(al_is_bitmap_locked(bitmap));
+      al_unlock_bitmap(bitmap);
       data->page_lr = NULL;
-      ALLEGRO_DEBUG("Unlocking page: %p\n", *back);
+      data->locked_page = NULL;
+      ALLEGRO_DEBUG("Unlocking page: %p\n", bitmap);
+   }
+}
+
+
+static void destroy_page(TTF_PAGE *page)
+{
+   al_destroy_bitmap(page->bitmap);
+   _al_vector_free(&page->skyline);
+   al_free(page->staging);
+   al_free(page);
+}
+
+
+/* Forget about the glyphs on the page used least recently, and destroy it.
+ * Returns false if all the pages were used in the current draw call.
+ */
+static bool evict_page(ALLEGRO_TTF_FONT_DATA *data)
+{
+   TTF_PAGE *page = NULL;
+   unsigned int index = 0;
+   unsigned int i;
+   int j;
+
+   for (i = 0; i < _al_vector_size(&data->pages); i++) {
+      TTF_PAGE **p = _al_vector_ref(&data->pages, i);
+      if ((*p)->last_used == data->use_tick)
+         continue;
+      if (!page || (*p)->last_used < page->last_used) {
+         page = *p;
+         index = i;
+      }
+   }
+   if (!page)
+      return false;
+
+   ALLEGRO_DEBUG("Evicting page %p\n", page->bitmap);
+
+   /* The page may still be referenced by held drawing. */
+   if (al_is_bitmap_drawing_held()) {
+      al_hold_bitmap_drawing(false);
+      al_hold_bitmap_drawing(true);
+   }
+
+   for (i = 0; i < _al_vector_size(&data->glyph_ranges); i++) {
+      ALLEGRO_TTF_GLYPH_RANGE *range = _al_vector_ref(&data->glyph_ranges, i);
+      for (j = 0; j < RANGE_SIZE; j++) {
+         ALLEGRO_TTF_GLYPH_DATA *glyph = &range->glyphs[j];
+         if (glyph->page == page) {
+            glyph->page = NULL;
+            memset(&glyph->region, 0, sizeof glyph->region);
+         }
+      }
    }
+
+   data->cache_memory -= al_get_bitmap_width(page->bitmap) *
+      al_get_bitmap_height(page->bitmap) * 4;
+   data->evictions++;
+   data->generation++;
+   _al_vector_delete_at(&data->pages, index);
+   destroy_page(page);
+   return true;
 }
 
 
-static ALLEGRO_BITMAP *push_new_page(ALLEGRO_TTF_FONT_DATA *data, int glyph_size)
+static TTF_PAGE *push_new_page(ALLEGRO_TTF_FONT_DATA *data, int glyph_size)
 {
-    ALLEGRO_BITMAP **back;
-    ALLEGRO_BITMAP *page;
+    TTF_PAGE **back;
+    TTF_PAGE *page;
+    ALLEGRO_BITMAP *bitmap;
+    SKYLINE_NODE *node;
     ALLEGRO_STATE state;
     int page_size = 1;
     /* 16 seems to work well. A particular problem are fixed width fonts which
@@ -188,6 +444,12 @@ static ALLEGRO_BITMAP *push_new_page(ALLEGRO_TTF_FONT_DATA *data, int glyph_size
 
     unlock_current_page(data);
 
+    if (data->max_cache_memory > 0) {
+       while (data->cache_memory + page_size * page_size * 4 >
+             data->max_cache_memory && evict_page(data)) {
+       }
+    }
+
     /* The bitmap will be destroyed when the parent font is destroyed so
      * it is not safe to register a destructor for it.
      */
@@ -195,77 +457,204 @@ static ALLEGRO_BITMAP *push_new_page(ALLEGRO_TTF_FONT_DATA *data, int glyph_size
     al_store_state(&state, ALLEGRO_STATE_NEW_BITMAP_PARAMETERS);
     al_set_new_bitmap_format(data->bitmap_format);
     al_set_new_bitmap_flags(data->bitmap_flags);
-    page = al_create_bitmap(page_size, page_size);
+    bitmap = al_create_bitmap(page_size, page_size);
     al_restore_state(&state);
     _al_pop_destructor_owner();
 
-    if (page) {
-       back = _al_vector_alloc_back(&data->page_bitmaps);
-       *back = page;
+    if (!bitmap)
+       return NULL;
 
-       data->page_pos_x = 0;
-       data->page_pos_y = 0;
-       data->page_line_height = 0;
-    }
+    page = al_calloc(1, sizeof *page);
+    page->bitmap = bitmap;
+    page->last_used = data->use_tick;
+    reset_dirty(page);
+    _al_vector_init(&page->skyline, sizeof(SKYLINE_NODE));
+    node = _al_vector_alloc_back(&page->skyline);
+    node->x = 0;
+    node->y = 0;
+    node->w = page_size;
+
+    back = _al_vector_alloc_back(&data->pages);
+    *back = page;
+    data->cache_memory += page_size * page_size * 4;
 
     return page;
 }
 
 
-static unsigned char *alloc_glyph_region(ALLEGRO_TTF_FONT_DATA *data,
-   int ft_index, int w, int h, bool new, ALLEGRO_TTF_GLYPH_DATA *glyph,
-   bool lock_whole_page)
+/* Returns the top of a w x h rectangle put at the left of the given
+ * skyline node, or -1 if it doesn't fit there.
+ */
+static int skyline_fit(TTF_PAGE *page, unsigned int index, int w, int h)
 {
-   ALLEGRO_BITMAP *page;
-   int w4 = align4(w);
-   int h4 = align4(h);
-   int glyph_size = w4 > h4 ? w4 : h4;
-   bool lock = false;
+   SKYLINE_NODE *node = _al_vector_ref(&page->skyline, index);
+   int y = 0;
+   int width_left = w;
+
+   if (node->x + w > al_get_bitmap_width(page->bitmap))
+      return -1;
+
+   while (width_left > 0) {
+      if (index >= _al_vector_size(&page->skyline))
+         return -1;
+      node = _al_vector_ref(&page->skyline, index);
+      if (node->y > y)
+         y = node->y;
+      if (y + h > al_get_bitmap_height(page->bitmap))
+         return -1;
+      width_left -= node->w;
+      index++;
+   }
 
-   if (_al_vector_is_empty(&data->page_bitmaps) || new) {
-      page = push_new_page(data, glyph_size);
-      if (!page)
-         return NULL;
+   return y;
+}
+
+
+/* Raise the skyline over a w x h rectangle put at x, y. */
+static void skyline_add(TTF_PAGE *page, unsigned int index, int x, int y,
+   int w, int h)
+{
+   SKYLINE_NODE *node = _al_vector_alloc_mid(&page->skyline, index);
+   unsigned int i;
+
+   node->x = x;
+   node->y = y + h;
+   node->w = w;
+
+   /* Cut the nodes now below the new one. */
+   for (i = index + 1; i < _al_vector_size(&page->skyline); i++) {
+      SKYLINE_NODE *prev = _al_vector_ref(&page->skyline, i - 1);
+      SKYLINE_NODE *cur = _al_vector_ref(&page->skyline, i);
+      int shrink = prev->x + prev->w - cur->x;
+      if (shrink <= 0)
+         break;
+      cur->x += shrink;
+      cur->w -= shrink;
+      if (cur->w > 0)
+         break;
+      _al_vector_delete_at(&page->skyline, i);
+      i--;
    }
-   else {
-      ALLEGRO_BITMAP **back = _al_vector_ref_back(&data->page_bitmaps);
-      page = *back;
+
+   /* Merge neighbours of the same height. */
+   for (i = 0; i + 1 < _al_vector_size(&page->skyline); i++) {
+      SKYLINE_NODE *cur = _al_vector_ref(&page->skyline, i);
+      SKYLINE_NODE *next = _al_vector_ref(&page->skyline, i + 1);
+      if (cur->y == next->y) {
+         cur->w += next->w;
+         _al_vector_delete_at(&page->skyline, i + 1);
+         i--;
+      }
+   }
+}
+
+
+/* Put a w x h rectangle as low as possible on the page. */
+static bool skyline_place(TTF_PAGE *page, int w, int h, int *x, int *y)
+{
+   unsigned int best_index = 0;
+   int best_bottom = INT_MAX;
+   int best_x = 0;
+   int best_y = 0;
+   unsigned int i;
+
+   if (al_get_bitmap_width(page->bitmap) * al_get_bitmap_height(page->bitmap)
+         - page->used_area < w * h)
+      return false;
+
+   for (i = 0; i < _al_vector_size(&page->skyline); i++) {
+      SKYLINE_NODE *node = _al_vector_ref(&page->skyline, i);
+      int top = skyline_fit(page, i, w, h);
+      if (top >= 0 && top + h < best_bottom) {
+         best_index = i;
+         best_bottom = top + h;
+         best_x = node->x;
+         best_y = top;
+      }
    }
 
-   ALLEGRO_DEBUG("Glyph %d: %dx%d (%dx%d)%s\n",
-      ft_index, w, h, w4, h4, new ? " new" : "");
+   if (best_bottom == INT_MAX)
+      return false;
+
+   skyline_add(page, best_index, best_x, best_y, w, h);
+   page->used_area += w * h;
+   *x = best_x;
+   *y = best_y;
+   return true;
+}
+
+
+/* Find a place for the glyph, on a new page if needed. Unless only the
+ * last page may be used, the pages are tried from the newest one.
+ */
+static TTF_PAGE *place_glyph(ALLEGRO_TTF_FONT_DATA *data,
+   int ft_index, int w, int h, ALLEGRO_TTF_GLYPH_DATA *glyph,
+   bool last_page_only)
+{
+   TTF_PAGE *page = NULL;
+   int w4 = align4(w);
+   int h4 = align4(h);
+   int glyph_size = w4 > h4 ? w4 : h4;
+   int x, y;
+   int i;
 
-   if (data->page_pos_x + w4 > al_get_bitmap_width(page)) {
-      data->page_pos_y += data->page_line_height;
-      data->page_pos_y = align4(data->page_pos_y);
-      data->page_pos_x = 0;
-      data->page_line_height = 0;
+   for (i = _al_vector_size(&data->pages) - 1; i >= 0; i--) {
+      TTF_PAGE **p = _al_vector_ref(&data->pages, i);
+      if (skyline_place(*p, w4, h4, &x, &y)) {
+         page = *p;
+         break;
+      }
+      if (last_page_only)
+         break;
    }
 
-   if (data->page_pos_y + h4 > al_get_bitmap_height(page)) {
-      return alloc_glyph_region(data, ft_index, w, h, true, glyph, lock_whole_page);
+   if (!page) {
+      page = push_new_page(data, glyph_size);
+      if (!page || !skyline_place(page, w4, h4, &x, &y))
+         return NULL;
    }
 
-   glyph->page_bitmap = page;
-   glyph->region.x = data->page_pos_x;
-   glyph->region.y = data->page_pos_y;
+   ALLEGRO_DEBUG("Glyph %d: %dx%d (%dx%d) at %d,%d of %p\n",
+      ft_index, w, h, w4, h4, x, y, page->bitmap);
+
+   glyph->page = page;
+   glyph->region.x = x;
+   glyph->region.y = y;
    glyph->region.w = w;
    glyph->region.h = h;
 
-   data->page_pos_x = align4(data->page_pos_x + w4);
-   if (h > data->page_line_height) {
-      data->page_line_height = h4;
-   }
+   return page;
+}
+
+
+static unsigned char *alloc_glyph_region(ALLEGRO_TTF_FONT_DATA *data,
+   int ft_index, int w, int h, ALLEGRO_TTF_GLYPH_DATA *glyph,
+   bool lock_whole_page)
+{
+   TTF_PAGE *page;
+   int w4 = align4(w);
+   int h4 = align4(h);
+   bool lock = false;
+
+   /* Locking the whole page clears it, so only the last page is used,
+    * which is empty when it is first locked.
+    */
+   page = place_glyph(data, ft_index, w, h, glyph, lock_whole_page);
+   if (!page)
+      return NULL;
 
    REGION lock_rect;
    if (lock_whole_page) {
       lock_rect.x = 0;
       lock_rect.y = 0;
-      lock_rect.w = al_get_bitmap_width(page);
-      lock_rect.h = al_get_bitmap_height(page);
+      lock_rect.w = al_get_bitmap_width(page->bitmap);
+      lock_rect.h = al_get_bitmap_height(page->bitmap);
+      if (data->page_lr && data->locked_page != page) {
+         unlock_current_page(data);
+      }
       if (!data->page_lr) {
          lock = true;
-         ALLEGRO_DEBUG("Locking whole page: %p\n", page);
+         ALLEGRO_DEBUG("Locking whole page: %p\n", page->bitmap);
       }
    }
    else {
@@ -276,7 +665,7 @@ static unsigned char *alloc_glyph_region(ALLEGRO_TTF_FONT_DATA *data,
       lock_rect.w = w4;
       lock_rect.h = h4;
       lock = true;
-      ALLEGRO_DEBUG("Locking glyph region: %p %d %d %d %d\n", page,
+      ALLEGRO_DEBUG("Locking glyph region: %p %d %d %d %d\n", page->bitmap,
          lock_rect.x, lock_rect.y, lock_rect.w, lock_rect.h);
    }
 
@@ -284,13 +673,14 @@ static unsigned char *alloc_glyph_region(ALLEGRO_TTF_FONT_DATA *data,
       char *ptr;
       int i;
 
-      data->page_lr = al_lock_bitmap_region(page,
+      data->page_lr = al_lock_bitmap_region(page->bitmap,
          lock_rect.x, lock_rect.y, lock_rect.w, lock_rect.h,
          ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE, ALLEGRO_LOCK_WRITEONLY);
 
       if (!data->page_lr) {
          return NULL;
       }
+      data->locked_page = page;
 
       /* Clear the data so we don't get garbage when using filtering
        * FIXME We could clear just the border but I'm not convinced that
@@ -311,10 +701,47 @@ static unsigned char *alloc_glyph_region(ALLEGRO_TTF_FONT_DATA *data,
 }
 
 
-static void copy_glyph_mono(ALLEGRO_TTF_FONT_DATA *font_data, FT_Face face,
-   unsigned char *glyph_data)
+/* Like alloc_glyph_region, but returns a pointer into the staging copy of
+ * the page, and the pitch of that. The glyph is uploaded by upload_staging.
+ */
+static unsigned char *stage_glyph_region(ALLEGRO_TTF_FONT_DATA *data,
+   int ft_index, int w, int h, ALLEGRO_TTF_GLYPH_DATA *glyph, int *pitch)
+{
+   TTF_PAGE *page;
+   int x2, y2;
+
+   page = place_glyph(data, ft_index, w, h, glyph, false);
+   if (!page)
+      return NULL;
+
+   *pitch = al_get_bitmap_width(page->bitmap) * 4;
+   if (!page->staging) {
+      page->staging = al_calloc(al_get_bitmap_height(page->bitmap), *pitch);
+      if (!page->staging)
+         return NULL;
+   }
+
+   /* The staging page starts out cleared, and the glyphs never overlap. */
+   x2 = glyph->region.x + align4(w);
+   y2 = glyph->region.y + align4(h);
+   if (glyph->region.x < page->dirty_x1)
+      page->dirty_x1 = glyph->region.x;
+   if (glyph->region.y < page->dirty_y1)
+      page->dirty_y1 = glyph->region.y;
+   if (x2 > page->dirty_x2)
+      page->dirty_x2 = x2;
+   if (y2 > page->dirty_y2)
+      page->dirty_y2 = y2;
+
+   return page->staging
+      + (glyph->region.y + 1) * *pitch
+      + (glyph->region.x + 1) * sizeof(int32_t);
+}
+
+
+static void copy_glyph_mono(int flags, FT_Face face,
+   unsigned char *glyph_data, int pitch)
 {
-   int pitch = font_data->page_lr->pitch;
    int x, y;
 
    for (y = 0; y < (int)face->glyph->bitmap.rows; y++) {
@@ -322,7 +749,7 @@ static void copy_glyph_mono(ALLEGRO_TTF_FONT_DATA *font_data, FT_Face face,
       unsigned char *dptr = glyph_data + pitch * y;
       int bit = 0;
 
-      if (font_data->flags & ALLEGRO_NO_PREMULTIPLIED_ALPHA) {
+      if (flags & ALLEGRO_NO_PREMULTIPLIED_ALPHA) {
          for (x = 0; x < (int)face->glyph->bitmap.width; x++) {
             unsigned char set = ((*ptr >> (7-bit)) & 1) ? 255 : 0;
             *dptr++ = 255;
@@ -352,17 +779,16 @@ static void copy_glyph_mono(ALLEGRO_TTF_FONT_DATA *font_data, FT_Face face,
 }
 
 
-static void copy_glyph_color(ALLEGRO_TTF_FONT_DATA *font_data, FT_Face face,
-   unsigned char *glyph_data)
+static void copy_glyph_color(int flags, FT_Face face,
+   unsigned char *glyph_data, int pitch)
 {
-   int pitch = font_data->page_lr->pitch;
    int x, y;
 
    for (y = 0; y < (int)face->glyph->bitmap.rows; y++) {
       unsigned char const *ptr = face->glyph->bitmap.buffer + face->glyph->bitmap.pitch * y;
       unsigned char *dptr = glyph_data + pitch * y;
 
-      if (font_data->flags & ALLEGRO_NO_PREMULTIPLIED_ALPHA) {
+      if (flags & ALLEGRO_NO_PREMULTIPLIED_ALPHA) {
          for (x = 0; x < (int)face->glyph->bitmap.width; x++) {
             unsigned char c = *ptr;
             *dptr++ = 255;
@@ -386,6 +812,215 @@ static void copy_glyph_color(ALLEGRO_TTF_FONT_DATA *font_data, FT_Face face,
 }
 
 
+/* Vector from a cell of a distance transform to the nearest seed. */
+typedef struct SDF_POINT
+{
+   short dx, dy;
+} SDF_POINT;
+
+#define SDF_FAR 9999
+
+
+static INLINE int sdf_dist2(SDF_POINT p)
+{
+   return p.dx * p.dx + p.dy * p.dy;
+}
+
+
+static INLINE void sdf_compare(SDF_POINT *grid, int w, int h, int x, int y,
+   int ox, int oy)
+{
+   SDF_POINT *p = &grid[y * w + x];
+   SDF_POINT q;
+
+   if (x + ox < 0 || x + ox >= w || y + oy < 0 || y + oy >= h)
+      return;
+
+   q = grid[(y + oy) * w + x + ox];
+   q.dx += ox;
+   q.dy += oy;
+   if (sdf_dist2(q) < sdf_dist2(*p))
+      *p = q;
+}
+
+
+/* Two pass 8-point sequential Euclidean distance transform. The seeds are
+ * the cells at (0, 0), all others start at SDF_FAR.
+ */
+static void sdf_propagate(SDF_POINT *grid, int w, int h)
+{
+   int x, y;
+
+   for (y = 0; y < h; y++) {
+      for (x = 0; x < w; x++) {
+         sdf_compare(grid, w, h, x, y, -1, 0);
+         sdf_compare(grid, w, h, x, y, 0, -1);
+         sdf_compare(grid, w, h, x, y, -1, -1);
+         sdf_compare(grid, w, h, x, y, 1, -1);
+      }
+      for (x = w - 1; x >= 0; x--)
+         sdf_compare(grid, w, h, x, y, 1, 0);
+   }
+
+   for (y = h - 1; y >= 0; y--) {
+      for (x = w - 1; x >= 0; x--) {
+         sdf_compare(grid, w, h, x, y, 1, 0);
+         sdf_compare(grid, w, h, x, y, 0, 1);
+         sdf_compare(grid, w, h, x, y, -1, 1);
+         sdf_compare(grid, w, h, x, y, 1, 1);
+      }
+      for (x = 0; x < w; x++)
+         sdf_compare(grid, w, h, x, y, -1, 0);
+   }
+}
+
+
+/* Turns the antialiased glyph into a signed distance field, spread pixels
+ * larger on every side. The distance is stored in the alpha channel, 0.5
+ * being the outline and 0 or 1 being spread pixels outside or inside it.
+ */
+static void copy_glyph_sdf(int flags, int spread, FT_Face face,
+   unsigned char *glyph_data, int pitch)
+{
+   FT_Bitmap const *bm = &face->glyph->bitmap;
+   int w = bm->width + 2 * spread;
+   int h = bm->rows + 2 * spread;
+   unsigned char *coverage = al_calloc(w * h, 1);
+   SDF_POINT *inside = al_malloc(w * h * sizeof *inside);
+   SDF_POINT *outside = al_malloc(w * h * sizeof *outside);
+   SDF_POINT seed = {0, 0};
+   SDF_POINT far = {SDF_FAR, SDF_FAR};
+   int x, y, i;
+
+   if (!coverage || !inside || !outside) {
+      ALLEGRO_ERROR("Out of memory for distance field of %dx%d glyph.\n",
+         w, h);
+      goto done;
+   }
+
+   for (y = 0; y < (int)bm->rows; y++) {
+      unsigned char const *ptr = bm->buffer + bm->pitch * y;
+      unsigned char *dptr = coverage + (y + spread) * w + spread;
+      for (x = 0; x < (int)bm->width; x++) {
+         if (bm->pixel_mode == FT_PIXEL_MODE_MONO)
+            dptr[x] = ((ptr[x >> 3] >> (7 - (x & 7))) & 1) ? 255 : 0;
+         else
+            dptr[x] = ptr[x];
+      }
+   }
+
+   /* Distances to the nearest cell inside and outside the glyph. */
+   for (i = 0; i < w * h; i++) {
+      bool in = coverage[i] >= 128;
+      inside[i] = in ? seed : far;
+      outside[i] = in ? far : seed;
+   }
+   sdf_propagate(inside, w, h);
+   sdf_propagate(outside, w, h);
+
+   for (y = 0; y < h; y++) {
+      unsigned char *dptr = glyph_data + pitch * y;
+      for (x = 0; x < w; x++) {
+         int c;
+         float d;
+         unsigned char v;
+
+         i = y * w + x;
+         c = coverage[i];
+         /* The outline runs through the partially covered cells. */
+         if (c > 0 && c < 255)
+            d = c / 255.0f - 0.5f;
+         else if (c >= 128)
+            d = sqrtf(sdf_dist2(outside[i])) - 0.5f;
+         else
+            d = 0.5f - sqrtf(sdf_dist2(inside[i]));
+
+         d = 0.5f + d / (2 * spread);
+         if (d < 0)
+            d = 0;
+         if (d > 1)
+            d = 1;
+         v = d * 255 + 0.5f;
+
+         if (flags & ALLEGRO_NO_PREMULTIPLIED_ALPHA) {
+            *dptr++ = 255;
+            *dptr++ = 255;
+            *dptr++ = 255;
+         }
+         else {
+            *dptr++ = v;
+            *dptr++ = v;
+            *dptr++ = v;
+         }
+         *dptr++ = v;
+      }
+   }
+
+done:
+   al_free(coverage);
+   al_free(inside);
+   al_free(outside);
+}
+
+
+/* Copy the glyph FreeType rendered into a region of w * h pixels as
+ * returned by get_glyph_region_size.
+ */
+static void copy_glyph(ALLEGRO_TTF_FONT_DATA const *font_data, FT_Face face,
+   unsigned char *glyph_data, int pitch)
+{
+   if (font_data->sdf_spread)
+      copy_glyph_sdf(font_data->flags, font_data->sdf_spread, face,
+         glyph_data, pitch);
+   else if (font_data->flags & ALLEGRO_TTF_MONOCHROME)
+      copy_glyph_mono(font_data->flags, face, glyph_data, pitch);
+   else
+      copy_glyph_color(font_data->flags, face, glyph_data, pitch);
+}
+
+
+/* Size and offset of the pixels copy_glyph makes of the glyph FreeType
+ * rendered. Returns false if there are none.
+ */
+static bool get_glyph_region_size(ALLEGRO_TTF_FONT_DATA const *font_data,
+   FT_Face face, int *w, int *h, short *offset_x, short *offset_y)
+{
+   *w = face->glyph->bitmap.width;
+   *h = face->glyph->bitmap.rows;
+   *offset_x = face->glyph->bitmap_left;
+   *offset_y = (font_data->size->metrics.ascender >> 6) -
+      face->glyph->bitmap_top;
+
+   if (*w == 0 || *h == 0)
+      return false;
+
+   *w += 2 * font_data->sdf_spread;
+   *h += 2 * font_data->sdf_spread;
+   *offset_x -= font_data->sdf_spread;
+   *offset_y -= font_data->sdf_spread;
+   return true;
+}
+
+
+static FT_Int32 get_load_flags(ALLEGRO_TTF_FONT_DATA const *font_data)
+{
+    FT_Int32 ft_load_flags;
+
+    // FIXME: make this a config setting? FT_LOAD_FORCE_AUTOHINT
+
+    // FIXME: Investigate why some fonts don't work without the
+    // NO_BITMAP flags. Supposedly using that flag makes small sizes
+    // look bad so ideally we would not used it.
+    ft_load_flags = FT_LOAD_RENDER | FT_LOAD_NO_BITMAP;
+    if ((font_data->flags & ALLEGRO_TTF_MONOCHROME) && !font_data->sdf_spread)
+       ft_load_flags |= FT_LOAD_TARGET_MONO;
+    if (font_data->flags & ALLEGRO_TTF_NO_AUTOHINT)
+       ft_load_flags |= FT_LOAD_NO_AUTOHINT;
+
+    return ft_load_flags;
+}
+
+
 /* NOTE: this function may disable the bitmap hold drawing state
  * and leave the current page bitmap locked.
  * 
@@ -395,108 +1030,426 @@ static void copy_glyph_color(ALLEGRO_TTF_FONT_DATA *font_data, FT_Face face,
 static void cache_glyph(ALLEGRO_TTF_FONT_DATA *font_data, FT_Face face,
    int ft_index, ALLEGRO_TTF_GLYPH_DATA *glyph, bool lock_whole_page)
 {
-    FT_Int32 ft_load_flags;
     FT_Error e;
     int w, h;
     unsigned char *glyph_data;
+    int pitch;
 
-    if (glyph->page_bitmap || glyph->region.x < 0)
+    if (glyph->page || glyph->region.x < 0) {
+        font_data->hits++;
         return;
+    }
+    font_data->misses++;
    
     /* We shouldn't ever get here, as cache misses
      * should have been set to ft_index = 0. */
     ASSERT(!(font_data->skip_cache_misses && !lock_whole_page));
 
-    // FIXME: make this a config setting? FT_LOAD_FORCE_AUTOHINT
-
-    // FIXME: Investigate why some fonts don't work without the
-    // NO_BITMAP flags. Supposedly using that flag makes small sizes
-    // look bad so ideally we would not used it.
-    ft_load_flags = FT_LOAD_RENDER | FT_LOAD_NO_BITMAP;
-    if (font_data->flags & ALLEGRO_TTF_MONOCHROME)
-       ft_load_flags |= FT_LOAD_TARGET_MONO;
-    if (font_data->flags & ALLEGRO_TTF_NO_AUTOHINT)
-       ft_load_flags |= FT_LOAD_NO_AUTOHINT;
+    lock_face(font_data);
 
-    e = FT_Load_Glyph(face, ft_index, ft_load_flags);
+    e = FT_Load_Glyph(face, ft_index, get_load_flags(font_data));
     if (e) {
        ALLEGRO_WARN("Failed loading glyph %d from.\n", ft_index);
     }
 
-    glyph->offset_x = face->glyph->bitmap_left;
-    glyph->offset_y = (face->size->metrics.ascender >> 6) - face->glyph->bitmap_top;
     glyph->advance = face->glyph->advance.x >> 6;
 
-    w = face->glyph->bitmap.width;
-    h = face->glyph->bitmap.rows;
-
-    if (w == 0 || h == 0) {
+    if (!get_glyph_region_size(font_data, face, &w, &h,
+          &glyph->offset_x, &glyph->offset_y)) {
        /* Mark this glyph so we won't try to cache it next time. */
        glyph->region.x = -1;
        glyph->region.y = -1;
        ALLEGRO_DEBUG("Glyph %d has zero size.\n", ft_index);
+       unlock_face(font_data);
        return;
     }
 
     /* Each glyph has a 1-pixel border all around. Note: The border is kept
      * even against the outer bitmap edge, to ensure consistent rendering.
      */
-    glyph_data = alloc_glyph_region(font_data, ft_index,
-       w + 2, h + 2, false, glyph, lock_whole_page);
+    if (font_data->async) {
+       glyph_data = stage_glyph_region(font_data, ft_index,
+          w + 2, h + 2, glyph, &pitch);
+    }
+    else {
+       glyph_data = alloc_glyph_region(font_data, ft_index,
+          w + 2, h + 2, glyph, lock_whole_page);
+       pitch = glyph_data ? font_data->page_lr->pitch : 0;
+    }
+
+    if (glyph_data == NULL) {
+       unlock_face(font_data);
+       return;
+    }
+
+    copy_glyph(font_data, face, glyph_data, pitch);
+
+    unlock_face(font_data);
+
+    /* Staged glyphs are uploaded together at the start of the next draw
+     * call, see flush_ready_glyphs.
+     */
+    if (!lock_whole_page && !font_data->async) {
+       unlock_current_page(font_data);
+    }
+}
+
+/* WARNING: It is only valid to call this function when the current page is empty
+ * (or already locked), otherwise it will gibberify the current glyphs on that page.
+ * 
+ * This leaves the current page unlocked.
+ */
+static void cache_glyphs(ALLEGRO_TTF_FONT_DATA *data, const char *text, size_t text_size)
+{
+   ALLEGRO_USTR_INFO info;
+   const ALLEGRO_USTR* ustr = al_ref_buffer(&info, text, text_size);
+   FT_Face face = data->face;
+   int pos = 0;
+   int32_t ch;  
+
+   while ((ch = al_ustr_get_next(ustr, &pos)) >= 0) {
+      ALLEGRO_TTF_GLYPH_DATA *glyph;
+      int ft_index = get_char_index(data, ch);
+      get_glyph(data, ft_index, &glyph);
+      cache_glyph(data, face, ft_index, glyph, true);
+   }
+}
+
+
+/* glyph_job_proc: [worker thread]
+ *  Rasterize a glyph for an async font into its own buffer, for
+ *  flush_ready_glyphs to put on a page.
+ */
+static void glyph_job_proc(void *arg)
+{
+   GLYPH_JOB *job = arg;
+   ALLEGRO_TTF_FONT_DATA *data = job->font_data;
+   FT_Face face = data->face;
+
+   lock_face(data);
+
+   if (FT_Load_Glyph(face, job->ft_index, get_load_flags(data))) {
+      ALLEGRO_WARN("Failed loading glyph %d from.\n", job->ft_index);
+   }
+
+   job->advance = face->glyph->advance.x >> 6;
+
+   if (get_glyph_region_size(data, face, &job->w, &job->h,
+         &job->offset_x, &job->offset_y)) {
+      job->pixels = al_malloc(job->w * job->h * 4);
+      if (job->pixels)
+         copy_glyph(data, face, job->pixels, job->w * 4);
+   }
+
+   unlock_face(data);
+
+   _al_mutex_lock(&data->async_mutex);
+   *(GLYPH_JOB **)_al_vector_alloc_back(&data->ready_glyphs) = job;
+   data->pending_glyphs--;
+   _al_cond_broadcast(&data->async_cond);
+   _al_mutex_unlock(&data->async_mutex);
+}
+
+
+/* Have a glyph rasterized in the background. Only its advance is known
+ * right away.
+ */
+static void queue_glyph(ALLEGRO_TTF_FONT_DATA *data, int ft_index,
+   ALLEGRO_TTF_GLYPH_DATA *glyph)
+{
+   GLYPH_JOB *job;
+   FT_Fixed advance;
+
+   job = al_calloc(1, sizeof *job);
+   if (!job) {
+      cache_glyph(data, data->face, ft_index, glyph, false);
+      return;
+   }
+   job->font_data = data;
+   job->ft_index = ft_index;
+
+   lock_face(data);
+   if (FT_Get_Advance(data->face, ft_index,
+         get_load_flags(data) & ~FT_LOAD_RENDER, &advance)) {
+      advance = 0;
+   }
+   unlock_face(data);
+
+   glyph->advance = advance >> 16;
+   glyph->pending = true;
+
+   _al_mutex_lock(&data->async_mutex);
+   data->pending_glyphs++;
+   _al_mutex_unlock(&data->async_mutex);
+
+   _al_queue_worker_job(glyph_job_proc, job);
+}
+
+
+/* Put the glyphs rasterized since the last call on the pages. */
+static void flush_ready_glyphs(ALLEGRO_TTF_FONT_DATA *data)
+{
+   _AL_VECTOR ready;
+   unsigned int i;
+
+   if (!data->async)
+      return;
+
+   _al_mutex_lock(&data->async_mutex);
+   if (_al_vector_is_empty(&data->ready_glyphs)) {
+      _al_mutex_unlock(&data->async_mutex);
+      /* Glyphs cached to get their dimensions may still be staged. */
+      unlock_current_page(data);
+      return;
+   }
+   ready = data->ready_glyphs;
+   _al_vector_init(&data->ready_glyphs, sizeof(GLYPH_JOB *));
+   _al_mutex_unlock(&data->async_mutex);
+
+   for (i = 0; i < _al_vector_size(&ready); i++) {
+      GLYPH_JOB *job = *(GLYPH_JOB **)_al_vector_ref(&ready, i);
+      ALLEGRO_TTF_GLYPH_DATA *glyph;
+
+      get_glyph(data, job->ft_index, &glyph);
+      glyph->pending = false;
+
+      /* It may have been cached in the meantime to get its dimensions. */
+      if (!glyph->page && glyph->region.x >= 0) {
+         glyph->offset_x = job->offset_x;
+         glyph->offset_y = job->offset_y;
+         glyph->advance = job->advance;
+
+         if (!job->pixels) {
+            glyph->region.x = -1;
+            glyph->region.y = -1;
+         }
+         else {
+            int pitch;
+            unsigned char *glyph_data = stage_glyph_region(data,
+               job->ft_index, job->w + 2, job->h + 2, glyph, &pitch);
+            int y;
+            if (glyph_data) {
+               for (y = 0; y < job->h; y++) {
+                  memcpy(glyph_data + y * pitch,
+                     job->pixels + y * job->w * 4, job->w * 4);
+               }
+            }
+         }
+      }
+
+      al_free(job->pixels);
+      al_free(job);
+   }
+
+   _al_vector_free(&ready);
+   unlock_current_page(data);
+   data->generation++;
+}
+
+
+/* Make sure a glyph will be drawn, now or once it is ready. */
+static void prepare_glyph(ALLEGRO_TTF_FONT_DATA *data, FT_Face face,
+   int ft_index, ALLEGRO_TTF_GLYPH_DATA *glyph)
+{
+   if (!data->async) {
+      cache_glyph(data, face, ft_index, glyph, false);
+   }
+   else if (glyph->page || glyph->region.x < 0) {
+      data->hits++;
+   }
+   else if (!glyph->pending) {
+      data->misses++;
+      queue_glyph(data, ft_index, glyph);
+   }
+}
+
+
+static int get_kerning(ALLEGRO_TTF_FONT_DATA const *data, FT_Face face,
+   int prev_ft_index, int ft_index)
+{
+   /* Do kerning? */
+   if (!(data->flags & ALLEGRO_TTF_NO_KERNING) && prev_ft_index != -1) {
+      FT_Vector delta;
+      lock_face(data);
+      FT_Get_Kerning(face, prev_ft_index, ft_index,
+         FT_KERNING_DEFAULT, &delta);
+      unlock_face(data);
+      return delta.x >> 6;
+   }
+
+   return 0;
+}
+
+
+static INLINE float sdf_smoothstep(float e0, float e1, float x)
+{
+   float t = (x - e0) / (e1 - e0);
+   if (t < 0)
+      t = 0;
+   if (t > 1)
+      t = 1;
+   return t * t * (3 - 2 * t);
+}
+
+
+static bool make_sdf_scratch(ALLEGRO_TTF_FONT_DATA *data, int w, int h)
+{
+   ALLEGRO_STATE state;
+
+   if (data->sdf_scratch) {
+      if (al_get_bitmap_width(data->sdf_scratch) >= w &&
+            al_get_bitmap_height(data->sdf_scratch) >= h)
+         return true;
+      w = _ALLEGRO_MAX(w, al_get_bitmap_width(data->sdf_scratch));
+      h = _ALLEGRO_MAX(h, al_get_bitmap_height(data->sdf_scratch));
+      al_destroy_bitmap(data->sdf_scratch);
+   }
+
+   _al_push_destructor_owner();
+   al_store_state(&state, ALLEGRO_STATE_NEW_BITMAP_PARAMETERS);
+   al_set_new_bitmap_flags(ALLEGRO_MEMORY_BITMAP);
+   al_set_new_bitmap_format(ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE);
+   data->sdf_scratch = al_create_bitmap(w, h);
+   al_restore_state(&state);
+   _al_pop_destructor_owner();
+
+   return data->sdf_scratch != NULL;
+}
+
+
+/* Without the SDF shader each glyph is thresholded into a memory bitmap at
+ * the scale it is drawn at, which is then drawn at that scale.
+ */
+static void draw_sdf_quad_software(ALLEGRO_TTF_FONT_DATA *data,
+   _AL_BITMAP_QUAD const *q, float scale, float width)
+{
+   ALLEGRO_LOCKED_REGION *src, *dst;
+   int sw = q->sw, sh = q->sh;
+   int dw = ceilf(sw * scale);
+   int dh = ceilf(sh * scale);
+   int x, y;
+
+   if (dw <= 0 || dh <= 0 || !make_sdf_scratch(data, dw, dh))
+      return;
+
+   src = al_lock_bitmap_region(q->bitmap, q->sx, q->sy, sw, sh,
+      ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE, ALLEGRO_LOCK_READONLY);
+   if (!src)
+      return;
+   dst = al_lock_bitmap_region(data->sdf_scratch, 0, 0, dw, dh,
+      ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE, ALLEGRO_LOCK_WRITEONLY);
+   if (!dst) {
+      al_unlock_bitmap(q->bitmap);
+      return;
+   }
 
-    if (glyph_data == NULL) {
-       return;
-    }
+   for (y = 0; y < dh; y++) {
+      unsigned char *dptr = (unsigned char *)dst->data + y * dst->pitch;
+      float v = (y + 0.5f) / scale - 0.5f;
+      int y0 = floorf(v);
+      float fy = v - y0;
+      int y1 = _ALLEGRO_CLAMP(0, y0 + 1, sh - 1);
+      y0 = _ALLEGRO_CLAMP(0, y0, sh - 1);
+
+      for (x = 0; x < dw; x++) {
+         float u = (x + 0.5f) / scale - 0.5f;
+         int x0 = floorf(u);
+         float fx = u - x0;
+         int x1 = _ALLEGRO_CLAMP(0, x0 + 1, sw - 1);
+         unsigned char const *r0, *r1;
+         float d, a;
+         unsigned char c;
+         x0 = _ALLEGRO_CLAMP(0, x0, sw - 1);
+
+         /* Bilinear filtering of the distance, like the shader gets. */
+         r0 = (unsigned char const *)src->data + y0 * src->pitch + 3;
+         r1 = (unsigned char const *)src->data + y1 * src->pitch + 3;
+         d = (r0[x0 * 4] * (1 - fx) + r0[x1 * 4] * fx) * (1 - fy) +
+            (r1[x0 * 4] * (1 - fx) + r1[x1 * 4] * fx) * fy;
+         a = sdf_smoothstep(0.5f - width, 0.5f + width, d / 255.0f);
+         c = a * 255 + 0.5f;
+
+         if (data->flags & ALLEGRO_NO_PREMULTIPLIED_ALPHA) {
+            *dptr++ = 255;
+            *dptr++ = 255;
+            *dptr++ = 255;
+         }
+         else {
+            *dptr++ = c;
+            *dptr++ = c;
+            *dptr++ = c;
+         }
+         *dptr++ = c;
+      }
+   }
 
-    if (font_data->flags & ALLEGRO_TTF_MONOCHROME)
-       copy_glyph_mono(font_data, face, glyph_data);
-    else
-       copy_glyph_color(font_data, face, glyph_data);
+   al_unlock_bitmap(data->sdf_scratch);
+   al_unlock_bitmap(q->bitmap);
 
-    if (!lock_whole_page) {
-       unlock_current_page(font_data);
-    }
+   al_draw_tinted_scaled_bitmap(data->sdf_scratch, q->tint, 0, 0, dw, dh,
+      q->dx, q->dy, dw / scale, dh / scale, 0);
 }
 
-/* WARNING: It is only valid to call this function when the current page is empty
- * (or already locked), otherwise it will gibberify the current glyphs on that page.
- * 
- * This leaves the current page unlocked.
+
+/* Distance field glyphs are drawn with the SDF shader of the display if
+ * there is one, which gives sharp edges at any scale.
  */
-static void cache_glyphs(ALLEGRO_TTF_FONT_DATA *data, const char *text, size_t text_size)
+static void draw_sdf_quads(ALLEGRO_TTF_FONT_DATA *data,
+   _AL_BITMAP_QUAD const *quads, int num_quads)
 {
-   ALLEGRO_USTR_INFO info;
-   const ALLEGRO_USTR* ustr = al_ref_buffer(&info, text, text_size);
-   FT_Face face = data->face;
-   int pos = 0;
-   int32_t ch;  
+   ALLEGRO_BITMAP *target = al_get_target_bitmap();
+   ALLEGRO_TRANSFORM const *t = al_get_current_transform();
+   ALLEGRO_SHADER *shader = NULL;
+   float scale, width;
+   int i;
 
-   while ((ch = al_ustr_get_next(ustr, &pos)) >= 0) {
-      ALLEGRO_TTF_GLYPH_DATA *glyph;
-      int ft_index = FT_Get_Char_Index(face, ch);
-      get_glyph(data, ft_index, &glyph);
-      cache_glyph(data, face, ft_index, glyph, true);
+   scale = sqrtf(fabsf(t->m[0][0] * t->m[1][1] - t->m[0][1] * t->m[1][0]));
+   if (scale <= 0)
+      return;
+
+   /* Antialias over about one pixel of the target. */
+   width = 1.0f / (4 * data->sdf_spread * scale);
+   if (width > 0.5f)
+      width = 0.5f;
+
+   if (!(al_get_bitmap_flags(target) & ALLEGRO_MEMORY_BITMAP))
+      shader = _al_get_sdf_shader(_al_get_bitmap_display(target));
+
+   if (shader) {
+      ALLEGRO_SHADER *old_shader = target->shader;
+      bool held = al_is_bitmap_drawing_held();
+
+      /* Draw what was held with the shader it was held for. */
+      al_hold_bitmap_drawing(false);
+      if (al_use_shader(shader)) {
+         al_set_shader_float(_AL_SHADER_VAR_SDF_WIDTH, width);
+         _al_draw_bitmap_quads(quads, num_quads);
+         al_use_shader(old_shader);
+         al_hold_bitmap_drawing(held);
+         return;
+      }
+      al_use_shader(old_shader);
+      al_hold_bitmap_drawing(held);
    }
+
+   for (i = 0; i < num_quads; i++)
+      draw_sdf_quad_software(data, &quads[i], scale, width);
 }
 
 
-static int get_kerning(ALLEGRO_TTF_FONT_DATA const *data, FT_Face face,
-   int prev_ft_index, int ft_index)
+static void flush_quads(ALLEGRO_TTF_FONT_DATA *data, QUAD_BATCH *batch)
 {
-   /* Do kerning? */
-   if (!(data->flags & ALLEGRO_TTF_NO_KERNING) && prev_ft_index != -1) {
-      FT_Vector delta;
-      FT_Get_Kerning(face, prev_ft_index, ft_index,
-         FT_KERNING_DEFAULT, &delta);
-      return delta.x >> 6;
-   }
-
-   return 0;
+   if (data->sdf_spread)
+      draw_sdf_quads(data, batch->quads, batch->count);
+   else
+      _al_draw_bitmap_quads(batch->quads, batch->count);
+   batch->count = 0;
 }
 
 
 static int render_glyph(ALLEGRO_FONT const *f, ALLEGRO_COLOR color,
-   int prev_ft_index, int ft_index, int32_t ch, float xpos, float ypos)
+   int prev_ft_index, int ft_index, int32_t ch, float xpos, float ypos,
+   QUAD_BATCH *batch)
 {
    ALLEGRO_TTF_FONT_DATA *data = f->data;
    FT_Face face = data->face;
@@ -514,17 +1467,25 @@ static int render_glyph(ALLEGRO_FONT const *f, ALLEGRO_COLOR color,
          ft_index = 0;
       }
    }
-   cache_glyph(data, face, ft_index, glyph, false);
+   prepare_glyph(data, face, ft_index, glyph);
 
    advance += get_kerning(data, face, prev_ft_index, ft_index);
 
-   if (glyph->page_bitmap) {
+   if (glyph->page) {
+      _AL_BITMAP_QUAD *quad;
+      glyph->page->last_used = data->use_tick;
+      if (batch->count == QUAD_BATCH_SIZE)
+         flush_quads(data, batch);
+      quad = &batch->quads[batch->count++];
       /* Each glyph has a 1-pixel border all around. */
-      al_draw_tinted_bitmap_region(glyph->page_bitmap, color,
-         glyph->region.x + 1, glyph->region.y + 1,
-         glyph->region.w - 2, glyph->region.h - 2,
-         xpos + glyph->offset_x + advance,
-         ypos + glyph->offset_y, 0);
+      quad->bitmap = glyph->page->bitmap;
+      quad->sx = glyph->region.x + 1;
+      quad->sy = glyph->region.y + 1;
+      quad->sw = glyph->region.w - 2;
+      quad->sh = glyph->region.h - 2;
+      quad->dx = xpos + glyph->offset_x + advance;
+      quad->dy = ypos + glyph->offset_y;
+      quad->tint = color;
    }
    else if (glyph->region.x > 0) {
       ALLEGRO_ERROR("Glyph %d not on any page.\n", ft_index);
@@ -546,28 +1507,24 @@ static int ttf_font_height(ALLEGRO_FONT const *f)
 static int ttf_font_ascent(ALLEGRO_FONT const *f)
 {
     ALLEGRO_TTF_FONT_DATA *data;
-    FT_Face face;
 
     ASSERT(f);
 
     data = f->data;
-    face = data->face;
 
-    return face->size->metrics.ascender >> 6;
+    return data->size->metrics.ascender >> 6;
 }
 
 
 static int ttf_font_descent(ALLEGRO_FONT const *f)
 {
     ALLEGRO_TTF_FONT_DATA *data;
-    FT_Face face;
 
     ASSERT(f);
 
     data = f->data;
-    face = data->face;
 
-    return (-face->size->metrics.descender) >> 6;
+    return (-data->size->metrics.descender) >> 6;
 }
 
 
@@ -575,12 +1532,16 @@ static int ttf_render_char(ALLEGRO_FONT const *f, ALLEGRO_COLOR color,
    int ch, float xpos, float ypos)
 {
    ALLEGRO_TTF_FONT_DATA *data = f->data;
-   FT_Face face = data->face;
    int advance = 0;
    int32_t ch32 = (int32_t) ch;
    
-   int ft_index = FT_Get_Char_Index(face, ch32);
-   advance = render_glyph(f, color, -1, ft_index, ch, xpos, ypos);
+   int ft_index = get_char_index(data, ch32);
+   QUAD_BATCH batch;
+   batch.count = 0;
+   flush_ready_glyphs(data);
+   advance = render_glyph(f, color, -1, ft_index, ch, xpos, ypos, &batch);
+   flush_quads(data, &batch);
+   data->use_tick++;
    
    return advance;
 }
@@ -592,7 +1553,7 @@ static int ttf_char_length(ALLEGRO_FONT const *f, int ch)
    ALLEGRO_TTF_FONT_DATA *data = f->data;
    ALLEGRO_TTF_GLYPH_DATA *glyph;
    FT_Face face = data->face;   
-   int ft_index = FT_Get_Char_Index(face, ch);
+   int ft_index = get_char_index(data, ch);
    if (!get_glyph(data, ft_index, &glyph)) {
       if (f->fallback) {
          return al_get_glyph_width(f, ch);
@@ -604,6 +1565,8 @@ static int ttf_char_length(ALLEGRO_FONT const *f, int ch)
    }
    cache_glyph(data, face, ft_index, glyph, false);
    result = glyph->region.w - 2;
+   if (glyph->region.w > 0)
+      result -= 2 * data->sdf_spread;
      
    return result;
 }
@@ -613,25 +1576,32 @@ static int ttf_render(ALLEGRO_FONT const *f, ALLEGRO_COLOR color,
    const ALLEGRO_USTR *text, float x, float y)
 {
    ALLEGRO_TTF_FONT_DATA *data = f->data;
-   FT_Face face = data->face;
    int pos = 0;
    int advance = 0;
    int prev_ft_index = -1;
    int32_t ch;
    bool hold;
+   QUAD_BATCH batch;
+
+   batch.count = 0;
+   flush_ready_glyphs(data);
 
    hold = al_is_bitmap_drawing_held();
    al_hold_bitmap_drawing(true);
 
    while ((ch = al_ustr_get_next(text, &pos)) >= 0) {
-      int ft_index = FT_Get_Char_Index(face, ch);
+      int ft_index = get_char_index(data, ch);
       advance += render_glyph(f, color, prev_ft_index, ft_index, ch,
-         x + advance, y);
+         x + advance, y, &batch);
       prev_ft_index = ft_index;
    }
 
+   flush_quads(data, &batch);
    al_hold_bitmap_drawing(hold);
 
+   /* The pages used from here on are used by a different draw call. */
+   data->use_tick++;
+
    return advance;
 }
 
@@ -699,16 +1669,16 @@ static void ttf_get_text_dimensions(ALLEGRO_FONT const *f,
 static void debug_cache(ALLEGRO_FONT *f)
 {
    ALLEGRO_TTF_FONT_DATA *data = f->data;
-   _AL_VECTOR *v = &data->page_bitmaps;
+   _AL_VECTOR *v = &data->pages;
    static int j = 0;
    int i;
 
    al_init_image_addon();
 
    for (i = 0; i < (int)_al_vector_size(v); i++) {
-      ALLEGRO_BITMAP **bmp = _al_vector_ref(v, i);
+      TTF_PAGE **page = _al_vector_ref(v, i);
       ALLEGRO_USTR *u = al_ustr_newf("font%d_%d.png", j, i);
-      al_save_bitmap(al_cstr(u), *bmp);
+      al_save_bitmap(al_cstr(u), (*page)->bitmap);
       al_ustr_free(u);
    }
    j++;
@@ -716,76 +1686,321 @@ static void debug_cache(ALLEGRO_FONT *f)
 #endif
 
 
-static void ttf_destroy(ALLEGRO_FONT *f)
+/* FNV-1a, to tell apart font files loaded through file handles. */
+static uint32_t hash_font_data(unsigned char const *p, size_t size)
 {
-   ALLEGRO_TTF_FONT_DATA *data = f->data;
-   int i;
+   uint32_t hash = 2166136261u;
+   size_t i;
 
-   unlock_current_page(data);
+   for (i = 0; i < size; i++) {
+      hash ^= p[i];
+      hash *= 16777619u;
+   }
 
-#ifdef DEBUG_CACHE
-   debug_cache(f);
-#endif
+   return hash;
+}
 
-   FT_Done_Face(data->face);
-   for (i = _al_vector_size(&data->glyph_ranges) - 1; i >= 0; i--) {
-      ALLEGRO_TTF_GLYPH_RANGE *range = _al_vector_ref(&data->glyph_ranges, i);
-      al_free(range->glyphs);
+
+/* Read everything from the current position to the end of the file. */
+static unsigned char *read_font_data(ALLEGRO_FILE *file, size_t *size)
+{
+   int64_t file_size = al_fsize(file);
+   int64_t pos = al_ftell(file);
+   size_t capacity;
+   size_t n = 0;
+   unsigned char *buf;
+
+   if (file_size >= 0 && pos >= 0 && file_size >= pos) {
+      capacity = file_size - pos;
+      buf = al_malloc(capacity > 0 ? capacity : 1);
+      if (!buf)
+         return NULL;
+      n = al_fread(file, buf, capacity);
    }
-   _al_vector_free(&data->glyph_ranges);
-   for (i = _al_vector_size(&data->page_bitmaps) - 1; i >= 0; i--) {
-      ALLEGRO_BITMAP **bmp = _al_vector_ref(&data->page_bitmaps, i);
-      al_destroy_bitmap(*bmp);
+   else {
+      /* Unknown size, read until the end. */
+      capacity = 64 * 1024;
+      buf = al_malloc(capacity);
+      if (!buf)
+         return NULL;
+      for (;;) {
+         unsigned char *grown;
+         n += al_fread(file, buf + n, capacity - n);
+         if (n < capacity)
+            break;
+         grown = al_realloc(buf, capacity * 2);
+         if (!grown) {
+            al_free(buf);
+            return NULL;
+         }
+         buf = grown;
+         capacity *= 2;
+      }
    }
-   _al_vector_free(&data->page_bitmaps);
-   al_free(data);
-   al_free(f);
+
+   if (n == 0 || al_ferror(file)) {
+      al_free(buf);
+      return NULL;
+   }
+
+   *size = n;
+   return buf;
+}
+
+
+/* Returns the face last loaded from filename with a new reference, if the
+ * file still has the same size and modification time.
+ * Call with faces_mutex held.
+ */
+static TTF_FACE *find_face_by_name(char const *filename, int face_index,
+   size_t size, time_t mtime)
+{
+   unsigned int i;
+
+   for (i = 0; i < _al_vector_size(&faces); i++) {
+      TTF_FACE *shared = *(TTF_FACE **)_al_vector_ref(&faces, i);
+      if (shared->filename && shared->face_index == face_index &&
+            shared->file_size == size && shared->mtime == mtime &&
+            !strcmp(shared->filename, filename)) {
+         shared->refcount++;
+         return shared;
+      }
+   }
+
+   return NULL;
 }
 
 
-static unsigned long ftread(FT_Stream stream, unsigned long offset,
-    unsigned char *buffer, unsigned long count)
+/* Returns a face loaded from the same data with a new reference.
+ * Call with faces_mutex held.
+ */
+static TTF_FACE *find_face_by_data(unsigned char const *file_data,
+   size_t size, uint32_t hash, int face_index)
 {
-    ALLEGRO_TTF_FONT_DATA *data = stream->pathname.pointer;
-    unsigned long bytes;
+   unsigned int i;
+
+   for (i = 0; i < _al_vector_size(&faces); i++) {
+      TTF_FACE *shared = *(TTF_FACE **)_al_vector_ref(&faces, i);
+      if (shared->face_index == face_index && shared->hash == hash &&
+            shared->file_size == size &&
+            !memcmp(shared->file_data, file_data, size)) {
+         shared->refcount++;
+         return shared;
+      }
+   }
+
+   return NULL;
+}
 
-    if (count == 0)
-       return 0;
 
-    if (offset != data->offset)
-       al_fseek(data->file, data->base_offset + offset, ALLEGRO_SEEK_SET);
-    bytes = al_fread(data->file, buffer, count);
-    data->offset = offset + bytes;
-    return bytes;
+static void set_face_name(TTF_FACE *shared, char const *filename,
+   time_t mtime)
+{
+   al_free(shared->filename);
+   shared->filename = al_malloc(strlen(filename) + 1);
+   if (shared->filename)
+      strcpy(shared->filename, filename);
+   shared->mtime = mtime;
 }
 
 
-static void ftclose(FT_Stream  stream)
+/* Frees the font data, or closes the file it is in. */
+static void free_font_data(unsigned char *file_data, ALLEGRO_FILE *file)
 {
-    ALLEGRO_TTF_FONT_DATA *data = stream->pathname.pointer;
-    al_fclose(data->file);
-    data->file = NULL;
+   if (file)
+      al_fclose(file);
+   else
+      al_free(file_data);
 }
 
-/* Function: al_load_ttf_font_f
+
+/* Reads the font from the file and returns its shared face, creating it
+ * if no other font was loaded from the same data. The file is closed,
+ * unless it is a mapped file and the face uses its memory. Memfiles and
+ * slices are copied, as their memory belongs to the caller.
+ * If by_name is set, the face can later be found by filename and
+ * modification time without reading the file again.
  */
-ALLEGRO_FONT *al_load_ttf_font_f(ALLEGRO_FILE *file,
-    char const *filename, int size, int flags)
+static TTF_FACE *open_face_f(ALLEGRO_FILE *file, char const *filename,
+   bool by_name, time_t mtime)
 {
-    return al_load_ttf_font_stretch_f(file, filename, 0, size, flags);
+   TTF_FACE *shared;
+   unsigned char *file_data;
+   size_t size;
+   uint32_t hash;
+   ALLEGRO_PATH *path;
+   int result;
+
+   file_data = NULL;
+   if (_al_file_is_mapped(file))
+      file_data = (unsigned char *)al_fpeek_buffer(file, &size);
+   if (file_data && size > 0) {
+      ALLEGRO_DEBUG("Using %s in place.\n", filename);
+   }
+   else {
+      file_data = read_font_data(file, &size);
+      al_fclose(file);
+      file = NULL;
+      if (!file_data) {
+         ALLEGRO_ERROR("Reading %s failed.\n", filename);
+         return NULL;
+      }
+   }
+   hash = hash_font_data(file_data, size);
+
+   _al_mutex_lock(&faces_mutex);
+
+   shared = find_face_by_data(file_data, size, hash, 0);
+   if (shared) {
+      ALLEGRO_DEBUG("Sharing face of %s.\n", filename);
+      if (by_name)
+         set_face_name(shared, filename, mtime);
+      _al_mutex_unlock(&faces_mutex);
+      free_font_data(file_data, file);
+      return shared;
+   }
+
+   shared = al_calloc(1, sizeof *shared);
+   if (!shared) {
+      _al_mutex_unlock(&faces_mutex);
+      free_font_data(file_data, file);
+      return NULL;
+   }
+   shared->file_data = file_data;
+   shared->file_size = size;
+   shared->file = file;
+   shared->hash = hash;
+   shared->face_index = 0;
+   shared->refcount = 1;
+
+   result = FT_New_Memory_Face(ft, file_data, size, shared->face_index,
+      &shared->face);
+   if (result != 0) {
+      ALLEGRO_ERROR("Reading %s failed. Freetype error code %d\n", filename,
+        result);
+      _al_mutex_unlock(&faces_mutex);
+      free_font_data(file_data, file);
+      al_free(shared);
+      return NULL;
+   }
+
+   // FIXME: The below doesn't use Allegro's streaming.
+   /* Small hack for Type1 fonts which store kerning information in
+    * a separate file - and we try to guess the name of that file.
+    */
+   path = al_create_path(filename);
+   if (!strcmp(al_get_path_extension(path), ".pfa")) {
+       const char *helper;
+       ALLEGRO_DEBUG("Type1 font assumed for %s.\n", filename);
+
+       al_set_path_extension(path, ".afm");
+       helper = al_path_cstr(path, '/');
+       FT_Attach_File(shared->face, helper);
+       ALLEGRO_DEBUG("Guessed afm file %s.\n", helper);
+
+       al_set_path_extension(path, ".tfm");
+       helper = al_path_cstr(path, '/');
+       FT_Attach_File(shared->face, helper);
+       ALLEGRO_DEBUG("Guessed tfm file %s.\n", helper);
+   }
+   al_destroy_path(path);
+
+   if (by_name)
+      set_face_name(shared, filename, mtime);
+
+   _al_mutex_init(&shared->mutex);
+   *(TTF_FACE **)_al_vector_alloc_back(&faces) = shared;
+
+   _al_mutex_unlock(&faces_mutex);
+
+   return shared;
 }
 
 
-/* Function: al_load_ttf_font_stretch_f
+static void destroy_face(TTF_FACE *shared)
+{
+   FT_Done_Face(shared->face);
+   _al_mutex_destroy(&shared->mutex);
+   free_font_data(shared->file_data, shared->file);
+   al_free(shared->filename);
+   al_free(shared);
+}
+
+
+static void release_face(TTF_FACE *shared)
+{
+   bool last;
+
+   _al_mutex_lock(&faces_mutex);
+   last = (--shared->refcount == 0);
+   if (last)
+      _al_vector_find_and_delete(&faces, &shared);
+   _al_mutex_unlock(&faces_mutex);
+
+   if (last)
+      destroy_face(shared);
+}
+
+
+static void ttf_destroy(ALLEGRO_FONT *f)
+{
+   ALLEGRO_TTF_FONT_DATA *data = f->data;
+   int i;
+
+   if (data->async) {
+      /* The glyphs being rasterized refer to the font. */
+      _al_mutex_lock(&data->async_mutex);
+      while (data->pending_glyphs > 0)
+         _al_cond_wait(&data->async_cond, &data->async_mutex);
+      _al_mutex_unlock(&data->async_mutex);
+
+      for (i = _al_vector_size(&data->ready_glyphs) - 1; i >= 0; i--) {
+         GLYPH_JOB **job = _al_vector_ref(&data->ready_glyphs, i);
+         al_free((*job)->pixels);
+         al_free(*job);
+      }
+      _al_vector_free(&data->ready_glyphs);
+      _al_cond_destroy(&data->async_cond);
+      _al_mutex_destroy(&data->async_mutex);
+   }
+
+   unlock_current_page(data);
+
+#ifdef DEBUG_CACHE
+   debug_cache(f);
+#endif
+
+   lock_face(data);
+   FT_Done_Size(data->size);
+   if (data->async)
+      data->shared->async_fonts--;
+   unlock_face(data);
+   release_face(data->shared);
+
+   for (i = _al_vector_size(&data->glyph_ranges) - 1; i >= 0; i--) {
+      ALLEGRO_TTF_GLYPH_RANGE *range = _al_vector_ref(&data->glyph_ranges, i);
+      al_free(range->glyphs);
+   }
+   _al_vector_free(&data->glyph_ranges);
+   for (i = _al_vector_size(&data->pages) - 1; i >= 0; i--) {
+      TTF_PAGE **page = _al_vector_ref(&data->pages, i);
+      destroy_page(*page);
+   }
+   _al_vector_free(&data->pages);
+   al_destroy_bitmap(data->sdf_scratch);
+   al_free(data);
+   al_free(f);
+}
+
+
+/* Creates a font of the given size for the shared face. The reference to
+ * the face is taken over, and released if the font can't be created.
  */
-ALLEGRO_FONT *al_load_ttf_font_stretch_f(ALLEGRO_FILE *file,
-    char const *filename, int w, int h, int flags)
+static ALLEGRO_FONT *load_ttf_font(TTF_FACE *shared, char const *filename,
+    int w, int h, int flags)
 {
-    FT_Face face;
     ALLEGRO_TTF_FONT_DATA *data;
     ALLEGRO_FONT *f;
-    ALLEGRO_PATH *path;
-    FT_Open_Args args;
     int result;
     ALLEGRO_CONFIG* system_cfg = al_get_system_config();
     const char* min_page_size_str =
@@ -796,21 +2011,26 @@ ALLEGRO_FONT *al_load_ttf_font_stretch_f(ALLEGRO_FILE *file,
       al_get_config_value(system_cfg, "ttf", "cache_text");
     const char* skip_cache_misses_str = 
       al_get_config_value(system_cfg, "ttf", "skip_cache_misses");
+    const char* async_glyphs_str =
+      al_get_config_value(system_cfg, "ttf", "async_glyphs");
+    const char* max_cache_memory_str =
+      al_get_config_value(system_cfg, "ttf", "max_cache_memory");
 
     if ((h > 0 && w < 0) || (h < 0 && w > 0)) {
        ALLEGRO_ERROR("Height/width have opposite signs (w = %d, h = %d).\n", w, h);
+       release_face(shared);
        return NULL;
     }
 
     data = al_calloc(1, sizeof *data);
-    data->stream.read = ftread;
-    data->stream.close = ftclose;
-    data->stream.pathname.pointer = data;
-    data->base_offset = al_ftell(file);
-    data->stream.size = al_fsize(file);
-    data->file = file;
+    data->shared = shared;
+    data->face = shared->face;
     data->bitmap_format = al_get_new_bitmap_format();
     data->bitmap_flags = al_get_new_bitmap_flags();
+    if (flags & ALLEGRO_TTF_SDF) {
+       /* The distance field is meant to be interpolated. */
+       data->bitmap_flags |= ALLEGRO_MIN_LINEAR | ALLEGRO_MAG_LINEAR;
+    }
     data->min_page_size = 256;
     data->max_page_size = 8192;
 
@@ -832,41 +2052,43 @@ ALLEGRO_FONT *al_load_ttf_font_stretch_f(ALLEGRO_FILE *file,
        data->skip_cache_misses = true;
     }
 
-    memset(&args, 0, sizeof args);
-    args.flags = FT_OPEN_STREAM;
-    args.stream = &data->stream;
+    /* Evicted glyphs are not cached again when skipping cache misses. */
+    if (max_cache_memory_str && !data->skip_cache_misses) {
+      int max_cache_memory = atoi(max_cache_memory_str);
+      if (max_cache_memory > 0) {
+         data->max_cache_memory = max_cache_memory;
+      }
+    }
+
+    if (async_glyphs_str && !strcmp(async_glyphs_str, "true") &&
+          !data->skip_cache_misses) {
+       data->async = true;
+       _al_mutex_init(&data->async_mutex);
+       _al_cond_init(&data->async_cond);
+       _al_vector_init(&data->ready_glyphs, sizeof(GLYPH_JOB *));
+    }
 
-    if ((result = FT_Open_Face(ft, &args, 0, &face)) != 0) {
-        ALLEGRO_ERROR("Reading %s failed. Freetype error code %d\n", filename,
-          result);
-        // Note: Freetype already closed the file for us.
+    _al_mutex_lock(&shared->mutex);
+
+    if ((result = FT_New_Size(shared->face, &data->size)) != 0) {
+        ALLEGRO_ERROR("Creating size for %s failed. Freetype error code %d\n",
+          filename, result);
+        _al_mutex_unlock(&shared->mutex);
+        release_face(shared);
+        if (data->async) {
+           _al_vector_free(&data->ready_glyphs);
+           _al_cond_destroy(&data->async_cond);
+           _al_mutex_destroy(&data->async_mutex);
+        }
         al_free(data);
         return NULL;
     }
-
-    // FIXME: The below doesn't use Allegro's streaming.
-    /* Small hack for Type1 fonts which store kerning information in
-     * a separate file - and we try to guess the name of that file.
-     */
-    path = al_create_path(filename);
-    if (!strcmp(al_get_path_extension(path), ".pfa")) {
-        const char *helper;
-        ALLEGRO_DEBUG("Type1 font assumed for %s.\n", filename);
-
-        al_set_path_extension(path, ".afm");
-        helper = al_path_cstr(path, '/');
-        FT_Attach_File(face, helper);
-        ALLEGRO_DEBUG("Guessed afm file %s.\n", helper);
-
-        al_set_path_extension(path, ".tfm");
-        helper = al_path_cstr(path, '/');
-        FT_Attach_File(face, helper);
-        ALLEGRO_DEBUG("Guessed tfm file %s.\n", helper);
-    }
-    al_destroy_path(path);
+    FT_Activate_Size(data->size);
+    if (data->async)
+       shared->async_fonts++;
 
     if (h > 0) {
-       FT_Set_Pixel_Sizes(face, w, h);
+       FT_Set_Pixel_Sizes(shared->face, w, h);
     }
     else {
        /* Set the "real dimension" of the font to be the passed size,
@@ -880,21 +2102,28 @@ ALLEGRO_FONT *al_load_ttf_font_stretch_f(ALLEGRO_FILE *file,
        req.height = (-h) << 6;
        req.horiResolution = 0;
        req.vertResolution = 0;
-       FT_Request_Size(face, &req);
+       FT_Request_Size(shared->face, &req);
     }
 
+    _al_mutex_unlock(&shared->mutex);
+
     ALLEGRO_DEBUG("Font %s loaded with pixel size %d x %d.\n", filename,
         w, h);
     ALLEGRO_DEBUG("    ascent=%.1f, descent=%.1f, height=%.1f\n",
-        face->size->metrics.ascender / 64.0,
-        face->size->metrics.descender / 64.0,
-        face->size->metrics.height / 64.0);
+        data->size->metrics.ascender / 64.0,
+        data->size->metrics.descender / 64.0,
+        data->size->metrics.height / 64.0);
 
-    data->face = face;
     data->flags = flags;
+    if (flags & ALLEGRO_TTF_SDF) {
+       /* Distances up to an eighth of the line height are kept, which is
+        * enough to scale the glyphs up and down by a good factor.
+        */
+       data->sdf_spread = _ALLEGRO_MAX(2, (data->size->metrics.height >> 6) / 8);
+    }
 
     _al_vector_init(&data->glyph_ranges, sizeof(ALLEGRO_TTF_GLYPH_RANGE));
-    _al_vector_init(&data->page_bitmaps, sizeof(ALLEGRO_BITMAP*));
+    _al_vector_init(&data->pages, sizeof(TTF_PAGE *));
     
     if (data->skip_cache_misses) {
        cache_glyphs(data, "\0", 1);
@@ -905,8 +2134,8 @@ ALLEGRO_FONT *al_load_ttf_font_stretch_f(ALLEGRO_FILE *file,
     unlock_current_page(data);
 
     f = al_calloc(sizeof *f, 1);
-    f->height = face->size->metrics.height >> 6;
-    f->vtable = &vt;
+    f->height = data->size->metrics.height >> 6;
+    f->vtable = (flags & ALLEGRO_TTF_SDF) ? &vt_sdf : &vt;
     f->data = data;
 
     _al_register_destructor(_al_dtor_list, "ttf_font", f,
@@ -916,6 +2145,27 @@ ALLEGRO_FONT *al_load_ttf_font_stretch_f(ALLEGRO_FILE *file,
 }
 
 
+/* Function: al_load_ttf_font_f
+ */
+ALLEGRO_FONT *al_load_ttf_font_f(ALLEGRO_FILE *file,
+    char const *filename, int size, int flags)
+{
+    return al_load_ttf_font_stretch_f(file, filename, 0, size, flags);
+}
+
+
+/* Function: al_load_ttf_font_stretch_f
+ */
+ALLEGRO_FONT *al_load_ttf_font_stretch_f(ALLEGRO_FILE *file,
+    char const *filename, int w, int h, int flags)
+{
+    TTF_FACE *shared = open_face_f(file, filename, false, 0);
+    if (!shared)
+       return NULL;
+    return load_ttf_font(shared, filename, w, h, flags);
+}
+
+
 /* Function: al_load_ttf_font
  */
 ALLEGRO_FONT *al_load_ttf_font(char const *filename, int size, int flags)
@@ -929,21 +2179,40 @@ ALLEGRO_FONT *al_load_ttf_font(char const *filename, int size, int flags)
 ALLEGRO_FONT *al_load_ttf_font_stretch(char const *filename, int w, int h,
    int flags)
 {
+   ALLEGRO_FS_ENTRY *entry;
+   TTF_FACE *shared = NULL;
+   bool by_name = false;
+   time_t mtime = 0;
    ALLEGRO_FILE *f;
-   ALLEGRO_FONT *font;
    ASSERT(filename);
 
-   f = al_fopen(filename, "rb");
-   if (!f)
-      return NULL;
-
-   /* The file handle is owned by the function and the file is usually only
-    * closed when the font is destroyed, in case Freetype has to load data
-    * at a later time.
+   /* Fonts loaded from a file which hasn't changed since share its face,
+    * without reading the file again.
     */
-   font = al_load_ttf_font_stretch_f(f, filename, w, h, flags);
+   entry = al_create_fs_entry(filename);
+   if (entry) {
+      if (al_fs_entry_exists(entry)) {
+         by_name = true;
+         mtime = al_get_fs_entry_mtime(entry);
+         _al_mutex_lock(&faces_mutex);
+         shared = find_face_by_name(filename, 0,
+            (size_t)al_get_fs_entry_size(entry), mtime);
+         _al_mutex_unlock(&faces_mutex);
+      }
+      al_destroy_fs_entry(entry);
+   }
+
+   if (!shared) {
+      f = al_fopen(filename, "rb");
+      if (!f)
+         return NULL;
 
-   return font;
+      shared = open_face_f(f, filename, by_name, mtime);
+      if (!shared)
+         return NULL;
+   }
+
+   return load_ttf_font(shared, filename, w, h, flags);
 }
 
 
@@ -952,8 +2221,11 @@ static int ttf_get_font_ranges(ALLEGRO_FONT *font, int ranges_count,
 {
    ALLEGRO_TTF_FONT_DATA *data = font->data;
    FT_UInt g;
-   FT_ULong unicode = FT_Get_First_Char(data->face, &g);
+   FT_ULong unicode;
    int i = 0;
+
+   _al_mutex_lock(&data->shared->mutex);
+   unicode = FT_Get_First_Char(data->face, &g);
    if (i < ranges_count) {
       ranges[i * 2 + 0] = unicode;
       ranges[i * 2 + 1] = unicode;
@@ -974,6 +2246,7 @@ static int ttf_get_font_ranges(ALLEGRO_FONT *font, int ranges_count,
       }
       unicode = unicode2;
    }
+   _al_mutex_unlock(&data->shared->mutex);
    return i;
 }
 
@@ -984,7 +2257,7 @@ static bool ttf_get_glyph_dimensions(ALLEGRO_FONT const *f,
    ALLEGRO_TTF_FONT_DATA *data = f->data;
    ALLEGRO_TTF_GLYPH_DATA *glyph;
    FT_Face face = data->face;   
-   int ft_index = FT_Get_Char_Index(face, codepoint);
+   int ft_index = get_char_index(data, codepoint);
    if (!get_glyph(data, ft_index, &glyph)) {
       if (f->fallback) {
          return al_get_glyph_dimensions(f->fallback, codepoint,
@@ -1000,6 +2273,13 @@ static bool ttf_get_glyph_dimensions(ALLEGRO_FONT const *f,
    *bbw = glyph->region.w - 2;
    *bbh = glyph->region.h;
    *bby = glyph->offset_y;
+   if (glyph->region.w > 0) {
+      /* Leave out the distance field around the glyph. */
+      *bbx += data->sdf_spread;
+      *bby += data->sdf_spread;
+      *bbw -= 2 * data->sdf_spread;
+      *bbh -= 2 * data->sdf_spread;
+   }
       
    return true;
 }
@@ -1009,7 +2289,7 @@ static int ttf_get_glyph_advance(ALLEGRO_FONT const *f, int codepoint1,
 {
    ALLEGRO_TTF_FONT_DATA *data = f->data;
    FT_Face face = data->face;
-   int ft_index = FT_Get_Char_Index(face, codepoint1);
+   int ft_index = get_char_index(data, codepoint1);
    ALLEGRO_TTF_GLYPH_DATA *glyph; 
    int kerning = 0;
    int advance = 0;
@@ -1027,11 +2307,11 @@ static int ttf_get_glyph_advance(ALLEGRO_FONT const *f, int codepoint1,
          ft_index = 0;
       }
    }
-   cache_glyph(data, face, ft_index, glyph, false);
+   prepare_glyph(data, face, ft_index, glyph);
    
    if (codepoint2 != ALLEGRO_NO_KERNING) { 
-      int ft_index1 = FT_Get_Char_Index(face, codepoint1);
-      int ft_index2 = FT_Get_Char_Index(face, codepoint2); 
+      int ft_index1 = get_char_index(data, codepoint1);
+      int ft_index2 = get_char_index(data, codepoint2); 
       kerning = get_kerning(data, face, ft_index1, ft_index2);
    }
    
@@ -1040,6 +2320,130 @@ static int ttf_get_glyph_advance(ALLEGRO_FONT const *f, int codepoint1,
 }
 
 
+static bool ttf_get_glyph(ALLEGRO_FONT const *f, int prev_codepoint,
+   int codepoint, ALLEGRO_GLYPH *glyph)
+{
+   ALLEGRO_TTF_FONT_DATA *data = f->data;
+   FT_Face face = data->face;
+   ALLEGRO_TTF_GLYPH_DATA *g;
+   int ft_index = get_char_index(data, codepoint);
+   int prev_ft_index = -1;
+
+   if (!get_glyph(data, ft_index, &g)) {
+      if (f->fallback) {
+         return al_get_glyph(f->fallback, ALLEGRO_NO_KERNING, codepoint,
+            glyph);
+      }
+      else {
+         get_glyph(data, 0, &g);
+         ft_index = 0;
+      }
+   }
+   prepare_glyph(data, face, ft_index, g);
+
+   if (prev_codepoint != ALLEGRO_NO_KERNING)
+      prev_ft_index = get_char_index(data, prev_codepoint);
+
+   glyph->kerning = get_kerning(data, face, prev_ft_index, ft_index);
+   glyph->offset_x = g->offset_x;
+   glyph->offset_y = g->offset_y;
+   glyph->advance = g->advance;
+
+   if (g->page) {
+      /* The glyph may only be staged if it was cached for its dimensions. */
+      upload_staging(g->page);
+      g->page->last_used = data->use_tick;
+      /* Each glyph has a 1-pixel border all around. */
+      glyph->bitmap = g->page->bitmap;
+      glyph->x = g->region.x + 1;
+      glyph->y = g->region.y + 1;
+      glyph->w = g->region.w - 2;
+      glyph->h = g->region.h - 2;
+   }
+   else {
+      glyph->bitmap = NULL;
+      glyph->x = glyph->y = glyph->w = glyph->h = 0;
+   }
+
+   return true;
+}
+
+
+static void ttf_touch_glyph_bitmaps(ALLEGRO_FONT const *f,
+   ALLEGRO_BITMAP * const *bitmaps, int count)
+{
+   ALLEGRO_TTF_FONT_DATA *data = f->data;
+   ALLEGRO_FONT *fallback = f->fallback;
+   int i;
+   unsigned int j;
+
+   for (i = 0; i < count; i++) {
+      bool found = false;
+
+      for (j = 0; j < _al_vector_size(&data->pages); j++) {
+         TTF_PAGE **page = _al_vector_ref(&data->pages, j);
+         if ((*page)->bitmap == bitmaps[i]) {
+            (*page)->last_used = data->use_tick;
+            found = true;
+            break;
+         }
+      }
+
+      /* Glyphs missing from this font came from the fallback font. */
+      if (!found && fallback && fallback->vtable->touch_glyph_bitmaps)
+         fallback->vtable->touch_glyph_bitmaps(fallback, &bitmaps[i], 1);
+   }
+}
+
+
+static int ttf_get_cache_generation(ALLEGRO_FONT const *f)
+{
+   ALLEGRO_TTF_FONT_DATA *data = f->data;
+
+   flush_ready_glyphs(data);
+
+   /* Layouts call this before each draw, so like the end of ttf_render
+    * it starts a new use of the pages.
+    */
+   data->use_tick++;
+
+   return data->generation;
+}
+
+
+
+/* Function: al_get_ttf_cache_stats
+ */
+bool al_get_ttf_cache_stats(ALLEGRO_FONT const *font,
+   ALLEGRO_TTF_CACHE_STATS *stats)
+{
+   ALLEGRO_TTF_FONT_DATA *data;
+   int64_t area = 0;
+   int64_t used_area = 0;
+   unsigned int i;
+   ASSERT(font);
+   ASSERT(stats);
+
+   if (font->vtable != &vt && font->vtable != &vt_sdf)
+      return false;
+
+   data = font->data;
+   for (i = 0; i < _al_vector_size(&data->pages); i++) {
+      TTF_PAGE **page = _al_vector_ref(&data->pages, i);
+      area += al_get_bitmap_width((*page)->bitmap) *
+         al_get_bitmap_height((*page)->bitmap);
+      used_area += (*page)->used_area;
+   }
+
+   stats->pages = _al_vector_size(&data->pages);
+   stats->memory = data->cache_memory;
+   stats->fill_ratio = area > 0 ? (float)used_area / area : 0.0f;
+   stats->hits = data->hits;
+   stats->misses = data->misses;
+   stats->evictions = data->evictions;
+   return true;
+}
+
 
 /* Function: al_init_ttf_addon
  */
@@ -1051,6 +2455,7 @@ bool al_init_ttf_addon(void)
    }
 
    FT_Init_FreeType(&ft);
+   _al_mutex_init(&faces_mutex);
    vt.font_height = ttf_font_height;
    vt.font_ascent = ttf_font_ascent;
    vt.font_descent = ttf_font_descent;
@@ -1063,6 +2468,17 @@ bool al_init_ttf_addon(void)
    vt.get_font_ranges = ttf_get_font_ranges;
    vt.get_glyph_dimensions = ttf_get_glyph_dimensions;
    vt.get_glyph_advance = ttf_get_glyph_advance;
+   vt.get_glyph = ttf_get_glyph;
+   vt.get_cache_generation = ttf_get_cache_generation;
+   vt.touch_glyph_bitmaps = ttf_touch_glyph_bitmaps;
+
+   /* Text layouts draw the glyphs themselves, which would bypass the
+    * distance field shader, so they fall back to rendering through us.
+    */
+   vt_sdf = vt;
+   vt_sdf.get_glyph = NULL;
+   vt_sdf.get_cache_generation = NULL;
+   vt_sdf.touch_glyph_bitmaps = NULL;
 
    al_register_font_loader(".ttf", al_load_ttf_font);
 
@@ -1086,6 +2502,16 @@ void al_shutdown_ttf_addon(void)
 
    al_register_font_loader(".ttf", NULL);
 
+   while (!_al_vector_is_empty(&faces)) {
+      TTF_FACE **back = _al_vector_ref_back(&faces);
+      ALLEGRO_WARN("Face of %s still in use.\n",
+         (*back)->filename ? (*back)->filename : "font");
+      destroy_face(*back);
+      _al_vector_delete_at(&faces, _al_vector_size(&faces) - 1);
+   }
+   _al_vector_free(&faces);
+   _al_mutex_destroy(&faces_mutex);
+
    FT_Done_FreeType(ft);
 
    ttf_inited = false;
@@ -10,6 +10,7 @@ set(ALLEGRO_SRC_FILES
     src/clipboard.c
     src/config.c
     src/convert.c
+    src/convert_simd.c
     src/cpu.c
     src/debug.c
     src/display.c
@@ -20,10 +21,14 @@ set(ALLEGRO_SRC_FILES
     src/evtsrc.c
     src/exitfunc.c
     src/file.c
+    src/file_mmap.c
+    src/file_buffered.c
     src/file_slice.c
     src/file_stdio.c
     src/fshook.c
+    src/fshook_pack.c
     src/fshook_stdio.c
+    src/fshook_watch.c
     src/fullscreen_mode.c
     src/haptic.c
     src/inline.c
@@ -48,6 +53,7 @@ set(ALLEGRO_SRC_FILES
     src/transformations.c
     src/tri_soft.c
     src/utf8.c
+    src/workers.c
     src/misc/aatree.c
     src/misc/bstrlib.c
     src/misc/list.c
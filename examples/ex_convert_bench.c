@@ -0,0 +1,128 @@
+/*
+ *    Benchmark for the pixel format converters.
+ *
+ *    Every conversion is timed by locking a memory bitmap in a different
+ *    format. Set simd_converters=false in the [graphics] section of
+ *    allegro5.cfg to measure the plain C converters instead.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <allegro5/allegro.h>
+
+#include "common.c"
+
+#define WIDTH 1024
+#define HEIGHT 1024
+
+/* How many seconds to spend on each conversion. */
+#define TEST_TIME 0.25
+
+typedef struct FORMAT {
+   int format;
+   char const *name;
+} FORMAT;
+
+static FORMAT const src_formats[] = {
+   {ALLEGRO_PIXEL_FORMAT_ARGB_8888, "ARGB_8888"},
+   {ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE, "ABGR_8888_LE"},
+   {ALLEGRO_PIXEL_FORMAT_XRGB_8888, "XRGB_8888"},
+   {ALLEGRO_PIXEL_FORMAT_ABGR_F32, "ABGR_F32"}
+};
+
+static FORMAT const dst_formats[] = {
+   {ALLEGRO_PIXEL_FORMAT_ARGB_8888, "ARGB_8888"},
+   {ALLEGRO_PIXEL_FORMAT_RGBA_8888, "RGBA_8888"},
+   {ALLEGRO_PIXEL_FORMAT_ABGR_8888, "ABGR_8888"},
+   {ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE, "ABGR_8888_LE"},
+   {ALLEGRO_PIXEL_FORMAT_XRGB_8888, "XRGB_8888"},
+   {ALLEGRO_PIXEL_FORMAT_RGB_888, "RGB_888"},
+   {ALLEGRO_PIXEL_FORMAT_BGR_888, "BGR_888"},
+   {ALLEGRO_PIXEL_FORMAT_RGB_565, "RGB_565"},
+   {ALLEGRO_PIXEL_FORMAT_RGB_555, "RGB_555"},
+   {ALLEGRO_PIXEL_FORMAT_RGBA_4444, "RGBA_4444"},
+   {ALLEGRO_PIXEL_FORMAT_ABGR_F32, "ABGR_F32"}
+};
+
+#define NUM(x) ((int)(sizeof(x) / sizeof((x)[0])))
+
+static ALLEGRO_BITMAP *create_source(int format)
+{
+   ALLEGRO_BITMAP *bmp;
+   ALLEGRO_LOCKED_REGION *lr;
+   int x, y;
+
+   al_set_new_bitmap_flags(ALLEGRO_MEMORY_BITMAP);
+   al_set_new_bitmap_format(format);
+   bmp = al_create_bitmap(WIDTH, HEIGHT);
+   if (!bmp)
+      return NULL;
+
+   /* Fill in some noise so no conversion gets an easy time. */
+   lr = al_lock_bitmap(bmp, ALLEGRO_PIXEL_FORMAT_ABGR_F32,
+      ALLEGRO_LOCK_WRITEONLY);
+   for (y = 0; y < HEIGHT; y++) {
+      float *row = (float *)((char *)lr->data + y * lr->pitch);
+      for (x = 0; x < WIDTH * 4; x++) {
+         row[x] = (rand() & 255) / 255.0f;
+      }
+   }
+   al_unlock_bitmap(bmp);
+
+   return bmp;
+}
+
+static double bench(ALLEGRO_BITMAP *bmp, int dst_format)
+{
+   double t0, t1;
+   int n = 0;
+
+   t0 = al_get_time();
+   do {
+      if (!al_lock_bitmap(bmp, dst_format, ALLEGRO_LOCK_READONLY))
+         return 0;
+      al_unlock_bitmap(bmp);
+      n++;
+      t1 = al_get_time();
+   } while (t1 - t0 < TEST_TIME);
+
+   return (double)WIDTH * HEIGHT * n / (t1 - t0) / 1e9;
+}
+
+int main(int argc, char **argv)
+{
+   int i, j;
+
+   (void)argc;
+   (void)argv;
+
+   if (!al_init()) {
+      abort_example("Could not init Allegro.\n");
+   }
+
+   open_log_monospace();
+
+   log_printf("%-14s %-14s %12s\n", "From", "To", "Gpixels/s");
+
+   for (i = 0; i < NUM(src_formats); i++) {
+      ALLEGRO_BITMAP *bmp = create_source(src_formats[i].format);
+      if (!bmp) {
+         abort_example("Error creating %s bitmap.\n", src_formats[i].name);
+      }
+
+      for (j = 0; j < NUM(dst_formats); j++) {
+         if (dst_formats[j].format == src_formats[i].format)
+            continue;
+         log_printf("%-14s %-14s %12.3f\n", src_formats[i].name,
+            dst_formats[j].name, bench(bmp, dst_formats[j].format));
+      }
+
+      al_destroy_bitmap(bmp);
+   }
+
+   close_log(true);
+
+   return 0;
+}
+
+/* vim: set sts=3 sw=3 et: */
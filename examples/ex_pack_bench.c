@@ -0,0 +1,227 @@
+/*
+ *    Benchmark for packed archives.
+ *
+ *    The files of a directory are listed and read through the stdio file
+ *    system, from an archive made of the same directory with
+ *    tools/allegro_pack.c, and from a .zip of it with PhysicsFS if the
+ *    PhysFS addon is available.
+ *
+ *    Usage: ex_pack_bench directory archive [zip]
+ */
+
+#define ALLEGRO_UNSTABLE
+#include <stdio.h>
+#include <stdlib.h>
+#include <allegro5/allegro.h>
+
+#ifdef HAVE_PHYSFS
+#include <allegro5/allegro_physfs.h>
+#include <physfs.h>
+#endif
+
+#include "common.c"
+
+/* Each test is run this many times and the best time is kept. */
+#define RUNS 5
+
+typedef struct FILE_LIST {
+   char **names;
+   int count;
+   int size;
+   size_t prefix_len;
+} FILE_LIST;
+
+static FILE_LIST files;
+static int num_listed;
+
+static int list_file(ALLEGRO_FS_ENTRY *e, void *extra)
+{
+   FILE_LIST *list = extra;
+   const char *name = al_get_fs_entry_name(e);
+
+   if (al_get_fs_entry_mode(e) & ALLEGRO_FILEMODE_ISDIR)
+      return ALLEGRO_FOR_EACH_FS_ENTRY_OK;
+
+   num_listed++;
+   if (!list)
+      return ALLEGRO_FOR_EACH_FS_ENTRY_OK;
+
+   if (list->count == list->size) {
+      list->size = list->size ? list->size * 2 : 256;
+      list->names = realloc(list->names, list->size * sizeof(char *));
+   }
+   list->names[list->count++] = strdup(name + list->prefix_len);
+   return ALLEGRO_FOR_EACH_FS_ENTRY_OK;
+}
+
+/* Milliseconds to list all files below the root recursively. */
+static double list(const char *root, FILE_LIST *list)
+{
+   ALLEGRO_FS_ENTRY *e;
+   double t0, t1;
+
+   num_listed = 0;
+   t0 = al_get_time();
+   e = al_create_fs_entry(root);
+   if (list) {
+      /* Also skip the separator after the root. */
+      const char *name = al_get_fs_entry_name(e);
+      list->prefix_len = strlen(name);
+      if (list->prefix_len > 0 &&
+            name[list->prefix_len - 1] != ALLEGRO_NATIVE_PATH_SEP)
+         list->prefix_len++;
+   }
+   al_for_each_fs_entry(e, list_file, list);
+   al_destroy_fs_entry(e);
+   t1 = al_get_time();
+
+   return (t1 - t0) * 1000;
+}
+
+/* Microseconds to open and close each file, on average. */
+static double open_all(const char *prefix)
+{
+   char path[1024];
+   double t0, t1;
+   int i;
+
+   t0 = al_get_time();
+   for (i = 0; i < files.count; i++) {
+      ALLEGRO_FILE *f;
+      snprintf(path, sizeof(path), "%s%s", prefix, files.names[i]);
+      f = al_fopen(path, "rb");
+      if (!f) {
+         abort_example("Could not open %s.\n", path);
+      }
+      al_fclose(f);
+   }
+   t1 = al_get_time();
+
+   return (t1 - t0) * 1e6 / files.count;
+}
+
+/* Milliseconds to read all files, and a checksum of their contents. */
+static double read_all(const char *prefix, uint32_t *sum)
+{
+   static unsigned char buf[64 * 1024];
+   char path[1024];
+   double t0, t1;
+   int i;
+
+   *sum = 0;
+   t0 = al_get_time();
+   for (i = 0; i < files.count; i++) {
+      ALLEGRO_FILE *f;
+      size_t n, j;
+      snprintf(path, sizeof(path), "%s%s", prefix, files.names[i]);
+      f = al_fopen(path, "rb");
+      if (!f) {
+         abort_example("Could not open %s.\n", path);
+      }
+      while ((n = al_fread(f, buf, sizeof(buf))) > 0) {
+         for (j = 0; j < n; j += 64)
+            *sum = *sum * 31 + buf[j];
+      }
+      al_fclose(f);
+   }
+   t1 = al_get_time();
+
+   return (t1 - t0) * 1000;
+}
+
+static void bench(const char *name, const char *root, const char *prefix,
+   double mount)
+{
+   double best_list = 1e9, best_open = 1e9, best_read = 1e9;
+   uint32_t sum = 0;
+   int i;
+
+   for (i = 0; i < RUNS; i++) {
+      double t = list(root, NULL);
+      if (t < best_list)
+         best_list = t;
+      t = open_all(prefix);
+      if (t < best_open)
+         best_open = t;
+      t = read_all(prefix, &sum);
+      if (t < best_read)
+         best_read = t;
+   }
+
+   if (num_listed != files.count) {
+      log_printf("%s lists %d files instead of %d.\n", name, num_listed,
+         files.count);
+   }
+
+   log_printf("%-8s %10.3f %10.3f %12.3f %10.3f   %08x\n", name, mount,
+      best_list, best_open, best_read, sum);
+}
+
+int main(int argc, char **argv)
+{
+   ALLEGRO_PATH *dir;
+   const char *prefix;
+   double t0, t1;
+
+   if (argc < 3) {
+      abort_example("Usage: %s directory archive [zip]\n", argv[0]);
+   }
+
+   if (!al_init()) {
+      abort_example("Could not init Allegro.\n");
+   }
+
+   open_log_monospace();
+
+   /* The names of the files, relative to the directory. */
+   list(argv[1], &files);
+   if (files.count == 0) {
+      abort_example("No files in %s.\n", argv[1]);
+   }
+   dir = al_create_path_for_directory(argv[1]);
+   prefix = al_path_cstr(dir, '/');
+
+   log_printf("%d files, best of %d runs, the same checksum means the same "
+      "contents.\n\n", files.count, RUNS);
+   log_printf("%-8s %10s %10s %12s %10s   %s\n", "", "mount ms", "list ms",
+      "open us/file", "read ms", "checksum");
+
+   bench("stdio", argv[1], prefix, 0);
+
+   t0 = al_get_time();
+   if (!al_mount_pack(argv[2])) {
+      abort_example("Could not mount %s.\n", argv[2]);
+   }
+   t1 = al_get_time();
+   al_set_pack_file_interface();
+   bench("pack", "/", "/", (t1 - t0) * 1000);
+   al_unmount_pack(argv[2]);
+
+#ifdef HAVE_PHYSFS
+   if (argc > 3) {
+      PHYSFS_init(argv[0]);
+      t0 = al_get_time();
+      if (!PHYSFS_mount(argv[3], NULL, 1)) {
+         abort_example("Could not mount %s.\n", argv[3]);
+      }
+      t1 = al_get_time();
+      al_set_physfs_file_interface();
+      bench("physfs", "/", "/", (t1 - t0) * 1000);
+      PHYSFS_deinit();
+   }
+#else
+   if (argc > 3) {
+      log_printf("\nBuilt without PhysFS, %s was not used.\n", argv[3]);
+   }
+#endif
+
+   al_set_standard_file_interface();
+   al_set_standard_fs_interface();
+   al_destroy_path(dir);
+
+   close_log(true);
+
+   return 0;
+}
+
+/* vim: set sts=3 sw=3 et: */
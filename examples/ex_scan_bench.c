@@ -0,0 +1,136 @@
+/*
+ *    Benchmark for listing directory trees.
+ *
+ *    A directory is listed recursively with al_for_each_fs_entry and with
+ *    al_scan_directory, with and without the size and modification time of
+ *    each file. Then it is watched for changes for a few seconds, which is
+ *    what a program reloading its data files would do instead of listing
+ *    everything again.
+ *
+ *    Usage: ex_scan_bench directory [seconds]
+ */
+
+#define ALLEGRO_UNSTABLE
+#include <stdio.h>
+#include <stdlib.h>
+#include <allegro5/allegro.h>
+
+#include "common.c"
+
+/* Each test is run this many times and the best time is kept. */
+#define RUNS 5
+
+static int num_files;
+static int num_dirs;
+static uint64_t total;
+
+static int count_entry(ALLEGRO_FS_ENTRY *e, void *extra)
+{
+   (void)extra;
+
+   if (al_get_fs_entry_mode(e) & ALLEGRO_FILEMODE_ISDIR) {
+      num_dirs++;
+   }
+   else {
+      num_files++;
+      total += al_get_fs_entry_size(e);
+   }
+   return ALLEGRO_FOR_EACH_FS_ENTRY_OK;
+}
+
+static int count_info(const ALLEGRO_FS_ENTRY_INFO *info, void *extra)
+{
+   (void)extra;
+
+   if (info->mode & ALLEGRO_FILEMODE_ISDIR) {
+      num_dirs++;
+   }
+   else {
+      num_files++;
+      total += info->size;
+   }
+   return ALLEGRO_FOR_EACH_FS_ENTRY_OK;
+}
+
+/* Milliseconds to list the directory, the best of RUNS. */
+static double bench(const char *name, const char *root, int flags)
+{
+   double best = 1e9;
+   int i;
+
+   for (i = 0; i < RUNS; i++) {
+      double t0, t1;
+
+      num_files = num_dirs = 0;
+      total = 0;
+      t0 = al_get_time();
+      if (flags < 0) {
+         ALLEGRO_FS_ENTRY *e = al_create_fs_entry(root);
+         al_for_each_fs_entry(e, count_entry, NULL);
+         al_destroy_fs_entry(e);
+      }
+      else {
+         al_scan_directory(root, flags, count_info, NULL);
+      }
+      t1 = al_get_time();
+      if (t1 - t0 < best)
+         best = t1 - t0;
+   }
+
+   log_printf("%-24s %8d %8d %14llu %10.3f\n", name, num_dirs, num_files,
+      (unsigned long long)total, best * 1000);
+   return best * 1000;
+}
+
+int main(int argc, char **argv)
+{
+   ALLEGRO_FS_WATCHER *watcher;
+   double seconds = 5;
+   double t0, t1;
+
+   if (argc < 2) {
+      abort_example("Usage: %s directory [seconds]\n", argv[0]);
+   }
+   if (argc > 2) {
+      seconds = atof(argv[2]);
+   }
+
+   if (!al_init()) {
+      abort_example("Could not init Allegro.\n");
+   }
+
+   open_log_monospace();
+
+   log_printf("Best of %d runs, sizes are 0 when only types are listed.\n\n",
+      RUNS);
+   log_printf("%-24s %8s %8s %14s %10s\n", "", "dirs", "files", "bytes", "ms");
+   bench("al_for_each_fs_entry", argv[1], -1);
+   bench("al_scan_directory", argv[1], 0);
+   bench("al_scan_directory types", argv[1], ALLEGRO_SCAN_DIRECTORY_TYPES_ONLY);
+
+   t0 = al_get_time();
+   watcher = al_create_fs_watcher(argv[1]);
+   t1 = al_get_time();
+   if (!watcher) {
+      log_printf("\nChanges can not be watched here.\n");
+   }
+   else {
+      double end = al_get_time() + seconds;
+      log_printf("\nWatching for %g seconds, which took %.3f ms to set up.\n",
+         seconds, (t1 - t0) * 1000);
+      while (al_get_time() < end) {
+         const char *path;
+         while ((path = al_get_next_fs_change(watcher))) {
+            log_printf("Changed: %s\n", path);
+         }
+         al_rest(0.1);
+      }
+      al_destroy_fs_watcher(watcher);
+   }
+
+   close_log(true);
+
+   return 0;
+}
+
+/* vim: set sts=3 sw=3 et: */
@@ -0,0 +1,181 @@
+/*
+ *    Benchmark for drawing lots of text.
+ *
+ *    A screen full of text is drawn glyph by glyph, with al_draw_text and
+ *    with text layouts. The last two hand the glyphs to the display in
+ *    batches. Run it with LIBGL_ALWAYS_SOFTWARE=1 to measure Mesa's
+ *    software renderer.
+ *
+ *    With --memory the text is drawn onto a memory bitmap instead, without
+ *    a display. Glyphs are not batched there, so that measures the cost of
+ *    the font code itself.
+ */
+
+#define ALLEGRO_UNSTABLE
+#include <stdio.h>
+#include <string.h>
+#include <allegro5/allegro.h>
+#include <allegro5/allegro_font.h>
+#include <allegro5/allegro_ttf.h>
+
+#include "common.c"
+
+#define WIDTH 800
+#define HEIGHT 600
+
+/* How many seconds to spend on each method. */
+#define TEST_TIME 2.0
+
+enum {
+   GLYPHS,
+   TEXT,
+   LAYOUTS,
+   NUM_METHODS
+};
+
+static char const *method_names[NUM_METHODS] = {
+   "al_draw_glyph", "al_draw_text", "al_draw_text_layout"
+};
+
+static ALLEGRO_DISPLAY *display;
+static ALLEGRO_FONT *font;
+static ALLEGRO_USTR *lines[HEIGHT];
+static ALLEGRO_TEXT_LAYOUT *layouts[HEIGHT];
+static int num_lines;
+
+static void make_lines(void)
+{
+   int line_height = al_get_font_line_height(font);
+   int i, c = 33;
+
+   for (num_lines = 0; (num_lines + 1) * line_height <= HEIGHT; num_lines++) {
+      ALLEGRO_USTR *u = al_ustr_new("");
+      while (al_get_ustr_width(font, u) < WIDTH) {
+         al_ustr_append_chr(u, c);
+         c = c == 126 ? 33 : c + 1;
+         if (c % 7 == 0)
+            al_ustr_append_chr(u, ' ');
+      }
+      lines[num_lines] = u;
+   }
+
+   for (i = 0; i < num_lines; i++)
+      layouts[i] = al_create_text_layout(font, lines[i]);
+}
+
+static void draw_glyphs(ALLEGRO_USTR const *u, ALLEGRO_COLOR color,
+   float x, float y)
+{
+   int pos = 0;
+   int32_t ch = al_ustr_get_next(u, &pos);
+
+   while (ch >= 0) {
+      int32_t next = al_ustr_get_next(u, &pos);
+      al_draw_glyph(font, color, x, y, ch);
+      x += al_get_glyph_advance(font, ch, next < 0 ? ALLEGRO_NO_KERNING : next);
+      ch = next;
+   }
+}
+
+static void draw_screen(int method, int frame)
+{
+   int line_height = al_get_font_line_height(font);
+   int i;
+
+   al_clear_to_color(al_map_rgb(0, 0, 0));
+
+   for (i = 0; i < num_lines; i++) {
+      ALLEGRO_COLOR color = al_map_rgb(255, 128 + (i + frame) % 128, 64);
+      float y = i * line_height;
+
+      switch (method) {
+         case GLYPHS:
+            draw_glyphs(lines[i], color, 0, y);
+            break;
+         case TEXT:
+            al_draw_ustr(font, color, 0, y, 0, lines[i]);
+            break;
+         case LAYOUTS:
+            al_draw_text_layout(layouts[i], color, 0, y, 0);
+            break;
+      }
+   }
+
+   if (display)
+      al_flip_display();
+}
+
+static double bench(int method)
+{
+   double t0, t1;
+   int n = 0;
+
+   /* Get all the glyphs into the cache first. */
+   draw_screen(method, 0);
+
+   t0 = al_get_time();
+   do {
+      draw_screen(method, n);
+      n++;
+      t1 = al_get_time();
+   } while (t1 - t0 < TEST_TIME);
+
+   return (t1 - t0) * 1000 / n;
+}
+
+int main(int argc, char **argv)
+{
+   ALLEGRO_BITMAP *memory_target = NULL;
+   bool memory = argc > 1 && strcmp(argv[1], "--memory") == 0;
+   int i;
+
+   if (!al_init()) {
+      abort_example("Could not init Allegro.\n");
+   }
+   al_init_font_addon();
+   al_init_ttf_addon();
+
+   open_log_monospace();
+
+   if (memory) {
+      al_set_new_bitmap_flags(ALLEGRO_MEMORY_BITMAP);
+      memory_target = al_create_bitmap(WIDTH, HEIGHT);
+      if (!memory_target) {
+         abort_example("Error creating bitmap\n");
+      }
+      al_set_target_bitmap(memory_target);
+   }
+   else {
+      display = al_create_display(WIDTH, HEIGHT);
+      if (!display) {
+         abort_example("Error creating display\n");
+      }
+   }
+
+   font = al_load_font("data/DejaVuSans.ttf", 12, 0);
+   if (!font) {
+      abort_example("Error loading data/DejaVuSans.ttf\n");
+   }
+
+   make_lines();
+
+   log_printf("%d lines of %d glyphs\n", num_lines,
+      (int)al_ustr_length(lines[0]));
+   log_printf("%-20s %12s\n", "Method", "ms/frame");
+   for (i = 0; i < NUM_METHODS; i++) {
+      log_printf("%-20s %12.3f\n", method_names[i], bench(i));
+   }
+
+   for (i = 0; i < num_lines; i++) {
+      al_destroy_text_layout(layouts[i]);
+      al_ustr_free(lines[i]);
+   }
+   al_destroy_font(font);
+   al_destroy_bitmap(memory_target);
+
+   close_log(true);
+
+   return 0;
+}
+
+/* vim: set sts=3 sw=3 et: */
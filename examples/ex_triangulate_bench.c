@@ -0,0 +1,133 @@
+/*
+ *    Benchmark for al_triangulate_polygon.
+ *
+ *    Star shaped polygons with a grid of holes are triangulated by splitting
+ *    them into monotone pieces and by ear clipping. Either can be selected
+ *    with the triangulator key in the [primitives] section of allegro5.cfg.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <allegro5/allegro.h>
+#include <allegro5/allegro_primitives.h>
+
+#include "common.c"
+
+/* Ear clipping is not run on polygons larger than this. */
+#define MAX_EAR_CLIPPING 20000
+
+/* Vertices of each hole. */
+#define HOLE_VERTICES 6
+
+typedef struct POLYGON {
+   float *vertices;
+   int *vertex_counts;
+   int num_vertices;
+} POLYGON;
+
+static int num_triangles;
+
+static void make_polygon(POLYGON *p, int outline, int holes)
+{
+   int side = (int)ceil(sqrt(holes));
+   int i, h, k = 0;
+
+   p->num_vertices = outline + holes * HOLE_VERTICES;
+   p->vertices = malloc(2 * p->num_vertices * sizeof(float));
+   p->vertex_counts = calloc(holes + 2, sizeof(int));
+
+   /* The outline, counter-clockwise on the screen. */
+   for (i = 0; i < outline; i++) {
+      double t = -2 * ALLEGRO_PI * i / outline;
+      double r = (i % 2) ? 1000 : 1000 + rand() % 500;
+      p->vertices[k++] = r * cos(t);
+      p->vertices[k++] = r * sin(t);
+   }
+   p->vertex_counts[0] = outline;
+
+   /* The holes, in a grid well inside the outline. */
+   for (h = 0; h < holes; h++) {
+      double cx = -600 + 1200.0 * (h % side + 0.5) / side;
+      double cy = -600 + 1200.0 * (h / side + 0.5) / side;
+      double r = 1200.0 / side * 0.3;
+      for (i = 0; i < HOLE_VERTICES; i++) {
+         double t = 2 * ALLEGRO_PI * i / HOLE_VERTICES + h;
+         p->vertices[k++] = cx + r * cos(t);
+         p->vertices[k++] = cy + r * sin(t);
+      }
+      p->vertex_counts[h + 1] = HOLE_VERTICES;
+   }
+}
+
+static void free_polygon(POLYGON *p)
+{
+   free(p->vertices);
+   free(p->vertex_counts);
+}
+
+static void count_triangle(int a, int b, int c, void *userdata)
+{
+   (void)a;
+   (void)b;
+   (void)c;
+   (void)userdata;
+   num_triangles++;
+}
+
+static double bench(POLYGON *p, char const *triangulator)
+{
+   double t0, t1;
+
+   al_set_config_value(al_get_system_config(), "primitives", "triangulator",
+      triangulator);
+
+   num_triangles = 0;
+   t0 = al_get_time();
+   al_triangulate_polygon(p->vertices, 2 * sizeof(float), p->vertex_counts,
+      count_triangle, NULL);
+   t1 = al_get_time();
+
+   return (t1 - t0) * 1000;
+}
+
+int main(int argc, char **argv)
+{
+   static int const sizes[][2] = {
+      {1000, 10}, {10000, 100}, {20000, 400}, {100000, 900}, {1000000, 2500}
+   };
+   int i;
+
+   (void)argc;
+   (void)argv;
+
+   if (!al_init()) {
+      abort_example("Could not init Allegro.\n");
+   }
+   al_init_primitives_addon();
+
+   open_log_monospace();
+
+   log_printf("%8s %6s %10s %16s %16s\n", "Outline", "Holes", "Triangles",
+      "monotone ms", "ear_clipping ms");
+   for (i = 0; i < (int)(sizeof(sizes) / sizeof(sizes[0])); i++) {
+      POLYGON p;
+      double monotone;
+
+      make_polygon(&p, sizes[i][0], sizes[i][1]);
+      monotone = bench(&p, "monotone");
+      log_printf("%8d %6d %10d %16.3f", sizes[i][0], sizes[i][1],
+         num_triangles, monotone);
+      if (p.num_vertices <= MAX_EAR_CLIPPING)
+         log_printf(" %16.3f\n", bench(&p, "ear_clipping"));
+      else
+         log_printf(" %16s\n", "-");
+      free_polygon(&p);
+   }
+
+   close_log(true);
+
+   return 0;
+}
+
+/* vim: set sts=3 sw=3 et: */
@@ -2,6 +2,7 @@
 #define __al_included_allegro5_bitmap_io_h
 
 #include "allegro5/bitmap.h"
+#include "allegro5/events.h"
 #include "allegro5/file.h"
 
 #ifdef __cplusplus
@@ -38,6 +39,24 @@ AL_FUNC(bool, al_save_bitmap_f, (ALLEGRO_FILE *fp, const char *ident, ALLEGRO_BI
 AL_FUNC(char const *, al_identify_bitmap_f, (ALLEGRO_FILE *fp));
 AL_FUNC(char const *, al_identify_bitmap, (char const *filename));
 
+#if defined(ALLEGRO_UNSTABLE) || defined(ALLEGRO_INTERNAL_UNSTABLE) || defined(ALLEGRO_SRC)
+/* Type: ALLEGRO_BITMAP_BATCH
+ */
+typedef struct ALLEGRO_BITMAP_BATCH ALLEGRO_BITMAP_BATCH;
+
+#define ALLEGRO_EVENT_BITMAP_BATCH_LOADED  70
+#define ALLEGRO_EVENT_BITMAP_LOADED        71
+
+AL_FUNC(bool, al_load_bitmap_async, (const char *filename, int flags, intptr_t data));
+
+AL_FUNC(ALLEGRO_BITMAP_BATCH *, al_load_bitmap_batch, (const char * const *filenames, int count, int flags));
+AL_FUNC(ALLEGRO_EVENT_SOURCE *, al_get_bitmap_loader_event_source, (void));
+AL_FUNC(bool, al_is_bitmap_batch_loaded, (ALLEGRO_BITMAP_BATCH *batch));
+AL_FUNC(void, al_wait_for_bitmap_batch, (ALLEGRO_BITMAP_BATCH *batch));
+AL_FUNC(ALLEGRO_BITMAP *, al_get_bitmap_batch_bitmap, (ALLEGRO_BITMAP_BATCH *batch, int index));
+AL_FUNC(void, al_destroy_bitmap_batch, (ALLEGRO_BITMAP_BATCH *batch));
+#endif
+
 #ifdef __cplusplus
    }
 #endif
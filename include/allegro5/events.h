@@ -264,6 +264,21 @@ AL_FUNC(bool, al_wait_for_event_until, (ALLEGRO_EVENT_QUEUE *queue,
                                         ALLEGRO_EVENT *ret_event,
                                         ALLEGRO_TIMEOUT *timeout));
 
+#if defined(ALLEGRO_UNSTABLE) || defined(ALLEGRO_INTERNAL_UNSTABLE) || defined(ALLEGRO_SRC)
+/* Enum: ALLEGRO_EVENT_QUEUE_OVERFLOW
+ */
+typedef enum ALLEGRO_EVENT_QUEUE_OVERFLOW
+{
+   ALLEGRO_EVENT_QUEUE_DROP_NEWEST = 0,
+   ALLEGRO_EVENT_QUEUE_DROP_OLDEST = 1
+} ALLEGRO_EVENT_QUEUE_OVERFLOW;
+
+AL_FUNC(ALLEGRO_EVENT_QUEUE*, al_create_lock_free_event_queue, (int capacity,
+                                        ALLEGRO_EVENT_QUEUE_OVERFLOW overflow));
+AL_FUNC(int, al_get_next_events, (ALLEGRO_EVENT_QUEUE*,
+                                  ALLEGRO_EVENT *ret_events, int max));
+#endif
+
 #ifdef __cplusplus
    }
 #endif
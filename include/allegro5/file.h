@@ -61,6 +61,9 @@ AL_FUNC(const char *, al_ferrmsg, (ALLEGRO_FILE *f));
 AL_FUNC(void, al_fclearerr, (ALLEGRO_FILE *f));
 AL_FUNC(int, al_fungetc, (ALLEGRO_FILE *f, int c));
 AL_FUNC(int64_t, al_fsize, (ALLEGRO_FILE *f));
+#if defined(ALLEGRO_UNSTABLE) || defined(ALLEGRO_INTERNAL_UNSTABLE) || defined(ALLEGRO_SRC)
+AL_FUNC(const void *, al_fpeek_buffer, (ALLEGRO_FILE *f, size_t *size));
+#endif
 
 /* Convenience functions. */
 AL_FUNC(int, al_fgetc, (ALLEGRO_FILE *f));
@@ -84,6 +87,17 @@ AL_FUNC(ALLEGRO_FILE*, al_fopen_fd, (int fd, const char *mode));
 AL_FUNC(ALLEGRO_FILE*, al_make_temp_file, (const char *tmpl,
       ALLEGRO_PATH **ret_path));
 
+#if defined(ALLEGRO_UNSTABLE) || defined(ALLEGRO_INTERNAL_UNSTABLE) || defined(ALLEGRO_SRC)
+/* Specific to memory mapped files. */
+AL_FUNC(void, al_set_mmap_file_interface, (void));
+#endif
+
+#if defined(ALLEGRO_UNSTABLE) || defined(ALLEGRO_INTERNAL_UNSTABLE) || defined(ALLEGRO_SRC)
+/* Specific to buffered files. */
+AL_FUNC(ALLEGRO_FILE*, al_fopen_buffered, (ALLEGRO_FILE *fp,
+      size_t buffer_size));
+#endif
+
 /* Specific to slices. */
 AL_FUNC(ALLEGRO_FILE*, al_fopen_slice, (ALLEGRO_FILE *fp,
       size_t initial_size, const char *mode));
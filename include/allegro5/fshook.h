@@ -139,6 +139,43 @@ AL_FUNC(void, al_set_fs_interface, (const ALLEGRO_FS_INTERFACE *vtable));
 AL_FUNC(void, al_set_standard_fs_interface, (void));
 
 
+#if defined(ALLEGRO_UNSTABLE) || defined(ALLEGRO_INTERNAL_UNSTABLE) || defined(ALLEGRO_SRC)
+/* Packed archives. */
+AL_FUNC(bool, al_mount_pack, (const char *path));
+AL_FUNC(bool, al_unmount_pack, (const char *path));
+AL_FUNC(void, al_set_pack_file_interface, (void));
+
+/* Type: ALLEGRO_FS_ENTRY_INFO
+ */
+typedef struct ALLEGRO_FS_ENTRY_INFO ALLEGRO_FS_ENTRY_INFO;
+
+struct ALLEGRO_FS_ENTRY_INFO {
+   const char *name;
+   uint32_t mode;
+   off_t size;
+   time_t mtime;
+};
+
+/* Enum: ALLEGRO_SCAN_DIRECTORY_FLAGS
+ */
+enum {
+   ALLEGRO_SCAN_DIRECTORY_TYPES_ONLY = 1
+};
+
+AL_FUNC(int, al_scan_directory, (const char *path, int flags,
+                                 int (*callback)(const ALLEGRO_FS_ENTRY_INFO *info, void *extra),
+                                 void *extra));
+
+/* Type: ALLEGRO_FS_WATCHER
+ */
+typedef struct ALLEGRO_FS_WATCHER ALLEGRO_FS_WATCHER;
+
+AL_FUNC(ALLEGRO_FS_WATCHER *, al_create_fs_watcher, (const char *path));
+AL_FUNC(void, al_destroy_fs_watcher, (ALLEGRO_FS_WATCHER *watcher));
+AL_FUNC(const char *, al_get_next_fs_change, (ALLEGRO_FS_WATCHER *watcher));
+#endif
+
+
 #ifdef __cplusplus
    }
 #endif
@@ -1,10 +1,16 @@
 #ifndef __al_included_allegro5_aintern_atomicops_h
 #define __al_included_allegro5_aintern_atomicops_h
 
+/* _AL_HAVE_ATOMICOPS is defined if the operations below are available.
+ * Code using them must have a fallback otherwise.
+ */
+
 #if __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 1)
 
    /* gcc 4.1 and above have builtin atomic operations. */
 
+   #define _AL_HAVE_ATOMICOPS
+
    typedef int _AL_ATOMIC;
 
    AL_INLINE(_AL_ATOMIC,
@@ -19,10 +25,60 @@
       return __sync_sub_and_fetch(ptr, 1);
    })
 
+   AL_INLINE(bool,
+      _al_compare_and_swap, (volatile _AL_ATOMIC *ptr, _AL_ATOMIC old_val,
+         _AL_ATOMIC new_val),
+   {
+      return __sync_bool_compare_and_swap(ptr, old_val, new_val);
+   })
+
+   AL_INLINE(void,
+      _al_memory_barrier, (void),
+   {
+      __sync_synchronize();
+   })
+
+   #if defined(__ATOMIC_ACQUIRE)
+
+   /* gcc 4.7 and above can order plain loads and stores cheaply. */
+
+   AL_INLINE(_AL_ATOMIC,
+      _al_atomic_load, (volatile _AL_ATOMIC *ptr),
+   {
+      return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+   })
+
+   AL_INLINE(void,
+      _al_atomic_store, (volatile _AL_ATOMIC *ptr, _AL_ATOMIC val),
+   {
+      __atomic_store_n(ptr, val, __ATOMIC_RELEASE);
+   })
+
+   #else
+
+   AL_INLINE(_AL_ATOMIC,
+      _al_atomic_load, (volatile _AL_ATOMIC *ptr),
+   {
+      _AL_ATOMIC val = *ptr;
+      __sync_synchronize();
+      return val;
+   })
+
+   AL_INLINE(void,
+      _al_atomic_store, (volatile _AL_ATOMIC *ptr, _AL_ATOMIC val),
+   {
+      __sync_synchronize();
+      *ptr = val;
+   })
+
+   #endif
+
 #elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
 
    /* gcc, x86 or x86-64 */
 
+   #define _AL_HAVE_ATOMICOPS
+
    typedef int _AL_ATOMIC;
 
    #define __al_fetch_and_add(ptr, value, result)                             \
@@ -49,11 +105,56 @@
       return old - 1;
    })
 
-#elif defined(_MSC_VER) && _M_IX86 >= 400
+   AL_INLINE(bool,
+      _al_compare_and_swap, (volatile _AL_ATOMIC *ptr, _AL_ATOMIC old_val,
+         _AL_ATOMIC new_val),
+   {
+      _AL_ATOMIC prev;
+      __asm__ __volatile__ (
+         "lock; cmpxchgl %2, %1"
+         : "=a" (prev), "+m" (*ptr)
+         : "r" (new_val), "0" (old_val)
+         : "memory"
+      );
+      return prev == old_val;
+   })
+
+   AL_INLINE(void,
+      _al_memory_barrier, (void),
+   {
+   #ifdef __x86_64__
+      __asm__ __volatile__ ("lock; addl $0, (%%rsp)" ::: "memory");
+   #else
+      __asm__ __volatile__ ("lock; addl $0, (%%esp)" ::: "memory");
+   #endif
+   })
+
+   /* x86 does not reorder loads with loads or stores with stores, so only
+    * the compiler needs to be kept from doing so.
+    */
+   AL_INLINE(_AL_ATOMIC,
+      _al_atomic_load, (volatile _AL_ATOMIC *ptr),
+   {
+      _AL_ATOMIC val = *ptr;
+      __asm__ __volatile__ ("" ::: "memory");
+      return val;
+   })
+
+   AL_INLINE(void,
+      _al_atomic_store, (volatile _AL_ATOMIC *ptr, _AL_ATOMIC val),
+   {
+      __asm__ __volatile__ ("" ::: "memory");
+      *ptr = val;
+   })
+
+#elif defined(_MSC_VER) && (_M_IX86 >= 400 || defined(_M_X64) || \
+   defined(_M_ARM) || defined(_M_ARM64))
 
-   /* MSVC, x86 */
+   /* MSVC, x86, x64 or ARM */
    /* MinGW supports these too, but we already have asm code above. */
 
+   #define _AL_HAVE_ATOMICOPS
+
    typedef LONG _AL_ATOMIC;
 
    AL_INLINE(_AL_ATOMIC,
@@ -68,6 +169,56 @@
       return InterlockedDecrement(ptr);
    })
 
+   AL_INLINE(bool,
+      _al_compare_and_swap, (volatile _AL_ATOMIC *ptr, _AL_ATOMIC old_val,
+         _AL_ATOMIC new_val),
+   {
+      return InterlockedCompareExchange(ptr, new_val, old_val) == old_val;
+   })
+
+   AL_INLINE(void,
+      _al_memory_barrier, (void),
+   {
+      MemoryBarrier();
+   })
+
+   #if defined(_M_ARM) || defined(_M_ARM64)
+
+   /* Volatile accesses are not ordered on ARM (/volatile:iso). */
+   AL_INLINE(_AL_ATOMIC,
+      _al_atomic_load, (volatile _AL_ATOMIC *ptr),
+   {
+      _AL_ATOMIC val = *ptr;
+      MemoryBarrier();
+      return val;
+   })
+
+   AL_INLINE(void,
+      _al_atomic_store, (volatile _AL_ATOMIC *ptr, _AL_ATOMIC val),
+   {
+      MemoryBarrier();
+      *ptr = val;
+   })
+
+   #else
+
+   /* MSVC gives volatile accesses acquire and release semantics on x86
+    * and x64 (/volatile:ms).
+    */
+   AL_INLINE(_AL_ATOMIC,
+      _al_atomic_load, (volatile _AL_ATOMIC *ptr),
+   {
+      return *ptr;
+   })
+
+   AL_INLINE(void,
+      _al_atomic_store, (volatile _AL_ATOMIC *ptr, _AL_ATOMIC val),
+   {
+      *ptr = val;
+   })
+
+   #endif
+
 #elif defined(ALLEGRO_HAVE_OSATOMIC_H)
 
    /* OS X, GCC < 4.1
@@ -79,6 +230,7 @@
     */
 
     #include <libkern/OSAtomic.h>
+    #define _AL_HAVE_ATOMICOPS
     typedef int32_t _AL_ATOMIC;
 
    AL_INLINE(_AL_ATOMIC,
@@ -93,26 +245,42 @@
       return OSAtomicDecrement32Barrier((_AL_ATOMIC *)ptr);
    })
 
+   AL_INLINE(bool,
+      _al_compare_and_swap, (volatile _AL_ATOMIC *ptr, _AL_ATOMIC old_val,
+         _AL_ATOMIC new_val),
+   {
+      return OSAtomicCompareAndSwap32Barrier(old_val, new_val,
+         (_AL_ATOMIC *)ptr);
+   })
 
-#else
-
-   /* Hope for the best? */
-   #warning Atomic operations undefined for your compiler/architecture.
-
-   typedef int _AL_ATOMIC;
+   AL_INLINE(void,
+      _al_memory_barrier, (void),
+   {
+      OSMemoryBarrier();
+   })
 
    AL_INLINE(_AL_ATOMIC,
-      _al_fetch_and_add1, (volatile _AL_ATOMIC *ptr),
+      _al_atomic_load, (volatile _AL_ATOMIC *ptr),
    {
-      return (*ptr)++;
+      _AL_ATOMIC val = *ptr;
+      OSMemoryBarrier();
+      return val;
    })
 
-   AL_INLINE(_AL_ATOMIC,
-      _al_sub1_and_fetch, (volatile _AL_ATOMIC *ptr),
+   AL_INLINE(void,
+      _al_atomic_store, (volatile _AL_ATOMIC *ptr, _AL_ATOMIC val),
    {
-      return --(*ptr);
+      OSMemoryBarrier();
+      *ptr = val;
    })
 
+
+#else
+
+   /* No atomic operations for this compiler and architecture.
+    * _AL_HAVE_ATOMICOPS stays undefined, so users fall back to mutexes.
+    */
+
 #endif
 
 #endif
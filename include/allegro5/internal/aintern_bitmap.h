@@ -139,6 +139,8 @@ AL_FUNC(ALLEGRO_DISPLAY*, _al_get_bitmap_display, (ALLEGRO_BITMAP *bitmap));
 extern void (*_al_convert_funcs[ALLEGRO_NUM_PIXEL_FORMATS]
    [ALLEGRO_NUM_PIXEL_FORMATS])(const void *, int, void *, int,
    int, int, int, int, int, int);
+void _al_select_convert_funcs(int cpu_caps);
+void _al_init_convert_funcs(void);
 
 /* Bitmap conversion */
 void _al_convert_bitmap_data(
@@ -162,6 +164,18 @@ void _al_convert_to_memory_bitmap(ALLEGRO_BITMAP *bitmap);
 /* Simple bitmap drawing */
 void _al_put_pixel(ALLEGRO_BITMAP *bitmap, int x, int y, ALLEGRO_COLOR color);
 
+/* A bitmap region drawn at dx/dy with _al_draw_bitmap_quads. */
+typedef struct _AL_BITMAP_QUAD
+{
+   ALLEGRO_BITMAP *bitmap;
+   float sx, sy, sw, sh;
+   float dx, dy;
+   ALLEGRO_COLOR tint;
+} _AL_BITMAP_QUAD;
+
+AL_FUNC(void, _al_draw_bitmap_quads, (const _AL_BITMAP_QUAD *quads,
+   int num_quads));
+
 /* Bitmap I/O */
 void _al_init_iio_table(void);
 
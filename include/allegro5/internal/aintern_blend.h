@@ -246,6 +246,29 @@ void _al_blend_memory(ALLEGRO_COLOR *src_color, ALLEGRO_BITMAP *dest,
    int dx, int dy, ALLEGRO_COLOR *result);
 
 
+/* The current blender, resolved for a destination pixel format. Fill it in
+ * with _al_init_blender once per drawing operation, then blend spans of
+ * source colors with blend_span.
+ */
+typedef struct _AL_BLENDER _AL_BLENDER;
+
+/* Blends n source colors into the n pixels starting at dst, which are in
+ * the blender's destination format.
+ */
+typedef void (*_AL_BLEND_SPAN)(const _AL_BLENDER *blender,
+   const ALLEGRO_COLOR *src, void *dst, int n);
+
+struct _AL_BLENDER {
+   int op, src_mode, dst_mode;
+   int op_alpha, src_alpha, dst_alpha;
+   ALLEGRO_COLOR const_color;
+   int dst_format;
+   _AL_BLEND_SPAN blend_span;
+};
+
+AL_FUNC(void, _al_init_blender, (_AL_BLENDER *blender, int dst_format));
+
+
 #ifdef __cplusplus
    }
 #endif
@@ -0,0 +1,23 @@
+#ifndef __al_included_allegro5_aintern_cpu_h
+#define __al_included_allegro5_aintern_cpu_h
+
+#ifdef __cplusplus
+   extern "C" {
+#endif
+
+
+/* Instruction set extensions, as returned by _al_get_cpu_capabilities. */
+#define _AL_CPU_SSE2    0x0001
+#define _AL_CPU_AVX2    0x0002
+#define _AL_CPU_NEON    0x0004
+
+int _al_get_cpu_capabilities(void);
+
+
+#ifdef __cplusplus
+   }
+#endif
+
+#endif
+
+/* vim: set sts=3 sw=3 et: */
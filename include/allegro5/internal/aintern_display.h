@@ -13,6 +13,8 @@ extern "C" {
 
 typedef struct ALLEGRO_DISPLAY_INTERFACE ALLEGRO_DISPLAY_INTERFACE;
 
+struct _AL_BITMAP_QUAD;
+
 struct ALLEGRO_DISPLAY_INTERFACE
 {
    int id;
@@ -80,7 +82,12 @@ struct ALLEGRO_DISPLAY_INTERFACE
    char *(*get_clipboard_text)(ALLEGRO_DISPLAY *display);
    bool  (*set_clipboard_text)(ALLEGRO_DISPLAY *display, const char *text);
    bool  (*has_clipboard_text)(ALLEGRO_DISPLAY *display);
-   
+
+   /* Optional. Adds the quads to the vertex cache, or returns false without
+    * drawing anything if they can't be drawn that way.
+    */
+   bool (*draw_bitmap_quads)(ALLEGRO_DISPLAY *display,
+      const struct _AL_BITMAP_QUAD *quads, int num_quads);
 };
 
 
@@ -146,6 +153,15 @@ struct ALLEGRO_DISPLAY
    ALLEGRO_BLENDER cur_blender;
 
    ALLEGRO_SHADER* default_shader;
+   ALLEGRO_SHADER* sdf_shader;  /* Created by _al_get_sdf_shader. */
+   bool sdf_shader_failed;
+   ALLEGRO_SHADER* instancing_shader;  /* Created by _al_get_instancing_shader. */
+   bool instancing_shader_failed;
+
+   /* Tells this display apart from any other created before or after it,
+    * which its address can't, as that may be reused.
+    */
+   uint64_t serial;
 
    ALLEGRO_TRANSFORM projview_transform;
 
@@ -7,6 +7,8 @@
 
 
 extern const ALLEGRO_FILE_INTERFACE _al_file_interface_stdio;
+extern const ALLEGRO_FILE_INTERFACE _al_file_interface_mmap;
+extern const ALLEGRO_FILE_INTERFACE _al_file_interface_buffered;
 
 #define ALLEGRO_UNGETC_SIZE 16
 
@@ -16,8 +18,39 @@ struct ALLEGRO_FILE
    void *userdata;
    unsigned char ungetc[ALLEGRO_UNGETC_SIZE];
    int ungetc_len;
+
+   /* Bytes which al_fread and friends can take without going through the
+    * vtable. Only buffered files set these, everything else leaves them
+    * NULL.
+    */
+   const unsigned char *read_pos;
+   const unsigned char *read_end;
+
+   /* Returns the bytes from the current position on for files which are
+    * kept in memory, see al_fpeek_buffer. NULL for other files. This is
+    * not part of ALLEGRO_FILE_INTERFACE, which can't grow.
+    */
+   const void *(*peek_buffer)(ALLEGRO_FILE *f, size_t *size);
+
+   /* Set for files of the mmap interface and copies of it, whose memory
+    * belongs to the file rather than to whoever opened it.
+    */
+   bool mapped;
 };
 
+AL_FUNC(ALLEGRO_FILE *, _al_fopen_for_loading, (const char *path));
+AL_FUNC(void *, _al_mmap_view, (const void *data, size_t size,
+   void (*release)(void *arg), void *arg));
+AL_FUNC(const void *, _al_file_mmap_peek_buffer, (ALLEGRO_FILE *f,
+   size_t *size));
+AL_FUNC(void, _al_set_file_peek_buffer, (ALLEGRO_FILE *f,
+   const void *(*peek_buffer)(ALLEGRO_FILE *f, size_t *size)));
+AL_FUNC(bool, _al_file_is_mapped, (ALLEGRO_FILE *f));
+AL_FUNC(void, _al_register_mapped_file_interface, (
+   const ALLEGRO_FILE_INTERFACE *vt));
+AL_FUNC(bool, _al_is_mapped_file_interface, (
+   const ALLEGRO_FILE_INTERFACE *vt));
+
 #ifdef __cplusplus
    }
 #endif
@@ -17,6 +17,7 @@
 #define __al_included_allegro5_aintern_fshook_h
 
 #include "allegro5/base.h"
+#include "allegro5/fshook.h"
 
 #ifdef __cplusplus
    extern "C" {
@@ -25,6 +26,16 @@
 
 extern struct ALLEGRO_FS_INTERFACE _al_fs_interface_stdio;
 
+/* Directories can be read relative to an already open directory, so the
+ * stdio file system lists them without resolving every path again.
+ */
+#if defined(ALLEGRO_HAVE_FSTATAT) && defined(ALLEGRO_HAVE_FDOPENDIR)
+   #define ALLEGRO_FS_STDIO_SCAN
+   AL_FUNC(int, _al_fs_stdio_scan_directory, (const char *path, int flags,
+      int (*callback)(const ALLEGRO_FS_ENTRY_INFO *info, void *extra),
+      void *extra));
+#endif
+
 
 #ifdef __cplusplus
    }
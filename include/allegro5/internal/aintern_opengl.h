@@ -124,6 +124,9 @@ typedef struct ALLEGRO_OGL_EXTRAS
    /* For OpenGL 3.0+ we use a single vao and vbo. */
    GLuint vao, vbo;
 
+   /* Per-instance attributes of instanced primitives are streamed here. */
+   GLuint instance_vbo;
+
 } ALLEGRO_OGL_EXTRAS;
 
 typedef struct ALLEGRO_OGL_BITMAP_VERTEX
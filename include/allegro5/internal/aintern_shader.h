@@ -51,6 +51,25 @@ void _al_unregister_shader_bitmap(ALLEGRO_SHADER *shader, ALLEGRO_BITMAP *bmp);
 
 ALLEGRO_SHADER *_al_create_default_shader(int display_flags);
 
+/* Uniform of the SDF shader: half the width of the antialiased edge, in
+ * units of the distance values.
+ */
+#define _AL_SHADER_VAR_SDF_WIDTH "al_sdf_width"
+
+AL_FUNC(ALLEGRO_SHADER *, _al_get_sdf_shader, (ALLEGRO_DISPLAY *display));
+
+/* Per-instance attributes of the instancing shader. The vertices are
+ * scaled by the zw components of the transform, rotated by the angle and
+ * moved by its xy components. The texture coordinates of the vertices are
+ * interpolated between the xy and zw components of the UV rectangle.
+ */
+#define _AL_SHADER_VAR_INSTANCE_TRANSFORM "al_instance_transform"
+#define _AL_SHADER_VAR_INSTANCE_ANGLE     "al_instance_angle"
+#define _AL_SHADER_VAR_INSTANCE_COLOR     "al_instance_color"
+#define _AL_SHADER_VAR_INSTANCE_UV        "al_instance_uv"
+
+AL_FUNC(ALLEGRO_SHADER *, _al_get_instancing_shader, (ALLEGRO_DISPLAY *display));
+
 #ifdef ALLEGRO_CFG_SHADER_GLSL
 ALLEGRO_SHADER *_al_create_shader_glsl(ALLEGRO_SHADER_PLATFORM platform);
 void _al_set_shader_glsl(ALLEGRO_DISPLAY *display, ALLEGRO_SHADER *shader);
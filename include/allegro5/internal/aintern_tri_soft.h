@@ -23,5 +23,8 @@ AL_FUNC(void, _al_draw_soft_triangle, (
    void (*first)(uintptr_t, int, int, int, int),
    void (*step)(uintptr_t, int),
    void (*draw)(uintptr_t, int, int, int)));
+AL_FUNC(void, _al_draw_soft_triangles, (ALLEGRO_BITMAP* texture, ALLEGRO_VERTEX* vtx, int num_triangles));
+AL_FUNC(int, _al_soft_triangles_are_threaded, (void));
+AL_FUNC(void, _al_init_threaded_rasterizer, (void));
 
 #endif
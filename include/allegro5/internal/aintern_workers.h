@@ -0,0 +1,17 @@
+#ifndef __al_included_allegro5_aintern_workers_h
+#define __al_included_allegro5_aintern_workers_h
+
+#ifdef __cplusplus
+   extern "C" {
+#endif
+
+void _al_init_workers(void);
+AL_FUNC(void, _al_queue_worker_job, (void (*proc)(void *arg), void *arg));
+
+#ifdef __cplusplus
+   }
+#endif
+
+#endif
+
+/* vim: set sts=3 sw=3 et: */
@@ -64,6 +64,8 @@
 
 #cmakedefine ALLEGRO_HAVE_FSEEKO
 #cmakedefine ALLEGRO_HAVE_FTELLO
+#cmakedefine ALLEGRO_HAVE_FSTATAT
+#cmakedefine ALLEGRO_HAVE_FDOPENDIR
 #cmakedefine ALLEGRO_HAVE_STRERROR_R
 #cmakedefine ALLEGRO_HAVE_STRERROR_S
 #cmakedefine ALLEGRO_HAVE_VA_COPY
@@ -430,13 +430,530 @@ void (*_al_convert_funcs[ALLEGRO_NUM_PIXEL_FORMATS]
 // Warning: This file was created by make_converters.py - do not edit.
 """)
 
+def is_8888(info):
+    """
+    Whether the format is a 32-bit format with 8-bit components, which is
+    what the SIMD converters know how to read.
+    """
+    if not info or info.float or info.single_channel or info.size != 32:
+        return False
+    for c in info.components.values():
+        if c.size != 8: return False
+    return True
+
+def simd_kind(info_a, info_b):
+    """
+    Return which kind of SIMD converter handles info_a -> info_b, or None.
+    """
+    if not info_a or not info_b or info_a == info_b: return None
+    if is_8888(info_a):
+        if info_b.float: return "to_f32"
+        if info_b.single_channel: return None
+        if info_b.size == 32: return "32"
+        if info_b.size == 24: return "24"
+        if info_b.size in (15, 16): return "16"
+        return None
+    if info_a.float and is_8888(info_b):
+        return "from_f32"
+    return None
+
+def simd_ops(info_a, info_b):
+    """
+    Return a list of (shift, mask) tuples plus a constant to add, which
+    together convert a pixel of info_a into a pixel of info_b. Components
+    with the same shift are merged.
+    """
+    shifts = {}
+    add = 0
+    for name, c_b in info_b.components.items():
+        if name == "X": continue
+        if name not in info_a.components:
+            if name == "A":
+                add |= ((1 << c_b.size) - 1) << c_b.position
+            continue
+        c_a = info_a.components[name]
+        mask_pos = c_a.position + c_a.size - c_b.size
+        mask = ((1 << c_b.size) - 1) << mask_pos
+        shift = c_b.position - mask_pos
+        shifts[shift] = shifts.get(shift, 0) | mask
+    return sorted(shifts.items()), add
+
+simd_isas = {
+    "sse2": {
+        "and": "_mm_and_si128(%s, _mm_set1_epi32((int)0x%08xu))",
+        "shl": "_mm_slli_epi32(%s, %d)",
+        "shr": "_mm_srli_epi32(%s, %d)",
+        "or": "_mm_or_si128(%s, %s)",
+        "const": "_mm_set1_epi32((int)0x%08xu)",
+    },
+    "avx2": {
+        "and": "_mm256_and_si256(%s, _mm256_set1_epi32((int)0x%08xu))",
+        "shl": "_mm256_slli_epi32(%s, %d)",
+        "shr": "_mm256_srli_epi32(%s, %d)",
+        "or": "_mm256_or_si256(%s, %s)",
+        "const": "_mm256_set1_epi32((int)0x%08xu)",
+    },
+    "neon": {
+        "and": "vandq_u32(%s, vdupq_n_u32(0x%08xu))",
+        "shl": "vshlq_n_u32(%s, %d)",
+        "shr": "vshrq_n_u32(%s, %d)",
+        "or": "vorrq_u32(%s, %s)",
+        "const": "vdupq_n_u32(0x%08xu)",
+    },
+}
+
+def simd_assign(info_a, info_b, isa, var, dest):
+    """
+    Create the statements converting the vector var of info_a pixels into a
+    vector dest of info_b pixels, using 32-bit lanes.
+    """
+    ops, add = simd_ops(info_a, info_b)
+    t = simd_isas[isa]
+    terms = []
+    for shift, mask in ops:
+        if shift > 0:
+            # The left shift drops the high bits by itself.
+            if mask == 0xffffffff >> shift: term = var
+            else: term = t["and"] % (var, mask)
+            term = t["shl"] % (term, shift)
+        elif shift < 0:
+            # The right shift drops the low bits by itself.
+            if mask == (0xffffffff << -shift) & 0xffffffff: term = var
+            else: term = t["and"] % (var, mask)
+            term = t["shr"] % (term, -shift)
+        else:
+            if mask == 0xffffffff: term = var
+            else: term = t["and"] % (var, mask)
+        terms.append(term)
+    if add:
+        terms.append(t["const"] % add)
+    r = "         %s = %s;\n" % (dest, terms[0])
+    for term in terms[1:]:
+        r += "         %s = %s;\n" % (dest, t["or"] % (dest, term))
+    return r
+
+def neon_planes_24(info_a, info_b):
+    """
+    For a 32 -> 24 bit conversion, return for each destination byte the
+    index of the source byte it is copied from.
+    """
+    planes = []
+    for j in range(3):
+        for name, c_b in info_b.components.items():
+            if c_b.position == 8 * j:
+                planes.append(info_a.components[name].position // 8)
+    return planes
+
+def f32_components(info):
+    """
+    Return the list of (name, position) of the 8-bit components of info in
+    the order of the fields of ALLEGRO_COLOR.
+    """
+    r = []
+    for name in "RGBA":
+        if name in info.components:
+            r.append((name, info.components[name].position))
+        else:
+            r.append((name, None))
+    return r
+
+def simd_tail(info_a, info_b):
+    """
+    The scalar loop converting the pixels left over after the vector loop.
+    """
+    macro_name = "ALLEGRO_CONVERT_" + info_a.name + "_TO_" + info_b.name
+    if info_b.size == 24:
+        return """\
+      for (; x < width; x++) {
+         int dst_pixel = %(macro_name)s(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+""" % locals()
+    return """\
+      for (; x < width; x++) {
+         dst_ptr[x] = %(macro_name)s(src_ptr[x]);
+      }
+""" % locals()
+
+def simd_body(info_a, info_b, isa):
+    """
+    Create the vector loop of one SIMD conversion function, or None if there
+    is no variant for this ISA.
+    """
+    kind = simd_kind(info_a, info_b)
+    if isa == "sse2":
+        if kind == "32":
+            conv = simd_assign(info_a, info_b, isa, "s", "d")
+            return """\
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+%(conv)s         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+""" % locals()
+        if kind == "16":
+            conv0 = simd_assign(info_a, info_b, isa, "s0", "d0")
+            conv1 = simd_assign(info_a, info_b, isa, "s1", "d1")
+            return """\
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+%(conv0)s%(conv1)s         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+""" % locals()
+        if kind == "24":
+            conv = simd_assign(info_a, info_b, isa, "s", "d")
+            return """\
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         int last;
+%(conv)s         d = pack_24_sse2(d);
+         _mm_storel_epi64((__m128i *)(dst_ptr + x * 3), d);
+         last = _mm_cvtsi128_si32(_mm_srli_si128(d, 8));
+         memcpy(dst_ptr + x * 3 + 8, &last, 4);
+      }
+""" % locals()
+        if kind == "to_f32":
+            r = """\
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+"""
+            for name, pos in f32_components(info_a):
+                v = name.lower()
+                if pos is None:
+                    r += "         __m128 %s = _mm_set1_ps(1.0f);\n" % v
+                    continue
+                if pos == 24: comp = "_mm_srli_epi32(s, 24)"
+                elif pos == 0: comp = "_mm_and_si128(s, _mm_set1_epi32(0xff))"
+                else: comp = ("_mm_and_si128(_mm_srli_epi32(s, %d), " +
+                    "_mm_set1_epi32(0xff))") % pos
+                r += ("         __m128 %s = _mm_div_ps(_mm_cvtepi32_ps(\n" +
+                    "            %s), _mm_set1_ps(255.0f));\n") % (v, comp)
+            r += """\
+         _MM_TRANSPOSE4_PS(r, g, b, a);
+         _mm_storeu_ps((float *)(dst_ptr + x + 0), r);
+         _mm_storeu_ps((float *)(dst_ptr + x + 1), g);
+         _mm_storeu_ps((float *)(dst_ptr + x + 2), b);
+         _mm_storeu_ps((float *)(dst_ptr + x + 3), a);
+      }
+"""
+            return r
+        if kind == "from_f32":
+            r = """\
+      for (; x + 4 <= width; x += 4) {
+         __m128 r = _mm_loadu_ps((const float *)(src_ptr + x + 0));
+         __m128 g = _mm_loadu_ps((const float *)(src_ptr + x + 1));
+         __m128 b = _mm_loadu_ps((const float *)(src_ptr + x + 2));
+         __m128 a = _mm_loadu_ps((const float *)(src_ptr + x + 3));
+         __m128i d;
+         _MM_TRANSPOSE4_PS(r, g, b, a);
+"""
+            terms = []
+            for name, pos in f32_components(info_b):
+                if pos is None: continue
+                term = ("_mm_cvttps_epi32(_mm_mul_ps(%s, " +
+                    "_mm_set1_ps(255.0f)))") % name.lower()
+                if pos: term = "_mm_slli_epi32(%s, %d)" % (term, pos)
+                terms.append(term)
+            r += "         d = %s;\n" % terms[0]
+            for term in terms[1:]:
+                r += "         d = _mm_or_si128(d,\n            %s);\n" % term
+            r += """\
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+"""
+            return r
+    if isa == "avx2":
+        if kind == "32":
+            conv = simd_assign(info_a, info_b, isa, "s", "d")
+            return """\
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+%(conv)s         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+""" % locals()
+        if kind == "16":
+            conv0 = simd_assign(info_a, info_b, isa, "s0", "d0")
+            conv1 = simd_assign(info_a, info_b, isa, "s1", "d1")
+            return """\
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+%(conv0)s%(conv1)s         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+""" % locals()
+        if kind == "24":
+            conv = simd_assign(info_a, info_b, isa, "s", "d")
+            return """\
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+%(conv)s         store_24_avx2(dst_ptr + x * 3, _mm256_castsi256_si128(d));
+         store_24_avx2(dst_ptr + x * 3 + 12, _mm256_extracti128_si256(d, 1));
+      }
+""" % locals()
+        return None
+    if isa == "neon":
+        if kind == "32":
+            conv = simd_assign(info_a, info_b, isa, "s", "d")
+            return """\
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+%(conv)s         vst1q_u32(dst_ptr + x, d);
+      }
+""" % locals()
+        if kind == "16":
+            conv0 = simd_assign(info_a, info_b, isa, "s0", "d0")
+            conv1 = simd_assign(info_a, info_b, isa, "s1", "d1")
+            return """\
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+%(conv0)s%(conv1)s         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+""" % locals()
+        if kind == "24":
+            p0, p1, p2 = neon_planes_24(info_a, info_b)
+            return """\
+      for (; x + 16 <= width; x += 16) {
+         uint8x16x4_t s = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x3_t d;
+         d.val[0] = s.val[%(p0)d];
+         d.val[1] = s.val[%(p1)d];
+         d.val[2] = s.val[%(p2)d];
+         vst3q_u8(dst_ptr + x * 3, d);
+      }
+""" % locals()
+        if kind == "to_f32":
+            r = """\
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         float32x4x4_t d;
+"""
+            for i, (name, pos) in enumerate(f32_components(info_a)):
+                if pos is None:
+                    r += "         d.val[%d] = vdupq_n_f32(1.0f);\n" % i
+                    continue
+                if pos == 24: comp = "vshrq_n_u32(s, 24)"
+                elif pos == 0: comp = "vandq_u32(s, vdupq_n_u32(0xff))"
+                else: comp = ("vandq_u32(vshrq_n_u32(s, %d), " +
+                    "vdupq_n_u32(0xff))") % pos
+                r += ("         d.val[%d] = vdivq_f32(vcvtq_f32_u32(\n" +
+                    "            %s), vdupq_n_f32(255.0f));\n") % (i, comp)
+            r += """\
+         vst4q_f32((float *)(dst_ptr + x), d);
+      }
+"""
+            return r
+        if kind == "from_f32":
+            r = """\
+      for (; x + 4 <= width; x += 4) {
+         float32x4x4_t s = vld4q_f32((const float *)(src_ptr + x));
+         uint32x4_t d;
+"""
+            terms = []
+            for i, (name, pos) in enumerate(f32_components(info_b)):
+                if pos is None: continue
+                term = "vcvtq_u32_f32(vmulq_n_f32(s.val[%d], 255.0f))" % i
+                if pos: term = "vshlq_n_u32(%s, %d)" % (term, pos)
+                terms.append(term)
+            r += "         d = %s;\n" % terms[0]
+            for term in terms[1:]:
+                r += "         d = vorrq_u32(d,\n            %s);\n" % term
+            r += """\
+         vst1q_u32(dst_ptr + x, d);
+      }
+"""
+            return r
+    return None
+
+def simd_function(info_a, info_b, isa):
+    """
+    Create a string with one SIMD conversion function, or None.
+    """
+    body = simd_body(info_a, info_b, isa)
+    if not body: return None
+
+    name = info_a.name.lower() + "_to_" + info_b.name.lower() + "_" + isa
+    types_and_sizes = {
+        15 : ("uint16_t", 2),
+        16 : ("uint16_t", 2),
+        24: ("uint8_t", 3),
+        32 : ("uint32_t", 4),
+        128 : ("ALLEGRO_COLOR", 16)}
+    a_type, a_size = types_and_sizes[info_a.size]
+    b_type, b_size = types_and_sizes[info_b.size]
+    a_offset = "sx * 3" if info_a.size == 24 else "sx"
+    b_offset = "dx * 3" if info_b.size == 24 else "dx"
+    tail = simd_tail(info_a, info_b)
+    attribute = "AVX2_TARGET " if isa == "avx2" else ""
+
+    return """\
+static %(attribute)svoid %(name)s(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const %(a_type)s *src_ptr = (const %(a_type)s *)
+         ((const char *)src + (sy + y) * src_pitch) + %(a_offset)s;
+      %(b_type)s *dst_ptr = (%(b_type)s *)
+         ((char *)dst + (dy + y) * dst_pitch) + %(b_offset)s;
+      int x = 0;
+%(body)s%(tail)s   }
+}
+""" % locals()
+
+def write_convert_simd_c(filename):
+    """
+    Write out the file with the SIMD variants of the conversion functions.
+    """
+    f = open(filename, "w")
+    f.write("""\
+// Warning: This file was created by make_converters.py - do not edit.
+#include <string.h>
+#include "allegro5/allegro.h"
+#include "allegro5/internal/aintern_bitmap.h"
+#include "allegro5/internal/aintern_convert.h"
+#include "allegro5/internal/aintern_cpu.h"
+
+/* The vector code assumes little endian pixel layout. */
+#ifndef ALLEGRO_BIG_ENDIAN
+   #if defined(__SSE2__) || defined(_M_X64) || \\
+      (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+      #define CONVERT_SSE2
+      #include <emmintrin.h>
+   #endif
+   #if defined(CONVERT_SSE2) && (defined(__clang__) || \\
+      (defined(__GNUC__) && __GNUC__ >= 5) || \\
+      (defined(_MSC_VER) && _MSC_VER >= 1800))
+      #define CONVERT_AVX2
+      #include <immintrin.h>
+      #ifdef __GNUC__
+         #define AVX2_TARGET __attribute__((target("avx2")))
+      #else
+         #define AVX2_TARGET
+      #endif
+   #endif
+   #if defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(__aarch64__)
+      #define CONVERT_NEON
+      #include <arm_neon.h>
+   #endif
+#endif
+
+#ifdef CONVERT_SSE2
+/* Packs four 24-bit pixels held in 32-bit lanes into the low 12 bytes. */
+static __m128i pack_24_sse2(__m128i d)
+{
+   __m128i pairs = _mm_or_si128(
+      _mm_and_si128(d, _mm_set_epi32(0, -1, 0, -1)),
+      _mm_slli_epi64(_mm_srli_epi64(d, 32), 24));
+   return _mm_or_si128(
+      _mm_and_si128(pairs, _mm_set_epi32(0, 0, 0xffff, -1)),
+      _mm_slli_si128(_mm_srli_si128(pairs, 8), 6));
+}
+#endif
+
+#ifdef CONVERT_AVX2
+/* Stores four 24-bit pixels held in 32-bit lanes as 12 bytes. */
+static AVX2_TARGET void store_24_avx2(uint8_t *dst, __m128i d)
+{
+   int last;
+   d = _mm_shuffle_epi8(d, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10,
+      12, 13, 14, -1, -1, -1, -1));
+   _mm_storel_epi64((__m128i *)dst, d);
+   last = _mm_cvtsi128_si32(_mm_srli_si128(d, 8));
+   memcpy(dst + 8, &last, 4);
+}
+#endif
+
+""")
+
+    guards = {
+        "sse2": "CONVERT_SSE2",
+        "avx2": "CONVERT_AVX2",
+        "neon": "CONVERT_NEON"}
+    caps = {
+        "sse2": "_AL_CPU_SSE2",
+        "avx2": "_AL_CPU_AVX2",
+        "neon": "_AL_CPU_NEON"}
+    isas = ["sse2", "avx2", "neon"]
+
+    entries = {}
+    for isa in isas:
+        entries[isa] = []
+        f.write("#ifdef %s\n" % guards[isa])
+        for a in formats_list:
+            for b in formats_list:
+                function = simd_function(a, b, isa)
+                if not function: continue
+                # Only AArch64 has vector division.
+                aarch64_only = isa == "neon" and simd_kind(a, b) == "to_f32"
+                if aarch64_only: f.write("#ifdef __aarch64__\n")
+                f.write(function)
+                if aarch64_only: f.write("#endif\n")
+                entries[isa].append((a, b, aarch64_only))
+        f.write("#endif\n\n")
+
+    f.write("""\
+static void (*scalar_funcs[ALLEGRO_NUM_PIXEL_FORMATS]
+   [ALLEGRO_NUM_PIXEL_FORMATS])(const void *, int, void *, int,
+   int, int, int, int, int, int);
+static bool scalar_funcs_saved = false;
+
+/* Replaces the entries of _al_convert_funcs which have a variant for one of
+ * the instruction sets in cpu_caps. Passing 0 restores the C versions.
+ */
+void _al_select_convert_funcs(int cpu_caps)
+{
+   if (!scalar_funcs_saved) {
+      memcpy(scalar_funcs, _al_convert_funcs, sizeof(scalar_funcs));
+      scalar_funcs_saved = true;
+   }
+   else {
+      memcpy(_al_convert_funcs, scalar_funcs, sizeof(scalar_funcs));
+   }
+
+""")
+    for isa in isas:
+        f.write("#ifdef %s\n" % guards[isa])
+        f.write("   if (cpu_caps & %s) {\n" % caps[isa])
+        for a, b, aarch64_only in entries[isa]:
+            name = a.name.lower() + "_to_" + b.name.lower() + "_" + isa
+            if aarch64_only: f.write("#ifdef __aarch64__\n")
+            f.write("      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_%s]\n" % a.name)
+            f.write("         [ALLEGRO_PIXEL_FORMAT_%s] = %s;\n" % (b.name, name))
+            if aarch64_only: f.write("#endif\n")
+        f.write("   }\n")
+        f.write("#endif\n")
+
+    f.write("""\
+   (void)cpu_caps;
+}
+
+// Warning: This file was created by make_converters.py - do not edit.
+""")
+
 def main(argv):
     global options
     p = optparse.OptionParser()
     p.description = """\
-When run from the toplevel A5 folder, this will re-create the convert.h and
-convert.c files containing all the low-level color conversion macros and
-functions."""
+When run from the toplevel A5 folder, this will re-create the convert.h,
+convert.c and convert_simd.c files containing all the low-level color
+conversion macros and functions."""
     options, args = p.parse_args()
 
     # Read in color.h to get the available formats.
@@ -456,6 +973,9 @@ functions."""
     # Output a function for each possible conversion.
     write_convert_c("src/convert.c")
 
+    # Output SIMD variants of the most common conversions.
+    write_convert_simd_c("src/convert_simd.c")
+
 if __name__ == "__main__":
     main(sys.argv)
 
@@ -293,6 +293,99 @@ def make_cubic_interpolator(name, fmt):
       return samp_buf-> #{fmt} ;
    }""")
 
+def make_block_interpolator(name, taps):
+   # Interpolates n frames at once. first[k] is the position of the first
+   # sample frame read for output frame k; the caller makes sure that none of
+   # the special cases of the per-frame interpolators above apply.
+   assert taps in (1, 2, 4)
+
+   print interp("""\
+   static INLINE void
+      #{name}
+      (float *out,
+       const ALLEGRO_SAMPLE_INSTANCE *spl,
+       unsigned int maxc,
+       const int *first,
+       const float *t,
+       int n)
+   {
+      int k;
+      int i;
+""")
+   if taps == 1:
+      print "(void)t;"
+   print """\
+      switch (spl->spl_data.depth) {
+      """
+
+   for depth in depths:
+      index = depth.index("f32")
+      print interp("""\
+         case #{depth.constant()}:
+            for (k = 0; k < n; k++) {
+               const int p0 = first[k] * (int)maxc;""")
+      for j in range(1, taps):
+         print interp("""\
+               const int p#{j} = p#{j - 1} + (int)maxc;""")
+      print """\
+               for (i = 0; i < (int)maxc; i++) {"""
+      for j in range(taps):
+         value = index("spl->spl_data.buffer", "p%d + i" % j)
+         print interp("""\
+                  const float x#{j} = #{value};""")
+      if taps == 1:
+         print """\
+                  *out++ = x0;"""
+      elif taps == 2:
+         print """\
+                  *out++ = (x0 * (1.0f - t[k])) + (x1 * t[k]);"""
+      else:
+         print """\
+                  const float c0 = x1;
+                  const float c1 = 0.5f * (x2 - x0);
+                  const float c2 = x0 - (2.5f * x1) + (2.0f * x2) - (0.5f * x3);
+                  const float c3 = (0.5f * (x3 - x0)) + (1.5f * (x1 - x2));
+                  *out++ = (((((c3 * t[k]) + c2) * t[k]) + c1) * t[k]) + c0;"""
+      print """\
+               }
+            }
+            break;
+         """
+
+   print """\
+      }
+   }"""
+
+def make_block_copier(name):
+   # Converts count consecutive sample values, for when no interpolation is
+   # required.
+   print interp("""\
+   static INLINE void
+      #{name}
+      (float *out,
+       const ALLEGRO_SAMPLE_INSTANCE *spl,
+       int start,
+       int count)
+   {
+      int i;
+
+      switch (spl->spl_data.depth) {
+      """)
+
+   for depth in depths:
+      value = depth.index("f32")("spl->spl_data.buffer", "start + i")
+      print interp("""\
+         case #{depth.constant()}:
+            for (i = 0; i < count; i++) {
+               out[i] = #{value};
+            }
+            break;
+         """)
+
+   print """\
+      }
+   }"""
+
 if __name__ == "__main__":
    print "// Warning: This file was created by make_resamplers.py - do not edit."
    print "// vim: set ft=c:"
@@ -302,5 +395,9 @@ if __name__ == "__main__":
    make_linear_interpolator("linear_spl32", "f32")
    make_linear_interpolator("linear_spl16", "s16")
    make_cubic_interpolator("cubic_spl32", "f32")
+   make_block_interpolator("point_block32", 1)
+   make_block_interpolator("linear_block32", 2)
+   make_block_interpolator("cubic_block32", 4)
+   make_block_copier("copy_block32")
 
 # vim: set sts=3 sw=3 et:
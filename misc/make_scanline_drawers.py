@@ -108,12 +108,8 @@ def make_drawer(name):
    print "{"
    if shade:
       print """\
-      int op, src_mode, dst_mode;
-      int op_alpha, src_alpha, dst_alpha;
-      ALLEGRO_COLOR const_color;
-      al_get_separate_blender(&op, &src_mode, &dst_mode,
-         &op_alpha, &src_alpha, &dst_alpha);
-      const_color = al_get_blend_color();
+      const _AL_BLENDER *blender = &s->blender;
+      ALLEGRO_COLOR span[SPAN_SIZE];
       """
 
    print "{"
@@ -135,65 +131,39 @@ def make_drawer(name):
       """
 
    print "{"
-   print """\
+   if not shade:
+      print """\
       const int dst_format = target->locked_region.format;
+      """
+   print """\
       uint8_t *dst_data = (uint8_t *)target->lock_data
          + y * target->locked_region.pitch
          + x1 * target->locked_region.pixel_size;
       """
 
    if shade:
-      make_if_blender_loop(
-            op='ALLEGRO_ADD',
-            src_mode='ALLEGRO_ONE',
-            src_alpha='ALLEGRO_ONE',
-            op_alpha='ALLEGRO_ADD',
-            dst_mode='ALLEGRO_INVERSE_ALPHA',
-            dst_alpha='ALLEGRO_INVERSE_ALPHA',
-            const_color='NULL',
-            if_format='ALLEGRO_PIXEL_FORMAT_ARGB_8888',
-            alpha_only=True
-            )
-      print "else"
-      make_if_blender_loop(
-            op='ALLEGRO_ADD',
-            src_mode='ALLEGRO_ALPHA',
-            src_alpha='ALLEGRO_ALPHA',
-            op_alpha='ALLEGRO_ADD',
-            dst_mode='ALLEGRO_INVERSE_ALPHA',
-            dst_alpha='ALLEGRO_INVERSE_ALPHA',
-            const_color='NULL',
-            if_format='ALLEGRO_PIXEL_FORMAT_ARGB_8888',
-            alpha_only=True
-            )
-      print "else"
-      make_if_blender_loop(
-            op='ALLEGRO_ADD',
-            src_mode='ALLEGRO_ONE',
-            src_alpha='ALLEGRO_ONE',
-            op_alpha='ALLEGRO_ADD',
-            dst_mode='ALLEGRO_ONE',
-            dst_alpha='ALLEGRO_ONE',
-            const_color='NULL',
-            if_format='ALLEGRO_PIXEL_FORMAT_ARGB_8888',
-            alpha_only=True
-            )
-      print "else"
-
-   if opaque and white:
+      # Blending is done a span at a time by the blender, which is already
+      # specialised for the destination format.
+      if texture:
+         make_loop(
+               if_format='ALLEGRO_PIXEL_FORMAT_ARGB_8888'
+               )
+         print "else"
+      make_loop()
+   elif opaque and white:
       make_loop(copy_format=True, src_size='4')
       print "else"
       make_loop(copy_format=True, src_size='3')
       print "else"
       make_loop(copy_format=True, src_size='2')
       print "else"
+      make_loop()
    else:
       make_loop(
             if_format='ALLEGRO_PIXEL_FORMAT_ARGB_8888'
             )
       print "else"
-
-   make_loop()
+      make_loop()
 
    print """\
    }
@@ -202,71 +172,19 @@ def make_drawer(name):
    }
    """
 
-def make_if_blender_loop(
-      op='op',
-      src_mode='src_mode',
-      dst_mode='dst_mode',
-      op_alpha='op_alpha',
-      src_alpha='src_alpha',
-      dst_alpha='dst_alpha',
-      src_format='src_format',
-      dst_format='dst_format',
-      const_color='NULL',
-      if_format=None,
-      alpha_only=False
-      ):
-   print interp("""\
-      if (op == #{op} &&
-            src_mode == #{src_mode} &&
-            src_alpha == #{src_alpha} &&
-            op_alpha == #{op_alpha} &&
-            dst_mode == #{dst_mode} &&
-            dst_alpha == #{dst_alpha}) {
-      """)
-
-   if texture and if_format:
-      make_loop(
-            op=op,
-            src_mode=src_mode,
-            src_alpha=src_alpha,
-            op_alpha=op_alpha,
-            dst_mode=dst_mode,
-            dst_alpha=dst_alpha,
-            const_color=const_color,
-            if_format=if_format,
-            alpha_only=alpha_only
-            )
-      print "else"
-
-   make_loop(
-      op=op,
-      src_mode=src_mode,
-      src_alpha=src_alpha,
-      op_alpha=op_alpha,
-      dst_mode=dst_mode,
-      dst_alpha=dst_alpha,
-      const_color=const_color,
-      alpha_only=alpha_only)
-
-   print "}"
-
 def make_loop(
-      op='op',
-      src_mode='src_mode',
-      dst_mode='dst_mode',
-      op_alpha='op_alpha',
-      src_alpha='src_alpha',
-      dst_alpha='dst_alpha',
       src_format='src_format',
       dst_format='dst_format',
       src_size='src_size',
-      const_color='&const_color',
       if_format=None,
-      copy_format=False,
-      alpha_only=False
+      copy_format=False
       ):
 
-   if if_format:
+   if if_format and shade:
+      # The blender takes care of the destination format.
+      src_format = if_format
+      print interp("if (src_format == #{src_format})")
+   elif if_format:
       src_format = if_format
       dst_format = if_format
       print interp("if (dst_format == #{dst_format}")
@@ -298,53 +216,29 @@ def make_loop(
             if (end_u >= 0 && end_u < s->w && end_v >= 0 && end_v < s->h) {
             """
          make_innermost_loop(
-            op=op,
-            src_mode=src_mode,
-            dst_mode=dst_mode,
-            op_alpha=op_alpha,
-            src_alpha=src_alpha,
-            dst_alpha=dst_alpha,
             src_format=src_format,
             dst_format=dst_format,
-            const_color=const_color,
             src_size=src_size,
             copy_format=copy_format,
-            tiling=False,
-            alpha_only=alpha_only
+            tiling=False
             )
          print "} else"
 
    make_innermost_loop(
-      op=op,
-      src_mode=src_mode,
-      dst_mode=dst_mode,
-      op_alpha=op_alpha,
-      src_alpha=src_alpha,
-      dst_alpha=dst_alpha,
       src_format=src_format,
       dst_format=dst_format,
-      const_color=const_color,
       src_size=src_size,
-      copy_format=copy_format,
-      alpha_only=alpha_only
+      copy_format=copy_format
       )
 
    print "}"
 
 def make_innermost_loop(
-      op='op',
-      src_mode='src_mode',
-      dst_mode='dst_mode',
-      op_alpha='op_alpha',
-      src_alpha='src_alpha',
-      dst_alpha='dst_alpha',
       src_format='src_format',
       dst_format='dst_format',
-      const_color='&const_color',
       src_size='src_size',
       copy_format=False,
-      tiling=True,
-      alpha_only=True
+      tiling=True
       ):
 
    print "{"
@@ -369,7 +263,18 @@ def make_innermost_loop(
             """
          uu_ofs = vv_ofs = "0"
 
-   print "for (; x1 <= x2; x1++) {"
+   if shade:
+      # Collect the source colors of up to SPAN_SIZE pixels, then hand them
+      # to the blender in one go.
+      print """\
+      while (x1 <= x2) {
+         const int span_end = _ALLEGRO_MIN(x2 + 1, x1 + SPAN_SIZE);
+         const int span_len = span_end - x1;
+         ALLEGRO_COLOR *span_color = span;
+         for (; x1 < span_end; x1++) {
+         """
+   else:
+      print "for (; x1 <= x2; x1++) {"
 
    if not texture:
       print """\
@@ -421,21 +326,9 @@ def make_innermost_loop(
          }
          """)
    elif shade:
-      blend = "_al_blend_inline"
-      if alpha_only:
-         blend = "_al_blend_alpha_inline"
-      print interp("""\
-         {
-            ALLEGRO_COLOR dst_color;
-            ALLEGRO_COLOR result;
-            _AL_INLINE_GET_PIXEL(#{dst_format}, dst_data, dst_color, false);
-            #{blend}(&src_color, &dst_color,
-               #{op}, #{src_mode}, #{dst_mode},
-               #{op_alpha}, #{src_alpha}, #{dst_alpha},
-               #{const_color}, &result);
-            _AL_INLINE_PUT_PIXEL(#{dst_format}, dst_data, result, true);
-         }
-         """)
+      print """\
+         *span_color++ = src_color;
+         """
    else:
       print interp("""\
          _AL_INLINE_PUT_PIXEL(#{dst_format}, dst_data, src_color, true);
@@ -468,6 +361,13 @@ def make_innermost_loop(
          cur_color.a += gs->color_dx.a;
          """
 
+   if shade:
+      print """\
+         }
+         blender->blend_span(blender, span, dst_data, span_len);
+         dst_data += span_len * target->locked_region.pixel_size;
+      """
+
    print """\
       }
    }"""
@@ -481,6 +381,8 @@ if __name__ == "__main__":
 #else
 #define _AL_EXPECT_FAIL(expr) (expr)
 #endif
+
+#define SPAN_SIZE 64
 """
 
    make_drawer("shader_solid_any_draw_shade")
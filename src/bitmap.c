@@ -23,6 +23,7 @@
 #include "allegro5/allegro.h"
 #include "allegro5/internal/aintern.h"
 #include "allegro5/internal/aintern_bitmap.h"
+#include "allegro5/internal/aintern_cpu.h"
 #include "allegro5/internal/aintern_display.h"
 #include "allegro5/internal/aintern_pixels.h"
 #include "allegro5/internal/aintern_shader.h"
@@ -630,6 +631,29 @@ void _al_convert_bitmap_data(
 }
 
 
+/* Picks the fastest pixel format converters the CPU supports. The SIMD
+ * versions can be disabled in allegro5.cfg, e.g. for benchmarking.
+ */
+void _al_init_convert_funcs(void)
+{
+   const char *value;
+   int caps = _al_get_cpu_capabilities();
+
+   value = al_get_config_value(al_get_system_config(), "graphics",
+      "simd_converters");
+   if (value && !_al_stricmp(value, "false"))
+      caps = 0;
+
+   _al_select_convert_funcs(caps);
+
+   ALLEGRO_INFO("Pixel format converters: %s%s%s%s\n",
+      (caps & _AL_CPU_SSE2) ? "SSE2 " : "",
+      (caps & _AL_CPU_AVX2) ? "AVX2 " : "",
+      (caps & _AL_CPU_NEON) ? "NEON " : "",
+      caps ? "" : "C");
+}
+
+
 /* Function: al_clone_bitmap
  */
 ALLEGRO_BITMAP *al_clone_bitmap(ALLEGRO_BITMAP *bitmap)
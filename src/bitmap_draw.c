@@ -250,4 +250,41 @@ void al_draw_scaled_rotated_bitmap(ALLEGRO_BITMAP *bitmap,
 }
 
 
+/* Internal function: _al_draw_bitmap_quads
+ *  Draw many bitmap regions, each with its own position and tint, like
+ *  al_draw_tinted_bitmap_region would. The display driver may put them
+ *  into the vertex cache all at once, otherwise they are drawn one by one.
+ *  Either way drawing is held while they are drawn.
+ */
+void _al_draw_bitmap_quads(const _AL_BITMAP_QUAD *quads, int num_quads)
+{
+   ALLEGRO_BITMAP *dest = al_get_target_bitmap();
+   ALLEGRO_DISPLAY *display = _al_get_bitmap_display(dest);
+   bool held;
+   int i;
+   ASSERT(quads || num_quads == 0);
+
+   if (num_quads <= 0)
+      return;
+
+   held = al_is_bitmap_drawing_held();
+   al_hold_bitmap_drawing(true);
+
+   if (!(al_get_bitmap_flags(dest) & ALLEGRO_MEMORY_BITMAP) &&
+         display && display->vt->draw_bitmap_quads &&
+         display->vt->draw_bitmap_quads(display, quads, num_quads)) {
+      al_hold_bitmap_drawing(held);
+      return;
+   }
+
+   for (i = 0; i < num_quads; i++) {
+      const _AL_BITMAP_QUAD *q = &quads[i];
+      al_draw_tinted_bitmap_region(q->bitmap, q->tint,
+         q->sx, q->sy, q->sw, q->sh, q->dx, q->dy, 0);
+   }
+
+   al_hold_bitmap_drawing(held);
+}
+
+
 /* vim: set ts=8 sts=3 sw=3 et: */
@@ -16,8 +16,11 @@
 #include "allegro5/allegro.h"
 #include "allegro5/internal/aintern.h"
 #include "allegro5/internal/aintern_bitmap.h"
+#include "allegro5/internal/aintern_events.h"
 #include "allegro5/internal/aintern_exitfunc.h"
+#include "allegro5/internal/aintern_thread.h"
 #include "allegro5/internal/aintern_vector.h"
+#include "allegro5/internal/aintern_workers.h"
 
 #include <string.h>
 
@@ -39,6 +42,7 @@ typedef struct Handler
 
 /* globals */
 static _AL_VECTOR iio_table = _AL_VECTOR_INITIALIZER(Handler);
+static ALLEGRO_EVENT_SOURCE loader_es;
 
 
 static Handler *add_iio_table_f(const char *ext)
@@ -104,11 +108,13 @@ static Handler *find_handler_for_file(ALLEGRO_FILE *f)
 static void free_iio_table(void)
 {
    _al_vector_free(&iio_table);
+   _al_event_source_free(&loader_es);
 }
 
 
 void _al_init_iio_table(void)
 {
+   _al_event_source_init(&loader_es);
    _al_add_exit_func(free_iio_table, "free_iio_table");
 }
 
@@ -221,6 +227,314 @@ ALLEGRO_BITMAP *al_load_bitmap_flags(const char *filename, int flags)
 }
 
 
+/* load_memory_bitmap: [worker thread]
+ *  Load a file as a memory bitmap, but otherwise with the new bitmap
+ *  parameters and file interface of the thread which asked for it.
+ *
+ *  ALLEGRO_CONVERT_BITMAP lets al_convert_memory_bitmaps turn the bitmap
+ *  into a video bitmap later. The flag is only added once the bitmap is
+ *  loaded, as al_create_bitmap would register the bitmap for conversion
+ *  straight away, while the loader is still writing to it or may yet
+ *  destroy it.
+ */
+static ALLEGRO_BITMAP *load_memory_bitmap(const char *filename, int flags,
+   ALLEGRO_STATE *state)
+{
+   ALLEGRO_BITMAP *bmp;
+   int new_flags;
+   bool convert;
+
+   al_restore_state(state);
+   new_flags = al_get_new_bitmap_flags();
+   convert = (new_flags & ALLEGRO_CONVERT_BITMAP) != 0;
+   new_flags &= ~(ALLEGRO_VIDEO_BITMAP | ALLEGRO_CONVERT_BITMAP);
+   al_set_new_bitmap_flags(new_flags | ALLEGRO_MEMORY_BITMAP);
+
+   bmp = al_load_bitmap_flags(filename, flags);
+   if (bmp && convert) {
+      bmp->_flags |= ALLEGRO_CONVERT_BITMAP;
+      _al_register_convert_bitmap(bmp);
+   }
+
+   return bmp;
+}
+
+
+typedef struct ASYNC_LOAD
+{
+   char *filename;
+   int flags;
+   intptr_t data;
+   ALLEGRO_STATE state;
+} ASYNC_LOAD;
+
+
+/* load_async: [worker thread]
+ */
+static void load_async(void *arg)
+{
+   ASYNC_LOAD *load = arg;
+   ALLEGRO_BITMAP *bmp;
+   bool emitted;
+
+   bmp = load_memory_bitmap(load->filename, load->flags, &load->state);
+
+   _al_event_source_lock(&loader_es);
+   emitted = _al_event_source_needs_to_generate_event(&loader_es);
+   if (emitted) {
+      ALLEGRO_EVENT event;
+      event.user.type = ALLEGRO_EVENT_BITMAP_LOADED;
+      event.user.timestamp = al_get_time();
+      event.user.data1 = (intptr_t)bmp;
+      event.user.data2 = load->data;
+      _al_event_source_emit_event(&loader_es, &event);
+   }
+   _al_event_source_unlock(&loader_es);
+
+   /* Nobody is told about the bitmap, so nobody else would destroy it. */
+   if (!emitted && bmp) {
+      ALLEGRO_WARN("No event queue for %s, destroying it\n", load->filename);
+      al_destroy_bitmap(bmp);
+   }
+
+   al_free(load->filename);
+   al_free(load);
+}
+
+
+/* Function: al_load_bitmap_async
+ */
+bool al_load_bitmap_async(const char *filename, int flags, intptr_t data)
+{
+   ASYNC_LOAD *load;
+
+   ASSERT(filename);
+
+   load = al_malloc(sizeof(*load));
+   if (!load)
+      return false;
+
+   load->filename = al_malloc(strlen(filename) + 1);
+   if (!load->filename) {
+      al_free(load);
+      return false;
+   }
+   strcpy(load->filename, filename);
+   load->flags = flags;
+   load->data = data;
+   al_store_state(&load->state,
+      ALLEGRO_STATE_NEW_BITMAP_PARAMETERS | ALLEGRO_STATE_NEW_FILE_INTERFACE);
+
+   _al_queue_worker_job(load_async, load);
+
+   return true;
+}
+
+
+typedef struct BATCH_ITEM
+{
+   ALLEGRO_BITMAP_BATCH *batch;
+   char *filename;
+   ALLEGRO_BITMAP *bitmap;
+} BATCH_ITEM;
+
+
+struct ALLEGRO_BITMAP_BATCH
+{
+   _AL_MUTEX mutex;
+   _AL_COND cond;
+   ALLEGRO_STATE state;    /* caller's new bitmap parameters and file interface */
+   int flags;
+   int count;
+   int remaining;
+   int num_loaded;
+   BATCH_ITEM *items;
+};
+
+
+/* batch_loaded:
+ *  Emit the event for a batch whose files have all been loaded. Called
+ *  with the batch mutex held.
+ */
+static void batch_loaded(ALLEGRO_BITMAP_BATCH *batch)
+{
+   _al_event_source_lock(&loader_es);
+   if (_al_event_source_needs_to_generate_event(&loader_es)) {
+      ALLEGRO_EVENT event;
+      event.user.type = ALLEGRO_EVENT_BITMAP_BATCH_LOADED;
+      event.user.timestamp = al_get_time();
+      event.user.data1 = (intptr_t)batch;
+      event.user.data2 = batch->num_loaded;
+      _al_event_source_emit_event(&loader_es, &event);
+   }
+   _al_event_source_unlock(&loader_es);
+
+   _al_cond_broadcast(&batch->cond);
+}
+
+
+/* load_batch_item: [worker thread]
+ *  Load one file of a batch. The last file to finish emits the event of the
+ *  batch.
+ */
+static void load_batch_item(void *arg)
+{
+   BATCH_ITEM *item = arg;
+   ALLEGRO_BITMAP_BATCH *batch = item->batch;
+   ALLEGRO_BITMAP *bmp;
+
+   bmp = load_memory_bitmap(item->filename, batch->flags, &batch->state);
+
+   _al_mutex_lock(&batch->mutex);
+
+   item->bitmap = bmp;
+   if (bmp)
+      batch->num_loaded++;
+
+   if (--batch->remaining == 0)
+      batch_loaded(batch);
+
+   _al_mutex_unlock(&batch->mutex);
+}
+
+
+/* Function: al_load_bitmap_batch
+ */
+ALLEGRO_BITMAP_BATCH *al_load_bitmap_batch(const char * const *filenames,
+   int count, int flags)
+{
+   ALLEGRO_BITMAP_BATCH *batch;
+   int i;
+
+   ASSERT(filenames || count == 0);
+   ASSERT(count >= 0);
+
+   batch = al_calloc(1, sizeof(*batch));
+   if (!batch)
+      return NULL;
+
+   batch->items = al_calloc(count ? count : 1, sizeof(BATCH_ITEM));
+   if (!batch->items) {
+      al_free(batch);
+      return NULL;
+   }
+
+   for (i = 0; i < count; i++) {
+      batch->items[i].batch = batch;
+      batch->items[i].filename = al_malloc(strlen(filenames[i]) + 1);
+      if (batch->items[i].filename) {
+         strcpy(batch->items[i].filename, filenames[i]);
+      }
+      else {
+         while (i-- > 0)
+            al_free(batch->items[i].filename);
+         al_free(batch->items);
+         al_free(batch);
+         return NULL;
+      }
+   }
+
+   _al_mutex_init(&batch->mutex);
+   _al_cond_init(&batch->cond);
+   al_store_state(&batch->state,
+      ALLEGRO_STATE_NEW_BITMAP_PARAMETERS | ALLEGRO_STATE_NEW_FILE_INTERFACE);
+   batch->flags = flags;
+   batch->count = count;
+   batch->remaining = count;
+   batch->num_loaded = 0;
+
+   if (count == 0) {
+      _al_mutex_lock(&batch->mutex);
+      batch_loaded(batch);
+      _al_mutex_unlock(&batch->mutex);
+   }
+
+   for (i = 0; i < count; i++) {
+      _al_queue_worker_job(load_batch_item, &batch->items[i]);
+   }
+
+   return batch;
+}
+
+
+/* Function: al_get_bitmap_loader_event_source
+ */
+ALLEGRO_EVENT_SOURCE *al_get_bitmap_loader_event_source(void)
+{
+   return &loader_es;
+}
+
+
+/* Function: al_is_bitmap_batch_loaded
+ */
+bool al_is_bitmap_batch_loaded(ALLEGRO_BITMAP_BATCH *batch)
+{
+   bool loaded;
+   ASSERT(batch);
+
+   _al_mutex_lock(&batch->mutex);
+   loaded = (batch->remaining == 0);
+   _al_mutex_unlock(&batch->mutex);
+
+   return loaded;
+}
+
+
+/* Function: al_wait_for_bitmap_batch
+ */
+void al_wait_for_bitmap_batch(ALLEGRO_BITMAP_BATCH *batch)
+{
+   ASSERT(batch);
+
+   _al_mutex_lock(&batch->mutex);
+   while (batch->remaining > 0)
+      _al_cond_wait(&batch->cond, &batch->mutex);
+   _al_mutex_unlock(&batch->mutex);
+}
+
+
+/* Function: al_get_bitmap_batch_bitmap
+ */
+ALLEGRO_BITMAP *al_get_bitmap_batch_bitmap(ALLEGRO_BITMAP_BATCH *batch,
+   int index)
+{
+   ALLEGRO_BITMAP *bmp;
+   ASSERT(batch);
+
+   if (index < 0 || index >= batch->count)
+      return NULL;
+
+   al_wait_for_bitmap_batch(batch);
+
+   bmp = batch->items[index].bitmap;
+   batch->items[index].bitmap = NULL;
+   return bmp;
+}
+
+
+/* Function: al_destroy_bitmap_batch
+ */
+void al_destroy_bitmap_batch(ALLEGRO_BITMAP_BATCH *batch)
+{
+   int i;
+
+   if (!batch)
+      return;
+
+   al_wait_for_bitmap_batch(batch);
+
+   for (i = 0; i < batch->count; i++) {
+      al_destroy_bitmap(batch->items[i].bitmap);
+      al_free(batch->items[i].filename);
+   }
+   al_free(batch->items);
+
+   _al_cond_destroy(&batch->cond);
+   _al_mutex_destroy(&batch->mutex);
+   al_free(batch);
+}
+
+
 /* Function: al_save_bitmap
  */
 bool al_save_bitmap(const char *filename, ALLEGRO_BITMAP *bitmap)
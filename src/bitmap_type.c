@@ -218,6 +218,29 @@ void al_convert_bitmap(ALLEGRO_BITMAP *bitmap)
 }
 
 
+/* convert_registered_bitmap:
+ *  Convert a bitmap taken off the list to a display bitmap. A bitmap which
+ *  can't be converted stays a memory bitmap, and must not come back onto
+ *  the list or the callers could retry it forever.
+ */
+static void convert_registered_bitmap(ALLEGRO_BITMAP *bitmap)
+{
+   int flags = al_get_bitmap_flags(bitmap);
+
+   al_set_new_bitmap_flags(flags & ~ALLEGRO_MEMORY_BITMAP);
+   al_set_new_bitmap_format(al_get_bitmap_format(bitmap));
+
+   ALLEGRO_DEBUG("converting memory bitmap %p to display bitmap\n", bitmap);
+
+   al_convert_bitmap(bitmap);
+
+   if (al_get_bitmap_flags(bitmap) & ALLEGRO_MEMORY_BITMAP) {
+      ALLEGRO_WARN("could not convert memory bitmap %p\n", bitmap);
+      _al_vector_find_and_delete(&convert_bitmap_list.bitmaps, &bitmap);
+   }
+}
+
+
 /* Function: al_convert_memory_bitmaps
  */
 void al_convert_memory_bitmaps(void)
@@ -242,17 +265,8 @@ void al_convert_memory_bitmaps(void)
    _al_vector_free(&convert_bitmap_list.bitmaps);
    _al_vector_init(&convert_bitmap_list.bitmaps, sizeof(ALLEGRO_BITMAP *));
    for (i = 0; i < _al_vector_size(&copy); i++) {
-      ALLEGRO_BITMAP **bptr;
-      int flags;
-      bptr = _al_vector_ref(&copy, i);
-      flags = al_get_bitmap_flags(*bptr);
-      flags &= ~ALLEGRO_MEMORY_BITMAP;
-      al_set_new_bitmap_flags(flags);
-      al_set_new_bitmap_format(al_get_bitmap_format(*bptr));
-      
-      ALLEGRO_DEBUG("converting memory bitmap %p to display bitmap\n", *bptr);
-      
-      al_convert_bitmap(*bptr);
+      ALLEGRO_BITMAP **bptr = _al_vector_ref(&copy, i);
+      convert_registered_bitmap(*bptr);
    }
 
    _al_vector_free(&copy);
@@ -263,6 +277,48 @@ void al_convert_memory_bitmaps(void)
 }
 
 
+/* Function: al_convert_memory_bitmaps_timed
+ */
+int al_convert_memory_bitmaps_timed(double seconds)
+{
+   ALLEGRO_STATE backup;
+   ALLEGRO_DISPLAY *display = al_get_current_display();
+   double end_time = al_get_time() + seconds;
+   int remaining;
+
+   al_lock_mutex(convert_bitmap_list.mutex);
+
+   if (display) {
+      al_store_state(&backup, ALLEGRO_STATE_NEW_BITMAP_PARAMETERS);
+
+      /* Convert the bitmaps in the order they were created, and at least
+       * one per call so that there is progress with any time budget.
+       */
+      do {
+         ALLEGRO_BITMAP **bptr;
+         ALLEGRO_BITMAP *bitmap;
+
+         if (_al_vector_is_empty(&convert_bitmap_list.bitmaps))
+            break;
+
+         bptr = _al_vector_ref_front(&convert_bitmap_list.bitmaps);
+         bitmap = *bptr;
+         _al_vector_delete_at(&convert_bitmap_list.bitmaps, 0);
+
+         convert_registered_bitmap(bitmap);
+      } while (al_get_time() < end_time);
+
+      al_restore_state(&backup);
+   }
+
+   remaining = _al_vector_size(&convert_bitmap_list.bitmaps);
+
+   al_unlock_mutex(convert_bitmap_list.mutex);
+
+   return remaining;
+}
+
+
 /* Converts a memory bitmap to a display bitmap preserving its contents.
  * The created bitmap belongs to the current display.
  * 
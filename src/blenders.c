@@ -20,8 +20,11 @@
 #include "allegro5/internal/aintern_bitmap.h"
 #include "allegro5/internal/aintern_blend.h"
 #include "allegro5/internal/aintern_display.h"
+#include "allegro5/internal/aintern_pixels.h"
 #include <string.h>
 
+ALLEGRO_DEBUG_CHANNEL("blender")
+
 void _al_blend_memory(ALLEGRO_COLOR *scol,
    ALLEGRO_BITMAP *dest,
    int dx, int dy, ALLEGRO_COLOR *result)
@@ -37,5 +40,141 @@ void _al_blend_memory(ALLEGRO_COLOR *scol,
                     op, src_blend, dest_blend,
                     alpha_op, alpha_src_blend, alpha_dest_blend,
                     &constcol, result);
-   (void) _al_blend_alpha_inline; // silence compiler
 }
+
+
+/* Span blenders. Each one is specialised for a blender and a destination
+ * format, the _any variants read those from the _AL_BLENDER instead.
+ */
+#define MAKE_BLEND_SPAN(name, format, blend, op, src_, dst_, aop, asrc_, adst_) \
+   static void name(const _AL_BLENDER *blender,                               \
+      const ALLEGRO_COLOR *src, void *dst, int n)                             \
+   {                                                                          \
+      ALLEGRO_COLOR constcol = blender->const_color;                          \
+      uint8_t *data = dst;                                                    \
+      int i;                                                                  \
+                                                                              \
+      for (i = 0; i < n; i++) {                                               \
+         ALLEGRO_COLOR dcol;                                                  \
+         ALLEGRO_COLOR result;                                                \
+         _AL_INLINE_GET_PIXEL(format, data, dcol, false);                     \
+         blend(&src[i], &dcol, op, src_, dst_, aop, asrc_, adst_,             \
+            &constcol, &result);                                              \
+         _AL_INLINE_PUT_PIXEL(format, data, result, true);                    \
+      }                                                                       \
+   }
+
+#define MAKE_BLEND_SPANS(mode, blend, op, src_, dst_, aop, asrc_, adst_)      \
+   MAKE_BLEND_SPAN(blend_span_##mode##_argb_8888,                             \
+      ALLEGRO_PIXEL_FORMAT_ARGB_8888, blend,                                  \
+      op, src_, dst_, aop, asrc_, adst_)                                      \
+   MAKE_BLEND_SPAN(blend_span_##mode##_abgr_8888_le,                          \
+      ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE, blend,                               \
+      op, src_, dst_, aop, asrc_, adst_)                                      \
+   MAKE_BLEND_SPAN(blend_span_##mode##_any,                                   \
+      blender->dst_format, blend,                                             \
+      op, src_, dst_, aop, asrc_, adst_)
+
+MAKE_BLEND_SPANS(premul, _al_blend_alpha_inline,
+   ALLEGRO_ADD, ALLEGRO_ONE, ALLEGRO_INVERSE_ALPHA,
+   ALLEGRO_ADD, ALLEGRO_ONE, ALLEGRO_INVERSE_ALPHA)
+MAKE_BLEND_SPANS(alpha, _al_blend_alpha_inline,
+   ALLEGRO_ADD, ALLEGRO_ALPHA, ALLEGRO_INVERSE_ALPHA,
+   ALLEGRO_ADD, ALLEGRO_ALPHA, ALLEGRO_INVERSE_ALPHA)
+MAKE_BLEND_SPANS(additive, _al_blend_alpha_inline,
+   ALLEGRO_ADD, ALLEGRO_ONE, ALLEGRO_ONE,
+   ALLEGRO_ADD, ALLEGRO_ONE, ALLEGRO_ONE)
+MAKE_BLEND_SPANS(alpha_only, _al_blend_alpha_inline,
+   blender->op, blender->src_mode, blender->dst_mode,
+   blender->op_alpha, blender->src_alpha, blender->dst_alpha)
+MAKE_BLEND_SPANS(generic, _al_blend_inline,
+   blender->op, blender->src_mode, blender->dst_mode,
+   blender->op_alpha, blender->src_alpha, blender->dst_alpha)
+
+#undef MAKE_BLEND_SPANS
+#undef MAKE_BLEND_SPAN
+
+enum {
+   BLEND_PREMUL,
+   BLEND_ALPHA,
+   BLEND_ADDITIVE,
+   BLEND_ALPHA_ONLY,
+   BLEND_GENERIC
+};
+
+static const _AL_BLEND_SPAN blend_spans[][3] = {
+   {blend_span_premul_argb_8888, blend_span_premul_abgr_8888_le,
+      blend_span_premul_any},
+   {blend_span_alpha_argb_8888, blend_span_alpha_abgr_8888_le,
+      blend_span_alpha_any},
+   {blend_span_additive_argb_8888, blend_span_additive_abgr_8888_le,
+      blend_span_additive_any},
+   {blend_span_alpha_only_argb_8888, blend_span_alpha_only_abgr_8888_le,
+      blend_span_alpha_only_any},
+   {blend_span_generic_argb_8888, blend_span_generic_abgr_8888_le,
+      blend_span_generic_any}
+};
+
+
+static bool is_alpha_factor(int mode)
+{
+   return mode == ALLEGRO_ZERO || mode == ALLEGRO_ONE ||
+      mode == ALLEGRO_ALPHA || mode == ALLEGRO_INVERSE_ALPHA;
+}
+
+
+static int get_blend_mode(const _AL_BLENDER *b)
+{
+   if (b->op == ALLEGRO_ADD && b->op_alpha == ALLEGRO_ADD) {
+      if (b->src_mode == b->src_alpha && b->dst_mode == b->dst_alpha) {
+         if (b->src_mode == ALLEGRO_ONE && b->dst_mode == ALLEGRO_INVERSE_ALPHA)
+            return BLEND_PREMUL;
+         if (b->src_mode == ALLEGRO_ALPHA && b->dst_mode == ALLEGRO_INVERSE_ALPHA)
+            return BLEND_ALPHA;
+         if (b->src_mode == ALLEGRO_ONE && b->dst_mode == ALLEGRO_ONE)
+            return BLEND_ADDITIVE;
+      }
+   }
+
+   /* _al_blend_alpha_inline only handles color factors which are the same
+    * for all components.
+    */
+   if (is_alpha_factor(b->src_mode) && is_alpha_factor(b->dst_mode))
+      return BLEND_ALPHA_ONLY;
+
+   return BLEND_GENERIC;
+}
+
+
+/* Internal function: _al_init_blender
+ *  Resolves the current blender for drawing to pixels in dst_format, which
+ *  must not be a video-only format.
+ */
+void _al_init_blender(_AL_BLENDER *blender, int dst_format)
+{
+   int format_index;
+
+   ASSERT(!_al_pixel_format_is_video_only(dst_format));
+
+   al_get_separate_blender(&blender->op, &blender->src_mode,
+      &blender->dst_mode, &blender->op_alpha, &blender->src_alpha,
+      &blender->dst_alpha);
+   blender->const_color = al_get_blend_color();
+   blender->dst_format = dst_format;
+
+   switch (dst_format) {
+      case ALLEGRO_PIXEL_FORMAT_ARGB_8888:
+         format_index = 0;
+         break;
+      case ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE:
+         format_index = 1;
+         break;
+      default:
+         format_index = 2;
+         break;
+   }
+
+   blender->blend_span = blend_spans[get_blend_mode(blender)][format_index];
+}
+
+/* vim: set sts=3 sw=3 et: */
@@ -0,0 +1,10983 @@
+// Warning: This file was created by make_converters.py - do not edit.
+#include <string.h>
+#include "allegro5/allegro.h"
+#include "allegro5/internal/aintern_bitmap.h"
+#include "allegro5/internal/aintern_convert.h"
+#include "allegro5/internal/aintern_cpu.h"
+
+/* The vector code assumes little endian pixel layout. */
+#ifndef ALLEGRO_BIG_ENDIAN
+   #if defined(__SSE2__) || defined(_M_X64) || \
+      (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+      #define CONVERT_SSE2
+      #include <emmintrin.h>
+   #endif
+   #if defined(CONVERT_SSE2) && (defined(__clang__) || \
+      (defined(__GNUC__) && __GNUC__ >= 5) || \
+      (defined(_MSC_VER) && _MSC_VER >= 1800))
+      #define CONVERT_AVX2
+      #include <immintrin.h>
+      #ifdef __GNUC__
+         #define AVX2_TARGET __attribute__((target("avx2")))
+      #else
+         #define AVX2_TARGET
+      #endif
+   #endif
+   #if defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(__aarch64__)
+      #define CONVERT_NEON
+      #include <arm_neon.h>
+   #endif
+#endif
+
+#ifdef CONVERT_SSE2
+/* Packs four 24-bit pixels held in 32-bit lanes into the low 12 bytes. */
+static __m128i pack_24_sse2(__m128i d)
+{
+   __m128i pairs = _mm_or_si128(
+      _mm_and_si128(d, _mm_set_epi32(0, -1, 0, -1)),
+      _mm_slli_epi64(_mm_srli_epi64(d, 32), 24));
+   return _mm_or_si128(
+      _mm_and_si128(pairs, _mm_set_epi32(0, 0, 0xffff, -1)),
+      _mm_slli_si128(_mm_srli_si128(pairs, 8), 6));
+}
+#endif
+
+#ifdef CONVERT_AVX2
+/* Stores four 24-bit pixels held in 32-bit lanes as 12 bytes. */
+static AVX2_TARGET void store_24_avx2(uint8_t *dst, __m128i d)
+{
+   int last;
+   d = _mm_shuffle_epi8(d, _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10,
+      12, 13, 14, -1, -1, -1, -1));
+   _mm_storel_epi64((__m128i *)dst, d);
+   last = _mm_cvtsi128_si32(_mm_srli_si128(d, 8));
+   memcpy(dst + 8, &last, 4);
+}
+#endif
+
+#ifdef CONVERT_SSE2
+static void argb_8888_to_rgba_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_srli_epi32(s, 24);
+         d = _mm_or_si128(d, _mm_slli_epi32(s, 8));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_argb_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0xf0000000u)), 16);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f00000u)), 12));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f000u)), 8));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f0u)), 4));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0xf0000000u)), 16);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f00000u)), 12));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f000u)), 8));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f0u)), 4));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_rgb_888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         int last;
+         d = _mm_and_si128(s, _mm_set1_epi32((int)0x00ffffffu));
+         d = pack_24_sse2(d);
+         _mm_storel_epi64((__m128i *)(dst_ptr + x * 3), d);
+         last = _mm_cvtsi128_si32(_mm_srli_si128(d, 8));
+         memcpy(dst_ptr + x * 3 + 8, &last, 4);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_ARGB_8888_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void argb_8888_to_rgb_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 8);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000fc00u)), 5));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f8u)), 3));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 8);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000fc00u)), 5));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f8u)), 3));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_rgb_555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 9);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f800u)), 6));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f8u)), 3));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 9);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f800u)), 6));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f8u)), 3));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_rgba_5551_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(s0, 31);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 8));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f800u)), 5));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f8u)), 2));
+         d1 = _mm_srli_epi32(s1, 31);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 8));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f800u)), 5));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f8u)), 2));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_argb_1555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x80000000u)), 16);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 9));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f800u)), 6));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f8u)), 3));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x80000000u)), 16);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 9));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f800u)), 6));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f8u)), 3));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_abgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_srli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm_or_si128(d, _mm_and_si128(s, _mm_set1_epi32((int)0xff00ff00u)));
+         d = _mm_or_si128(d, _mm_slli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x000000ffu)), 16));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_xbgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_srli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm_or_si128(d, _mm_and_si128(s, _mm_set1_epi32((int)0x0000ff00u)));
+         d = _mm_or_si128(d, _mm_slli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x000000ffu)), 16));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_bgr_888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         int last;
+         d = _mm_srli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm_or_si128(d, _mm_and_si128(s, _mm_set1_epi32((int)0x0000ff00u)));
+         d = _mm_or_si128(d, _mm_slli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x000000ffu)), 16));
+         d = pack_24_sse2(d);
+         _mm_storel_epi64((__m128i *)(dst_ptr + x * 3), d);
+         last = _mm_cvtsi128_si32(_mm_srli_si128(d, 8));
+         memcpy(dst_ptr + x * 3 + 8, &last, 4);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_ARGB_8888_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void argb_8888_to_bgr_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 19);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000fc00u)), 5));
+         d0 = _mm_or_si128(d0, _mm_slli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f8u)), 8));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 19);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000fc00u)), 5));
+         d1 = _mm_or_si128(d1, _mm_slli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f8u)), 8));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_bgr_555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 19);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f800u)), 6));
+         d0 = _mm_or_si128(d0, _mm_slli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f8u)), 7));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 19);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f800u)), 6));
+         d1 = _mm_or_si128(d1, _mm_slli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f8u)), 7));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_rgbx_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_slli_epi32(s, 8);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_xrgb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_and_si128(s, _mm_set1_epi32((int)0x00ffffffu));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_abgr_f32_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      ALLEGRO_COLOR *dst_ptr = (ALLEGRO_COLOR *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128 r = _mm_div_ps(_mm_cvtepi32_ps(
+            _mm_and_si128(_mm_srli_epi32(s, 16), _mm_set1_epi32(0xff))), _mm_set1_ps(255.0f));
+         __m128 g = _mm_div_ps(_mm_cvtepi32_ps(
+            _mm_and_si128(_mm_srli_epi32(s, 8), _mm_set1_epi32(0xff))), _mm_set1_ps(255.0f));
+         __m128 b = _mm_div_ps(_mm_cvtepi32_ps(
+            _mm_and_si128(s, _mm_set1_epi32(0xff))), _mm_set1_ps(255.0f));
+         __m128 a = _mm_div_ps(_mm_cvtepi32_ps(
+            _mm_srli_epi32(s, 24)), _mm_set1_ps(255.0f));
+         _MM_TRANSPOSE4_PS(r, g, b, a);
+         _mm_storeu_ps((float *)(dst_ptr + x + 0), r);
+         _mm_storeu_ps((float *)(dst_ptr + x + 1), g);
+         _mm_storeu_ps((float *)(dst_ptr + x + 2), b);
+         _mm_storeu_ps((float *)(dst_ptr + x + 3), a);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ABGR_F32(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_abgr_8888_le_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_srli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm_or_si128(d, _mm_and_si128(s, _mm_set1_epi32((int)0xff00ff00u)));
+         d = _mm_or_si128(d, _mm_slli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x000000ffu)), 16));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_rgba_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(s0, 28);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f00000u)), 8));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f000u)), 4));
+         d0 = _mm_or_si128(d0, _mm_and_si128(s0, _mm_set1_epi32((int)0x000000f0u)));
+         d1 = _mm_srli_epi32(s1, 28);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f00000u)), 8));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f000u)), 4));
+         d1 = _mm_or_si128(d1, _mm_and_si128(s1, _mm_set1_epi32((int)0x000000f0u)));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_argb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_srli_epi32(s, 8);
+         d = _mm_or_si128(d, _mm_slli_epi32(s, 24));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_argb_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0xf0000000u)), 20);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f00000u)), 16));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f000u)), 12));
+         d0 = _mm_or_si128(d0, _mm_slli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f0u)), 8));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0xf0000000u)), 20);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f00000u)), 16));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f000u)), 12));
+         d1 = _mm_or_si128(d1, _mm_slli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f0u)), 8));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_rgb_888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         int last;
+         d = _mm_srli_epi32(s, 8);
+         d = pack_24_sse2(d);
+         _mm_storel_epi64((__m128i *)(dst_ptr + x * 3), d);
+         last = _mm_cvtsi128_si32(_mm_srli_si128(d, 8));
+         memcpy(dst_ptr + x * 3 + 8, &last, 4);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_RGBA_8888_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void rgba_8888_to_rgb_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0xf8000000u)), 16);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00fc0000u)), 13));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f800u)), 11));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0xf8000000u)), 16);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00fc0000u)), 13));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f800u)), 11));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_rgb_555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0xf8000000u)), 17);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 14));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f800u)), 11));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0xf8000000u)), 17);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 14));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f800u)), 11));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_rgba_5551_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0xf8000000u)), 16);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 13));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f800u)), 10));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00000080u)), 7));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0xf8000000u)), 16);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 13));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f800u)), 10));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00000080u)), 7));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_argb_1555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0xf8000000u)), 17);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 14));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f800u)), 11));
+         d0 = _mm_or_si128(d0, _mm_slli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00000080u)), 8));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0xf8000000u)), 17);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 14));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f800u)), 11));
+         d1 = _mm_or_si128(d1, _mm_slli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00000080u)), 8));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_abgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_srli_epi32(s, 24);
+         d = _mm_or_si128(d, _mm_srli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x00ff0000u)), 8));
+         d = _mm_or_si128(d, _mm_slli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x0000ff00u)), 8));
+         d = _mm_or_si128(d, _mm_slli_epi32(s, 24));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_xbgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_srli_epi32(s, 24);
+         d = _mm_or_si128(d, _mm_srli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x00ff0000u)), 8));
+         d = _mm_or_si128(d, _mm_slli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x0000ff00u)), 8));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_bgr_888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         int last;
+         d = _mm_srli_epi32(s, 24);
+         d = _mm_or_si128(d, _mm_srli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x00ff0000u)), 8));
+         d = _mm_or_si128(d, _mm_slli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x0000ff00u)), 8));
+         d = pack_24_sse2(d);
+         _mm_storel_epi64((__m128i *)(dst_ptr + x * 3), d);
+         last = _mm_cvtsi128_si32(_mm_srli_si128(d, 8));
+         memcpy(dst_ptr + x * 3 + 8, &last, 4);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_RGBA_8888_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void rgba_8888_to_bgr_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(s0, 27);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00fc0000u)), 13));
+         d0 = _mm_or_si128(d0, _mm_and_si128(s0, _mm_set1_epi32((int)0x0000f800u)));
+         d1 = _mm_srli_epi32(s1, 27);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00fc0000u)), 13));
+         d1 = _mm_or_si128(d1, _mm_and_si128(s1, _mm_set1_epi32((int)0x0000f800u)));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_bgr_555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(s0, 27);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 14));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f800u)), 1));
+         d1 = _mm_srli_epi32(s1, 27);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 14));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f800u)), 1));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_rgbx_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_and_si128(s, _mm_set1_epi32((int)0xffffff00u));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_xrgb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_srli_epi32(s, 8);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_abgr_f32_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      ALLEGRO_COLOR *dst_ptr = (ALLEGRO_COLOR *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128 r = _mm_div_ps(_mm_cvtepi32_ps(
+            _mm_srli_epi32(s, 24)), _mm_set1_ps(255.0f));
+         __m128 g = _mm_div_ps(_mm_cvtepi32_ps(
+            _mm_and_si128(_mm_srli_epi32(s, 16), _mm_set1_epi32(0xff))), _mm_set1_ps(255.0f));
+         __m128 b = _mm_div_ps(_mm_cvtepi32_ps(
+            _mm_and_si128(_mm_srli_epi32(s, 8), _mm_set1_epi32(0xff))), _mm_set1_ps(255.0f));
+         __m128 a = _mm_div_ps(_mm_cvtepi32_ps(
+            _mm_and_si128(s, _mm_set1_epi32(0xff))), _mm_set1_ps(255.0f));
+         _MM_TRANSPOSE4_PS(r, g, b, a);
+         _mm_storeu_ps((float *)(dst_ptr + x + 0), r);
+         _mm_storeu_ps((float *)(dst_ptr + x + 1), g);
+         _mm_storeu_ps((float *)(dst_ptr + x + 2), b);
+         _mm_storeu_ps((float *)(dst_ptr + x + 3), a);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ABGR_F32(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_abgr_8888_le_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_srli_epi32(s, 24);
+         d = _mm_or_si128(d, _mm_srli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x00ff0000u)), 8));
+         d = _mm_or_si128(d, _mm_slli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x0000ff00u)), 8));
+         d = _mm_or_si128(d, _mm_slli_epi32(s, 24));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_rgba_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0xf0000000u)), 16);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f00000u)), 12));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f000u)), 8));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f0u)), 4));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0xf0000000u)), 16);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f00000u)), 12));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f000u)), 8));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f0u)), 4));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_argb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_srli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm_or_si128(d, _mm_and_si128(s, _mm_set1_epi32((int)0xff00ff00u)));
+         d = _mm_or_si128(d, _mm_slli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x000000ffu)), 16));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_rgba_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_srli_epi32(s, 24);
+         d = _mm_or_si128(d, _mm_srli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x00ff0000u)), 8));
+         d = _mm_or_si128(d, _mm_slli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x0000ff00u)), 8));
+         d = _mm_or_si128(d, _mm_slli_epi32(s, 24));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_argb_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f00000u)), 20);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0xf0000000u)), 16));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f000u)), 8));
+         d0 = _mm_or_si128(d0, _mm_slli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f0u)), 4));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f00000u)), 20);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0xf0000000u)), 16));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f000u)), 8));
+         d1 = _mm_or_si128(d1, _mm_slli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f0u)), 4));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_rgb_888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         int last;
+         d = _mm_srli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm_or_si128(d, _mm_and_si128(s, _mm_set1_epi32((int)0x0000ff00u)));
+         d = _mm_or_si128(d, _mm_slli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x000000ffu)), 16));
+         d = pack_24_sse2(d);
+         _mm_storel_epi64((__m128i *)(dst_ptr + x * 3), d);
+         last = _mm_cvtsi128_si32(_mm_srli_si128(d, 8));
+         memcpy(dst_ptr + x * 3 + 8, &last, 4);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_ABGR_8888_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void abgr_8888_to_rgb_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 19);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000fc00u)), 5));
+         d0 = _mm_or_si128(d0, _mm_slli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f8u)), 8));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 19);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000fc00u)), 5));
+         d1 = _mm_or_si128(d1, _mm_slli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f8u)), 8));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_rgb_555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 19);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f800u)), 6));
+         d0 = _mm_or_si128(d0, _mm_slli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f8u)), 7));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 19);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f800u)), 6));
+         d1 = _mm_or_si128(d1, _mm_slli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f8u)), 7));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_rgba_5551_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(s0, 31);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 18));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f800u)), 5));
+         d0 = _mm_or_si128(d0, _mm_slli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f8u)), 8));
+         d1 = _mm_srli_epi32(s1, 31);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 18));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f800u)), 5));
+         d1 = _mm_or_si128(d1, _mm_slli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f8u)), 8));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_argb_1555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 19);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x80000000u)), 16));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f800u)), 6));
+         d0 = _mm_or_si128(d0, _mm_slli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f8u)), 7));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 19);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x80000000u)), 16));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f800u)), 6));
+         d1 = _mm_or_si128(d1, _mm_slli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f8u)), 7));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_xbgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_and_si128(s, _mm_set1_epi32((int)0x00ffffffu));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_bgr_888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         int last;
+         d = _mm_and_si128(s, _mm_set1_epi32((int)0x00ffffffu));
+         d = pack_24_sse2(d);
+         _mm_storel_epi64((__m128i *)(dst_ptr + x * 3), d);
+         last = _mm_cvtsi128_si32(_mm_srli_si128(d, 8));
+         memcpy(dst_ptr + x * 3 + 8, &last, 4);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_ABGR_8888_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void abgr_8888_to_bgr_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 8);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000fc00u)), 5));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f8u)), 3));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 8);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000fc00u)), 5));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f8u)), 3));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_bgr_555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 9);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f800u)), 6));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f8u)), 3));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 9);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f800u)), 6));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f8u)), 3));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_rgbx_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_srli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x00ff0000u)), 8);
+         d = _mm_or_si128(d, _mm_slli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x0000ff00u)), 8));
+         d = _mm_or_si128(d, _mm_slli_epi32(s, 24));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_xrgb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_srli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm_or_si128(d, _mm_and_si128(s, _mm_set1_epi32((int)0x0000ff00u)));
+         d = _mm_or_si128(d, _mm_slli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x000000ffu)), 16));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_abgr_f32_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      ALLEGRO_COLOR *dst_ptr = (ALLEGRO_COLOR *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128 r = _mm_div_ps(_mm_cvtepi32_ps(
+            _mm_and_si128(s, _mm_set1_epi32(0xff))), _mm_set1_ps(255.0f));
+         __m128 g = _mm_div_ps(_mm_cvtepi32_ps(
+            _mm_and_si128(_mm_srli_epi32(s, 8), _mm_set1_epi32(0xff))), _mm_set1_ps(255.0f));
+         __m128 b = _mm_div_ps(_mm_cvtepi32_ps(
+            _mm_and_si128(_mm_srli_epi32(s, 16), _mm_set1_epi32(0xff))), _mm_set1_ps(255.0f));
+         __m128 a = _mm_div_ps(_mm_cvtepi32_ps(
+            _mm_srli_epi32(s, 24)), _mm_set1_ps(255.0f));
+         _MM_TRANSPOSE4_PS(r, g, b, a);
+         _mm_storeu_ps((float *)(dst_ptr + x + 0), r);
+         _mm_storeu_ps((float *)(dst_ptr + x + 1), g);
+         _mm_storeu_ps((float *)(dst_ptr + x + 2), b);
+         _mm_storeu_ps((float *)(dst_ptr + x + 3), a);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ABGR_F32(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_abgr_8888_le_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = s;
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_rgba_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(s0, 28);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f00000u)), 16));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f000u)), 4));
+         d0 = _mm_or_si128(d0, _mm_slli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f0u)), 8));
+         d1 = _mm_srli_epi32(s1, 28);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f00000u)), 16));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f000u)), 4));
+         d1 = _mm_or_si128(d1, _mm_slli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f0u)), 8));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_argb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_srli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm_or_si128(d, _mm_and_si128(s, _mm_set1_epi32((int)0x0000ff00u)));
+         d = _mm_or_si128(d, _mm_slli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x000000ffu)), 16));
+         d = _mm_or_si128(d, _mm_set1_epi32((int)0xff000000u));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_rgba_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_srli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x00ff0000u)), 8);
+         d = _mm_or_si128(d, _mm_slli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x0000ff00u)), 8));
+         d = _mm_or_si128(d, _mm_slli_epi32(s, 24));
+         d = _mm_or_si128(d, _mm_set1_epi32((int)0x000000ffu));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_argb_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f00000u)), 20);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f000u)), 8));
+         d0 = _mm_or_si128(d0, _mm_slli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f0u)), 4));
+         d0 = _mm_or_si128(d0, _mm_set1_epi32((int)0x0000f000u));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f00000u)), 20);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f000u)), 8));
+         d1 = _mm_or_si128(d1, _mm_slli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f0u)), 4));
+         d1 = _mm_or_si128(d1, _mm_set1_epi32((int)0x0000f000u));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_rgb_888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         int last;
+         d = _mm_srli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm_or_si128(d, _mm_and_si128(s, _mm_set1_epi32((int)0x0000ff00u)));
+         d = _mm_or_si128(d, _mm_slli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x000000ffu)), 16));
+         d = pack_24_sse2(d);
+         _mm_storel_epi64((__m128i *)(dst_ptr + x * 3), d);
+         last = _mm_cvtsi128_si32(_mm_srli_si128(d, 8));
+         memcpy(dst_ptr + x * 3 + 8, &last, 4);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_XBGR_8888_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void xbgr_8888_to_rgb_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 19);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000fc00u)), 5));
+         d0 = _mm_or_si128(d0, _mm_slli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f8u)), 8));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 19);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000fc00u)), 5));
+         d1 = _mm_or_si128(d1, _mm_slli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f8u)), 8));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_rgb_555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 19);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f800u)), 6));
+         d0 = _mm_or_si128(d0, _mm_slli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f8u)), 7));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 19);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f800u)), 6));
+         d1 = _mm_or_si128(d1, _mm_slli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f8u)), 7));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_rgba_5551_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 18);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f800u)), 5));
+         d0 = _mm_or_si128(d0, _mm_slli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f8u)), 8));
+         d0 = _mm_or_si128(d0, _mm_set1_epi32((int)0x00000001u));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 18);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f800u)), 5));
+         d1 = _mm_or_si128(d1, _mm_slli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f8u)), 8));
+         d1 = _mm_or_si128(d1, _mm_set1_epi32((int)0x00000001u));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_argb_1555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 19);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f800u)), 6));
+         d0 = _mm_or_si128(d0, _mm_slli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f8u)), 7));
+         d0 = _mm_or_si128(d0, _mm_set1_epi32((int)0x00008000u));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 19);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f800u)), 6));
+         d1 = _mm_or_si128(d1, _mm_slli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f8u)), 7));
+         d1 = _mm_or_si128(d1, _mm_set1_epi32((int)0x00008000u));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_abgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_and_si128(s, _mm_set1_epi32((int)0x00ffffffu));
+         d = _mm_or_si128(d, _mm_set1_epi32((int)0xff000000u));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_bgr_888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         int last;
+         d = _mm_and_si128(s, _mm_set1_epi32((int)0x00ffffffu));
+         d = pack_24_sse2(d);
+         _mm_storel_epi64((__m128i *)(dst_ptr + x * 3), d);
+         last = _mm_cvtsi128_si32(_mm_srli_si128(d, 8));
+         memcpy(dst_ptr + x * 3 + 8, &last, 4);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_XBGR_8888_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void xbgr_8888_to_bgr_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 8);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000fc00u)), 5));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f8u)), 3));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 8);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000fc00u)), 5));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f8u)), 3));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_bgr_555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 9);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f800u)), 6));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f8u)), 3));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 9);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f800u)), 6));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f8u)), 3));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_rgbx_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_srli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x00ff0000u)), 8);
+         d = _mm_or_si128(d, _mm_slli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x0000ff00u)), 8));
+         d = _mm_or_si128(d, _mm_slli_epi32(s, 24));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_xrgb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_srli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm_or_si128(d, _mm_and_si128(s, _mm_set1_epi32((int)0x0000ff00u)));
+         d = _mm_or_si128(d, _mm_slli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x000000ffu)), 16));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_abgr_f32_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      ALLEGRO_COLOR *dst_ptr = (ALLEGRO_COLOR *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128 r = _mm_div_ps(_mm_cvtepi32_ps(
+            _mm_and_si128(s, _mm_set1_epi32(0xff))), _mm_set1_ps(255.0f));
+         __m128 g = _mm_div_ps(_mm_cvtepi32_ps(
+            _mm_and_si128(_mm_srli_epi32(s, 8), _mm_set1_epi32(0xff))), _mm_set1_ps(255.0f));
+         __m128 b = _mm_div_ps(_mm_cvtepi32_ps(
+            _mm_and_si128(_mm_srli_epi32(s, 16), _mm_set1_epi32(0xff))), _mm_set1_ps(255.0f));
+         __m128 a = _mm_set1_ps(1.0f);
+         _MM_TRANSPOSE4_PS(r, g, b, a);
+         _mm_storeu_ps((float *)(dst_ptr + x + 0), r);
+         _mm_storeu_ps((float *)(dst_ptr + x + 1), g);
+         _mm_storeu_ps((float *)(dst_ptr + x + 2), b);
+         _mm_storeu_ps((float *)(dst_ptr + x + 3), a);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ABGR_F32(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_abgr_8888_le_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_and_si128(s, _mm_set1_epi32((int)0x00ffffffu));
+         d = _mm_or_si128(d, _mm_set1_epi32((int)0xff000000u));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_rgba_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f00000u)), 16);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f000u)), 4));
+         d0 = _mm_or_si128(d0, _mm_slli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f0u)), 8));
+         d0 = _mm_or_si128(d0, _mm_set1_epi32((int)0x0000000fu));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f00000u)), 16);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f000u)), 4));
+         d1 = _mm_or_si128(d1, _mm_slli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f0u)), 8));
+         d1 = _mm_or_si128(d1, _mm_set1_epi32((int)0x0000000fu));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_argb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_srli_epi32(s, 8);
+         d = _mm_or_si128(d, _mm_set1_epi32((int)0xff000000u));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_rgba_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_and_si128(s, _mm_set1_epi32((int)0xffffff00u));
+         d = _mm_or_si128(d, _mm_set1_epi32((int)0x000000ffu));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_argb_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0xf0000000u)), 20);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f00000u)), 16));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f000u)), 12));
+         d0 = _mm_or_si128(d0, _mm_set1_epi32((int)0x0000f000u));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0xf0000000u)), 20);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f00000u)), 16));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f000u)), 12));
+         d1 = _mm_or_si128(d1, _mm_set1_epi32((int)0x0000f000u));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_rgb_888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         int last;
+         d = _mm_srli_epi32(s, 8);
+         d = pack_24_sse2(d);
+         _mm_storel_epi64((__m128i *)(dst_ptr + x * 3), d);
+         last = _mm_cvtsi128_si32(_mm_srli_si128(d, 8));
+         memcpy(dst_ptr + x * 3 + 8, &last, 4);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_RGBX_8888_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void rgbx_8888_to_rgb_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0xf8000000u)), 16);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00fc0000u)), 13));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f800u)), 11));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0xf8000000u)), 16);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00fc0000u)), 13));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f800u)), 11));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_rgb_555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0xf8000000u)), 17);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 14));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f800u)), 11));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0xf8000000u)), 17);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 14));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f800u)), 11));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_rgba_5551_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0xf8000000u)), 16);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 13));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f800u)), 10));
+         d0 = _mm_or_si128(d0, _mm_set1_epi32((int)0x00000001u));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0xf8000000u)), 16);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 13));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f800u)), 10));
+         d1 = _mm_or_si128(d1, _mm_set1_epi32((int)0x00000001u));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_argb_1555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0xf8000000u)), 17);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 14));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f800u)), 11));
+         d0 = _mm_or_si128(d0, _mm_set1_epi32((int)0x00008000u));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0xf8000000u)), 17);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 14));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f800u)), 11));
+         d1 = _mm_or_si128(d1, _mm_set1_epi32((int)0x00008000u));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_abgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_srli_epi32(s, 24);
+         d = _mm_or_si128(d, _mm_srli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x00ff0000u)), 8));
+         d = _mm_or_si128(d, _mm_slli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x0000ff00u)), 8));
+         d = _mm_or_si128(d, _mm_set1_epi32((int)0xff000000u));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_xbgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_srli_epi32(s, 24);
+         d = _mm_or_si128(d, _mm_srli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x00ff0000u)), 8));
+         d = _mm_or_si128(d, _mm_slli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x0000ff00u)), 8));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_bgr_888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         int last;
+         d = _mm_srli_epi32(s, 24);
+         d = _mm_or_si128(d, _mm_srli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x00ff0000u)), 8));
+         d = _mm_or_si128(d, _mm_slli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x0000ff00u)), 8));
+         d = pack_24_sse2(d);
+         _mm_storel_epi64((__m128i *)(dst_ptr + x * 3), d);
+         last = _mm_cvtsi128_si32(_mm_srli_si128(d, 8));
+         memcpy(dst_ptr + x * 3 + 8, &last, 4);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_RGBX_8888_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void rgbx_8888_to_bgr_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(s0, 27);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00fc0000u)), 13));
+         d0 = _mm_or_si128(d0, _mm_and_si128(s0, _mm_set1_epi32((int)0x0000f800u)));
+         d1 = _mm_srli_epi32(s1, 27);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00fc0000u)), 13));
+         d1 = _mm_or_si128(d1, _mm_and_si128(s1, _mm_set1_epi32((int)0x0000f800u)));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_bgr_555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(s0, 27);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 14));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f800u)), 1));
+         d1 = _mm_srli_epi32(s1, 27);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 14));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f800u)), 1));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_xrgb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_srli_epi32(s, 8);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_abgr_f32_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      ALLEGRO_COLOR *dst_ptr = (ALLEGRO_COLOR *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128 r = _mm_div_ps(_mm_cvtepi32_ps(
+            _mm_srli_epi32(s, 24)), _mm_set1_ps(255.0f));
+         __m128 g = _mm_div_ps(_mm_cvtepi32_ps(
+            _mm_and_si128(_mm_srli_epi32(s, 16), _mm_set1_epi32(0xff))), _mm_set1_ps(255.0f));
+         __m128 b = _mm_div_ps(_mm_cvtepi32_ps(
+            _mm_and_si128(_mm_srli_epi32(s, 8), _mm_set1_epi32(0xff))), _mm_set1_ps(255.0f));
+         __m128 a = _mm_set1_ps(1.0f);
+         _MM_TRANSPOSE4_PS(r, g, b, a);
+         _mm_storeu_ps((float *)(dst_ptr + x + 0), r);
+         _mm_storeu_ps((float *)(dst_ptr + x + 1), g);
+         _mm_storeu_ps((float *)(dst_ptr + x + 2), b);
+         _mm_storeu_ps((float *)(dst_ptr + x + 3), a);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ABGR_F32(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_abgr_8888_le_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_srli_epi32(s, 24);
+         d = _mm_or_si128(d, _mm_srli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x00ff0000u)), 8));
+         d = _mm_or_si128(d, _mm_slli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x0000ff00u)), 8));
+         d = _mm_or_si128(d, _mm_set1_epi32((int)0xff000000u));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_rgba_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0xf0000000u)), 16);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f00000u)), 12));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f000u)), 8));
+         d0 = _mm_or_si128(d0, _mm_set1_epi32((int)0x0000000fu));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0xf0000000u)), 16);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f00000u)), 12));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f000u)), 8));
+         d1 = _mm_or_si128(d1, _mm_set1_epi32((int)0x0000000fu));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_argb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_and_si128(s, _mm_set1_epi32((int)0x00ffffffu));
+         d = _mm_or_si128(d, _mm_set1_epi32((int)0xff000000u));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_rgba_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_slli_epi32(s, 8);
+         d = _mm_or_si128(d, _mm_set1_epi32((int)0x000000ffu));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_argb_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f00000u)), 12);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f000u)), 8));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f0u)), 4));
+         d0 = _mm_or_si128(d0, _mm_set1_epi32((int)0x0000f000u));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f00000u)), 12);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f000u)), 8));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f0u)), 4));
+         d1 = _mm_or_si128(d1, _mm_set1_epi32((int)0x0000f000u));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_rgb_888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         int last;
+         d = _mm_and_si128(s, _mm_set1_epi32((int)0x00ffffffu));
+         d = pack_24_sse2(d);
+         _mm_storel_epi64((__m128i *)(dst_ptr + x * 3), d);
+         last = _mm_cvtsi128_si32(_mm_srli_si128(d, 8));
+         memcpy(dst_ptr + x * 3 + 8, &last, 4);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_XRGB_8888_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void xrgb_8888_to_rgb_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 8);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000fc00u)), 5));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f8u)), 3));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 8);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000fc00u)), 5));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f8u)), 3));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_rgb_555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 9);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f800u)), 6));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f8u)), 3));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 9);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f800u)), 6));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f8u)), 3));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_rgba_5551_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 8);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f800u)), 5));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f8u)), 2));
+         d0 = _mm_or_si128(d0, _mm_set1_epi32((int)0x00000001u));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 8);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f800u)), 5));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f8u)), 2));
+         d1 = _mm_or_si128(d1, _mm_set1_epi32((int)0x00000001u));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_argb_1555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 9);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f800u)), 6));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f8u)), 3));
+         d0 = _mm_or_si128(d0, _mm_set1_epi32((int)0x00008000u));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 9);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f800u)), 6));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f8u)), 3));
+         d1 = _mm_or_si128(d1, _mm_set1_epi32((int)0x00008000u));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_abgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_srli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm_or_si128(d, _mm_and_si128(s, _mm_set1_epi32((int)0x0000ff00u)));
+         d = _mm_or_si128(d, _mm_slli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x000000ffu)), 16));
+         d = _mm_or_si128(d, _mm_set1_epi32((int)0xff000000u));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_xbgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_srli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm_or_si128(d, _mm_and_si128(s, _mm_set1_epi32((int)0x0000ff00u)));
+         d = _mm_or_si128(d, _mm_slli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x000000ffu)), 16));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_bgr_888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         int last;
+         d = _mm_srli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm_or_si128(d, _mm_and_si128(s, _mm_set1_epi32((int)0x0000ff00u)));
+         d = _mm_or_si128(d, _mm_slli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x000000ffu)), 16));
+         d = pack_24_sse2(d);
+         _mm_storel_epi64((__m128i *)(dst_ptr + x * 3), d);
+         last = _mm_cvtsi128_si32(_mm_srli_si128(d, 8));
+         memcpy(dst_ptr + x * 3 + 8, &last, 4);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_XRGB_8888_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void xrgb_8888_to_bgr_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 19);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000fc00u)), 5));
+         d0 = _mm_or_si128(d0, _mm_slli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f8u)), 8));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 19);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000fc00u)), 5));
+         d1 = _mm_or_si128(d1, _mm_slli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f8u)), 8));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_bgr_555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 19);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f800u)), 6));
+         d0 = _mm_or_si128(d0, _mm_slli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f8u)), 7));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 19);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f800u)), 6));
+         d1 = _mm_or_si128(d1, _mm_slli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f8u)), 7));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_rgbx_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_slli_epi32(s, 8);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_abgr_f32_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      ALLEGRO_COLOR *dst_ptr = (ALLEGRO_COLOR *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128 r = _mm_div_ps(_mm_cvtepi32_ps(
+            _mm_and_si128(_mm_srli_epi32(s, 16), _mm_set1_epi32(0xff))), _mm_set1_ps(255.0f));
+         __m128 g = _mm_div_ps(_mm_cvtepi32_ps(
+            _mm_and_si128(_mm_srli_epi32(s, 8), _mm_set1_epi32(0xff))), _mm_set1_ps(255.0f));
+         __m128 b = _mm_div_ps(_mm_cvtepi32_ps(
+            _mm_and_si128(s, _mm_set1_epi32(0xff))), _mm_set1_ps(255.0f));
+         __m128 a = _mm_set1_ps(1.0f);
+         _MM_TRANSPOSE4_PS(r, g, b, a);
+         _mm_storeu_ps((float *)(dst_ptr + x + 0), r);
+         _mm_storeu_ps((float *)(dst_ptr + x + 1), g);
+         _mm_storeu_ps((float *)(dst_ptr + x + 2), b);
+         _mm_storeu_ps((float *)(dst_ptr + x + 3), a);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ABGR_F32(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_abgr_8888_le_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_srli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm_or_si128(d, _mm_and_si128(s, _mm_set1_epi32((int)0x0000ff00u)));
+         d = _mm_or_si128(d, _mm_slli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x000000ffu)), 16));
+         d = _mm_or_si128(d, _mm_set1_epi32((int)0xff000000u));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_rgba_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f00000u)), 8);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f000u)), 4));
+         d0 = _mm_or_si128(d0, _mm_and_si128(s0, _mm_set1_epi32((int)0x000000f0u)));
+         d0 = _mm_or_si128(d0, _mm_set1_epi32((int)0x0000000fu));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f00000u)), 8);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f000u)), 4));
+         d1 = _mm_or_si128(d1, _mm_and_si128(s1, _mm_set1_epi32((int)0x000000f0u)));
+         d1 = _mm_or_si128(d1, _mm_set1_epi32((int)0x0000000fu));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+static void abgr_f32_to_argb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const ALLEGRO_COLOR *src_ptr = (const ALLEGRO_COLOR *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128 r = _mm_loadu_ps((const float *)(src_ptr + x + 0));
+         __m128 g = _mm_loadu_ps((const float *)(src_ptr + x + 1));
+         __m128 b = _mm_loadu_ps((const float *)(src_ptr + x + 2));
+         __m128 a = _mm_loadu_ps((const float *)(src_ptr + x + 3));
+         __m128i d;
+         _MM_TRANSPOSE4_PS(r, g, b, a);
+         d = _mm_slli_epi32(_mm_cvttps_epi32(_mm_mul_ps(r, _mm_set1_ps(255.0f))), 16);
+         d = _mm_or_si128(d,
+            _mm_slli_epi32(_mm_cvttps_epi32(_mm_mul_ps(g, _mm_set1_ps(255.0f))), 8));
+         d = _mm_or_si128(d,
+            _mm_cvttps_epi32(_mm_mul_ps(b, _mm_set1_ps(255.0f))));
+         d = _mm_or_si128(d,
+            _mm_slli_epi32(_mm_cvttps_epi32(_mm_mul_ps(a, _mm_set1_ps(255.0f))), 24));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_F32_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_f32_to_rgba_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const ALLEGRO_COLOR *src_ptr = (const ALLEGRO_COLOR *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128 r = _mm_loadu_ps((const float *)(src_ptr + x + 0));
+         __m128 g = _mm_loadu_ps((const float *)(src_ptr + x + 1));
+         __m128 b = _mm_loadu_ps((const float *)(src_ptr + x + 2));
+         __m128 a = _mm_loadu_ps((const float *)(src_ptr + x + 3));
+         __m128i d;
+         _MM_TRANSPOSE4_PS(r, g, b, a);
+         d = _mm_slli_epi32(_mm_cvttps_epi32(_mm_mul_ps(r, _mm_set1_ps(255.0f))), 24);
+         d = _mm_or_si128(d,
+            _mm_slli_epi32(_mm_cvttps_epi32(_mm_mul_ps(g, _mm_set1_ps(255.0f))), 16));
+         d = _mm_or_si128(d,
+            _mm_slli_epi32(_mm_cvttps_epi32(_mm_mul_ps(b, _mm_set1_ps(255.0f))), 8));
+         d = _mm_or_si128(d,
+            _mm_cvttps_epi32(_mm_mul_ps(a, _mm_set1_ps(255.0f))));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_F32_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_f32_to_abgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const ALLEGRO_COLOR *src_ptr = (const ALLEGRO_COLOR *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128 r = _mm_loadu_ps((const float *)(src_ptr + x + 0));
+         __m128 g = _mm_loadu_ps((const float *)(src_ptr + x + 1));
+         __m128 b = _mm_loadu_ps((const float *)(src_ptr + x + 2));
+         __m128 a = _mm_loadu_ps((const float *)(src_ptr + x + 3));
+         __m128i d;
+         _MM_TRANSPOSE4_PS(r, g, b, a);
+         d = _mm_cvttps_epi32(_mm_mul_ps(r, _mm_set1_ps(255.0f)));
+         d = _mm_or_si128(d,
+            _mm_slli_epi32(_mm_cvttps_epi32(_mm_mul_ps(g, _mm_set1_ps(255.0f))), 8));
+         d = _mm_or_si128(d,
+            _mm_slli_epi32(_mm_cvttps_epi32(_mm_mul_ps(b, _mm_set1_ps(255.0f))), 16));
+         d = _mm_or_si128(d,
+            _mm_slli_epi32(_mm_cvttps_epi32(_mm_mul_ps(a, _mm_set1_ps(255.0f))), 24));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_F32_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_f32_to_xbgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const ALLEGRO_COLOR *src_ptr = (const ALLEGRO_COLOR *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128 r = _mm_loadu_ps((const float *)(src_ptr + x + 0));
+         __m128 g = _mm_loadu_ps((const float *)(src_ptr + x + 1));
+         __m128 b = _mm_loadu_ps((const float *)(src_ptr + x + 2));
+         __m128 a = _mm_loadu_ps((const float *)(src_ptr + x + 3));
+         __m128i d;
+         _MM_TRANSPOSE4_PS(r, g, b, a);
+         d = _mm_cvttps_epi32(_mm_mul_ps(r, _mm_set1_ps(255.0f)));
+         d = _mm_or_si128(d,
+            _mm_slli_epi32(_mm_cvttps_epi32(_mm_mul_ps(g, _mm_set1_ps(255.0f))), 8));
+         d = _mm_or_si128(d,
+            _mm_slli_epi32(_mm_cvttps_epi32(_mm_mul_ps(b, _mm_set1_ps(255.0f))), 16));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_F32_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_f32_to_rgbx_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const ALLEGRO_COLOR *src_ptr = (const ALLEGRO_COLOR *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128 r = _mm_loadu_ps((const float *)(src_ptr + x + 0));
+         __m128 g = _mm_loadu_ps((const float *)(src_ptr + x + 1));
+         __m128 b = _mm_loadu_ps((const float *)(src_ptr + x + 2));
+         __m128 a = _mm_loadu_ps((const float *)(src_ptr + x + 3));
+         __m128i d;
+         _MM_TRANSPOSE4_PS(r, g, b, a);
+         d = _mm_slli_epi32(_mm_cvttps_epi32(_mm_mul_ps(r, _mm_set1_ps(255.0f))), 24);
+         d = _mm_or_si128(d,
+            _mm_slli_epi32(_mm_cvttps_epi32(_mm_mul_ps(g, _mm_set1_ps(255.0f))), 16));
+         d = _mm_or_si128(d,
+            _mm_slli_epi32(_mm_cvttps_epi32(_mm_mul_ps(b, _mm_set1_ps(255.0f))), 8));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_F32_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_f32_to_xrgb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const ALLEGRO_COLOR *src_ptr = (const ALLEGRO_COLOR *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128 r = _mm_loadu_ps((const float *)(src_ptr + x + 0));
+         __m128 g = _mm_loadu_ps((const float *)(src_ptr + x + 1));
+         __m128 b = _mm_loadu_ps((const float *)(src_ptr + x + 2));
+         __m128 a = _mm_loadu_ps((const float *)(src_ptr + x + 3));
+         __m128i d;
+         _MM_TRANSPOSE4_PS(r, g, b, a);
+         d = _mm_slli_epi32(_mm_cvttps_epi32(_mm_mul_ps(r, _mm_set1_ps(255.0f))), 16);
+         d = _mm_or_si128(d,
+            _mm_slli_epi32(_mm_cvttps_epi32(_mm_mul_ps(g, _mm_set1_ps(255.0f))), 8));
+         d = _mm_or_si128(d,
+            _mm_cvttps_epi32(_mm_mul_ps(b, _mm_set1_ps(255.0f))));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_F32_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_f32_to_abgr_8888_le_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const ALLEGRO_COLOR *src_ptr = (const ALLEGRO_COLOR *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128 r = _mm_loadu_ps((const float *)(src_ptr + x + 0));
+         __m128 g = _mm_loadu_ps((const float *)(src_ptr + x + 1));
+         __m128 b = _mm_loadu_ps((const float *)(src_ptr + x + 2));
+         __m128 a = _mm_loadu_ps((const float *)(src_ptr + x + 3));
+         __m128i d;
+         _MM_TRANSPOSE4_PS(r, g, b, a);
+         d = _mm_cvttps_epi32(_mm_mul_ps(r, _mm_set1_ps(255.0f)));
+         d = _mm_or_si128(d,
+            _mm_slli_epi32(_mm_cvttps_epi32(_mm_mul_ps(g, _mm_set1_ps(255.0f))), 8));
+         d = _mm_or_si128(d,
+            _mm_slli_epi32(_mm_cvttps_epi32(_mm_mul_ps(b, _mm_set1_ps(255.0f))), 16));
+         d = _mm_or_si128(d,
+            _mm_slli_epi32(_mm_cvttps_epi32(_mm_mul_ps(a, _mm_set1_ps(255.0f))), 24));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_F32_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_argb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_srli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm_or_si128(d, _mm_and_si128(s, _mm_set1_epi32((int)0xff00ff00u)));
+         d = _mm_or_si128(d, _mm_slli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x000000ffu)), 16));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_rgba_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_srli_epi32(s, 24);
+         d = _mm_or_si128(d, _mm_srli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x00ff0000u)), 8));
+         d = _mm_or_si128(d, _mm_slli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x0000ff00u)), 8));
+         d = _mm_or_si128(d, _mm_slli_epi32(s, 24));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_argb_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f00000u)), 20);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0xf0000000u)), 16));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f000u)), 8));
+         d0 = _mm_or_si128(d0, _mm_slli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f0u)), 4));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f00000u)), 20);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0xf0000000u)), 16));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f000u)), 8));
+         d1 = _mm_or_si128(d1, _mm_slli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f0u)), 4));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_rgb_888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         int last;
+         d = _mm_srli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm_or_si128(d, _mm_and_si128(s, _mm_set1_epi32((int)0x0000ff00u)));
+         d = _mm_or_si128(d, _mm_slli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x000000ffu)), 16));
+         d = pack_24_sse2(d);
+         _mm_storel_epi64((__m128i *)(dst_ptr + x * 3), d);
+         last = _mm_cvtsi128_si32(_mm_srli_si128(d, 8));
+         memcpy(dst_ptr + x * 3 + 8, &last, 4);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void abgr_8888_le_to_rgb_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 19);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000fc00u)), 5));
+         d0 = _mm_or_si128(d0, _mm_slli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f8u)), 8));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 19);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000fc00u)), 5));
+         d1 = _mm_or_si128(d1, _mm_slli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f8u)), 8));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_rgb_555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 19);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f800u)), 6));
+         d0 = _mm_or_si128(d0, _mm_slli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f8u)), 7));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 19);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f800u)), 6));
+         d1 = _mm_or_si128(d1, _mm_slli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f8u)), 7));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_rgba_5551_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(s0, 31);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 18));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f800u)), 5));
+         d0 = _mm_or_si128(d0, _mm_slli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f8u)), 8));
+         d1 = _mm_srli_epi32(s1, 31);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 18));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f800u)), 5));
+         d1 = _mm_or_si128(d1, _mm_slli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f8u)), 8));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_argb_1555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 19);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x80000000u)), 16));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f800u)), 6));
+         d0 = _mm_or_si128(d0, _mm_slli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f8u)), 7));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 19);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x80000000u)), 16));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f800u)), 6));
+         d1 = _mm_or_si128(d1, _mm_slli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f8u)), 7));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_abgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = s;
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_xbgr_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_and_si128(s, _mm_set1_epi32((int)0x00ffffffu));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_bgr_888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         int last;
+         d = _mm_and_si128(s, _mm_set1_epi32((int)0x00ffffffu));
+         d = pack_24_sse2(d);
+         _mm_storel_epi64((__m128i *)(dst_ptr + x * 3), d);
+         last = _mm_cvtsi128_si32(_mm_srli_si128(d, 8));
+         memcpy(dst_ptr + x * 3 + 8, &last, 4);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_ABGR_8888_LE_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void abgr_8888_le_to_bgr_565_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 8);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000fc00u)), 5));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f8u)), 3));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 8);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000fc00u)), 5));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f8u)), 3));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_bgr_555_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f80000u)), 9);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f800u)), 6));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f8u)), 3));
+         d1 = _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f80000u)), 9);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f800u)), 6));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f8u)), 3));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_rgbx_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_srli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x00ff0000u)), 8);
+         d = _mm_or_si128(d, _mm_slli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x0000ff00u)), 8));
+         d = _mm_or_si128(d, _mm_slli_epi32(s, 24));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_xrgb_8888_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i d;
+         d = _mm_srli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm_or_si128(d, _mm_and_si128(s, _mm_set1_epi32((int)0x0000ff00u)));
+         d = _mm_or_si128(d, _mm_slli_epi32(_mm_and_si128(s, _mm_set1_epi32((int)0x000000ffu)), 16));
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_abgr_f32_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      ALLEGRO_COLOR *dst_ptr = (ALLEGRO_COLOR *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         __m128i s = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128 r = _mm_div_ps(_mm_cvtepi32_ps(
+            _mm_and_si128(s, _mm_set1_epi32(0xff))), _mm_set1_ps(255.0f));
+         __m128 g = _mm_div_ps(_mm_cvtepi32_ps(
+            _mm_and_si128(_mm_srli_epi32(s, 8), _mm_set1_epi32(0xff))), _mm_set1_ps(255.0f));
+         __m128 b = _mm_div_ps(_mm_cvtepi32_ps(
+            _mm_and_si128(_mm_srli_epi32(s, 16), _mm_set1_epi32(0xff))), _mm_set1_ps(255.0f));
+         __m128 a = _mm_div_ps(_mm_cvtepi32_ps(
+            _mm_srli_epi32(s, 24)), _mm_set1_ps(255.0f));
+         _MM_TRANSPOSE4_PS(r, g, b, a);
+         _mm_storeu_ps((float *)(dst_ptr + x + 0), r);
+         _mm_storeu_ps((float *)(dst_ptr + x + 1), g);
+         _mm_storeu_ps((float *)(dst_ptr + x + 2), b);
+         _mm_storeu_ps((float *)(dst_ptr + x + 3), a);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ABGR_F32(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_rgba_4444_sse2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m128i s0 = _mm_loadu_si128((const __m128i *)(src_ptr + x));
+         __m128i s1 = _mm_loadu_si128((const __m128i *)(src_ptr + x + 4));
+         __m128i d0, d1;
+         d0 = _mm_srli_epi32(s0, 28);
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x00f00000u)), 16));
+         d0 = _mm_or_si128(d0, _mm_srli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x0000f000u)), 4));
+         d0 = _mm_or_si128(d0, _mm_slli_epi32(_mm_and_si128(s0, _mm_set1_epi32((int)0x000000f0u)), 8));
+         d1 = _mm_srli_epi32(s1, 28);
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x00f00000u)), 16));
+         d1 = _mm_or_si128(d1, _mm_srli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x0000f000u)), 4));
+         d1 = _mm_or_si128(d1, _mm_slli_epi32(_mm_and_si128(s1, _mm_set1_epi32((int)0x000000f0u)), 8));
+         d0 = _mm_srai_epi32(_mm_slli_epi32(d0, 16), 16);
+         d1 = _mm_srai_epi32(_mm_slli_epi32(d1, 16), 16);
+         _mm_storeu_si128((__m128i *)(dst_ptr + x), _mm_packs_epi32(d0, d1));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+#endif
+
+#ifdef CONVERT_AVX2
+static AVX2_TARGET void argb_8888_to_rgba_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(s, 24);
+         d = _mm256_or_si256(d, _mm256_slli_epi32(s, 8));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void argb_8888_to_argb_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0xf0000000u)), 16);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f00000u)), 12));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f000u)), 8));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f0u)), 4));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0xf0000000u)), 16);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f00000u)), 12));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f000u)), 8));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f0u)), 4));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void argb_8888_to_rgb_888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_and_si256(s, _mm256_set1_epi32((int)0x00ffffffu));
+         store_24_avx2(dst_ptr + x * 3, _mm256_castsi256_si128(d));
+         store_24_avx2(dst_ptr + x * 3 + 12, _mm256_extracti128_si256(d, 1));
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_ARGB_8888_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static AVX2_TARGET void argb_8888_to_rgb_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 8);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000fc00u)), 5));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f8u)), 3));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 8);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000fc00u)), 5));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f8u)), 3));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void argb_8888_to_rgb_555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 9);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f800u)), 6));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f8u)), 3));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 9);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f800u)), 6));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f8u)), 3));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void argb_8888_to_rgba_5551_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(s0, 31);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 8));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f800u)), 5));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f8u)), 2));
+         d1 = _mm256_srli_epi32(s1, 31);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 8));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f800u)), 5));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f8u)), 2));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void argb_8888_to_argb_1555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x80000000u)), 16);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 9));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f800u)), 6));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f8u)), 3));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x80000000u)), 16);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 9));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f800u)), 6));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f8u)), 3));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void argb_8888_to_abgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm256_or_si256(d, _mm256_and_si256(s, _mm256_set1_epi32((int)0xff00ff00u)));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x000000ffu)), 16));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void argb_8888_to_xbgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm256_or_si256(d, _mm256_and_si256(s, _mm256_set1_epi32((int)0x0000ff00u)));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x000000ffu)), 16));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void argb_8888_to_bgr_888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm256_or_si256(d, _mm256_and_si256(s, _mm256_set1_epi32((int)0x0000ff00u)));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x000000ffu)), 16));
+         store_24_avx2(dst_ptr + x * 3, _mm256_castsi256_si128(d));
+         store_24_avx2(dst_ptr + x * 3 + 12, _mm256_extracti128_si256(d, 1));
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_ARGB_8888_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static AVX2_TARGET void argb_8888_to_bgr_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 19);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000fc00u)), 5));
+         d0 = _mm256_or_si256(d0, _mm256_slli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f8u)), 8));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 19);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000fc00u)), 5));
+         d1 = _mm256_or_si256(d1, _mm256_slli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f8u)), 8));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void argb_8888_to_bgr_555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 19);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f800u)), 6));
+         d0 = _mm256_or_si256(d0, _mm256_slli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f8u)), 7));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 19);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f800u)), 6));
+         d1 = _mm256_or_si256(d1, _mm256_slli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f8u)), 7));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void argb_8888_to_rgbx_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_slli_epi32(s, 8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void argb_8888_to_xrgb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_and_si256(s, _mm256_set1_epi32((int)0x00ffffffu));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void argb_8888_to_abgr_8888_le_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm256_or_si256(d, _mm256_and_si256(s, _mm256_set1_epi32((int)0xff00ff00u)));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x000000ffu)), 16));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void argb_8888_to_rgba_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(s0, 28);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f00000u)), 8));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f000u)), 4));
+         d0 = _mm256_or_si256(d0, _mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f0u)));
+         d1 = _mm256_srli_epi32(s1, 28);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f00000u)), 8));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f000u)), 4));
+         d1 = _mm256_or_si256(d1, _mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f0u)));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void rgba_8888_to_argb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(s, 8);
+         d = _mm256_or_si256(d, _mm256_slli_epi32(s, 24));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void rgba_8888_to_argb_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0xf0000000u)), 20);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f00000u)), 16));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f000u)), 12));
+         d0 = _mm256_or_si256(d0, _mm256_slli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f0u)), 8));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0xf0000000u)), 20);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f00000u)), 16));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f000u)), 12));
+         d1 = _mm256_or_si256(d1, _mm256_slli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f0u)), 8));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void rgba_8888_to_rgb_888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(s, 8);
+         store_24_avx2(dst_ptr + x * 3, _mm256_castsi256_si128(d));
+         store_24_avx2(dst_ptr + x * 3 + 12, _mm256_extracti128_si256(d, 1));
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_RGBA_8888_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static AVX2_TARGET void rgba_8888_to_rgb_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0xf8000000u)), 16);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00fc0000u)), 13));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f800u)), 11));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0xf8000000u)), 16);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00fc0000u)), 13));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f800u)), 11));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void rgba_8888_to_rgb_555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0xf8000000u)), 17);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 14));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f800u)), 11));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0xf8000000u)), 17);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 14));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f800u)), 11));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void rgba_8888_to_rgba_5551_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0xf8000000u)), 16);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 13));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f800u)), 10));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00000080u)), 7));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0xf8000000u)), 16);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 13));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f800u)), 10));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00000080u)), 7));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void rgba_8888_to_argb_1555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0xf8000000u)), 17);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 14));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f800u)), 11));
+         d0 = _mm256_or_si256(d0, _mm256_slli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00000080u)), 8));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0xf8000000u)), 17);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 14));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f800u)), 11));
+         d1 = _mm256_or_si256(d1, _mm256_slli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00000080u)), 8));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void rgba_8888_to_abgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(s, 24);
+         d = _mm256_or_si256(d, _mm256_srli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x00ff0000u)), 8));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x0000ff00u)), 8));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(s, 24));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void rgba_8888_to_xbgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(s, 24);
+         d = _mm256_or_si256(d, _mm256_srli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x00ff0000u)), 8));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x0000ff00u)), 8));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void rgba_8888_to_bgr_888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(s, 24);
+         d = _mm256_or_si256(d, _mm256_srli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x00ff0000u)), 8));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x0000ff00u)), 8));
+         store_24_avx2(dst_ptr + x * 3, _mm256_castsi256_si128(d));
+         store_24_avx2(dst_ptr + x * 3 + 12, _mm256_extracti128_si256(d, 1));
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_RGBA_8888_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static AVX2_TARGET void rgba_8888_to_bgr_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(s0, 27);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00fc0000u)), 13));
+         d0 = _mm256_or_si256(d0, _mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f800u)));
+         d1 = _mm256_srli_epi32(s1, 27);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00fc0000u)), 13));
+         d1 = _mm256_or_si256(d1, _mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f800u)));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void rgba_8888_to_bgr_555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(s0, 27);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 14));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f800u)), 1));
+         d1 = _mm256_srli_epi32(s1, 27);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 14));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f800u)), 1));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void rgba_8888_to_rgbx_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_and_si256(s, _mm256_set1_epi32((int)0xffffff00u));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void rgba_8888_to_xrgb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(s, 8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void rgba_8888_to_abgr_8888_le_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(s, 24);
+         d = _mm256_or_si256(d, _mm256_srli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x00ff0000u)), 8));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x0000ff00u)), 8));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(s, 24));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void rgba_8888_to_rgba_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0xf0000000u)), 16);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f00000u)), 12));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f000u)), 8));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f0u)), 4));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0xf0000000u)), 16);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f00000u)), 12));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f000u)), 8));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f0u)), 4));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void abgr_8888_to_argb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm256_or_si256(d, _mm256_and_si256(s, _mm256_set1_epi32((int)0xff00ff00u)));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x000000ffu)), 16));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void abgr_8888_to_rgba_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(s, 24);
+         d = _mm256_or_si256(d, _mm256_srli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x00ff0000u)), 8));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x0000ff00u)), 8));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(s, 24));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void abgr_8888_to_argb_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f00000u)), 20);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0xf0000000u)), 16));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f000u)), 8));
+         d0 = _mm256_or_si256(d0, _mm256_slli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f0u)), 4));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f00000u)), 20);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0xf0000000u)), 16));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f000u)), 8));
+         d1 = _mm256_or_si256(d1, _mm256_slli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f0u)), 4));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void abgr_8888_to_rgb_888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm256_or_si256(d, _mm256_and_si256(s, _mm256_set1_epi32((int)0x0000ff00u)));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x000000ffu)), 16));
+         store_24_avx2(dst_ptr + x * 3, _mm256_castsi256_si128(d));
+         store_24_avx2(dst_ptr + x * 3 + 12, _mm256_extracti128_si256(d, 1));
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_ABGR_8888_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static AVX2_TARGET void abgr_8888_to_rgb_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 19);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000fc00u)), 5));
+         d0 = _mm256_or_si256(d0, _mm256_slli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f8u)), 8));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 19);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000fc00u)), 5));
+         d1 = _mm256_or_si256(d1, _mm256_slli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f8u)), 8));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void abgr_8888_to_rgb_555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 19);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f800u)), 6));
+         d0 = _mm256_or_si256(d0, _mm256_slli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f8u)), 7));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 19);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f800u)), 6));
+         d1 = _mm256_or_si256(d1, _mm256_slli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f8u)), 7));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void abgr_8888_to_rgba_5551_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(s0, 31);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 18));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f800u)), 5));
+         d0 = _mm256_or_si256(d0, _mm256_slli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f8u)), 8));
+         d1 = _mm256_srli_epi32(s1, 31);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 18));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f800u)), 5));
+         d1 = _mm256_or_si256(d1, _mm256_slli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f8u)), 8));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void abgr_8888_to_argb_1555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 19);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x80000000u)), 16));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f800u)), 6));
+         d0 = _mm256_or_si256(d0, _mm256_slli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f8u)), 7));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 19);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x80000000u)), 16));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f800u)), 6));
+         d1 = _mm256_or_si256(d1, _mm256_slli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f8u)), 7));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void abgr_8888_to_xbgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_and_si256(s, _mm256_set1_epi32((int)0x00ffffffu));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void abgr_8888_to_bgr_888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_and_si256(s, _mm256_set1_epi32((int)0x00ffffffu));
+         store_24_avx2(dst_ptr + x * 3, _mm256_castsi256_si128(d));
+         store_24_avx2(dst_ptr + x * 3 + 12, _mm256_extracti128_si256(d, 1));
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_ABGR_8888_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static AVX2_TARGET void abgr_8888_to_bgr_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 8);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000fc00u)), 5));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f8u)), 3));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 8);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000fc00u)), 5));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f8u)), 3));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void abgr_8888_to_bgr_555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 9);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f800u)), 6));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f8u)), 3));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 9);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f800u)), 6));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f8u)), 3));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void abgr_8888_to_rgbx_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x00ff0000u)), 8);
+         d = _mm256_or_si256(d, _mm256_slli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x0000ff00u)), 8));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(s, 24));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void abgr_8888_to_xrgb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm256_or_si256(d, _mm256_and_si256(s, _mm256_set1_epi32((int)0x0000ff00u)));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x000000ffu)), 16));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void abgr_8888_to_abgr_8888_le_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = s;
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void abgr_8888_to_rgba_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(s0, 28);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f00000u)), 16));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f000u)), 4));
+         d0 = _mm256_or_si256(d0, _mm256_slli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f0u)), 8));
+         d1 = _mm256_srli_epi32(s1, 28);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f00000u)), 16));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f000u)), 4));
+         d1 = _mm256_or_si256(d1, _mm256_slli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f0u)), 8));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void xbgr_8888_to_argb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm256_or_si256(d, _mm256_and_si256(s, _mm256_set1_epi32((int)0x0000ff00u)));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x000000ffu)), 16));
+         d = _mm256_or_si256(d, _mm256_set1_epi32((int)0xff000000u));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void xbgr_8888_to_rgba_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x00ff0000u)), 8);
+         d = _mm256_or_si256(d, _mm256_slli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x0000ff00u)), 8));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(s, 24));
+         d = _mm256_or_si256(d, _mm256_set1_epi32((int)0x000000ffu));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void xbgr_8888_to_argb_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f00000u)), 20);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f000u)), 8));
+         d0 = _mm256_or_si256(d0, _mm256_slli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f0u)), 4));
+         d0 = _mm256_or_si256(d0, _mm256_set1_epi32((int)0x0000f000u));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f00000u)), 20);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f000u)), 8));
+         d1 = _mm256_or_si256(d1, _mm256_slli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f0u)), 4));
+         d1 = _mm256_or_si256(d1, _mm256_set1_epi32((int)0x0000f000u));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void xbgr_8888_to_rgb_888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm256_or_si256(d, _mm256_and_si256(s, _mm256_set1_epi32((int)0x0000ff00u)));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x000000ffu)), 16));
+         store_24_avx2(dst_ptr + x * 3, _mm256_castsi256_si128(d));
+         store_24_avx2(dst_ptr + x * 3 + 12, _mm256_extracti128_si256(d, 1));
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_XBGR_8888_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static AVX2_TARGET void xbgr_8888_to_rgb_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 19);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000fc00u)), 5));
+         d0 = _mm256_or_si256(d0, _mm256_slli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f8u)), 8));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 19);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000fc00u)), 5));
+         d1 = _mm256_or_si256(d1, _mm256_slli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f8u)), 8));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void xbgr_8888_to_rgb_555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 19);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f800u)), 6));
+         d0 = _mm256_or_si256(d0, _mm256_slli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f8u)), 7));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 19);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f800u)), 6));
+         d1 = _mm256_or_si256(d1, _mm256_slli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f8u)), 7));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void xbgr_8888_to_rgba_5551_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 18);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f800u)), 5));
+         d0 = _mm256_or_si256(d0, _mm256_slli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f8u)), 8));
+         d0 = _mm256_or_si256(d0, _mm256_set1_epi32((int)0x00000001u));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 18);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f800u)), 5));
+         d1 = _mm256_or_si256(d1, _mm256_slli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f8u)), 8));
+         d1 = _mm256_or_si256(d1, _mm256_set1_epi32((int)0x00000001u));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void xbgr_8888_to_argb_1555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 19);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f800u)), 6));
+         d0 = _mm256_or_si256(d0, _mm256_slli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f8u)), 7));
+         d0 = _mm256_or_si256(d0, _mm256_set1_epi32((int)0x00008000u));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 19);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f800u)), 6));
+         d1 = _mm256_or_si256(d1, _mm256_slli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f8u)), 7));
+         d1 = _mm256_or_si256(d1, _mm256_set1_epi32((int)0x00008000u));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void xbgr_8888_to_abgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_and_si256(s, _mm256_set1_epi32((int)0x00ffffffu));
+         d = _mm256_or_si256(d, _mm256_set1_epi32((int)0xff000000u));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void xbgr_8888_to_bgr_888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_and_si256(s, _mm256_set1_epi32((int)0x00ffffffu));
+         store_24_avx2(dst_ptr + x * 3, _mm256_castsi256_si128(d));
+         store_24_avx2(dst_ptr + x * 3 + 12, _mm256_extracti128_si256(d, 1));
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_XBGR_8888_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static AVX2_TARGET void xbgr_8888_to_bgr_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 8);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000fc00u)), 5));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f8u)), 3));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 8);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000fc00u)), 5));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f8u)), 3));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void xbgr_8888_to_bgr_555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 9);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f800u)), 6));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f8u)), 3));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 9);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f800u)), 6));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f8u)), 3));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void xbgr_8888_to_rgbx_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x00ff0000u)), 8);
+         d = _mm256_or_si256(d, _mm256_slli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x0000ff00u)), 8));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(s, 24));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void xbgr_8888_to_xrgb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm256_or_si256(d, _mm256_and_si256(s, _mm256_set1_epi32((int)0x0000ff00u)));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x000000ffu)), 16));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void xbgr_8888_to_abgr_8888_le_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_and_si256(s, _mm256_set1_epi32((int)0x00ffffffu));
+         d = _mm256_or_si256(d, _mm256_set1_epi32((int)0xff000000u));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void xbgr_8888_to_rgba_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f00000u)), 16);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f000u)), 4));
+         d0 = _mm256_or_si256(d0, _mm256_slli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f0u)), 8));
+         d0 = _mm256_or_si256(d0, _mm256_set1_epi32((int)0x0000000fu));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f00000u)), 16);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f000u)), 4));
+         d1 = _mm256_or_si256(d1, _mm256_slli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f0u)), 8));
+         d1 = _mm256_or_si256(d1, _mm256_set1_epi32((int)0x0000000fu));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void rgbx_8888_to_argb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(s, 8);
+         d = _mm256_or_si256(d, _mm256_set1_epi32((int)0xff000000u));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void rgbx_8888_to_rgba_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_and_si256(s, _mm256_set1_epi32((int)0xffffff00u));
+         d = _mm256_or_si256(d, _mm256_set1_epi32((int)0x000000ffu));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void rgbx_8888_to_argb_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0xf0000000u)), 20);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f00000u)), 16));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f000u)), 12));
+         d0 = _mm256_or_si256(d0, _mm256_set1_epi32((int)0x0000f000u));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0xf0000000u)), 20);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f00000u)), 16));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f000u)), 12));
+         d1 = _mm256_or_si256(d1, _mm256_set1_epi32((int)0x0000f000u));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void rgbx_8888_to_rgb_888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(s, 8);
+         store_24_avx2(dst_ptr + x * 3, _mm256_castsi256_si128(d));
+         store_24_avx2(dst_ptr + x * 3 + 12, _mm256_extracti128_si256(d, 1));
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_RGBX_8888_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static AVX2_TARGET void rgbx_8888_to_rgb_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0xf8000000u)), 16);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00fc0000u)), 13));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f800u)), 11));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0xf8000000u)), 16);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00fc0000u)), 13));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f800u)), 11));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void rgbx_8888_to_rgb_555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0xf8000000u)), 17);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 14));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f800u)), 11));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0xf8000000u)), 17);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 14));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f800u)), 11));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void rgbx_8888_to_rgba_5551_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0xf8000000u)), 16);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 13));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f800u)), 10));
+         d0 = _mm256_or_si256(d0, _mm256_set1_epi32((int)0x00000001u));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0xf8000000u)), 16);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 13));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f800u)), 10));
+         d1 = _mm256_or_si256(d1, _mm256_set1_epi32((int)0x00000001u));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void rgbx_8888_to_argb_1555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0xf8000000u)), 17);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 14));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f800u)), 11));
+         d0 = _mm256_or_si256(d0, _mm256_set1_epi32((int)0x00008000u));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0xf8000000u)), 17);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 14));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f800u)), 11));
+         d1 = _mm256_or_si256(d1, _mm256_set1_epi32((int)0x00008000u));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void rgbx_8888_to_abgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(s, 24);
+         d = _mm256_or_si256(d, _mm256_srli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x00ff0000u)), 8));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x0000ff00u)), 8));
+         d = _mm256_or_si256(d, _mm256_set1_epi32((int)0xff000000u));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void rgbx_8888_to_xbgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(s, 24);
+         d = _mm256_or_si256(d, _mm256_srli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x00ff0000u)), 8));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x0000ff00u)), 8));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void rgbx_8888_to_bgr_888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(s, 24);
+         d = _mm256_or_si256(d, _mm256_srli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x00ff0000u)), 8));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x0000ff00u)), 8));
+         store_24_avx2(dst_ptr + x * 3, _mm256_castsi256_si128(d));
+         store_24_avx2(dst_ptr + x * 3 + 12, _mm256_extracti128_si256(d, 1));
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_RGBX_8888_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static AVX2_TARGET void rgbx_8888_to_bgr_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(s0, 27);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00fc0000u)), 13));
+         d0 = _mm256_or_si256(d0, _mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f800u)));
+         d1 = _mm256_srli_epi32(s1, 27);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00fc0000u)), 13));
+         d1 = _mm256_or_si256(d1, _mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f800u)));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void rgbx_8888_to_bgr_555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(s0, 27);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 14));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f800u)), 1));
+         d1 = _mm256_srli_epi32(s1, 27);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 14));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f800u)), 1));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void rgbx_8888_to_xrgb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(s, 8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void rgbx_8888_to_abgr_8888_le_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(s, 24);
+         d = _mm256_or_si256(d, _mm256_srli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x00ff0000u)), 8));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x0000ff00u)), 8));
+         d = _mm256_or_si256(d, _mm256_set1_epi32((int)0xff000000u));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void rgbx_8888_to_rgba_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0xf0000000u)), 16);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f00000u)), 12));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f000u)), 8));
+         d0 = _mm256_or_si256(d0, _mm256_set1_epi32((int)0x0000000fu));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0xf0000000u)), 16);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f00000u)), 12));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f000u)), 8));
+         d1 = _mm256_or_si256(d1, _mm256_set1_epi32((int)0x0000000fu));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void xrgb_8888_to_argb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_and_si256(s, _mm256_set1_epi32((int)0x00ffffffu));
+         d = _mm256_or_si256(d, _mm256_set1_epi32((int)0xff000000u));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void xrgb_8888_to_rgba_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_slli_epi32(s, 8);
+         d = _mm256_or_si256(d, _mm256_set1_epi32((int)0x000000ffu));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void xrgb_8888_to_argb_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f00000u)), 12);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f000u)), 8));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f0u)), 4));
+         d0 = _mm256_or_si256(d0, _mm256_set1_epi32((int)0x0000f000u));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f00000u)), 12);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f000u)), 8));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f0u)), 4));
+         d1 = _mm256_or_si256(d1, _mm256_set1_epi32((int)0x0000f000u));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void xrgb_8888_to_rgb_888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_and_si256(s, _mm256_set1_epi32((int)0x00ffffffu));
+         store_24_avx2(dst_ptr + x * 3, _mm256_castsi256_si128(d));
+         store_24_avx2(dst_ptr + x * 3 + 12, _mm256_extracti128_si256(d, 1));
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_XRGB_8888_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static AVX2_TARGET void xrgb_8888_to_rgb_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 8);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000fc00u)), 5));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f8u)), 3));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 8);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000fc00u)), 5));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f8u)), 3));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void xrgb_8888_to_rgb_555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 9);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f800u)), 6));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f8u)), 3));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 9);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f800u)), 6));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f8u)), 3));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void xrgb_8888_to_rgba_5551_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 8);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f800u)), 5));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f8u)), 2));
+         d0 = _mm256_or_si256(d0, _mm256_set1_epi32((int)0x00000001u));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 8);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f800u)), 5));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f8u)), 2));
+         d1 = _mm256_or_si256(d1, _mm256_set1_epi32((int)0x00000001u));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void xrgb_8888_to_argb_1555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 9);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f800u)), 6));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f8u)), 3));
+         d0 = _mm256_or_si256(d0, _mm256_set1_epi32((int)0x00008000u));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 9);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f800u)), 6));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f8u)), 3));
+         d1 = _mm256_or_si256(d1, _mm256_set1_epi32((int)0x00008000u));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void xrgb_8888_to_abgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm256_or_si256(d, _mm256_and_si256(s, _mm256_set1_epi32((int)0x0000ff00u)));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x000000ffu)), 16));
+         d = _mm256_or_si256(d, _mm256_set1_epi32((int)0xff000000u));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void xrgb_8888_to_xbgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm256_or_si256(d, _mm256_and_si256(s, _mm256_set1_epi32((int)0x0000ff00u)));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x000000ffu)), 16));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void xrgb_8888_to_bgr_888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm256_or_si256(d, _mm256_and_si256(s, _mm256_set1_epi32((int)0x0000ff00u)));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x000000ffu)), 16));
+         store_24_avx2(dst_ptr + x * 3, _mm256_castsi256_si128(d));
+         store_24_avx2(dst_ptr + x * 3 + 12, _mm256_extracti128_si256(d, 1));
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_XRGB_8888_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static AVX2_TARGET void xrgb_8888_to_bgr_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 19);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000fc00u)), 5));
+         d0 = _mm256_or_si256(d0, _mm256_slli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f8u)), 8));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 19);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000fc00u)), 5));
+         d1 = _mm256_or_si256(d1, _mm256_slli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f8u)), 8));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void xrgb_8888_to_bgr_555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 19);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f800u)), 6));
+         d0 = _mm256_or_si256(d0, _mm256_slli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f8u)), 7));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 19);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f800u)), 6));
+         d1 = _mm256_or_si256(d1, _mm256_slli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f8u)), 7));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void xrgb_8888_to_rgbx_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_slli_epi32(s, 8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void xrgb_8888_to_abgr_8888_le_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm256_or_si256(d, _mm256_and_si256(s, _mm256_set1_epi32((int)0x0000ff00u)));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x000000ffu)), 16));
+         d = _mm256_or_si256(d, _mm256_set1_epi32((int)0xff000000u));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void xrgb_8888_to_rgba_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f00000u)), 8);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f000u)), 4));
+         d0 = _mm256_or_si256(d0, _mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f0u)));
+         d0 = _mm256_or_si256(d0, _mm256_set1_epi32((int)0x0000000fu));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f00000u)), 8);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f000u)), 4));
+         d1 = _mm256_or_si256(d1, _mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f0u)));
+         d1 = _mm256_or_si256(d1, _mm256_set1_epi32((int)0x0000000fu));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void abgr_8888_le_to_argb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm256_or_si256(d, _mm256_and_si256(s, _mm256_set1_epi32((int)0xff00ff00u)));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x000000ffu)), 16));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void abgr_8888_le_to_rgba_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(s, 24);
+         d = _mm256_or_si256(d, _mm256_srli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x00ff0000u)), 8));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x0000ff00u)), 8));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(s, 24));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void abgr_8888_le_to_argb_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f00000u)), 20);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0xf0000000u)), 16));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f000u)), 8));
+         d0 = _mm256_or_si256(d0, _mm256_slli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f0u)), 4));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f00000u)), 20);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0xf0000000u)), 16));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f000u)), 8));
+         d1 = _mm256_or_si256(d1, _mm256_slli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f0u)), 4));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void abgr_8888_le_to_rgb_888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm256_or_si256(d, _mm256_and_si256(s, _mm256_set1_epi32((int)0x0000ff00u)));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x000000ffu)), 16));
+         store_24_avx2(dst_ptr + x * 3, _mm256_castsi256_si128(d));
+         store_24_avx2(dst_ptr + x * 3 + 12, _mm256_extracti128_si256(d, 1));
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static AVX2_TARGET void abgr_8888_le_to_rgb_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 19);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000fc00u)), 5));
+         d0 = _mm256_or_si256(d0, _mm256_slli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f8u)), 8));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 19);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000fc00u)), 5));
+         d1 = _mm256_or_si256(d1, _mm256_slli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f8u)), 8));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void abgr_8888_le_to_rgb_555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 19);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f800u)), 6));
+         d0 = _mm256_or_si256(d0, _mm256_slli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f8u)), 7));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 19);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f800u)), 6));
+         d1 = _mm256_or_si256(d1, _mm256_slli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f8u)), 7));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void abgr_8888_le_to_rgba_5551_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(s0, 31);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 18));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f800u)), 5));
+         d0 = _mm256_or_si256(d0, _mm256_slli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f8u)), 8));
+         d1 = _mm256_srli_epi32(s1, 31);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 18));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f800u)), 5));
+         d1 = _mm256_or_si256(d1, _mm256_slli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f8u)), 8));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void abgr_8888_le_to_argb_1555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 19);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x80000000u)), 16));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f800u)), 6));
+         d0 = _mm256_or_si256(d0, _mm256_slli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f8u)), 7));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 19);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x80000000u)), 16));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f800u)), 6));
+         d1 = _mm256_or_si256(d1, _mm256_slli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f8u)), 7));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void abgr_8888_le_to_abgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = s;
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void abgr_8888_le_to_xbgr_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_and_si256(s, _mm256_set1_epi32((int)0x00ffffffu));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void abgr_8888_le_to_bgr_888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_and_si256(s, _mm256_set1_epi32((int)0x00ffffffu));
+         store_24_avx2(dst_ptr + x * 3, _mm256_castsi256_si128(d));
+         store_24_avx2(dst_ptr + x * 3 + 12, _mm256_extracti128_si256(d, 1));
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_ABGR_8888_LE_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static AVX2_TARGET void abgr_8888_le_to_bgr_565_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 8);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000fc00u)), 5));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f8u)), 3));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 8);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000fc00u)), 5));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f8u)), 3));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void abgr_8888_le_to_bgr_555_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f80000u)), 9);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f800u)), 6));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f8u)), 3));
+         d1 = _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f80000u)), 9);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f800u)), 6));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f8u)), 3));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void abgr_8888_le_to_rgbx_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x00ff0000u)), 8);
+         d = _mm256_or_si256(d, _mm256_slli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x0000ff00u)), 8));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(s, 24));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void abgr_8888_le_to_xrgb_8888_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         __m256i s = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i d;
+         d = _mm256_srli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x00ff0000u)), 16);
+         d = _mm256_or_si256(d, _mm256_and_si256(s, _mm256_set1_epi32((int)0x0000ff00u)));
+         d = _mm256_or_si256(d, _mm256_slli_epi32(_mm256_and_si256(s, _mm256_set1_epi32((int)0x000000ffu)), 16));
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+static AVX2_TARGET void abgr_8888_le_to_rgba_4444_avx2(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         __m256i s0 = _mm256_loadu_si256((const __m256i *)(src_ptr + x));
+         __m256i s1 = _mm256_loadu_si256((const __m256i *)(src_ptr + x + 8));
+         __m256i d0, d1, d;
+         d0 = _mm256_srli_epi32(s0, 28);
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x00f00000u)), 16));
+         d0 = _mm256_or_si256(d0, _mm256_srli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x0000f000u)), 4));
+         d0 = _mm256_or_si256(d0, _mm256_slli_epi32(_mm256_and_si256(s0, _mm256_set1_epi32((int)0x000000f0u)), 8));
+         d1 = _mm256_srli_epi32(s1, 28);
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x00f00000u)), 16));
+         d1 = _mm256_or_si256(d1, _mm256_srli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x0000f000u)), 4));
+         d1 = _mm256_or_si256(d1, _mm256_slli_epi32(_mm256_and_si256(s1, _mm256_set1_epi32((int)0x000000f0u)), 8));
+         d0 = _mm256_srai_epi32(_mm256_slli_epi32(d0, 16), 16);
+         d1 = _mm256_srai_epi32(_mm256_slli_epi32(d1, 16), 16);
+         d = _mm256_permute4x64_epi64(_mm256_packs_epi32(d0, d1), 0xd8);
+         _mm256_storeu_si256((__m256i *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+#endif
+
+#ifdef CONVERT_NEON
+static void argb_8888_to_rgba_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vshrq_n_u32(s, 24);
+         d = vorrq_u32(d, vshlq_n_u32(s, 8));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_argb_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0xf0000000u)), 16);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f00000u)), 12));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f000u)), 8));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f0u)), 4));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0xf0000000u)), 16);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f00000u)), 12));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f000u)), 8));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f0u)), 4));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_rgb_888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         uint8x16x4_t s = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x3_t d;
+         d.val[0] = s.val[0];
+         d.val[1] = s.val[1];
+         d.val[2] = s.val[2];
+         vst3q_u8(dst_ptr + x * 3, d);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_ARGB_8888_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void argb_8888_to_rgb_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 8);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000fc00u)), 5));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f8u)), 3));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 8);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000fc00u)), 5));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f8u)), 3));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_rgb_555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 9);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f800u)), 6));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f8u)), 3));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 9);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f800u)), 6));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f8u)), 3));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_rgba_5551_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(s0, 31);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 8));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f800u)), 5));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f8u)), 2));
+         d1 = vshrq_n_u32(s1, 31);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 8));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f800u)), 5));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f8u)), 2));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_argb_1555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x80000000u)), 16);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 9));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f800u)), 6));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f8u)), 3));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x80000000u)), 16);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 9));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f800u)), 6));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f8u)), 3));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_abgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vshrq_n_u32(vandq_u32(s, vdupq_n_u32(0x00ff0000u)), 16);
+         d = vorrq_u32(d, vandq_u32(s, vdupq_n_u32(0xff00ff00u)));
+         d = vorrq_u32(d, vshlq_n_u32(vandq_u32(s, vdupq_n_u32(0x000000ffu)), 16));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_xbgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vshrq_n_u32(vandq_u32(s, vdupq_n_u32(0x00ff0000u)), 16);
+         d = vorrq_u32(d, vandq_u32(s, vdupq_n_u32(0x0000ff00u)));
+         d = vorrq_u32(d, vshlq_n_u32(vandq_u32(s, vdupq_n_u32(0x000000ffu)), 16));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_bgr_888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         uint8x16x4_t s = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x3_t d;
+         d.val[0] = s.val[2];
+         d.val[1] = s.val[1];
+         d.val[2] = s.val[0];
+         vst3q_u8(dst_ptr + x * 3, d);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_ARGB_8888_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void argb_8888_to_bgr_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 19);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000fc00u)), 5));
+         d0 = vorrq_u32(d0, vshlq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f8u)), 8));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 19);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000fc00u)), 5));
+         d1 = vorrq_u32(d1, vshlq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f8u)), 8));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_bgr_555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 19);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f800u)), 6));
+         d0 = vorrq_u32(d0, vshlq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f8u)), 7));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 19);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f800u)), 6));
+         d1 = vorrq_u32(d1, vshlq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f8u)), 7));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_rgbx_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vshlq_n_u32(s, 8);
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_xrgb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vandq_u32(s, vdupq_n_u32(0x00ffffffu));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+#ifdef __aarch64__
+static void argb_8888_to_abgr_f32_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      ALLEGRO_COLOR *dst_ptr = (ALLEGRO_COLOR *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         float32x4x4_t d;
+         d.val[0] = vdivq_f32(vcvtq_f32_u32(
+            vandq_u32(vshrq_n_u32(s, 16), vdupq_n_u32(0xff))), vdupq_n_f32(255.0f));
+         d.val[1] = vdivq_f32(vcvtq_f32_u32(
+            vandq_u32(vshrq_n_u32(s, 8), vdupq_n_u32(0xff))), vdupq_n_f32(255.0f));
+         d.val[2] = vdivq_f32(vcvtq_f32_u32(
+            vandq_u32(s, vdupq_n_u32(0xff))), vdupq_n_f32(255.0f));
+         d.val[3] = vdivq_f32(vcvtq_f32_u32(
+            vshrq_n_u32(s, 24)), vdupq_n_f32(255.0f));
+         vst4q_f32((float *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ABGR_F32(src_ptr[x]);
+      }
+   }
+}
+#endif
+static void argb_8888_to_abgr_8888_le_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vshrq_n_u32(vandq_u32(s, vdupq_n_u32(0x00ff0000u)), 16);
+         d = vorrq_u32(d, vandq_u32(s, vdupq_n_u32(0xff00ff00u)));
+         d = vorrq_u32(d, vshlq_n_u32(vandq_u32(s, vdupq_n_u32(0x000000ffu)), 16));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static void argb_8888_to_rgba_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(s0, 28);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f00000u)), 8));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f000u)), 4));
+         d0 = vorrq_u32(d0, vandq_u32(s0, vdupq_n_u32(0x000000f0u)));
+         d1 = vshrq_n_u32(s1, 28);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f00000u)), 8));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f000u)), 4));
+         d1 = vorrq_u32(d1, vandq_u32(s1, vdupq_n_u32(0x000000f0u)));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ARGB_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_argb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vshrq_n_u32(s, 8);
+         d = vorrq_u32(d, vshlq_n_u32(s, 24));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_argb_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0xf0000000u)), 20);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f00000u)), 16));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f000u)), 12));
+         d0 = vorrq_u32(d0, vshlq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f0u)), 8));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0xf0000000u)), 20);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f00000u)), 16));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f000u)), 12));
+         d1 = vorrq_u32(d1, vshlq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f0u)), 8));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_rgb_888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         uint8x16x4_t s = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x3_t d;
+         d.val[0] = s.val[1];
+         d.val[1] = s.val[2];
+         d.val[2] = s.val[3];
+         vst3q_u8(dst_ptr + x * 3, d);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_RGBA_8888_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void rgba_8888_to_rgb_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0xf8000000u)), 16);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00fc0000u)), 13));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f800u)), 11));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0xf8000000u)), 16);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00fc0000u)), 13));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f800u)), 11));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_rgb_555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0xf8000000u)), 17);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 14));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f800u)), 11));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0xf8000000u)), 17);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 14));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f800u)), 11));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_rgba_5551_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0xf8000000u)), 16);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 13));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f800u)), 10));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00000080u)), 7));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0xf8000000u)), 16);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 13));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f800u)), 10));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00000080u)), 7));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_argb_1555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0xf8000000u)), 17);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 14));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f800u)), 11));
+         d0 = vorrq_u32(d0, vshlq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00000080u)), 8));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0xf8000000u)), 17);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 14));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f800u)), 11));
+         d1 = vorrq_u32(d1, vshlq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00000080u)), 8));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_abgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vshrq_n_u32(s, 24);
+         d = vorrq_u32(d, vshrq_n_u32(vandq_u32(s, vdupq_n_u32(0x00ff0000u)), 8));
+         d = vorrq_u32(d, vshlq_n_u32(vandq_u32(s, vdupq_n_u32(0x0000ff00u)), 8));
+         d = vorrq_u32(d, vshlq_n_u32(s, 24));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_xbgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vshrq_n_u32(s, 24);
+         d = vorrq_u32(d, vshrq_n_u32(vandq_u32(s, vdupq_n_u32(0x00ff0000u)), 8));
+         d = vorrq_u32(d, vshlq_n_u32(vandq_u32(s, vdupq_n_u32(0x0000ff00u)), 8));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_bgr_888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         uint8x16x4_t s = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x3_t d;
+         d.val[0] = s.val[3];
+         d.val[1] = s.val[2];
+         d.val[2] = s.val[1];
+         vst3q_u8(dst_ptr + x * 3, d);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_RGBA_8888_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void rgba_8888_to_bgr_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(s0, 27);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00fc0000u)), 13));
+         d0 = vorrq_u32(d0, vandq_u32(s0, vdupq_n_u32(0x0000f800u)));
+         d1 = vshrq_n_u32(s1, 27);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00fc0000u)), 13));
+         d1 = vorrq_u32(d1, vandq_u32(s1, vdupq_n_u32(0x0000f800u)));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_bgr_555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(s0, 27);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 14));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f800u)), 1));
+         d1 = vshrq_n_u32(s1, 27);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 14));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f800u)), 1));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_rgbx_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vandq_u32(s, vdupq_n_u32(0xffffff00u));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_xrgb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vshrq_n_u32(s, 8);
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+#ifdef __aarch64__
+static void rgba_8888_to_abgr_f32_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      ALLEGRO_COLOR *dst_ptr = (ALLEGRO_COLOR *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         float32x4x4_t d;
+         d.val[0] = vdivq_f32(vcvtq_f32_u32(
+            vshrq_n_u32(s, 24)), vdupq_n_f32(255.0f));
+         d.val[1] = vdivq_f32(vcvtq_f32_u32(
+            vandq_u32(vshrq_n_u32(s, 16), vdupq_n_u32(0xff))), vdupq_n_f32(255.0f));
+         d.val[2] = vdivq_f32(vcvtq_f32_u32(
+            vandq_u32(vshrq_n_u32(s, 8), vdupq_n_u32(0xff))), vdupq_n_f32(255.0f));
+         d.val[3] = vdivq_f32(vcvtq_f32_u32(
+            vandq_u32(s, vdupq_n_u32(0xff))), vdupq_n_f32(255.0f));
+         vst4q_f32((float *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ABGR_F32(src_ptr[x]);
+      }
+   }
+}
+#endif
+static void rgba_8888_to_abgr_8888_le_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vshrq_n_u32(s, 24);
+         d = vorrq_u32(d, vshrq_n_u32(vandq_u32(s, vdupq_n_u32(0x00ff0000u)), 8));
+         d = vorrq_u32(d, vshlq_n_u32(vandq_u32(s, vdupq_n_u32(0x0000ff00u)), 8));
+         d = vorrq_u32(d, vshlq_n_u32(s, 24));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static void rgba_8888_to_rgba_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0xf0000000u)), 16);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f00000u)), 12));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f000u)), 8));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f0u)), 4));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0xf0000000u)), 16);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f00000u)), 12));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f000u)), 8));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f0u)), 4));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBA_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_argb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vshrq_n_u32(vandq_u32(s, vdupq_n_u32(0x00ff0000u)), 16);
+         d = vorrq_u32(d, vandq_u32(s, vdupq_n_u32(0xff00ff00u)));
+         d = vorrq_u32(d, vshlq_n_u32(vandq_u32(s, vdupq_n_u32(0x000000ffu)), 16));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_rgba_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vshrq_n_u32(s, 24);
+         d = vorrq_u32(d, vshrq_n_u32(vandq_u32(s, vdupq_n_u32(0x00ff0000u)), 8));
+         d = vorrq_u32(d, vshlq_n_u32(vandq_u32(s, vdupq_n_u32(0x0000ff00u)), 8));
+         d = vorrq_u32(d, vshlq_n_u32(s, 24));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_argb_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f00000u)), 20);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0xf0000000u)), 16));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f000u)), 8));
+         d0 = vorrq_u32(d0, vshlq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f0u)), 4));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f00000u)), 20);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0xf0000000u)), 16));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f000u)), 8));
+         d1 = vorrq_u32(d1, vshlq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f0u)), 4));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_rgb_888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         uint8x16x4_t s = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x3_t d;
+         d.val[0] = s.val[2];
+         d.val[1] = s.val[1];
+         d.val[2] = s.val[0];
+         vst3q_u8(dst_ptr + x * 3, d);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_ABGR_8888_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void abgr_8888_to_rgb_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 19);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000fc00u)), 5));
+         d0 = vorrq_u32(d0, vshlq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f8u)), 8));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 19);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000fc00u)), 5));
+         d1 = vorrq_u32(d1, vshlq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f8u)), 8));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_rgb_555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 19);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f800u)), 6));
+         d0 = vorrq_u32(d0, vshlq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f8u)), 7));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 19);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f800u)), 6));
+         d1 = vorrq_u32(d1, vshlq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f8u)), 7));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_rgba_5551_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(s0, 31);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 18));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f800u)), 5));
+         d0 = vorrq_u32(d0, vshlq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f8u)), 8));
+         d1 = vshrq_n_u32(s1, 31);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 18));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f800u)), 5));
+         d1 = vorrq_u32(d1, vshlq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f8u)), 8));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_argb_1555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 19);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x80000000u)), 16));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f800u)), 6));
+         d0 = vorrq_u32(d0, vshlq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f8u)), 7));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 19);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x80000000u)), 16));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f800u)), 6));
+         d1 = vorrq_u32(d1, vshlq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f8u)), 7));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_xbgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vandq_u32(s, vdupq_n_u32(0x00ffffffu));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_bgr_888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         uint8x16x4_t s = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x3_t d;
+         d.val[0] = s.val[0];
+         d.val[1] = s.val[1];
+         d.val[2] = s.val[2];
+         vst3q_u8(dst_ptr + x * 3, d);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_ABGR_8888_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void abgr_8888_to_bgr_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 8);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000fc00u)), 5));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f8u)), 3));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 8);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000fc00u)), 5));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f8u)), 3));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_bgr_555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 9);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f800u)), 6));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f8u)), 3));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 9);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f800u)), 6));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f8u)), 3));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_rgbx_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vshrq_n_u32(vandq_u32(s, vdupq_n_u32(0x00ff0000u)), 8);
+         d = vorrq_u32(d, vshlq_n_u32(vandq_u32(s, vdupq_n_u32(0x0000ff00u)), 8));
+         d = vorrq_u32(d, vshlq_n_u32(s, 24));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_xrgb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vshrq_n_u32(vandq_u32(s, vdupq_n_u32(0x00ff0000u)), 16);
+         d = vorrq_u32(d, vandq_u32(s, vdupq_n_u32(0x0000ff00u)));
+         d = vorrq_u32(d, vshlq_n_u32(vandq_u32(s, vdupq_n_u32(0x000000ffu)), 16));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+#ifdef __aarch64__
+static void abgr_8888_to_abgr_f32_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      ALLEGRO_COLOR *dst_ptr = (ALLEGRO_COLOR *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         float32x4x4_t d;
+         d.val[0] = vdivq_f32(vcvtq_f32_u32(
+            vandq_u32(s, vdupq_n_u32(0xff))), vdupq_n_f32(255.0f));
+         d.val[1] = vdivq_f32(vcvtq_f32_u32(
+            vandq_u32(vshrq_n_u32(s, 8), vdupq_n_u32(0xff))), vdupq_n_f32(255.0f));
+         d.val[2] = vdivq_f32(vcvtq_f32_u32(
+            vandq_u32(vshrq_n_u32(s, 16), vdupq_n_u32(0xff))), vdupq_n_f32(255.0f));
+         d.val[3] = vdivq_f32(vcvtq_f32_u32(
+            vshrq_n_u32(s, 24)), vdupq_n_f32(255.0f));
+         vst4q_f32((float *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ABGR_F32(src_ptr[x]);
+      }
+   }
+}
+#endif
+static void abgr_8888_to_abgr_8888_le_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = s;
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_to_rgba_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(s0, 28);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f00000u)), 16));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f000u)), 4));
+         d0 = vorrq_u32(d0, vshlq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f0u)), 8));
+         d1 = vshrq_n_u32(s1, 28);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f00000u)), 16));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f000u)), 4));
+         d1 = vorrq_u32(d1, vshlq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f0u)), 8));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_argb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vshrq_n_u32(vandq_u32(s, vdupq_n_u32(0x00ff0000u)), 16);
+         d = vorrq_u32(d, vandq_u32(s, vdupq_n_u32(0x0000ff00u)));
+         d = vorrq_u32(d, vshlq_n_u32(vandq_u32(s, vdupq_n_u32(0x000000ffu)), 16));
+         d = vorrq_u32(d, vdupq_n_u32(0xff000000u));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_rgba_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vshrq_n_u32(vandq_u32(s, vdupq_n_u32(0x00ff0000u)), 8);
+         d = vorrq_u32(d, vshlq_n_u32(vandq_u32(s, vdupq_n_u32(0x0000ff00u)), 8));
+         d = vorrq_u32(d, vshlq_n_u32(s, 24));
+         d = vorrq_u32(d, vdupq_n_u32(0x000000ffu));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_argb_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f00000u)), 20);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f000u)), 8));
+         d0 = vorrq_u32(d0, vshlq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f0u)), 4));
+         d0 = vorrq_u32(d0, vdupq_n_u32(0x0000f000u));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f00000u)), 20);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f000u)), 8));
+         d1 = vorrq_u32(d1, vshlq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f0u)), 4));
+         d1 = vorrq_u32(d1, vdupq_n_u32(0x0000f000u));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_rgb_888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         uint8x16x4_t s = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x3_t d;
+         d.val[0] = s.val[2];
+         d.val[1] = s.val[1];
+         d.val[2] = s.val[0];
+         vst3q_u8(dst_ptr + x * 3, d);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_XBGR_8888_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void xbgr_8888_to_rgb_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 19);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000fc00u)), 5));
+         d0 = vorrq_u32(d0, vshlq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f8u)), 8));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 19);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000fc00u)), 5));
+         d1 = vorrq_u32(d1, vshlq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f8u)), 8));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_rgb_555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 19);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f800u)), 6));
+         d0 = vorrq_u32(d0, vshlq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f8u)), 7));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 19);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f800u)), 6));
+         d1 = vorrq_u32(d1, vshlq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f8u)), 7));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_rgba_5551_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 18);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f800u)), 5));
+         d0 = vorrq_u32(d0, vshlq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f8u)), 8));
+         d0 = vorrq_u32(d0, vdupq_n_u32(0x00000001u));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 18);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f800u)), 5));
+         d1 = vorrq_u32(d1, vshlq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f8u)), 8));
+         d1 = vorrq_u32(d1, vdupq_n_u32(0x00000001u));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_argb_1555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 19);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f800u)), 6));
+         d0 = vorrq_u32(d0, vshlq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f8u)), 7));
+         d0 = vorrq_u32(d0, vdupq_n_u32(0x00008000u));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 19);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f800u)), 6));
+         d1 = vorrq_u32(d1, vshlq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f8u)), 7));
+         d1 = vorrq_u32(d1, vdupq_n_u32(0x00008000u));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_abgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vandq_u32(s, vdupq_n_u32(0x00ffffffu));
+         d = vorrq_u32(d, vdupq_n_u32(0xff000000u));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_bgr_888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         uint8x16x4_t s = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x3_t d;
+         d.val[0] = s.val[0];
+         d.val[1] = s.val[1];
+         d.val[2] = s.val[2];
+         vst3q_u8(dst_ptr + x * 3, d);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_XBGR_8888_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void xbgr_8888_to_bgr_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 8);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000fc00u)), 5));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f8u)), 3));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 8);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000fc00u)), 5));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f8u)), 3));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_bgr_555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 9);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f800u)), 6));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f8u)), 3));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 9);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f800u)), 6));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f8u)), 3));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_rgbx_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vshrq_n_u32(vandq_u32(s, vdupq_n_u32(0x00ff0000u)), 8);
+         d = vorrq_u32(d, vshlq_n_u32(vandq_u32(s, vdupq_n_u32(0x0000ff00u)), 8));
+         d = vorrq_u32(d, vshlq_n_u32(s, 24));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_xrgb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vshrq_n_u32(vandq_u32(s, vdupq_n_u32(0x00ff0000u)), 16);
+         d = vorrq_u32(d, vandq_u32(s, vdupq_n_u32(0x0000ff00u)));
+         d = vorrq_u32(d, vshlq_n_u32(vandq_u32(s, vdupq_n_u32(0x000000ffu)), 16));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+#ifdef __aarch64__
+static void xbgr_8888_to_abgr_f32_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      ALLEGRO_COLOR *dst_ptr = (ALLEGRO_COLOR *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         float32x4x4_t d;
+         d.val[0] = vdivq_f32(vcvtq_f32_u32(
+            vandq_u32(s, vdupq_n_u32(0xff))), vdupq_n_f32(255.0f));
+         d.val[1] = vdivq_f32(vcvtq_f32_u32(
+            vandq_u32(vshrq_n_u32(s, 8), vdupq_n_u32(0xff))), vdupq_n_f32(255.0f));
+         d.val[2] = vdivq_f32(vcvtq_f32_u32(
+            vandq_u32(vshrq_n_u32(s, 16), vdupq_n_u32(0xff))), vdupq_n_f32(255.0f));
+         d.val[3] = vdupq_n_f32(1.0f);
+         vst4q_f32((float *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ABGR_F32(src_ptr[x]);
+      }
+   }
+}
+#endif
+static void xbgr_8888_to_abgr_8888_le_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vandq_u32(s, vdupq_n_u32(0x00ffffffu));
+         d = vorrq_u32(d, vdupq_n_u32(0xff000000u));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static void xbgr_8888_to_rgba_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f00000u)), 16);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f000u)), 4));
+         d0 = vorrq_u32(d0, vshlq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f0u)), 8));
+         d0 = vorrq_u32(d0, vdupq_n_u32(0x0000000fu));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f00000u)), 16);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f000u)), 4));
+         d1 = vorrq_u32(d1, vshlq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f0u)), 8));
+         d1 = vorrq_u32(d1, vdupq_n_u32(0x0000000fu));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XBGR_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_argb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vshrq_n_u32(s, 8);
+         d = vorrq_u32(d, vdupq_n_u32(0xff000000u));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_rgba_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vandq_u32(s, vdupq_n_u32(0xffffff00u));
+         d = vorrq_u32(d, vdupq_n_u32(0x000000ffu));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_argb_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0xf0000000u)), 20);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f00000u)), 16));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f000u)), 12));
+         d0 = vorrq_u32(d0, vdupq_n_u32(0x0000f000u));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0xf0000000u)), 20);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f00000u)), 16));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f000u)), 12));
+         d1 = vorrq_u32(d1, vdupq_n_u32(0x0000f000u));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_rgb_888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         uint8x16x4_t s = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x3_t d;
+         d.val[0] = s.val[1];
+         d.val[1] = s.val[2];
+         d.val[2] = s.val[3];
+         vst3q_u8(dst_ptr + x * 3, d);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_RGBX_8888_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void rgbx_8888_to_rgb_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0xf8000000u)), 16);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00fc0000u)), 13));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f800u)), 11));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0xf8000000u)), 16);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00fc0000u)), 13));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f800u)), 11));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_rgb_555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0xf8000000u)), 17);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 14));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f800u)), 11));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0xf8000000u)), 17);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 14));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f800u)), 11));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_rgba_5551_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0xf8000000u)), 16);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 13));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f800u)), 10));
+         d0 = vorrq_u32(d0, vdupq_n_u32(0x00000001u));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0xf8000000u)), 16);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 13));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f800u)), 10));
+         d1 = vorrq_u32(d1, vdupq_n_u32(0x00000001u));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_argb_1555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0xf8000000u)), 17);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 14));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f800u)), 11));
+         d0 = vorrq_u32(d0, vdupq_n_u32(0x00008000u));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0xf8000000u)), 17);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 14));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f800u)), 11));
+         d1 = vorrq_u32(d1, vdupq_n_u32(0x00008000u));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_abgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vshrq_n_u32(s, 24);
+         d = vorrq_u32(d, vshrq_n_u32(vandq_u32(s, vdupq_n_u32(0x00ff0000u)), 8));
+         d = vorrq_u32(d, vshlq_n_u32(vandq_u32(s, vdupq_n_u32(0x0000ff00u)), 8));
+         d = vorrq_u32(d, vdupq_n_u32(0xff000000u));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_xbgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vshrq_n_u32(s, 24);
+         d = vorrq_u32(d, vshrq_n_u32(vandq_u32(s, vdupq_n_u32(0x00ff0000u)), 8));
+         d = vorrq_u32(d, vshlq_n_u32(vandq_u32(s, vdupq_n_u32(0x0000ff00u)), 8));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_bgr_888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         uint8x16x4_t s = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x3_t d;
+         d.val[0] = s.val[3];
+         d.val[1] = s.val[2];
+         d.val[2] = s.val[1];
+         vst3q_u8(dst_ptr + x * 3, d);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_RGBX_8888_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void rgbx_8888_to_bgr_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(s0, 27);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00fc0000u)), 13));
+         d0 = vorrq_u32(d0, vandq_u32(s0, vdupq_n_u32(0x0000f800u)));
+         d1 = vshrq_n_u32(s1, 27);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00fc0000u)), 13));
+         d1 = vorrq_u32(d1, vandq_u32(s1, vdupq_n_u32(0x0000f800u)));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_bgr_555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(s0, 27);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 14));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f800u)), 1));
+         d1 = vshrq_n_u32(s1, 27);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 14));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f800u)), 1));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_xrgb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vshrq_n_u32(s, 8);
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+#ifdef __aarch64__
+static void rgbx_8888_to_abgr_f32_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      ALLEGRO_COLOR *dst_ptr = (ALLEGRO_COLOR *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         float32x4x4_t d;
+         d.val[0] = vdivq_f32(vcvtq_f32_u32(
+            vshrq_n_u32(s, 24)), vdupq_n_f32(255.0f));
+         d.val[1] = vdivq_f32(vcvtq_f32_u32(
+            vandq_u32(vshrq_n_u32(s, 16), vdupq_n_u32(0xff))), vdupq_n_f32(255.0f));
+         d.val[2] = vdivq_f32(vcvtq_f32_u32(
+            vandq_u32(vshrq_n_u32(s, 8), vdupq_n_u32(0xff))), vdupq_n_f32(255.0f));
+         d.val[3] = vdupq_n_f32(1.0f);
+         vst4q_f32((float *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ABGR_F32(src_ptr[x]);
+      }
+   }
+}
+#endif
+static void rgbx_8888_to_abgr_8888_le_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vshrq_n_u32(s, 24);
+         d = vorrq_u32(d, vshrq_n_u32(vandq_u32(s, vdupq_n_u32(0x00ff0000u)), 8));
+         d = vorrq_u32(d, vshlq_n_u32(vandq_u32(s, vdupq_n_u32(0x0000ff00u)), 8));
+         d = vorrq_u32(d, vdupq_n_u32(0xff000000u));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static void rgbx_8888_to_rgba_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0xf0000000u)), 16);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f00000u)), 12));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f000u)), 8));
+         d0 = vorrq_u32(d0, vdupq_n_u32(0x0000000fu));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0xf0000000u)), 16);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f00000u)), 12));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f000u)), 8));
+         d1 = vorrq_u32(d1, vdupq_n_u32(0x0000000fu));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_RGBX_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_argb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vandq_u32(s, vdupq_n_u32(0x00ffffffu));
+         d = vorrq_u32(d, vdupq_n_u32(0xff000000u));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_rgba_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vshlq_n_u32(s, 8);
+         d = vorrq_u32(d, vdupq_n_u32(0x000000ffu));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_argb_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f00000u)), 12);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f000u)), 8));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f0u)), 4));
+         d0 = vorrq_u32(d0, vdupq_n_u32(0x0000f000u));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f00000u)), 12);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f000u)), 8));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f0u)), 4));
+         d1 = vorrq_u32(d1, vdupq_n_u32(0x0000f000u));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_rgb_888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         uint8x16x4_t s = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x3_t d;
+         d.val[0] = s.val[0];
+         d.val[1] = s.val[1];
+         d.val[2] = s.val[2];
+         vst3q_u8(dst_ptr + x * 3, d);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_XRGB_8888_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void xrgb_8888_to_rgb_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 8);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000fc00u)), 5));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f8u)), 3));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 8);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000fc00u)), 5));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f8u)), 3));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_rgb_555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 9);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f800u)), 6));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f8u)), 3));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 9);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f800u)), 6));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f8u)), 3));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_rgba_5551_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 8);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f800u)), 5));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f8u)), 2));
+         d0 = vorrq_u32(d0, vdupq_n_u32(0x00000001u));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 8);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f800u)), 5));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f8u)), 2));
+         d1 = vorrq_u32(d1, vdupq_n_u32(0x00000001u));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_argb_1555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 9);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f800u)), 6));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f8u)), 3));
+         d0 = vorrq_u32(d0, vdupq_n_u32(0x00008000u));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 9);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f800u)), 6));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f8u)), 3));
+         d1 = vorrq_u32(d1, vdupq_n_u32(0x00008000u));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_abgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vshrq_n_u32(vandq_u32(s, vdupq_n_u32(0x00ff0000u)), 16);
+         d = vorrq_u32(d, vandq_u32(s, vdupq_n_u32(0x0000ff00u)));
+         d = vorrq_u32(d, vshlq_n_u32(vandq_u32(s, vdupq_n_u32(0x000000ffu)), 16));
+         d = vorrq_u32(d, vdupq_n_u32(0xff000000u));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_xbgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vshrq_n_u32(vandq_u32(s, vdupq_n_u32(0x00ff0000u)), 16);
+         d = vorrq_u32(d, vandq_u32(s, vdupq_n_u32(0x0000ff00u)));
+         d = vorrq_u32(d, vshlq_n_u32(vandq_u32(s, vdupq_n_u32(0x000000ffu)), 16));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_bgr_888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         uint8x16x4_t s = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x3_t d;
+         d.val[0] = s.val[2];
+         d.val[1] = s.val[1];
+         d.val[2] = s.val[0];
+         vst3q_u8(dst_ptr + x * 3, d);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_XRGB_8888_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void xrgb_8888_to_bgr_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 19);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000fc00u)), 5));
+         d0 = vorrq_u32(d0, vshlq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f8u)), 8));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 19);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000fc00u)), 5));
+         d1 = vorrq_u32(d1, vshlq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f8u)), 8));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_bgr_555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 19);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f800u)), 6));
+         d0 = vorrq_u32(d0, vshlq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f8u)), 7));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 19);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f800u)), 6));
+         d1 = vorrq_u32(d1, vshlq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f8u)), 7));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_rgbx_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vshlq_n_u32(s, 8);
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+#ifdef __aarch64__
+static void xrgb_8888_to_abgr_f32_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      ALLEGRO_COLOR *dst_ptr = (ALLEGRO_COLOR *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         float32x4x4_t d;
+         d.val[0] = vdivq_f32(vcvtq_f32_u32(
+            vandq_u32(vshrq_n_u32(s, 16), vdupq_n_u32(0xff))), vdupq_n_f32(255.0f));
+         d.val[1] = vdivq_f32(vcvtq_f32_u32(
+            vandq_u32(vshrq_n_u32(s, 8), vdupq_n_u32(0xff))), vdupq_n_f32(255.0f));
+         d.val[2] = vdivq_f32(vcvtq_f32_u32(
+            vandq_u32(s, vdupq_n_u32(0xff))), vdupq_n_f32(255.0f));
+         d.val[3] = vdupq_n_f32(1.0f);
+         vst4q_f32((float *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ABGR_F32(src_ptr[x]);
+      }
+   }
+}
+#endif
+static void xrgb_8888_to_abgr_8888_le_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vshrq_n_u32(vandq_u32(s, vdupq_n_u32(0x00ff0000u)), 16);
+         d = vorrq_u32(d, vandq_u32(s, vdupq_n_u32(0x0000ff00u)));
+         d = vorrq_u32(d, vshlq_n_u32(vandq_u32(s, vdupq_n_u32(0x000000ffu)), 16));
+         d = vorrq_u32(d, vdupq_n_u32(0xff000000u));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static void xrgb_8888_to_rgba_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f00000u)), 8);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f000u)), 4));
+         d0 = vorrq_u32(d0, vandq_u32(s0, vdupq_n_u32(0x000000f0u)));
+         d0 = vorrq_u32(d0, vdupq_n_u32(0x0000000fu));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f00000u)), 8);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f000u)), 4));
+         d1 = vorrq_u32(d1, vandq_u32(s1, vdupq_n_u32(0x000000f0u)));
+         d1 = vorrq_u32(d1, vdupq_n_u32(0x0000000fu));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_XRGB_8888_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+static void abgr_f32_to_argb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const ALLEGRO_COLOR *src_ptr = (const ALLEGRO_COLOR *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         float32x4x4_t s = vld4q_f32((const float *)(src_ptr + x));
+         uint32x4_t d;
+         d = vshlq_n_u32(vcvtq_u32_f32(vmulq_n_f32(s.val[0], 255.0f)), 16);
+         d = vorrq_u32(d,
+            vshlq_n_u32(vcvtq_u32_f32(vmulq_n_f32(s.val[1], 255.0f)), 8));
+         d = vorrq_u32(d,
+            vcvtq_u32_f32(vmulq_n_f32(s.val[2], 255.0f)));
+         d = vorrq_u32(d,
+            vshlq_n_u32(vcvtq_u32_f32(vmulq_n_f32(s.val[3], 255.0f)), 24));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_F32_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_f32_to_rgba_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const ALLEGRO_COLOR *src_ptr = (const ALLEGRO_COLOR *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         float32x4x4_t s = vld4q_f32((const float *)(src_ptr + x));
+         uint32x4_t d;
+         d = vshlq_n_u32(vcvtq_u32_f32(vmulq_n_f32(s.val[0], 255.0f)), 24);
+         d = vorrq_u32(d,
+            vshlq_n_u32(vcvtq_u32_f32(vmulq_n_f32(s.val[1], 255.0f)), 16));
+         d = vorrq_u32(d,
+            vshlq_n_u32(vcvtq_u32_f32(vmulq_n_f32(s.val[2], 255.0f)), 8));
+         d = vorrq_u32(d,
+            vcvtq_u32_f32(vmulq_n_f32(s.val[3], 255.0f)));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_F32_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_f32_to_abgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const ALLEGRO_COLOR *src_ptr = (const ALLEGRO_COLOR *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         float32x4x4_t s = vld4q_f32((const float *)(src_ptr + x));
+         uint32x4_t d;
+         d = vcvtq_u32_f32(vmulq_n_f32(s.val[0], 255.0f));
+         d = vorrq_u32(d,
+            vshlq_n_u32(vcvtq_u32_f32(vmulq_n_f32(s.val[1], 255.0f)), 8));
+         d = vorrq_u32(d,
+            vshlq_n_u32(vcvtq_u32_f32(vmulq_n_f32(s.val[2], 255.0f)), 16));
+         d = vorrq_u32(d,
+            vshlq_n_u32(vcvtq_u32_f32(vmulq_n_f32(s.val[3], 255.0f)), 24));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_F32_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_f32_to_xbgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const ALLEGRO_COLOR *src_ptr = (const ALLEGRO_COLOR *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         float32x4x4_t s = vld4q_f32((const float *)(src_ptr + x));
+         uint32x4_t d;
+         d = vcvtq_u32_f32(vmulq_n_f32(s.val[0], 255.0f));
+         d = vorrq_u32(d,
+            vshlq_n_u32(vcvtq_u32_f32(vmulq_n_f32(s.val[1], 255.0f)), 8));
+         d = vorrq_u32(d,
+            vshlq_n_u32(vcvtq_u32_f32(vmulq_n_f32(s.val[2], 255.0f)), 16));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_F32_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_f32_to_rgbx_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const ALLEGRO_COLOR *src_ptr = (const ALLEGRO_COLOR *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         float32x4x4_t s = vld4q_f32((const float *)(src_ptr + x));
+         uint32x4_t d;
+         d = vshlq_n_u32(vcvtq_u32_f32(vmulq_n_f32(s.val[0], 255.0f)), 24);
+         d = vorrq_u32(d,
+            vshlq_n_u32(vcvtq_u32_f32(vmulq_n_f32(s.val[1], 255.0f)), 16));
+         d = vorrq_u32(d,
+            vshlq_n_u32(vcvtq_u32_f32(vmulq_n_f32(s.val[2], 255.0f)), 8));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_F32_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_f32_to_xrgb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const ALLEGRO_COLOR *src_ptr = (const ALLEGRO_COLOR *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         float32x4x4_t s = vld4q_f32((const float *)(src_ptr + x));
+         uint32x4_t d;
+         d = vshlq_n_u32(vcvtq_u32_f32(vmulq_n_f32(s.val[0], 255.0f)), 16);
+         d = vorrq_u32(d,
+            vshlq_n_u32(vcvtq_u32_f32(vmulq_n_f32(s.val[1], 255.0f)), 8));
+         d = vorrq_u32(d,
+            vcvtq_u32_f32(vmulq_n_f32(s.val[2], 255.0f)));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_F32_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_f32_to_abgr_8888_le_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const ALLEGRO_COLOR *src_ptr = (const ALLEGRO_COLOR *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         float32x4x4_t s = vld4q_f32((const float *)(src_ptr + x));
+         uint32x4_t d;
+         d = vcvtq_u32_f32(vmulq_n_f32(s.val[0], 255.0f));
+         d = vorrq_u32(d,
+            vshlq_n_u32(vcvtq_u32_f32(vmulq_n_f32(s.val[1], 255.0f)), 8));
+         d = vorrq_u32(d,
+            vshlq_n_u32(vcvtq_u32_f32(vmulq_n_f32(s.val[2], 255.0f)), 16));
+         d = vorrq_u32(d,
+            vshlq_n_u32(vcvtq_u32_f32(vmulq_n_f32(s.val[3], 255.0f)), 24));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_F32_TO_ABGR_8888_LE(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_argb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vshrq_n_u32(vandq_u32(s, vdupq_n_u32(0x00ff0000u)), 16);
+         d = vorrq_u32(d, vandq_u32(s, vdupq_n_u32(0xff00ff00u)));
+         d = vorrq_u32(d, vshlq_n_u32(vandq_u32(s, vdupq_n_u32(0x000000ffu)), 16));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ARGB_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_rgba_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vshrq_n_u32(s, 24);
+         d = vorrq_u32(d, vshrq_n_u32(vandq_u32(s, vdupq_n_u32(0x00ff0000u)), 8));
+         d = vorrq_u32(d, vshlq_n_u32(vandq_u32(s, vdupq_n_u32(0x0000ff00u)), 8));
+         d = vorrq_u32(d, vshlq_n_u32(s, 24));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBA_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_argb_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f00000u)), 20);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0xf0000000u)), 16));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f000u)), 8));
+         d0 = vorrq_u32(d0, vshlq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f0u)), 4));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f00000u)), 20);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0xf0000000u)), 16));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f000u)), 8));
+         d1 = vorrq_u32(d1, vshlq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f0u)), 4));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ARGB_4444(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_rgb_888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         uint8x16x4_t s = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x3_t d;
+         d.val[0] = s.val[2];
+         d.val[1] = s.val[1];
+         d.val[2] = s.val[0];
+         vst3q_u8(dst_ptr + x * 3, d);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGB_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void abgr_8888_le_to_rgb_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 19);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000fc00u)), 5));
+         d0 = vorrq_u32(d0, vshlq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f8u)), 8));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 19);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000fc00u)), 5));
+         d1 = vorrq_u32(d1, vshlq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f8u)), 8));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGB_565(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_rgb_555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 19);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f800u)), 6));
+         d0 = vorrq_u32(d0, vshlq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f8u)), 7));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 19);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f800u)), 6));
+         d1 = vorrq_u32(d1, vshlq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f8u)), 7));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGB_555(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_rgba_5551_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(s0, 31);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 18));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f800u)), 5));
+         d0 = vorrq_u32(d0, vshlq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f8u)), 8));
+         d1 = vshrq_n_u32(s1, 31);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 18));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f800u)), 5));
+         d1 = vorrq_u32(d1, vshlq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f8u)), 8));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBA_5551(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_argb_1555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 19);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x80000000u)), 16));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f800u)), 6));
+         d0 = vorrq_u32(d0, vshlq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f8u)), 7));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 19);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x80000000u)), 16));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f800u)), 6));
+         d1 = vorrq_u32(d1, vshlq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f8u)), 7));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ARGB_1555(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_abgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = s;
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ABGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_xbgr_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vandq_u32(s, vdupq_n_u32(0x00ffffffu));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_XBGR_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_bgr_888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint8_t *dst_ptr = (uint8_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx * 3;
+      int x = 0;
+      for (; x + 16 <= width; x += 16) {
+         uint8x16x4_t s = vld4q_u8((const uint8_t *)(src_ptr + x));
+         uint8x16x3_t d;
+         d.val[0] = s.val[0];
+         d.val[1] = s.val[1];
+         d.val[2] = s.val[2];
+         vst3q_u8(dst_ptr + x * 3, d);
+      }
+      for (; x < width; x++) {
+         int dst_pixel = ALLEGRO_CONVERT_ABGR_8888_LE_TO_BGR_888(src_ptr[x]);
+         dst_ptr[x * 3 + 0] = dst_pixel;
+         dst_ptr[x * 3 + 1] = dst_pixel >> 8;
+         dst_ptr[x * 3 + 2] = dst_pixel >> 16;
+      }
+   }
+}
+static void abgr_8888_le_to_bgr_565_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 8);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000fc00u)), 5));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f8u)), 3));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 8);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000fc00u)), 5));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f8u)), 3));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_BGR_565(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_bgr_555_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f80000u)), 9);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f800u)), 6));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f8u)), 3));
+         d1 = vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f80000u)), 9);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f800u)), 6));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f8u)), 3));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_BGR_555(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_rgbx_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vshrq_n_u32(vandq_u32(s, vdupq_n_u32(0x00ff0000u)), 8);
+         d = vorrq_u32(d, vshlq_n_u32(vandq_u32(s, vdupq_n_u32(0x0000ff00u)), 8));
+         d = vorrq_u32(d, vshlq_n_u32(s, 24));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBX_8888(src_ptr[x]);
+      }
+   }
+}
+static void abgr_8888_le_to_xrgb_8888_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint32_t *dst_ptr = (uint32_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         uint32x4_t d;
+         d = vshrq_n_u32(vandq_u32(s, vdupq_n_u32(0x00ff0000u)), 16);
+         d = vorrq_u32(d, vandq_u32(s, vdupq_n_u32(0x0000ff00u)));
+         d = vorrq_u32(d, vshlq_n_u32(vandq_u32(s, vdupq_n_u32(0x000000ffu)), 16));
+         vst1q_u32(dst_ptr + x, d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_XRGB_8888(src_ptr[x]);
+      }
+   }
+}
+#ifdef __aarch64__
+static void abgr_8888_le_to_abgr_f32_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      ALLEGRO_COLOR *dst_ptr = (ALLEGRO_COLOR *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 4 <= width; x += 4) {
+         uint32x4_t s = vld1q_u32(src_ptr + x);
+         float32x4x4_t d;
+         d.val[0] = vdivq_f32(vcvtq_f32_u32(
+            vandq_u32(s, vdupq_n_u32(0xff))), vdupq_n_f32(255.0f));
+         d.val[1] = vdivq_f32(vcvtq_f32_u32(
+            vandq_u32(vshrq_n_u32(s, 8), vdupq_n_u32(0xff))), vdupq_n_f32(255.0f));
+         d.val[2] = vdivq_f32(vcvtq_f32_u32(
+            vandq_u32(vshrq_n_u32(s, 16), vdupq_n_u32(0xff))), vdupq_n_f32(255.0f));
+         d.val[3] = vdivq_f32(vcvtq_f32_u32(
+            vshrq_n_u32(s, 24)), vdupq_n_f32(255.0f));
+         vst4q_f32((float *)(dst_ptr + x), d);
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_ABGR_F32(src_ptr[x]);
+      }
+   }
+}
+#endif
+static void abgr_8888_le_to_rgba_4444_neon(const void *src, int src_pitch,
+   void *dst, int dst_pitch,
+   int sx, int sy, int dx, int dy, int width, int height)
+{
+   int y;
+   for (y = 0; y < height; y++) {
+      const uint32_t *src_ptr = (const uint32_t *)
+         ((const char *)src + (sy + y) * src_pitch) + sx;
+      uint16_t *dst_ptr = (uint16_t *)
+         ((char *)dst + (dy + y) * dst_pitch) + dx;
+      int x = 0;
+      for (; x + 8 <= width; x += 8) {
+         uint32x4_t s0 = vld1q_u32(src_ptr + x);
+         uint32x4_t s1 = vld1q_u32(src_ptr + x + 4);
+         uint32x4_t d0, d1;
+         d0 = vshrq_n_u32(s0, 28);
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x00f00000u)), 16));
+         d0 = vorrq_u32(d0, vshrq_n_u32(vandq_u32(s0, vdupq_n_u32(0x0000f000u)), 4));
+         d0 = vorrq_u32(d0, vshlq_n_u32(vandq_u32(s0, vdupq_n_u32(0x000000f0u)), 8));
+         d1 = vshrq_n_u32(s1, 28);
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x00f00000u)), 16));
+         d1 = vorrq_u32(d1, vshrq_n_u32(vandq_u32(s1, vdupq_n_u32(0x0000f000u)), 4));
+         d1 = vorrq_u32(d1, vshlq_n_u32(vandq_u32(s1, vdupq_n_u32(0x000000f0u)), 8));
+         vst1q_u16(dst_ptr + x, vcombine_u16(vmovn_u32(d0), vmovn_u32(d1)));
+      }
+      for (; x < width; x++) {
+         dst_ptr[x] = ALLEGRO_CONVERT_ABGR_8888_LE_TO_RGBA_4444(src_ptr[x]);
+      }
+   }
+}
+#endif
+
+static void (*scalar_funcs[ALLEGRO_NUM_PIXEL_FORMATS]
+   [ALLEGRO_NUM_PIXEL_FORMATS])(const void *, int, void *, int,
+   int, int, int, int, int, int);
+static bool scalar_funcs_saved = false;
+
+/* Replaces the entries of _al_convert_funcs which have a variant for one of
+ * the instruction sets in cpu_caps. Passing 0 restores the C versions.
+ */
+void _al_select_convert_funcs(int cpu_caps)
+{
+   if (!scalar_funcs_saved) {
+      memcpy(scalar_funcs, _al_convert_funcs, sizeof(scalar_funcs));
+      scalar_funcs_saved = true;
+   }
+   else {
+      memcpy(_al_convert_funcs, scalar_funcs, sizeof(scalar_funcs));
+   }
+
+#ifdef CONVERT_SSE2
+   if (cpu_caps & _AL_CPU_SSE2) {
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_8888] = argb_8888_to_rgba_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_4444] = argb_8888_to_argb_4444_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_888] = argb_8888_to_rgb_888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_565] = argb_8888_to_rgb_565_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_555] = argb_8888_to_rgb_555_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_5551] = argb_8888_to_rgba_5551_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_1555] = argb_8888_to_argb_1555_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888] = argb_8888_to_abgr_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_XBGR_8888] = argb_8888_to_xbgr_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_888] = argb_8888_to_bgr_888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_565] = argb_8888_to_bgr_565_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_555] = argb_8888_to_bgr_555_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBX_8888] = argb_8888_to_rgbx_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_XRGB_8888] = argb_8888_to_xrgb_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_F32] = argb_8888_to_abgr_f32_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] = argb_8888_to_abgr_8888_le_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_4444] = argb_8888_to_rgba_4444_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_8888] = rgba_8888_to_argb_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_4444] = rgba_8888_to_argb_4444_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_888] = rgba_8888_to_rgb_888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_565] = rgba_8888_to_rgb_565_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_555] = rgba_8888_to_rgb_555_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_5551] = rgba_8888_to_rgba_5551_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_1555] = rgba_8888_to_argb_1555_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888] = rgba_8888_to_abgr_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_XBGR_8888] = rgba_8888_to_xbgr_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_888] = rgba_8888_to_bgr_888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_565] = rgba_8888_to_bgr_565_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_555] = rgba_8888_to_bgr_555_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBX_8888] = rgba_8888_to_rgbx_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_XRGB_8888] = rgba_8888_to_xrgb_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_F32] = rgba_8888_to_abgr_f32_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] = rgba_8888_to_abgr_8888_le_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_4444] = rgba_8888_to_rgba_4444_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_8888] = abgr_8888_to_argb_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_8888] = abgr_8888_to_rgba_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_4444] = abgr_8888_to_argb_4444_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_888] = abgr_8888_to_rgb_888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_565] = abgr_8888_to_rgb_565_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_555] = abgr_8888_to_rgb_555_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_5551] = abgr_8888_to_rgba_5551_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_1555] = abgr_8888_to_argb_1555_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_XBGR_8888] = abgr_8888_to_xbgr_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_888] = abgr_8888_to_bgr_888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_565] = abgr_8888_to_bgr_565_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_555] = abgr_8888_to_bgr_555_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBX_8888] = abgr_8888_to_rgbx_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_XRGB_8888] = abgr_8888_to_xrgb_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_F32] = abgr_8888_to_abgr_f32_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] = abgr_8888_to_abgr_8888_le_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_4444] = abgr_8888_to_rgba_4444_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_8888] = xbgr_8888_to_argb_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_8888] = xbgr_8888_to_rgba_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_4444] = xbgr_8888_to_argb_4444_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_888] = xbgr_8888_to_rgb_888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_565] = xbgr_8888_to_rgb_565_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_555] = xbgr_8888_to_rgb_555_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_5551] = xbgr_8888_to_rgba_5551_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_1555] = xbgr_8888_to_argb_1555_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888] = xbgr_8888_to_abgr_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_888] = xbgr_8888_to_bgr_888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_565] = xbgr_8888_to_bgr_565_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_555] = xbgr_8888_to_bgr_555_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBX_8888] = xbgr_8888_to_rgbx_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_XRGB_8888] = xbgr_8888_to_xrgb_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_F32] = xbgr_8888_to_abgr_f32_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] = xbgr_8888_to_abgr_8888_le_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_4444] = xbgr_8888_to_rgba_4444_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_8888] = rgbx_8888_to_argb_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_8888] = rgbx_8888_to_rgba_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_4444] = rgbx_8888_to_argb_4444_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_888] = rgbx_8888_to_rgb_888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_565] = rgbx_8888_to_rgb_565_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_555] = rgbx_8888_to_rgb_555_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_5551] = rgbx_8888_to_rgba_5551_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_1555] = rgbx_8888_to_argb_1555_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888] = rgbx_8888_to_abgr_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_XBGR_8888] = rgbx_8888_to_xbgr_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_888] = rgbx_8888_to_bgr_888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_565] = rgbx_8888_to_bgr_565_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_555] = rgbx_8888_to_bgr_555_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_XRGB_8888] = rgbx_8888_to_xrgb_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_F32] = rgbx_8888_to_abgr_f32_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] = rgbx_8888_to_abgr_8888_le_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_4444] = rgbx_8888_to_rgba_4444_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_8888] = xrgb_8888_to_argb_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_8888] = xrgb_8888_to_rgba_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_4444] = xrgb_8888_to_argb_4444_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_888] = xrgb_8888_to_rgb_888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_565] = xrgb_8888_to_rgb_565_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_555] = xrgb_8888_to_rgb_555_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_5551] = xrgb_8888_to_rgba_5551_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_1555] = xrgb_8888_to_argb_1555_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888] = xrgb_8888_to_abgr_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_XBGR_8888] = xrgb_8888_to_xbgr_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_888] = xrgb_8888_to_bgr_888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_565] = xrgb_8888_to_bgr_565_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_555] = xrgb_8888_to_bgr_555_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBX_8888] = xrgb_8888_to_rgbx_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_F32] = xrgb_8888_to_abgr_f32_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] = xrgb_8888_to_abgr_8888_le_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_4444] = xrgb_8888_to_rgba_4444_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_F32]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_8888] = abgr_f32_to_argb_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_F32]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_8888] = abgr_f32_to_rgba_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_F32]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888] = abgr_f32_to_abgr_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_F32]
+         [ALLEGRO_PIXEL_FORMAT_XBGR_8888] = abgr_f32_to_xbgr_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_F32]
+         [ALLEGRO_PIXEL_FORMAT_RGBX_8888] = abgr_f32_to_rgbx_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_F32]
+         [ALLEGRO_PIXEL_FORMAT_XRGB_8888] = abgr_f32_to_xrgb_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_F32]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] = abgr_f32_to_abgr_8888_le_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_8888] = abgr_8888_le_to_argb_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_8888] = abgr_8888_le_to_rgba_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_4444] = abgr_8888_le_to_argb_4444_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_RGB_888] = abgr_8888_le_to_rgb_888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_RGB_565] = abgr_8888_le_to_rgb_565_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_RGB_555] = abgr_8888_le_to_rgb_555_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_5551] = abgr_8888_le_to_rgba_5551_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_1555] = abgr_8888_le_to_argb_1555_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888] = abgr_8888_le_to_abgr_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_XBGR_8888] = abgr_8888_le_to_xbgr_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_BGR_888] = abgr_8888_le_to_bgr_888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_BGR_565] = abgr_8888_le_to_bgr_565_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_BGR_555] = abgr_8888_le_to_bgr_555_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_RGBX_8888] = abgr_8888_le_to_rgbx_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_XRGB_8888] = abgr_8888_le_to_xrgb_8888_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_F32] = abgr_8888_le_to_abgr_f32_sse2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_4444] = abgr_8888_le_to_rgba_4444_sse2;
+   }
+#endif
+#ifdef CONVERT_AVX2
+   if (cpu_caps & _AL_CPU_AVX2) {
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_8888] = argb_8888_to_rgba_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_4444] = argb_8888_to_argb_4444_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_888] = argb_8888_to_rgb_888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_565] = argb_8888_to_rgb_565_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_555] = argb_8888_to_rgb_555_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_5551] = argb_8888_to_rgba_5551_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_1555] = argb_8888_to_argb_1555_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888] = argb_8888_to_abgr_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_XBGR_8888] = argb_8888_to_xbgr_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_888] = argb_8888_to_bgr_888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_565] = argb_8888_to_bgr_565_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_555] = argb_8888_to_bgr_555_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBX_8888] = argb_8888_to_rgbx_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_XRGB_8888] = argb_8888_to_xrgb_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] = argb_8888_to_abgr_8888_le_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_4444] = argb_8888_to_rgba_4444_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_8888] = rgba_8888_to_argb_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_4444] = rgba_8888_to_argb_4444_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_888] = rgba_8888_to_rgb_888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_565] = rgba_8888_to_rgb_565_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_555] = rgba_8888_to_rgb_555_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_5551] = rgba_8888_to_rgba_5551_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_1555] = rgba_8888_to_argb_1555_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888] = rgba_8888_to_abgr_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_XBGR_8888] = rgba_8888_to_xbgr_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_888] = rgba_8888_to_bgr_888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_565] = rgba_8888_to_bgr_565_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_555] = rgba_8888_to_bgr_555_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBX_8888] = rgba_8888_to_rgbx_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_XRGB_8888] = rgba_8888_to_xrgb_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] = rgba_8888_to_abgr_8888_le_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_4444] = rgba_8888_to_rgba_4444_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_8888] = abgr_8888_to_argb_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_8888] = abgr_8888_to_rgba_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_4444] = abgr_8888_to_argb_4444_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_888] = abgr_8888_to_rgb_888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_565] = abgr_8888_to_rgb_565_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_555] = abgr_8888_to_rgb_555_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_5551] = abgr_8888_to_rgba_5551_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_1555] = abgr_8888_to_argb_1555_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_XBGR_8888] = abgr_8888_to_xbgr_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_888] = abgr_8888_to_bgr_888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_565] = abgr_8888_to_bgr_565_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_555] = abgr_8888_to_bgr_555_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBX_8888] = abgr_8888_to_rgbx_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_XRGB_8888] = abgr_8888_to_xrgb_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] = abgr_8888_to_abgr_8888_le_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_4444] = abgr_8888_to_rgba_4444_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_8888] = xbgr_8888_to_argb_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_8888] = xbgr_8888_to_rgba_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_4444] = xbgr_8888_to_argb_4444_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_888] = xbgr_8888_to_rgb_888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_565] = xbgr_8888_to_rgb_565_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_555] = xbgr_8888_to_rgb_555_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_5551] = xbgr_8888_to_rgba_5551_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_1555] = xbgr_8888_to_argb_1555_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888] = xbgr_8888_to_abgr_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_888] = xbgr_8888_to_bgr_888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_565] = xbgr_8888_to_bgr_565_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_555] = xbgr_8888_to_bgr_555_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBX_8888] = xbgr_8888_to_rgbx_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_XRGB_8888] = xbgr_8888_to_xrgb_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] = xbgr_8888_to_abgr_8888_le_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_4444] = xbgr_8888_to_rgba_4444_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_8888] = rgbx_8888_to_argb_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_8888] = rgbx_8888_to_rgba_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_4444] = rgbx_8888_to_argb_4444_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_888] = rgbx_8888_to_rgb_888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_565] = rgbx_8888_to_rgb_565_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_555] = rgbx_8888_to_rgb_555_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_5551] = rgbx_8888_to_rgba_5551_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_1555] = rgbx_8888_to_argb_1555_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888] = rgbx_8888_to_abgr_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_XBGR_8888] = rgbx_8888_to_xbgr_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_888] = rgbx_8888_to_bgr_888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_565] = rgbx_8888_to_bgr_565_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_555] = rgbx_8888_to_bgr_555_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_XRGB_8888] = rgbx_8888_to_xrgb_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] = rgbx_8888_to_abgr_8888_le_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_4444] = rgbx_8888_to_rgba_4444_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_8888] = xrgb_8888_to_argb_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_8888] = xrgb_8888_to_rgba_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_4444] = xrgb_8888_to_argb_4444_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_888] = xrgb_8888_to_rgb_888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_565] = xrgb_8888_to_rgb_565_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_555] = xrgb_8888_to_rgb_555_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_5551] = xrgb_8888_to_rgba_5551_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_1555] = xrgb_8888_to_argb_1555_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888] = xrgb_8888_to_abgr_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_XBGR_8888] = xrgb_8888_to_xbgr_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_888] = xrgb_8888_to_bgr_888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_565] = xrgb_8888_to_bgr_565_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_555] = xrgb_8888_to_bgr_555_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBX_8888] = xrgb_8888_to_rgbx_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] = xrgb_8888_to_abgr_8888_le_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_4444] = xrgb_8888_to_rgba_4444_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_8888] = abgr_8888_le_to_argb_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_8888] = abgr_8888_le_to_rgba_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_4444] = abgr_8888_le_to_argb_4444_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_RGB_888] = abgr_8888_le_to_rgb_888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_RGB_565] = abgr_8888_le_to_rgb_565_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_RGB_555] = abgr_8888_le_to_rgb_555_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_5551] = abgr_8888_le_to_rgba_5551_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_1555] = abgr_8888_le_to_argb_1555_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888] = abgr_8888_le_to_abgr_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_XBGR_8888] = abgr_8888_le_to_xbgr_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_BGR_888] = abgr_8888_le_to_bgr_888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_BGR_565] = abgr_8888_le_to_bgr_565_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_BGR_555] = abgr_8888_le_to_bgr_555_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_RGBX_8888] = abgr_8888_le_to_rgbx_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_XRGB_8888] = abgr_8888_le_to_xrgb_8888_avx2;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_4444] = abgr_8888_le_to_rgba_4444_avx2;
+   }
+#endif
+#ifdef CONVERT_NEON
+   if (cpu_caps & _AL_CPU_NEON) {
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_8888] = argb_8888_to_rgba_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_4444] = argb_8888_to_argb_4444_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_888] = argb_8888_to_rgb_888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_565] = argb_8888_to_rgb_565_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_555] = argb_8888_to_rgb_555_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_5551] = argb_8888_to_rgba_5551_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_1555] = argb_8888_to_argb_1555_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888] = argb_8888_to_abgr_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_XBGR_8888] = argb_8888_to_xbgr_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_888] = argb_8888_to_bgr_888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_565] = argb_8888_to_bgr_565_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_555] = argb_8888_to_bgr_555_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBX_8888] = argb_8888_to_rgbx_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_XRGB_8888] = argb_8888_to_xrgb_8888_neon;
+#ifdef __aarch64__
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_F32] = argb_8888_to_abgr_f32_neon;
+#endif
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] = argb_8888_to_abgr_8888_le_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ARGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_4444] = argb_8888_to_rgba_4444_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_8888] = rgba_8888_to_argb_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_4444] = rgba_8888_to_argb_4444_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_888] = rgba_8888_to_rgb_888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_565] = rgba_8888_to_rgb_565_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_555] = rgba_8888_to_rgb_555_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_5551] = rgba_8888_to_rgba_5551_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_1555] = rgba_8888_to_argb_1555_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888] = rgba_8888_to_abgr_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_XBGR_8888] = rgba_8888_to_xbgr_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_888] = rgba_8888_to_bgr_888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_565] = rgba_8888_to_bgr_565_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_555] = rgba_8888_to_bgr_555_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBX_8888] = rgba_8888_to_rgbx_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_XRGB_8888] = rgba_8888_to_xrgb_8888_neon;
+#ifdef __aarch64__
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_F32] = rgba_8888_to_abgr_f32_neon;
+#endif
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] = rgba_8888_to_abgr_8888_le_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBA_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_4444] = rgba_8888_to_rgba_4444_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_8888] = abgr_8888_to_argb_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_8888] = abgr_8888_to_rgba_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_4444] = abgr_8888_to_argb_4444_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_888] = abgr_8888_to_rgb_888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_565] = abgr_8888_to_rgb_565_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_555] = abgr_8888_to_rgb_555_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_5551] = abgr_8888_to_rgba_5551_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_1555] = abgr_8888_to_argb_1555_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_XBGR_8888] = abgr_8888_to_xbgr_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_888] = abgr_8888_to_bgr_888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_565] = abgr_8888_to_bgr_565_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_555] = abgr_8888_to_bgr_555_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBX_8888] = abgr_8888_to_rgbx_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_XRGB_8888] = abgr_8888_to_xrgb_8888_neon;
+#ifdef __aarch64__
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_F32] = abgr_8888_to_abgr_f32_neon;
+#endif
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] = abgr_8888_to_abgr_8888_le_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_4444] = abgr_8888_to_rgba_4444_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_8888] = xbgr_8888_to_argb_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_8888] = xbgr_8888_to_rgba_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_4444] = xbgr_8888_to_argb_4444_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_888] = xbgr_8888_to_rgb_888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_565] = xbgr_8888_to_rgb_565_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_555] = xbgr_8888_to_rgb_555_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_5551] = xbgr_8888_to_rgba_5551_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_1555] = xbgr_8888_to_argb_1555_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888] = xbgr_8888_to_abgr_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_888] = xbgr_8888_to_bgr_888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_565] = xbgr_8888_to_bgr_565_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_555] = xbgr_8888_to_bgr_555_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBX_8888] = xbgr_8888_to_rgbx_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_XRGB_8888] = xbgr_8888_to_xrgb_8888_neon;
+#ifdef __aarch64__
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_F32] = xbgr_8888_to_abgr_f32_neon;
+#endif
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] = xbgr_8888_to_abgr_8888_le_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XBGR_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_4444] = xbgr_8888_to_rgba_4444_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_8888] = rgbx_8888_to_argb_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_8888] = rgbx_8888_to_rgba_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_4444] = rgbx_8888_to_argb_4444_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_888] = rgbx_8888_to_rgb_888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_565] = rgbx_8888_to_rgb_565_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_555] = rgbx_8888_to_rgb_555_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_5551] = rgbx_8888_to_rgba_5551_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_1555] = rgbx_8888_to_argb_1555_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888] = rgbx_8888_to_abgr_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_XBGR_8888] = rgbx_8888_to_xbgr_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_888] = rgbx_8888_to_bgr_888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_565] = rgbx_8888_to_bgr_565_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_555] = rgbx_8888_to_bgr_555_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_XRGB_8888] = rgbx_8888_to_xrgb_8888_neon;
+#ifdef __aarch64__
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_F32] = rgbx_8888_to_abgr_f32_neon;
+#endif
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] = rgbx_8888_to_abgr_8888_le_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_RGBX_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_4444] = rgbx_8888_to_rgba_4444_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_8888] = xrgb_8888_to_argb_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_8888] = xrgb_8888_to_rgba_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_4444] = xrgb_8888_to_argb_4444_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_888] = xrgb_8888_to_rgb_888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_565] = xrgb_8888_to_rgb_565_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGB_555] = xrgb_8888_to_rgb_555_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_5551] = xrgb_8888_to_rgba_5551_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_1555] = xrgb_8888_to_argb_1555_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888] = xrgb_8888_to_abgr_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_XBGR_8888] = xrgb_8888_to_xbgr_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_888] = xrgb_8888_to_bgr_888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_565] = xrgb_8888_to_bgr_565_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_BGR_555] = xrgb_8888_to_bgr_555_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBX_8888] = xrgb_8888_to_rgbx_8888_neon;
+#ifdef __aarch64__
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_F32] = xrgb_8888_to_abgr_f32_neon;
+#endif
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] = xrgb_8888_to_abgr_8888_le_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_XRGB_8888]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_4444] = xrgb_8888_to_rgba_4444_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_F32]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_8888] = abgr_f32_to_argb_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_F32]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_8888] = abgr_f32_to_rgba_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_F32]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888] = abgr_f32_to_abgr_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_F32]
+         [ALLEGRO_PIXEL_FORMAT_XBGR_8888] = abgr_f32_to_xbgr_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_F32]
+         [ALLEGRO_PIXEL_FORMAT_RGBX_8888] = abgr_f32_to_rgbx_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_F32]
+         [ALLEGRO_PIXEL_FORMAT_XRGB_8888] = abgr_f32_to_xrgb_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_F32]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE] = abgr_f32_to_abgr_8888_le_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_8888] = abgr_8888_le_to_argb_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_8888] = abgr_8888_le_to_rgba_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_4444] = abgr_8888_le_to_argb_4444_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_RGB_888] = abgr_8888_le_to_rgb_888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_RGB_565] = abgr_8888_le_to_rgb_565_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_RGB_555] = abgr_8888_le_to_rgb_555_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_5551] = abgr_8888_le_to_rgba_5551_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_ARGB_1555] = abgr_8888_le_to_argb_1555_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_8888] = abgr_8888_le_to_abgr_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_XBGR_8888] = abgr_8888_le_to_xbgr_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_BGR_888] = abgr_8888_le_to_bgr_888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_BGR_565] = abgr_8888_le_to_bgr_565_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_BGR_555] = abgr_8888_le_to_bgr_555_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_RGBX_8888] = abgr_8888_le_to_rgbx_8888_neon;
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_XRGB_8888] = abgr_8888_le_to_xrgb_8888_neon;
+#ifdef __aarch64__
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_ABGR_F32] = abgr_8888_le_to_abgr_f32_neon;
+#endif
+      _al_convert_funcs[ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE]
+         [ALLEGRO_PIXEL_FORMAT_RGBA_4444] = abgr_8888_le_to_rgba_4444_neon;
+   }
+#endif
+   (void)cpu_caps;
+}
+
+// Warning: This file was created by make_converters.py - do not edit.
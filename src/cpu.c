@@ -18,6 +18,7 @@
 #include "allegro5/allegro.h"
 #include "allegro5/cpu.h"
 #include "allegro5/internal/aintern.h"
+#include "allegro5/internal/aintern_cpu.h"
 
 /* 
 * The CPU and pysical memory detection functions below use 
@@ -37,6 +38,18 @@
 #include <sys/sysctl.h>
 #endif
 
+#if defined(__i386__) || defined(__x86_64__)
+   #if defined(__GNUC__)
+      #define ALLEGRO_CPUID_GCC
+      #include <cpuid.h>
+   #endif
+#elif defined(_M_IX86) || defined(_M_X64)
+   #if defined(_MSC_VER) && _MSC_VER >= 1600
+      #define ALLEGRO_CPUID_MSVC
+      #include <intrin.h>
+   #endif
+#endif
+
 #ifdef ALLEGRO_WINDOWS
 #ifndef WINVER
 #define WINVER 0x0500
@@ -108,5 +121,90 @@ int al_get_ram_size(void)
 }
 
 
+#if defined(ALLEGRO_CPUID_GCC) || defined(ALLEGRO_CPUID_MSVC)
+
+static void cpuid(unsigned int leaf, unsigned int subleaf,
+   unsigned int regs[4])
+{
+#ifdef ALLEGRO_CPUID_GCC
+   __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#else
+   int r[4];
+   __cpuidex(r, (int)leaf, (int)subleaf);
+   regs[0] = r[0];
+   regs[1] = r[1];
+   regs[2] = r[2];
+   regs[3] = r[3];
+#endif
+}
+
+/* Returns the register state the OS saves on context switches (XCR0). */
+static unsigned int xgetbv0(void)
+{
+#ifdef ALLEGRO_CPUID_GCC
+   unsigned int eax, edx;
+   __asm__ __volatile__ ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+   return eax;
+#else
+   return (unsigned int)_xgetbv(0);
+#endif
+}
+
+
+static int detect_cpu_capabilities(void)
+{
+   unsigned int regs[4];
+   unsigned int max_leaf;
+   int caps = 0;
+
+   cpuid(0, 0, regs);
+   max_leaf = regs[0];
+   if (max_leaf < 1)
+      return 0;
+
+   cpuid(1, 0, regs);
+   if (regs[3] & (1 << 26))
+      caps |= _AL_CPU_SSE2;
+
+   /* AVX2 needs the OS to preserve the YMM registers, too. */
+   if (max_leaf >= 7 && (regs[2] & (1 << 27)) && (regs[2] & (1 << 28)) &&
+         (xgetbv0() & 0x6) == 0x6) {
+      cpuid(7, 0, regs);
+      if (regs[1] & (1 << 5))
+         caps |= _AL_CPU_AVX2;
+   }
+
+   return caps;
+}
+
+#else
+
+static int detect_cpu_capabilities(void)
+{
+#if defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(__aarch64__)
+   /* If the compiler was allowed to use NEON, so are we. */
+   return _AL_CPU_NEON;
+#else
+   return 0;
+#endif
+}
+
+#endif
+
+
+/* Internal function: _al_get_cpu_capabilities
+ *  Returns a combination of the _AL_CPU_* flags of the instruction set
+ *  extensions the processor supports.
+ */
+int _al_get_cpu_capabilities(void)
+{
+   static int caps = -1;
+
+   if (caps < 0)
+      caps = detect_cpu_capabilities();
+   return caps;
+}
+
+
 /* vi: set ts=4 sw=4 expandtab: */
       
@@ -33,6 +33,9 @@
 ALLEGRO_DEBUG_CHANNEL("display")
 
 
+static uint64_t display_serial = 0;
+
+
 /* Function: al_create_display
  */
 ALLEGRO_DISPLAY *al_create_display(int w, int h)
@@ -77,6 +80,11 @@ ALLEGRO_DISPLAY *al_create_display(int w, int h)
    al_identity_transform(&display->projview_transform);
 
    display->default_shader = NULL;
+   display->sdf_shader = NULL;
+   display->sdf_shader_failed = false;
+   display->instancing_shader = NULL;
+   display->instancing_shader_failed = false;
+   display->serial = ++display_serial;
 
    _al_vector_init(&display->display_invalidated_callbacks, sizeof(void *));
    _al_vector_init(&display->display_validated_callbacks, sizeof(void *));
@@ -162,6 +170,10 @@ void al_destroy_display(ALLEGRO_DISPLAY *display)
          _al_set_current_display_only(NULL);
 #endif
 
+      al_destroy_shader(display->sdf_shader);
+      display->sdf_shader = NULL;
+      al_destroy_shader(display->instancing_shader);
+      display->instancing_shader = NULL;
       al_destroy_shader(display->default_shader);
       display->default_shader = NULL;
 
@@ -26,11 +26,27 @@
 
 #include "allegro5/allegro.h"
 #include "allegro5/internal/aintern.h"
+#include "allegro5/internal/aintern_atomicops.h"
 #include "allegro5/internal/aintern_dtor.h"
 #include "allegro5/internal/aintern_exitfunc.h"
 #include "allegro5/internal/aintern_events.h"
 #include "allegro5/internal/aintern_system.h"
 
+ALLEGRO_DEBUG_CHANNEL("events")
+
+
+
+#ifdef _AL_HAVE_ATOMICOPS
+/* A slot of the ring buffer of a lock-free queue. The sequence number says
+ * whether the slot is free to be written (it equals the write position) or
+ * holds an event to be read (it equals the read position plus one).
+ */
+typedef struct EVENT_SLOT
+{
+   volatile _AL_ATOMIC sequence;
+   ALLEGRO_EVENT event;
+} EVENT_SLOT;
+#endif
 
 
 struct ALLEGRO_EVENT_QUEUE
@@ -42,6 +58,25 @@ struct ALLEGRO_EVENT_QUEUE
    bool paused;
    _AL_MUTEX mutex;
    _AL_COND cond;
+
+#ifdef _AL_HAVE_ATOMICOPS
+   /* Only for queues made by al_create_lock_free_event_queue, which keep
+    * their events in the ring buffer instead of the events vector, and only
+    * use the mutex to wait for events.
+    */
+   EVENT_SLOT *ring;
+   unsigned int ring_mask;          /* ring buffer size minus one */
+   volatile _AL_ATOMIC ring_head;   /* next position to write */
+   volatile _AL_ATOMIC ring_tail;   /* next position to read */
+   volatile _AL_ATOMIC waiters;     /* number of threads waiting for events */
+   ALLEGRO_EVENT_QUEUE_OVERFLOW overflow;
+
+   /* Room for the events ring_discard_events_of_source keeps, so it can't
+    * fail, and the mutex serialising its use.
+    */
+   ALLEGRO_EVENT *ring_kept;
+   _AL_MUTEX ring_kept_mutex;
+#endif
 };
 
 
@@ -60,6 +95,20 @@ static void ref_if_user_event(ALLEGRO_EVENT *event);
 static void unref_if_user_event(ALLEGRO_EVENT *event);
 static void discard_events_of_source(ALLEGRO_EVENT_QUEUE *queue,
    const ALLEGRO_EVENT_SOURCE *source);
+static int pot(int x);
+#ifdef _AL_HAVE_ATOMICOPS
+static bool ring_push(ALLEGRO_EVENT_QUEUE *queue, const ALLEGRO_EVENT *event,
+   bool add_ref);
+static bool ring_pop(ALLEGRO_EVENT_QUEUE *queue, ALLEGRO_EVENT *ret_event);
+static int ring_pop_many(ALLEGRO_EVENT_QUEUE *queue, ALLEGRO_EVENT *ret_events,
+   int max);
+static bool ring_peek(ALLEGRO_EVENT_QUEUE *queue, ALLEGRO_EVENT *ret_event);
+static bool ring_wait(ALLEGRO_EVENT_QUEUE *queue, ALLEGRO_EVENT *ret_event,
+   ALLEGRO_TIMEOUT *timeout);
+static void ring_flush(ALLEGRO_EVENT_QUEUE *queue);
+static void ring_discard_events_of_source(ALLEGRO_EVENT_QUEUE *queue,
+   const ALLEGRO_EVENT_SOURCE *source);
+#endif
 
 
 
@@ -100,6 +149,10 @@ ALLEGRO_EVENT_QUEUE *al_create_event_queue(void)
       queue->events_head = 0;
       queue->events_tail = 0;
       queue->paused = false;
+#ifdef _AL_HAVE_ATOMICOPS
+      queue->ring = NULL;
+      queue->ring_kept = NULL;
+#endif
 
       _AL_MARK_MUTEX_UNINITED(queue->mutex);
       _al_mutex_init(&queue->mutex);
@@ -114,6 +167,57 @@ ALLEGRO_EVENT_QUEUE *al_create_event_queue(void)
 
 
 
+/* Function: al_create_lock_free_event_queue
+ */
+ALLEGRO_EVENT_QUEUE *al_create_lock_free_event_queue(int capacity,
+   ALLEGRO_EVENT_QUEUE_OVERFLOW overflow)
+{
+#ifdef _AL_HAVE_ATOMICOPS
+   ALLEGRO_EVENT_QUEUE *queue;
+   unsigned int size;
+   unsigned int i;
+
+   ASSERT(capacity > 0);
+
+   size = pot(capacity > 1 ? capacity : 2);
+
+   queue = al_create_event_queue();
+   if (!queue)
+      return NULL;
+
+   queue->ring = al_malloc(size * sizeof(EVENT_SLOT));
+   queue->ring_kept = al_malloc(size * sizeof(ALLEGRO_EVENT));
+   if (!queue->ring || !queue->ring_kept) {
+      al_destroy_event_queue(queue);
+      return NULL;
+   }
+   _AL_MARK_MUTEX_UNINITED(queue->ring_kept_mutex);
+   _al_mutex_init(&queue->ring_kept_mutex);
+
+   for (i = 0; i < size; i++) {
+      queue->ring[i].sequence = i;
+   }
+   queue->ring_mask = size - 1;
+   queue->ring_head = 0;
+   queue->ring_tail = 0;
+   queue->waiters = 0;
+   queue->overflow = overflow;
+
+   return queue;
+#else
+   /* Without atomic operations the queue can't be lock-free, so it is an
+    * ordinary one, which grows instead of dropping events.
+    */
+   ASSERT(capacity > 0);
+   (void)capacity;
+   (void)overflow;
+   ALLEGRO_WARN("No atomic operations, making an ordinary event queue.\n");
+   return al_create_event_queue();
+#endif
+}
+
+
+
 /* Function: al_destroy_event_queue
  */
 void al_destroy_event_queue(ALLEGRO_EVENT_QUEUE *queue)
@@ -133,6 +237,12 @@ void al_destroy_event_queue(ALLEGRO_EVENT_QUEUE *queue)
 
    ASSERT(queue->events_head == queue->events_tail);
    _al_vector_free(&queue->events);
+#ifdef _AL_HAVE_ATOMICOPS
+   if (queue->ring_kept)
+      _al_mutex_destroy(&queue->ring_kept_mutex);
+   al_free(queue->ring);
+   al_free(queue->ring_kept);
+#endif
 
    _al_cond_destroy(&queue->cond);
    _al_mutex_destroy(&queue->mutex);
@@ -194,6 +304,12 @@ void al_unregister_event_source(ALLEGRO_EVENT_QUEUE *queue,
       _al_event_source_on_unregistration_from_queue(source, queue);
 
       /* Drop all the events in the queue that belonged to the source. */
+#ifdef _AL_HAVE_ATOMICOPS
+      if (queue->ring) {
+         ring_discard_events_of_source(queue, source);
+         return;
+      }
+#endif
       _al_mutex_lock(&queue->mutex);
       discard_events_of_source(queue, source);
       _al_mutex_unlock(&queue->mutex);
@@ -235,8 +351,39 @@ static void heartbeat(void)
 
 
 
+#ifdef _AL_HAVE_ATOMICOPS
+/* ring_add:
+ *  Return the ring buffer position n places after pos.
+ */
+static _AL_ATOMIC ring_add(_AL_ATOMIC pos, unsigned int n)
+{
+   return (_AL_ATOMIC)((unsigned int)pos + n);
+}
+
+
+
+/* ring_distance:
+ *  Return how far ring buffer position a is ahead of position b. Positions
+ *  wrap around, so they are compared through their difference.
+ */
+static int ring_distance(_AL_ATOMIC a, _AL_ATOMIC b)
+{
+   return (int)((unsigned int)a - (unsigned int)b);
+}
+#endif
+
+
+
 static bool is_event_queue_empty(ALLEGRO_EVENT_QUEUE *queue)
 {
+#ifdef _AL_HAVE_ATOMICOPS
+   if (queue->ring) {
+      const _AL_ATOMIC pos = _al_atomic_load(&queue->ring_tail);
+      EVENT_SLOT *slot = &queue->ring[pos & queue->ring_mask];
+      return ring_distance(_al_atomic_load(&slot->sequence), pos) != 1;
+   }
+#endif
+
    return (queue->events_head == queue->events_tail);
 }
 
@@ -300,6 +447,11 @@ bool al_get_next_event(ALLEGRO_EVENT_QUEUE *queue, ALLEGRO_EVENT *ret_event)
 
    heartbeat();
 
+#ifdef _AL_HAVE_ATOMICOPS
+   if (queue->ring)
+      return ring_pop(queue, ret_event);
+#endif
+
    _al_mutex_lock(&queue->mutex);
 
    next_event = get_next_event_if_any(queue, true);
@@ -315,6 +467,41 @@ bool al_get_next_event(ALLEGRO_EVENT_QUEUE *queue, ALLEGRO_EVENT *ret_event)
 
 
 
+/* Function: al_get_next_events
+ */
+int al_get_next_events(ALLEGRO_EVENT_QUEUE *queue, ALLEGRO_EVENT *ret_events,
+   int max)
+{
+   ALLEGRO_EVENT *next_event;
+   int n = 0;
+   ASSERT(queue);
+   ASSERT(ret_events || max <= 0);
+
+   heartbeat();
+
+   if (max <= 0)
+      return 0;
+
+#ifdef _AL_HAVE_ATOMICOPS
+   if (queue->ring)
+      return ring_pop_many(queue, ret_events, max);
+#endif
+
+   _al_mutex_lock(&queue->mutex);
+
+   while (n < max && (next_event = get_next_event_if_any(queue, true))) {
+      copy_event(&ret_events[n], next_event);
+      /* Don't increment reference count on user events. */
+      n++;
+   }
+
+   _al_mutex_unlock(&queue->mutex);
+
+   return n;
+}
+
+
+
 /* Function: al_peek_next_event
  */
 bool al_peek_next_event(ALLEGRO_EVENT_QUEUE *queue, ALLEGRO_EVENT *ret_event)
@@ -325,6 +512,11 @@ bool al_peek_next_event(ALLEGRO_EVENT_QUEUE *queue, ALLEGRO_EVENT *ret_event)
 
    heartbeat();
 
+#ifdef _AL_HAVE_ATOMICOPS
+   if (queue->ring)
+      return ring_peek(queue, ret_event);
+#endif
+
    _al_mutex_lock(&queue->mutex);
 
    next_event = get_next_event_if_any(queue, false);
@@ -349,6 +541,16 @@ bool al_drop_next_event(ALLEGRO_EVENT_QUEUE *queue)
 
    heartbeat();
 
+#ifdef _AL_HAVE_ATOMICOPS
+   if (queue->ring) {
+      ALLEGRO_EVENT event;
+      if (!ring_pop(queue, &event))
+         return false;
+      unref_if_user_event(&event);
+      return true;
+   }
+#endif
+
    _al_mutex_lock(&queue->mutex);
 
    next_event = get_next_event_if_any(queue, true);
@@ -372,6 +574,13 @@ void al_flush_event_queue(ALLEGRO_EVENT_QUEUE *queue)
 
    heartbeat();
 
+#ifdef _AL_HAVE_ATOMICOPS
+   if (queue->ring) {
+      ring_flush(queue);
+      return;
+   }
+#endif
+
    _al_mutex_lock(&queue->mutex);
 
    /* Decrement reference counts on all user events. */
@@ -399,6 +608,13 @@ void al_wait_for_event(ALLEGRO_EVENT_QUEUE *queue, ALLEGRO_EVENT *ret_event)
 
    heartbeat();
 
+#ifdef _AL_HAVE_ATOMICOPS
+   if (queue->ring) {
+      ring_wait(queue, ret_event, NULL);
+      return;
+   }
+#endif
+
    _al_mutex_lock(&queue->mutex);
    {
       while (is_event_queue_empty(queue)) {
@@ -458,6 +674,11 @@ static bool do_wait_for_event(ALLEGRO_EVENT_QUEUE *queue,
    bool timed_out = false;
    ALLEGRO_EVENT *next_event = NULL;
 
+#ifdef _AL_HAVE_ATOMICOPS
+   if (queue->ring)
+      return ring_wait(queue, ret_event, timeout);
+#endif
+
    _al_mutex_lock(&queue->mutex);
    {
       int result = 0;
@@ -597,6 +818,13 @@ void _al_event_queue_push_event(ALLEGRO_EVENT_QUEUE *queue,
    if (queue->paused)
       return;
 
+#ifdef _AL_HAVE_ATOMICOPS
+   if (queue->ring) {
+      ring_push(queue, orig_event, true);
+      return;
+   }
+#endif
+
    _al_mutex_lock(&queue->mutex);
    {
       new_event = alloc_event(queue);
@@ -697,6 +925,306 @@ static void discard_events_of_source(ALLEGRO_EVENT_QUEUE *queue,
 
 
 
+#ifdef _AL_HAVE_ATOMICOPS
+/*
+ * Lock-free queues
+ *
+ * The events of a queue made by al_create_lock_free_event_queue live in a
+ * fixed size ring buffer. Every slot has a sequence number, and producers
+ * and consumers claim slots by advancing the head and tail positions with
+ * compare-and-swap. A slot only becomes visible to consumers once the
+ * producer has finished writing it and bumped its sequence number, and only
+ * free for producers once the consumer has finished reading it.
+ *
+ * The queue mutex and condition variable are only used by threads which
+ * block waiting for events, and producers only touch them when someone is
+ * waiting.
+ */
+
+
+
+/* ring_push:
+ *  Add an event to the ring buffer, dealing with a full buffer according
+ *  to the overflow policy of the queue. If add_ref is true, a reference is
+ *  taken on user events that get into the queue; otherwise the caller's
+ *  reference is handed over, and dropped if the event is discarded.
+ *  Returns false if the event was discarded.
+ *
+ *  [runs in background threads]
+ */
+static bool ring_push(ALLEGRO_EVENT_QUEUE *queue, const ALLEGRO_EVENT *event,
+   bool add_ref)
+{
+   EVENT_SLOT *slot;
+   _AL_ATOMIC pos;
+
+   for (;;) {
+      int dif;
+
+      pos = _al_atomic_load(&queue->ring_head);
+      slot = &queue->ring[pos & queue->ring_mask];
+      dif = ring_distance(_al_atomic_load(&slot->sequence), pos);
+
+      if (dif == 0) {
+         if (_al_compare_and_swap(&queue->ring_head, pos, ring_add(pos, 1)))
+            break;
+      }
+      else if (dif < 0) {
+         /* The ring buffer is full. */
+         if (queue->overflow == ALLEGRO_EVENT_QUEUE_DROP_OLDEST) {
+            ALLEGRO_EVENT old_event;
+            if (ring_pop(queue, &old_event)) {
+               unref_if_user_event(&old_event);
+            }
+         }
+         else {
+            if (!add_ref) {
+               ALLEGRO_EVENT new_event = *event;
+               unref_if_user_event(&new_event);
+            }
+            return false;
+         }
+      }
+      /* Otherwise another producer got the slot first. */
+   }
+
+   copy_event(&slot->event, event);
+   if (add_ref) {
+      ref_if_user_event(&slot->event);
+   }
+   _al_atomic_store(&slot->sequence, ring_add(pos, 1));
+
+   /* Wake up threads that are waiting for an event to be placed in the
+    * queue. The barrier orders the store above before the load of the
+    * number of waiters, which ring_wait updates before it checks whether
+    * the queue is empty.
+    */
+   _al_memory_barrier();
+   if (_al_atomic_load(&queue->waiters) > 0) {
+      _al_mutex_lock(&queue->mutex);
+      _al_cond_broadcast(&queue->cond);
+      _al_mutex_unlock(&queue->mutex);
+   }
+
+   return true;
+}
+
+
+
+/* ring_pop:
+ *  Remove the next event from the ring buffer, if any.
+ */
+static bool ring_pop(ALLEGRO_EVENT_QUEUE *queue, ALLEGRO_EVENT *ret_event)
+{
+   EVENT_SLOT *slot;
+   _AL_ATOMIC pos;
+
+   for (;;) {
+      int dif;
+
+      pos = _al_atomic_load(&queue->ring_tail);
+      slot = &queue->ring[pos & queue->ring_mask];
+      dif = ring_distance(_al_atomic_load(&slot->sequence), ring_add(pos, 1));
+
+      if (dif == 0) {
+         if (_al_compare_and_swap(&queue->ring_tail, pos, ring_add(pos, 1)))
+            break;
+      }
+      else if (dif < 0) {
+         return false;
+      }
+   }
+
+   copy_event(ret_event, &slot->event);
+   _al_atomic_store(&slot->sequence,
+      ring_add(pos, queue->ring_mask + 1));
+
+   return true;
+}
+
+
+
+/* ring_pop_many:
+ *  Remove up to max events from the ring buffer, claiming all of them at
+ *  once.  Returns the number of events removed.
+ */
+static int ring_pop_many(ALLEGRO_EVENT_QUEUE *queue, ALLEGRO_EVENT *ret_events,
+   int max)
+{
+   _AL_ATOMIC pos;
+   int n;
+   int i;
+
+   for (;;) {
+      pos = _al_atomic_load(&queue->ring_tail);
+
+      /* Count the consecutive slots ready to be read. */
+      for (n = 0; n < max; n++) {
+         EVENT_SLOT *slot = &queue->ring[ring_add(pos, n) & queue->ring_mask];
+         if (ring_distance(_al_atomic_load(&slot->sequence), ring_add(pos, n)) != 1)
+            break;
+      }
+
+      if (n == 0) {
+         EVENT_SLOT *slot = &queue->ring[pos & queue->ring_mask];
+         if (ring_distance(_al_atomic_load(&slot->sequence), ring_add(pos, 1)) < 0)
+            return 0;
+         continue;
+      }
+
+      if (_al_compare_and_swap(&queue->ring_tail, pos, ring_add(pos, n)))
+         break;
+   }
+
+   for (i = 0; i < n; i++) {
+      EVENT_SLOT *slot = &queue->ring[ring_add(pos, i) & queue->ring_mask];
+      copy_event(&ret_events[i], &slot->event);
+      _al_atomic_store(&slot->sequence,
+         ring_add(pos, i + queue->ring_mask + 1));
+   }
+
+   return n;
+}
+
+
+
+/* ring_peek:
+ *  Copy the next event in the ring buffer, if any, without removing it.
+ *  The reference on user events is taken under the reference count mutex,
+ *  so a producer dropping the event for overflow can't release it first.
+ */
+static bool ring_peek(ALLEGRO_EVENT_QUEUE *queue, ALLEGRO_EVENT *ret_event)
+{
+   for (;;) {
+      _AL_ATOMIC pos = _al_atomic_load(&queue->ring_tail);
+      EVENT_SLOT *slot = &queue->ring[pos & queue->ring_mask];
+      _AL_ATOMIC seq = _al_atomic_load(&slot->sequence);
+      int dif = ring_distance(seq, ring_add(pos, 1));
+
+      if (dif < 0)
+         return false;
+      if (dif > 0)
+         continue;
+
+      _al_mutex_lock(&user_event_refcount_mutex);
+      copy_event(ret_event, &slot->event);
+      _al_memory_barrier();
+      if (_al_atomic_load(&slot->sequence) == seq) {
+         /* The slot was not given back while we copied it. */
+         if (ALLEGRO_EVENT_TYPE_IS_USER(ret_event->type)) {
+            ALLEGRO_USER_EVENT_DESCRIPTOR *descr =
+               ret_event->user.__internal__descr;
+            if (descr)
+               descr->refcount++;
+         }
+         _al_mutex_unlock(&user_event_refcount_mutex);
+         return true;
+      }
+      _al_mutex_unlock(&user_event_refcount_mutex);
+   }
+}
+
+
+
+/* ring_wait:
+ *  Wait for the ring buffer to become non-empty, as do_wait_for_event.
+ *  timeout may be NULL to wait forever.
+ */
+static bool ring_wait(ALLEGRO_EVENT_QUEUE *queue, ALLEGRO_EVENT *ret_event,
+   ALLEGRO_TIMEOUT *timeout)
+{
+   int result = 0;
+
+   for (;;) {
+      if (is_event_queue_empty(queue)) {
+         _al_fetch_and_add1(&queue->waiters);
+         _al_mutex_lock(&queue->mutex);
+         while (is_event_queue_empty(queue) && (result != -1)) {
+            if (timeout)
+               result = _al_cond_timedwait(&queue->cond, &queue->mutex,
+                  timeout);
+            else
+               _al_cond_wait(&queue->cond, &queue->mutex);
+         }
+         _al_mutex_unlock(&queue->mutex);
+         _al_sub1_and_fetch(&queue->waiters);
+
+         if (result == -1)
+            return false;
+      }
+
+      /* Another thread may still take the event before we do. */
+      if (!ret_event || ring_pop(queue, ret_event))
+         return true;
+   }
+}
+
+
+
+/* ring_flush:
+ *  Drop the events in the ring buffer.
+ */
+static void ring_flush(ALLEGRO_EVENT_QUEUE *queue)
+{
+   ALLEGRO_EVENT event;
+   unsigned int i;
+
+   /* Don't keep going forever if producers are faster than us. */
+   for (i = 0; i <= queue->ring_mask; i++) {
+      if (!ring_pop(queue, &event))
+         break;
+      unref_if_user_event(&event);
+   }
+}
+
+
+
+/* ring_discard_events_of_source:
+ *  Discard all the events in the ring buffer that belong to the source.
+ *  Slots can't be compacted in place while producers and consumers run
+ *  without a lock, so the events are taken out and the other ones put
+ *  back, in order. They end up after any events added in the meantime,
+ *  and a consumer running concurrently may see them out of order with
+ *  those.
+ */
+static void ring_discard_events_of_source(ALLEGRO_EVENT_QUEUE *queue,
+   const ALLEGRO_EVENT_SOURCE *source)
+{
+   ALLEGRO_EVENT *kept = queue->ring_kept;
+   ALLEGRO_EVENT event;
+   unsigned int num_kept = 0;
+   unsigned int num_lost = 0;
+   unsigned int i;
+
+   _al_mutex_lock(&queue->ring_kept_mutex);
+
+   for (i = 0; i <= queue->ring_mask; i++) {
+      if (!ring_pop(queue, &event))
+         break;
+      if (event.any.source == source) {
+         unref_if_user_event(&event);
+      }
+      else {
+         kept[num_kept++] = event;
+      }
+   }
+
+   for (i = 0; i < num_kept; i++) {
+      if (!ring_push(queue, &kept[i], false))
+         num_lost++;
+   }
+
+   _al_mutex_unlock(&queue->ring_kept_mutex);
+
+   if (num_lost > 0) {
+      ALLEGRO_WARN("Queue filled up while discarding events, "
+         "%u events dropped.\n", num_lost);
+   }
+}
+#endif
+
+
+
 /* Function: al_unref_user_event
  */
 void al_unref_user_event(ALLEGRO_USER_EVENT *event)
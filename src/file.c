@@ -19,6 +19,24 @@
 #include "allegro5/internal/aintern_file.h"
 
 
+/* Take n bytes from the read buffer if they are all there, else read
+ * them normally.
+ */
+static bool read_small(ALLEGRO_FILE *f, unsigned char *b, int n)
+{
+   int i;
+
+   if (f->read_pos && f->read_end - f->read_pos >= n && f->ungetc_len == 0) {
+      for (i = 0; i < n; i++)
+         b[i] = f->read_pos[i];
+      f->read_pos += n;
+      return true;
+   }
+
+   return al_fread(f, b, n) == (size_t)n;
+}
+
+
 /* Function: al_fopen
  */
 ALLEGRO_FILE *al_fopen(const char *path, const char *mode)
@@ -47,6 +65,12 @@ ALLEGRO_FILE *al_fopen_interface(const ALLEGRO_FILE_INTERFACE *drv,
          f->vtable = drv;
          f->userdata = drv->fi_fopen(path, mode);
          f->ungetc_len = 0;
+         f->read_pos = NULL;
+         f->read_end = NULL;
+         f->peek_buffer = NULL;
+         f->mapped = _al_is_mapped_file_interface(drv);
+         if (f->mapped)
+            f->peek_buffer = _al_file_mmap_peek_buffer;
          if (!f->userdata) {
             al_free(f);
             f = NULL;
@@ -75,12 +99,42 @@ ALLEGRO_FILE *al_create_file_handle(const ALLEGRO_FILE_INTERFACE *drv,
       f->vtable = drv;
       f->userdata = userdata;
       f->ungetc_len = 0;
+      f->read_pos = NULL;
+      f->read_end = NULL;
+      f->peek_buffer = NULL;
+      f->mapped = false;
    }
 
    return f;
 }
 
 
+/* Internal function: _al_set_file_peek_buffer
+ *  Let al_fpeek_buffer return the memory a file is kept in, through the
+ *  given function.
+ */
+void _al_set_file_peek_buffer(ALLEGRO_FILE *f,
+   const void *(*peek_buffer)(ALLEGRO_FILE *f, size_t *size))
+{
+   ASSERT(f);
+
+   f->peek_buffer = peek_buffer;
+}
+
+
+/* Internal function: _al_file_is_mapped
+ *  Whether the memory al_fpeek_buffer returns for the file belongs to the
+ *  file itself, as it does for mapped files and files in packs, rather than
+ *  to whoever opened it.
+ */
+bool _al_file_is_mapped(ALLEGRO_FILE *f)
+{
+   ASSERT(f);
+
+   return f->mapped;
+}
+
+
 /* Function: al_fclose
  */
 bool al_fclose(ALLEGRO_FILE *f)
@@ -103,6 +157,13 @@ size_t al_fread(ALLEGRO_FILE *f, void *ptr, size_t size)
    ASSERT(f);
    ASSERT(ptr);
 
+   if (f->read_pos && f->ungetc_len == 0 &&
+         size <= (size_t)(f->read_end - f->read_pos)) {
+      memcpy(ptr, f->read_pos, size);
+      f->read_pos += size;
+      return size;
+   }
+
    if (f->ungetc_len) {
       int bytes_ungetc = 0;
       unsigned char *cptr = ptr;
@@ -226,7 +287,7 @@ int al_fgetc(ALLEGRO_FILE *f)
    uint8_t c;
    ASSERT(f);
 
-   if (al_fread(f, &c, 1) != 1) {
+   if (!read_small(f, &c, 1)) {
       return EOF;
    }
 
@@ -256,7 +317,7 @@ int16_t al_fread16le(ALLEGRO_FILE *f)
    unsigned char b[2];
    ASSERT(f);
 
-   if (al_fread(f, b, 2) == 2) {
+   if (read_small(f, b, 2)) {
       return (((int16_t)b[1] << 8) | (int16_t)b[0]);
    }
 
@@ -271,7 +332,7 @@ int32_t al_fread32le(ALLEGRO_FILE *f)
    unsigned char b[4];
    ASSERT(f);
 
-   if (al_fread(f, b, 4) == 4) {
+   if (read_small(f, b, 4)) {
       return (((int32_t)b[3] << 24) | ((int32_t)b[2] << 16) |
               ((int32_t)b[1] << 8) | (int32_t)b[0]);
    }
@@ -335,7 +396,7 @@ int16_t al_fread16be(ALLEGRO_FILE *f)
    unsigned char b[2];
    ASSERT(f);
 
-   if (al_fread(f, b, 2) == 2) {
+   if (read_small(f, b, 2)) {
       return (((int16_t)b[0] << 8) | (int16_t)b[1]);
    }
 
@@ -350,7 +411,7 @@ int32_t al_fread32be(ALLEGRO_FILE *f)
    unsigned char b[4];
    ASSERT(f);
 
-   if (al_fread(f, b, 4) == 4) {
+   if (read_small(f, b, 4)) {
       return (((int32_t)b[0] << 24) | ((int32_t)b[1] << 16) |
               ((int32_t)b[2] << 8) | (int32_t)b[3]);
    }
@@ -528,6 +589,27 @@ int64_t al_fsize(ALLEGRO_FILE *f)
 }
 
 
+/* Function: al_fpeek_buffer
+ */
+const void *al_fpeek_buffer(ALLEGRO_FILE *f, size_t *size)
+{
+   const void *ptr = NULL;
+   ASSERT(f != NULL);
+   ASSERT(size != NULL);
+
+   /* Bytes put back with al_fungetc are not in the buffer. */
+   if (f->peek_buffer && f->ungetc_len == 0) {
+      ptr = f->peek_buffer(f, size);
+   }
+
+   if (!ptr) {
+      *size = 0;
+   }
+
+   return ptr;
+}
+
+
 /* Function: al_get_file_userdata
  */
 void *al_get_file_userdata(ALLEGRO_FILE *f)
@@ -0,0 +1,367 @@
+/*         ______   ___    ___
+ *        /\  _  \ /\_ \  /\_ \
+ *        \ \ \L\ \\//\ \ \//\ \      __     __   _ __   ___
+ *         \ \  __ \ \ \ \  \ \ \   /'__`\ /'_ `\/\`'__\/ __`\
+ *          \ \ \/\ \ \_\ \_ \_\ \_/\  __//\ \L\ \ \ \//\ \L\ \
+ *           \ \_\ \_\/\____\/\____\ \____\ \____ \ \_\\ \____/
+ *            \/_/\/_/\/____/\/____/\/____/\/___L\ \/_/ \/___/
+ *                                           /\____/
+ *                                           \_/__/
+ *
+ *      Buffered files - read another file in large blocks.
+ *
+ *      See LICENSE.txt for copyright information.
+ */
+
+#include "allegro5/allegro.h"
+#include "allegro5/internal/aintern.h"
+#include "allegro5/internal/aintern_file.h"
+
+ALLEGRO_DEBUG_CHANNEL("file")
+
+#define DEFAULT_BUFFER_SIZE   (64 * 1024)
+
+
+/* The bytes not read yet are between f->read_pos and f->read_end, which
+ * al_fread and the other readers in file.c take directly. The parent is
+ * always at the end of the buffered bytes.
+ */
+typedef struct BUFFERED_FILE
+{
+   ALLEGRO_FILE *fp;       /* parent file handle */
+   unsigned char *buf;
+   size_t buf_size;
+   size_t buf_len;         /* bytes in buf */
+   int64_t buf_offset;     /* position of buf in the parent, or -1 */
+   bool eof;
+   bool wrote;             /* last parent access was a write */
+} BUFFERED_FILE;
+
+
+static void set_buffer(ALLEGRO_FILE *f, size_t len, size_t pos)
+{
+   BUFFERED_FILE *bf = al_get_file_userdata(f);
+
+   bf->buf_len = len;
+   f->read_pos = bf->buf + pos;
+   f->read_end = bf->buf + len;
+}
+
+
+static int64_t buffered_position(ALLEGRO_FILE *f)
+{
+   BUFFERED_FILE *bf = al_get_file_userdata(f);
+
+   if (bf->buf_offset < 0)
+      return -1;
+   return bf->buf_offset + (f->read_pos - bf->buf);
+}
+
+
+/* Move the parent to where the reader is and empty the buffer, before
+ * a write. This always seeks, as stdio wants between reads and writes.
+ */
+static bool drop_buffer(ALLEGRO_FILE *f)
+{
+   BUFFERED_FILE *bf = al_get_file_userdata(f);
+   size_t unread = f->read_end - f->read_pos;
+
+   if (!al_fseek(bf->fp, -(int64_t)unread, ALLEGRO_SEEK_CUR))
+      return false;
+
+   if (bf->buf_offset >= 0)
+      bf->buf_offset += f->read_pos - bf->buf;
+   set_buffer(f, 0, 0);
+   return true;
+}
+
+
+static bool buffered_fclose(ALLEGRO_FILE *f)
+{
+   BUFFERED_FILE *bf = al_get_file_userdata(f);
+   bool ret;
+
+   ret = al_fclose(bf->fp);
+   al_free(bf->buf);
+   al_free(bf);
+
+   return ret;
+}
+
+
+static size_t buffered_fread(ALLEGRO_FILE *f, void *ptr, size_t size)
+{
+   BUFFERED_FILE *bf = al_get_file_userdata(f);
+   unsigned char *dst = ptr;
+   size_t done;
+   size_t n;
+
+   /* Whatever is left in the buffer first. */
+   done = f->read_end - f->read_pos;
+   if (done > size)
+      done = size;
+   memcpy(dst, f->read_pos, done);
+   f->read_pos += done;
+
+   if (done == size)
+      return done;
+
+   if (bf->buf_offset >= 0)
+      bf->buf_offset += bf->buf_len;
+   set_buffer(f, 0, 0);
+
+   if (bf->wrote) {
+      /* Like stdio, the parent may need a seek between a write and a read. */
+      if (!al_fseek(bf->fp, 0, ALLEGRO_SEEK_CUR))
+         return done;
+      bf->wrote = false;
+   }
+
+   if (size - done >= bf->buf_size) {
+      /* Too large to be worth buffering. */
+      n = al_fread(bf->fp, dst + done, size - done);
+      if (bf->buf_offset >= 0)
+         bf->buf_offset += n;
+   }
+   else {
+      /* Filling the buffer often stops short at the end of the file.
+       * That only matters to the caller if their own read is short.
+       */
+      int errnum = al_get_errno();
+
+      set_buffer(f, al_fread(bf->fp, bf->buf, bf->buf_size), 0);
+      n = f->read_end - f->read_pos;
+      if (n > size - done)
+         n = size - done;
+      if (n == size - done && !al_ferror(bf->fp))
+         al_set_errno(errnum);
+      memcpy(dst + done, f->read_pos, n);
+      f->read_pos += n;
+   }
+
+   done += n;
+   if (done < size)
+      bf->eof = true;
+
+   return done;
+}
+
+
+static size_t buffered_fwrite(ALLEGRO_FILE *f, const void *ptr, size_t size)
+{
+   BUFFERED_FILE *bf = al_get_file_userdata(f);
+   size_t n;
+
+   /* Writes go straight to the parent. */
+   if (!drop_buffer(f))
+      return 0;
+
+   n = al_fwrite(bf->fp, ptr, size);
+   bf->wrote = true;
+   if (bf->buf_offset >= 0)
+      bf->buf_offset += n;
+
+   return n;
+}
+
+
+static bool buffered_fflush(ALLEGRO_FILE *f)
+{
+   BUFFERED_FILE *bf = al_get_file_userdata(f);
+
+   return al_fflush(bf->fp);
+}
+
+
+static int64_t buffered_ftell(ALLEGRO_FILE *f)
+{
+   return buffered_position(f);
+}
+
+
+static bool buffered_fseek(ALLEGRO_FILE *f, int64_t offset, int whence)
+{
+   BUFFERED_FILE *bf = al_get_file_userdata(f);
+   int64_t pos = buffered_position(f);
+
+   /* Seeks which stay inside the buffer don't need the parent. Readers
+    * skipping over a few bytes of a header do that a lot.
+    */
+   if (whence != ALLEGRO_SEEK_END && pos >= 0) {
+      int64_t target = (whence == ALLEGRO_SEEK_SET) ? offset : pos + offset;
+
+      if (target >= bf->buf_offset &&
+            target <= bf->buf_offset + (int64_t)bf->buf_len) {
+         f->read_pos = bf->buf + (target - bf->buf_offset);
+         bf->eof = false;
+         return true;
+      }
+   }
+
+   if (whence == ALLEGRO_SEEK_CUR) {
+      /* The parent is ahead by the unread bytes. */
+      offset -= f->read_end - f->read_pos;
+   }
+
+   if (!al_fseek(bf->fp, offset, whence))
+      return false;
+
+   bf->buf_offset = al_ftell(bf->fp);
+   set_buffer(f, 0, 0);
+   bf->eof = false;
+   bf->wrote = false;
+   return true;
+}
+
+
+static bool buffered_feof(ALLEGRO_FILE *f)
+{
+   BUFFERED_FILE *bf = al_get_file_userdata(f);
+
+   return bf->eof;
+}
+
+
+static int buffered_ferror(ALLEGRO_FILE *f)
+{
+   BUFFERED_FILE *bf = al_get_file_userdata(f);
+
+   return al_ferror(bf->fp);
+}
+
+
+static const char *buffered_ferrmsg(ALLEGRO_FILE *f)
+{
+   BUFFERED_FILE *bf = al_get_file_userdata(f);
+
+   return al_ferrmsg(bf->fp);
+}
+
+
+static void buffered_fclearerr(ALLEGRO_FILE *f)
+{
+   BUFFERED_FILE *bf = al_get_file_userdata(f);
+
+   bf->eof = false;
+   al_fclearerr(bf->fp);
+}
+
+
+/* Bytes pushed back go where the generic al_fungetc would put them, but
+ * like ungetc they also clear the end of file state. The byte just read is
+ * usually the one put back, so the reader steps back over it instead.
+ */
+static int buffered_fungetc(ALLEGRO_FILE *f, int c)
+{
+   BUFFERED_FILE *bf = al_get_file_userdata(f);
+
+   bf->eof = false;
+
+   if (f->ungetc_len == 0 && f->read_pos && f->read_pos > bf->buf &&
+         f->read_pos[-1] == (unsigned char)c) {
+      f->read_pos--;
+      return c;
+   }
+
+   if (f->ungetc_len == ALLEGRO_UNGETC_SIZE)
+      return EOF;
+   f->ungetc[f->ungetc_len++] = (unsigned char)c;
+   return c;
+}
+
+
+static off_t buffered_fsize(ALLEGRO_FILE *f)
+{
+   BUFFERED_FILE *bf = al_get_file_userdata(f);
+
+   return al_fsize(bf->fp);
+}
+
+
+const struct ALLEGRO_FILE_INTERFACE _al_file_interface_buffered =
+{
+   NULL,   /* fopen */
+   buffered_fclose,
+   buffered_fread,
+   buffered_fwrite,
+   buffered_fflush,
+   buffered_ftell,
+   buffered_fseek,
+   buffered_feof,
+   buffered_ferror,
+   buffered_ferrmsg,
+   buffered_fclearerr,
+   buffered_fungetc,
+   buffered_fsize
+};
+
+
+/* Function: al_fopen_buffered
+ */
+ALLEGRO_FILE *al_fopen_buffered(ALLEGRO_FILE *fp, size_t buffer_size)
+{
+   BUFFERED_FILE *bf;
+   ALLEGRO_FILE *f;
+   ASSERT(fp);
+
+   if (buffer_size == 0)
+      buffer_size = DEFAULT_BUFFER_SIZE;
+
+   bf = al_calloc(1, sizeof(*bf));
+   if (!bf) {
+      al_set_errno(ENOMEM);
+      return NULL;
+   }
+
+   bf->buf = al_malloc(buffer_size);
+   if (!bf->buf) {
+      al_set_errno(ENOMEM);
+      al_free(bf);
+      return NULL;
+   }
+
+   bf->fp = fp;
+   bf->buf_size = buffer_size;
+   bf->buf_offset = al_ftell(fp);
+
+   f = al_create_file_handle(&_al_file_interface_buffered, bf);
+   if (!f) {
+      al_free(bf->buf);
+      al_free(bf);
+      return NULL;
+   }
+
+   set_buffer(f, 0, 0);
+   return f;
+}
+
+
+/* Internal function: _al_fopen_for_loading
+ *  Open a file for one of the built-in loaders. Files which are not in
+ *  memory already are read through a buffer, since the loaders often read
+ *  only a few bytes at a time.
+ */
+ALLEGRO_FILE *_al_fopen_for_loading(const char *path)
+{
+   ALLEGRO_FILE *fp;
+   ALLEGRO_FILE *f;
+   size_t size;
+
+   fp = al_fopen(path, "rb");
+   if (!fp)
+      return NULL;
+
+   if (al_fpeek_buffer(fp, &size))
+      return fp;
+
+   f = al_fopen_buffered(fp, 0);
+   if (!f) {
+      ALLEGRO_WARN("Reading %s without a buffer\n", path);
+      return fp;
+   }
+
+   return f;
+}
+
+
+/* vim: set sts=3 sw=3 et: */
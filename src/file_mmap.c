@@ -0,0 +1,588 @@
+/*         ______   ___    ___
+ *        /\  _  \ /\_ \  /\_ \
+ *        \ \ \L\ \\//\ \ \//\ \      __     __   _ __   ___
+ *         \ \  __ \ \ \ \  \ \ \   /'__`\ /'_ `\/\`'__\/ __`\
+ *          \ \ \/\ \ \_\ \_ \_\ \_/\  __//\ \L\ \ \ \//\ \L\ \
+ *           \ \_\ \_\/\____\/\____\ \____\ \____ \ \_\\ \____/
+ *            \/_/\/_/\/____/\/____/\/____/\/___L\ \/_/ \/___/
+ *                                           /\____/
+ *                                           \_/__/
+ *
+ *      Read-only files mapped into memory.
+ *
+ *      See LICENSE.txt for copyright information.
+ */
+
+#include "allegro5/allegro.h"
+
+/* enable large file support in gcc/glibc */
+#if defined ALLEGRO_HAVE_FTELLO && defined ALLEGRO_HAVE_FSEEKO
+#ifndef _LARGEFILE_SOURCE
+   #define _LARGEFILE_SOURCE
+#endif
+#ifndef _LARGEFILE_SOURCE64
+   #define _LARGEFILE_SOURCE64
+#endif
+#ifndef _FILE_OFFSET_BITS
+   #define _FILE_OFFSET_BITS 64
+#endif
+#endif
+
+#include <stdio.h>
+
+#include "allegro5/internal/aintern.h"
+#include "allegro5/internal/aintern_file.h"
+#include "allegro5/internal/aintern_wunicode.h"
+
+#if defined(ALLEGRO_WINDOWS)
+   #include <windows.h>
+#elif defined(ALLEGRO_HAVE_MMAP)
+   #include <sys/types.h>
+   #include <sys/mman.h>
+   #include <sys/stat.h>
+   #include <fcntl.h>
+   #include <unistd.h>
+#endif
+
+ALLEGRO_DEBUG_CHANNEL("mmap")
+
+
+typedef struct MMAP_FILE
+{
+   const unsigned char *data;
+   size_t size;
+   size_t pos;
+   bool eof;
+   bool mapped;
+   bool owned;    /* data was allocated with al_malloc */
+   void (*release)(void *arg);   /* for views, called when closed */
+   void *release_arg;
+} MMAP_FILE;
+
+
+/* The mmap interface and copies of it with their own fopen, whose files
+ * are all MMAP_FILE.
+ */
+#define MAX_MAPPED_INTERFACES 4
+static const ALLEGRO_FILE_INTERFACE *mapped_interfaces[MAX_MAPPED_INTERFACES] =
+{
+   &_al_file_interface_mmap
+};
+
+
+/* What empty files point to, since they can't be mapped. */
+static const unsigned char empty_file[1];
+
+
+static void set_empty(MMAP_FILE *mf)
+{
+   mf->data = empty_file;
+   mf->size = 0;
+   mf->mapped = false;
+   mf->owned = false;
+}
+
+
+/* Read a file of unknown size, like a pipe, until its end. */
+static bool read_until_eof(MMAP_FILE *mf, ALLEGRO_FILE *fp)
+{
+   unsigned char *data = NULL;
+   size_t size = 0;
+   size_t capacity = 0;
+
+   for (;;) {
+      size_t n;
+
+      if (size == capacity) {
+         unsigned char *bigger;
+         if (capacity > (size_t)-1 / 2) {
+            al_set_errno(EFBIG);
+            break;
+         }
+         capacity = capacity ? capacity * 2 : 65536;
+         bigger = al_realloc(data, capacity);
+         if (!bigger) {
+            al_set_errno(ENOMEM);
+            break;
+         }
+         data = bigger;
+      }
+
+      n = al_fread(fp, data + size, capacity - size);
+      size += n;
+      if (n == 0 || al_feof(fp) || al_ferror(fp))
+         break;
+   }
+
+   if (!al_feof(fp) || al_ferror(fp)) {
+      al_free(data);
+      al_fclose(fp);
+      return false;
+   }
+   al_fclose(fp);
+
+   if (size == 0) {
+      al_free(data);
+      set_empty(mf);
+      return true;
+   }
+
+   mf->data = data;
+   mf->size = size;
+   mf->mapped = false;
+   mf->owned = true;
+   return true;
+}
+
+
+/* Read all of an open file into memory and close it. */
+static bool read_whole_stream(MMAP_FILE *mf, ALLEGRO_FILE *fp)
+{
+   int64_t size;
+   unsigned char *data;
+
+   /* Sizes of pipes are unknown, and files of some virtual file systems
+    * claim to be empty, so those are read until they end.
+    */
+   size = al_fsize(fp);
+   if (size <= 0)
+      return read_until_eof(mf, fp);
+
+   if ((uint64_t)size > (size_t)-1) {
+      al_fclose(fp);
+      al_set_errno(EFBIG);
+      return false;
+   }
+
+   data = al_malloc(size);
+   if (!data) {
+      al_fclose(fp);
+      al_set_errno(ENOMEM);
+      return false;
+   }
+
+   if (al_fread(fp, data, size) != (size_t)size) {
+      al_free(data);
+      al_fclose(fp);
+      return false;
+   }
+   al_fclose(fp);
+
+   mf->data = data;
+   mf->size = size;
+   mf->mapped = false;
+   mf->owned = true;
+   return true;
+}
+
+
+/* Read the whole file into memory, for when it can't be mapped. */
+static bool read_whole_file(MMAP_FILE *mf, const char *path)
+{
+   ALLEGRO_FILE *fp;
+
+   fp = al_fopen_interface(&_al_file_interface_stdio, path, "rb");
+   if (!fp)
+      return false;
+
+   return read_whole_stream(mf, fp);
+}
+
+
+#if defined(ALLEGRO_WINDOWS)
+
+static bool map_file(MMAP_FILE *mf, const char *path)
+{
+   wchar_t *wpath = _al_win_utf16(path);
+   HANDLE file;
+   HANDLE mapping;
+   LARGE_INTEGER size;
+   void *data;
+
+   file = CreateFileW(wpath, GENERIC_READ, FILE_SHARE_READ, NULL,
+      OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+   al_free(wpath);
+   if (file == INVALID_HANDLE_VALUE) {
+      al_set_errno(ENOENT);
+      return false;
+   }
+
+   if (!GetFileSizeEx(file, &size) ||
+         (uint64_t)size.QuadPart > (size_t)-1) {
+      CloseHandle(file);
+      al_set_errno(EFBIG);
+      return false;
+   }
+
+   if (size.QuadPart == 0) {
+      CloseHandle(file);
+      set_empty(mf);
+      return true;
+   }
+
+   mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+   CloseHandle(file);
+   if (!mapping) {
+      ALLEGRO_DEBUG("%s could not be mapped, reading it instead\n", path);
+      return read_whole_file(mf, path);
+   }
+
+   /* The view keeps the mapping alive. */
+   data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+   CloseHandle(mapping);
+   if (!data) {
+      ALLEGRO_DEBUG("%s could not be mapped, reading it instead\n", path);
+      return read_whole_file(mf, path);
+   }
+
+   mf->data = data;
+   mf->size = (size_t)size.QuadPart;
+   mf->mapped = true;
+   return true;
+}
+
+
+static void unmap_file(MMAP_FILE *mf)
+{
+   UnmapViewOfFile((void *)mf->data);
+}
+
+#elif defined(ALLEGRO_HAVE_MMAP)
+
+static bool map_file(MMAP_FILE *mf, const char *path)
+{
+   struct stat st;
+   void *data;
+   int fd;
+
+   fd = open(path, O_RDONLY);
+   if (fd == -1) {
+      al_set_errno(errno);
+      return false;
+   }
+
+   if (fstat(fd, &st) == -1) {
+      al_set_errno(errno);
+      close(fd);
+      return false;
+   }
+
+   if (S_ISDIR(st.st_mode)) {
+      close(fd);
+      al_set_errno(EISDIR);
+      return false;
+   }
+
+   /* Pipes and devices can't be mapped, and empty files can't either,
+    * though virtual ones may have contents anyway. They are read from the
+    * descriptor already open, as opening a pipe again would wait for
+    * another writer.
+    */
+   if (!S_ISREG(st.st_mode) || st.st_size == 0) {
+      ALLEGRO_FILE *fp = al_fopen_fd(fd, "rb");
+      if (!fp) {
+         close(fd);
+         return false;
+      }
+      return read_whole_stream(mf, fp);
+   }
+
+   if ((uint64_t)st.st_size > (size_t)-1) {
+      close(fd);
+      al_set_errno(EFBIG);
+      return false;
+   }
+
+   /* The mapping stays valid after the descriptor is closed. */
+   data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+   close(fd);
+   if (data == MAP_FAILED) {
+      ALLEGRO_DEBUG("%s could not be mapped, reading it instead\n", path);
+      return read_whole_file(mf, path);
+   }
+
+   mf->data = data;
+   mf->size = st.st_size;
+   mf->mapped = true;
+   return true;
+}
+
+
+static void unmap_file(MMAP_FILE *mf)
+{
+   munmap((void *)mf->data, mf->size);
+}
+
+#else
+
+static bool map_file(MMAP_FILE *mf, const char *path)
+{
+   return read_whole_file(mf, path);
+}
+
+
+static void unmap_file(MMAP_FILE *mf)
+{
+   (void)mf;
+}
+
+#endif
+
+
+static void *file_mmap_fopen(const char *path, const char *mode)
+{
+   MMAP_FILE *mf;
+
+   ALLEGRO_DEBUG("opening %s %s\n", path, mode);
+
+   if (mode[0] != 'r' || strchr(mode, '+')) {
+      ALLEGRO_WARN("%s: mapped files can only be read\n", path);
+      al_set_errno(EINVAL);
+      return NULL;
+   }
+
+   mf = al_calloc(1, sizeof(*mf));
+   if (!mf) {
+      al_set_errno(ENOMEM);
+      return NULL;
+   }
+
+   if (!map_file(mf, path)) {
+      al_free(mf);
+      return NULL;
+   }
+
+   return mf;
+}
+
+
+static bool file_mmap_fclose(ALLEGRO_FILE *f)
+{
+   MMAP_FILE *mf = al_get_file_userdata(f);
+
+   if (mf->mapped)
+      unmap_file(mf);
+   else if (mf->owned)
+      al_free((void *)mf->data);
+   if (mf->release)
+      mf->release(mf->release_arg);
+   al_free(mf);
+
+   return true;
+}
+
+
+static size_t file_mmap_fread(ALLEGRO_FILE *f, void *ptr, size_t size)
+{
+   MMAP_FILE *mf = al_get_file_userdata(f);
+   size_t n = size;
+
+   if (mf->size - mf->pos < size) {
+      n = mf->size - mf->pos;
+      mf->eof = true;
+   }
+
+   memcpy(ptr, mf->data + mf->pos, n);
+   mf->pos += n;
+
+   return n;
+}
+
+
+static size_t file_mmap_fwrite(ALLEGRO_FILE *f, const void *ptr, size_t size)
+{
+   (void)f;
+   (void)ptr;
+   (void)size;
+
+   al_set_errno(EBADF);
+   return 0;
+}
+
+
+static bool file_mmap_fflush(ALLEGRO_FILE *f)
+{
+   (void)f;
+   return true;
+}
+
+
+static int64_t file_mmap_ftell(ALLEGRO_FILE *f)
+{
+   MMAP_FILE *mf = al_get_file_userdata(f);
+
+   return mf->pos;
+}
+
+
+static bool file_mmap_fseek(ALLEGRO_FILE *f, int64_t offset, int whence)
+{
+   MMAP_FILE *mf = al_get_file_userdata(f);
+   int64_t pos = mf->pos;
+
+   switch (whence) {
+      case ALLEGRO_SEEK_SET: pos = offset; break;
+      case ALLEGRO_SEEK_CUR: pos = mf->pos + offset; break;
+      case ALLEGRO_SEEK_END: pos = mf->size + offset; break;
+   }
+
+   if (pos < 0) {
+      al_set_errno(EINVAL);
+      return false;
+   }
+
+   /* Seeking past the end stops at the end, like with memfiles. */
+   mf->pos = (uint64_t)pos < mf->size ? (size_t)pos : mf->size;
+   mf->eof = false;
+
+   return true;
+}
+
+
+static bool file_mmap_feof(ALLEGRO_FILE *f)
+{
+   MMAP_FILE *mf = al_get_file_userdata(f);
+
+   return mf->eof;
+}
+
+
+static int file_mmap_ferror(ALLEGRO_FILE *f)
+{
+   (void)f;
+   return 0;
+}
+
+
+static const char *file_mmap_ferrmsg(ALLEGRO_FILE *f)
+{
+   (void)f;
+   return "";
+}
+
+
+static void file_mmap_fclearerr(ALLEGRO_FILE *f)
+{
+   MMAP_FILE *mf = al_get_file_userdata(f);
+
+   mf->eof = false;
+}
+
+
+static off_t file_mmap_fsize(ALLEGRO_FILE *f)
+{
+   MMAP_FILE *mf = al_get_file_userdata(f);
+
+   return mf->size;
+}
+
+
+/* Internal function: _al_file_mmap_peek_buffer
+ *  The peek_buffer function of mapped files, see al_fpeek_buffer. Files
+ *  opened through a copy of the mmap interface, like those in packs, use
+ *  it too.
+ */
+const void *_al_file_mmap_peek_buffer(ALLEGRO_FILE *f, size_t *size)
+{
+   MMAP_FILE *mf = al_get_file_userdata(f);
+
+   *size = mf->size - mf->pos;
+   return mf->data + mf->pos;
+}
+
+
+const struct ALLEGRO_FILE_INTERFACE _al_file_interface_mmap =
+{
+   file_mmap_fopen,
+   file_mmap_fclose,
+   file_mmap_fread,
+   file_mmap_fwrite,
+   file_mmap_fflush,
+   file_mmap_ftell,
+   file_mmap_fseek,
+   file_mmap_feof,
+   file_mmap_ferror,
+   file_mmap_ferrmsg,
+   file_mmap_fclearerr,
+   NULL,   /* ungetc */
+   file_mmap_fsize
+};
+
+
+/* Internal function: _al_register_mapped_file_interface
+ *  Make files opened with a copy of the mmap interface count as mapped
+ *  files, see _al_file_is_mapped. The interface must stay valid.
+ */
+void _al_register_mapped_file_interface(const ALLEGRO_FILE_INTERFACE *vt)
+{
+   int i;
+
+   for (i = 0; i < MAX_MAPPED_INTERFACES; i++) {
+      if (mapped_interfaces[i] == vt)
+         return;
+      if (!mapped_interfaces[i]) {
+         mapped_interfaces[i] = vt;
+         return;
+      }
+   }
+
+   ASSERT(false);
+   ALLEGRO_ERROR("Too many mapped file interfaces.\n");
+}
+
+
+/* Internal function: _al_is_mapped_file_interface
+ */
+bool _al_is_mapped_file_interface(const ALLEGRO_FILE_INTERFACE *vt)
+{
+   int i;
+
+   for (i = 0; i < MAX_MAPPED_INTERFACES && mapped_interfaces[i]; i++) {
+      if (mapped_interfaces[i] == vt)
+         return true;
+   }
+
+   return false;
+}
+
+
+/* Internal function: _al_mmap_view
+ *  Make the userdata of a file of the mmap interface for memory which is
+ *  already there. The memory must stay valid until the file is closed,
+ *  which calls release(arg) if release is not NULL. Nothing is released
+ *  if this fails.
+ */
+void *_al_mmap_view(const void *data, size_t size,
+   void (*release)(void *arg), void *arg)
+{
+   MMAP_FILE *mf;
+
+   mf = al_calloc(1, sizeof(*mf));
+   if (!mf) {
+      al_set_errno(ENOMEM);
+      return NULL;
+   }
+
+   if (size == 0) {
+      set_empty(mf);
+   }
+   else {
+      mf->data = data;
+      mf->size = size;
+   }
+   mf->release = release;
+   mf->release_arg = arg;
+
+   return mf;
+}
+
+
+/* Function: al_set_mmap_file_interface
+ */
+void al_set_mmap_file_interface(void)
+{
+   al_set_new_file_interface(&_al_file_interface_mmap);
+}
+
+
+/* vim: set sts=3 sw=3 et: */
@@ -15,6 +15,7 @@
  */
 
 #include "allegro5/allegro.h"
+#include "allegro5/internal/aintern_file.h"
 
 typedef struct SLICE_DATA SLICE_DATA;
 
@@ -183,6 +184,24 @@ static off_t slice_fsize(ALLEGRO_FILE *f)
    return slice->size;
 }
 
+static const void *slice_fpeek_buffer(ALLEGRO_FILE *f, size_t *size)
+{
+   SLICE_DATA *slice = al_get_file_userdata(f);
+   const void *ptr;
+
+   if (!(slice->mode & SLICE_READ)) {
+      return NULL;
+   }
+
+   /* The parent is always at the current position of the slice. */
+   ptr = al_fpeek_buffer(slice->fp, size);
+   if (ptr && *size > slice->size - slice->pos) {
+      *size = slice->size - slice->pos;
+   }
+
+   return ptr;
+}
+
 static const ALLEGRO_FILE_INTERFACE fi =
 {
    NULL,
@@ -205,6 +224,7 @@ static const ALLEGRO_FILE_INTERFACE fi =
 ALLEGRO_FILE *al_fopen_slice(ALLEGRO_FILE *fp, size_t initial_size, const char *mode)
 {
    SLICE_DATA *userdata = al_calloc(1, sizeof(*userdata));
+   ALLEGRO_FILE *f;
    
    if (!userdata) {
       return NULL;
@@ -226,6 +246,11 @@ ALLEGRO_FILE *al_fopen_slice(ALLEGRO_FILE *fp, size_t initial_size, const char *
    userdata->anchor = al_ftell(fp);
    userdata->size = initial_size;
    
-   return al_create_file_handle(&fi, userdata);
+   f = al_create_file_handle(&fi, userdata);
+   if (f) {
+      _al_set_file_peek_buffer(f, slice_fpeek_buffer);
+   }
+   
+   return f;
 }
 
@@ -273,6 +273,92 @@ int al_for_each_fs_entry(ALLEGRO_FS_ENTRY *dir,
 }
 
 
+/* Fallback for file systems which can only list directories entry by entry.
+ * The names are made relative by skipping prefix_len bytes.
+ */
+static int scan_fs_entries(ALLEGRO_FS_ENTRY *dir, size_t prefix_len,
+   int (*callback)(const ALLEGRO_FS_ENTRY_INFO *info, void *extra),
+   void *extra)
+{
+   ALLEGRO_FS_ENTRY *entry;
+
+   if (!al_open_directory(dir)) {
+      return ALLEGRO_FOR_EACH_FS_ENTRY_ERROR;
+   }
+
+   for (entry = al_read_directory(dir); entry; entry = al_read_directory(dir)) {
+      ALLEGRO_FS_ENTRY_INFO info;
+      const char *name = al_get_fs_entry_name(entry);
+      int result;
+
+      info.name = (strlen(name) > prefix_len) ? name + prefix_len : name;
+      info.mode = al_get_fs_entry_mode(entry);
+      info.size = al_get_fs_entry_size(entry);
+      info.mtime = al_get_fs_entry_mtime(entry);
+
+      result = callback(&info, extra);
+      if (result == ALLEGRO_FOR_EACH_FS_ENTRY_OK &&
+            (info.mode & ALLEGRO_FILEMODE_ISDIR)) {
+         result = scan_fs_entries(entry, prefix_len, callback, extra);
+      }
+
+      al_destroy_fs_entry(entry);
+
+      if ((result == ALLEGRO_FOR_EACH_FS_ENTRY_STOP) ||
+         (result == ALLEGRO_FOR_EACH_FS_ENTRY_ERROR)) {
+         al_close_directory(dir);
+         return result;
+      }
+   }
+
+   al_close_directory(dir);
+   return ALLEGRO_FOR_EACH_FS_ENTRY_OK;
+}
+
+
+/* Function: al_scan_directory
+ */
+int al_scan_directory(const char *path, int flags,
+   int (*callback)(const ALLEGRO_FS_ENTRY_INFO *info, void *extra),
+   void *extra)
+{
+   ALLEGRO_FS_ENTRY *dir;
+   const char *name;
+   size_t prefix_len;
+   int result;
+   ASSERT(path);
+   ASSERT(callback);
+
+#ifdef ALLEGRO_FS_STDIO_SCAN
+   if (al_get_fs_interface() == &_al_fs_interface_stdio) {
+      return _al_fs_stdio_scan_directory(path, flags, callback, extra);
+   }
+#else
+   (void)flags;
+#endif
+
+   dir = al_create_fs_entry(path);
+   if (!dir || !(al_get_fs_entry_mode(dir) & ALLEGRO_FILEMODE_ISDIR)) {
+      al_destroy_fs_entry(dir);
+      al_set_errno(ENOENT);
+      return ALLEGRO_FOR_EACH_FS_ENTRY_ERROR;
+   }
+
+   /* Also skip the separator after the directory name. */
+   name = al_get_fs_entry_name(dir);
+   prefix_len = strlen(name);
+   if (prefix_len > 0 && name[prefix_len - 1] != '/' &&
+         name[prefix_len - 1] != ALLEGRO_NATIVE_PATH_SEP) {
+      prefix_len++;
+   }
+
+   result = scan_fs_entries(dir, prefix_len, callback, extra);
+   al_destroy_fs_entry(dir);
+
+   return result;
+}
+
+
 
 
 /*
@@ -0,0 +1,939 @@
+/*         ______   ___    ___
+ *        /\  _  \ /\_ \  /\_ \
+ *        \ \ \L\ \\//\ \ \//\ \      __     __   _ __   ___
+ *         \ \  __ \ \ \ \  \ \ \   /'__`\ /'_ `\/\`'__\/ __`\
+ *          \ \ \/\ \ \_\ \_ \_\ \_/\  __//\ \L\ \ \ \//\ \L\ \
+ *           \ \_\ \_\/\____\/\____\ \____\ \____ \ \_\\ \____/
+ *            \/_/\/_/\/____/\/____/\/____/\/___L\ \/_/ \/___/
+ *                                           /\____/
+ *                                           \_/__/
+ *
+ *      Read-only filesystem in packed archives.
+ *
+ *      See LICENSE.txt for copyright information.
+ */
+
+/* An archive is mapped into memory and looks like this, with all numbers
+ * in little endian:
+ *
+ *    header, 32 bytes:
+ *       char magic[4]        "ALPK"
+ *       u32 version          1
+ *       u32 num_entries
+ *       u32 names_size       size of the name table
+ *       u32 alignment        of the data of each entry, informational
+ *       u8 reserved[12]
+ *
+ *    index, 40 bytes for each entry, sorted by name with strcmp:
+ *       u64 offset           of the data from the start of the archive
+ *       u64 size             of the file
+ *       u64 stored_size      of the data in the archive
+ *       i64 mtime
+ *       u32 name_offset      into the name table
+ *       u16 name_len
+ *       u8 method            0 = stored, 1 = LZ4 block
+ *       u8 reserved
+ *
+ *    name table, names_size bytes of NUL terminated names like "a/b.png"
+ *
+ *    data of the entries
+ *
+ * Directories are not stored, they are the common prefixes of the names.
+ * Since the index is sorted, all the files in a directory are next to each
+ * other, and finding one or listing a directory is a binary search.
+ *
+ * tools/allegro_pack.c makes archives.
+ */
+
+#include "allegro5/allegro.h"
+#include "allegro5/internal/aintern.h"
+#include "allegro5/internal/aintern_exitfunc.h"
+#include "allegro5/internal/aintern_file.h"
+#include "allegro5/internal/aintern_thread.h"
+#include "allegro5/internal/aintern_vector.h"
+
+ALLEGRO_DEBUG_CHANNEL("pack")
+
+#define PACK_MAGIC         "ALPK"
+#define PACK_VERSION       1
+#define PACK_HEADER_SIZE   32
+#define PACK_ENTRY_SIZE    40
+
+enum {
+   PACK_STORED = 0,
+   PACK_LZ4    = 1
+};
+
+
+typedef struct PACK_ENTRY
+{
+   const char *name;       /* in the name table */
+   uint64_t offset;
+   uint64_t size;
+   uint64_t stored_size;
+   int64_t mtime;
+   int method;
+} PACK_ENTRY;
+
+
+typedef struct PACK
+{
+   ALLEGRO_USTR *path;     /* as given to al_mount_pack */
+   ALLEGRO_FILE *file;     /* keeps the archive mapped */
+   const unsigned char *data;
+   size_t size;
+   PACK_ENTRY *entries;
+   int num_entries;
+   int refcount;           /* the mount and each open stored file */
+} PACK;
+
+
+typedef struct ALLEGRO_FS_ENTRY_PACK ALLEGRO_FS_ENTRY_PACK;
+
+struct ALLEGRO_FS_ENTRY_PACK
+{
+   ALLEGRO_FS_ENTRY fs_entry; /* must be first */
+   ALLEGRO_USTR *key;         /* name in the index, "" for the root */
+   ALLEGRO_USTR *name;        /* "/" followed by the key */
+   uint32_t mode;
+   off_t size;
+   time_t mtime;
+
+   /* For directory listing. */
+   _AL_VECTOR children;       /* ALLEGRO_USTR * */
+   unsigned int next_child;
+   bool is_dir_open;
+};
+
+
+/* Mounted archives, the most recent last. */
+static _AL_VECTOR packs = _AL_VECTOR_INITIALIZER(PACK *);
+
+/* current working directory */
+/* We cannot use ALLEGRO_USTR because we have nowhere to free it. */
+static char fs_pack_cwd[1024] = "/";
+
+/* The files in archives are memory, read with the functions of the
+ * mmap interface. This is a copy of that with our own fopen.
+ */
+static ALLEGRO_FILE_INTERFACE file_pack_vtable;
+
+static const ALLEGRO_FS_INTERFACE fs_pack_vtable;
+
+/* Files read in place keep their archive mapped after it is unmounted,
+ * and may be closed on any thread.
+ */
+static _AL_MUTEX pack_refcount_mutex = _AL_MUTEX_UNINITED;
+
+
+static uint32_t get16(const unsigned char *p)
+{
+   return p[0] | (p[1] << 8);
+}
+
+
+static uint32_t get32(const unsigned char *p)
+{
+   return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+
+static uint64_t get64(const unsigned char *p)
+{
+   return get32(p) | ((uint64_t)get32(p + 4) << 32);
+}
+
+
+/* Decompress an LZ4 block. Returns the size of the output, or -1 if the
+ * input is damaged or the output does not fit.
+ */
+static int64_t lz4_decompress(const unsigned char *src, size_t src_size,
+   unsigned char *dst, size_t dst_size)
+{
+   const unsigned char *src_end = src + src_size;
+   unsigned char *d = dst;
+   unsigned char *dst_end = dst + dst_size;
+
+   while (src < src_end) {
+      unsigned int token = *src++;
+      size_t len = token >> 4;
+      size_t offset;
+      const unsigned char *match;
+
+      /* Literals */
+      if (len == 15) {
+         unsigned int b;
+         do {
+            if (src == src_end)
+               return -1;
+            b = *src++;
+            len += b;
+         } while (b == 255);
+      }
+      if (len > (size_t)(src_end - src) || len > (size_t)(dst_end - d))
+         return -1;
+      memcpy(d, src, len);
+      d += len;
+      src += len;
+
+      /* The last sequence has no match. */
+      if (src == src_end)
+         break;
+
+      /* Match */
+      if (src_end - src < 2)
+         return -1;
+      offset = src[0] | (src[1] << 8);
+      src += 2;
+      if (offset == 0 || offset > (size_t)(d - dst))
+         return -1;
+
+      len = token & 15;
+      if (len == 15) {
+         unsigned int b;
+         do {
+            if (src == src_end)
+               return -1;
+            b = *src++;
+            len += b;
+         } while (b == 255);
+      }
+      len += 4;
+      if (len > (size_t)(dst_end - d))
+         return -1;
+
+      /* The match may overlap what it writes. */
+      match = d - offset;
+      while (len--)
+         *d++ = *match++;
+   }
+
+   return d - dst;
+}
+
+
+static void free_pack(PACK *pack)
+{
+   al_fclose(pack->file);
+   al_free(pack->entries);
+   al_ustr_free(pack->path);
+   al_free(pack);
+}
+
+
+static void ref_pack(PACK *pack)
+{
+   _al_mutex_lock(&pack_refcount_mutex);
+   pack->refcount++;
+   _al_mutex_unlock(&pack_refcount_mutex);
+}
+
+
+/* Free the pack once it is unmounted and none of its files are open. */
+static void unref_pack(void *arg)
+{
+   PACK *pack = arg;
+   int refcount;
+
+   _al_mutex_lock(&pack_refcount_mutex);
+   refcount = --pack->refcount;
+   _al_mutex_unlock(&pack_refcount_mutex);
+
+   if (refcount == 0)
+      free_pack(pack);
+}
+
+
+static void free_buffer(void *arg)
+{
+   al_free(arg);
+}
+
+
+/* Check the archive and read its index. Nothing in the archive is trusted,
+ * so that lookups need no checks later.
+ */
+static bool read_index(PACK *pack)
+{
+   const unsigned char *p = pack->data;
+   const char *names;
+   uint32_t num_entries;
+   uint32_t names_size;
+   size_t names_offset;
+   uint32_t i;
+
+   if (pack->size < PACK_HEADER_SIZE || memcmp(p, PACK_MAGIC, 4) != 0) {
+      ALLEGRO_WARN("%s is not an archive\n", al_cstr(pack->path));
+      return false;
+   }
+
+   if (get32(p + 4) != PACK_VERSION) {
+      ALLEGRO_WARN("%s has unknown version %u\n", al_cstr(pack->path),
+         (unsigned)get32(p + 4));
+      return false;
+   }
+
+   num_entries = get32(p + 8);
+   names_size = get32(p + 12);
+   if (num_entries > (pack->size - PACK_HEADER_SIZE) / PACK_ENTRY_SIZE) {
+      ALLEGRO_WARN("%s: index is truncated\n", al_cstr(pack->path));
+      return false;
+   }
+   names_offset = PACK_HEADER_SIZE + (size_t)num_entries * PACK_ENTRY_SIZE;
+   if (names_size > pack->size - names_offset ||
+         (names_size > 0 && p[names_offset + names_size - 1] != '\0')) {
+      ALLEGRO_WARN("%s: name table is damaged\n", al_cstr(pack->path));
+      return false;
+   }
+   names = (const char *)p + names_offset;
+
+   pack->entries = al_malloc((num_entries ? num_entries : 1) *
+      sizeof(PACK_ENTRY));
+   if (!pack->entries) {
+      al_set_errno(ENOMEM);
+      return false;
+   }
+
+   for (i = 0; i < num_entries; i++) {
+      const unsigned char *ie = p + PACK_HEADER_SIZE + i * PACK_ENTRY_SIZE;
+      PACK_ENTRY *e = &pack->entries[i];
+      uint32_t name_offset = get32(ie + 32);
+      uint32_t name_len = get16(ie + 36);
+
+      e->offset = get64(ie);
+      e->size = get64(ie + 8);
+      e->stored_size = get64(ie + 16);
+      e->mtime = (int64_t)get64(ie + 24);
+      e->method = ie[38];
+
+      if (name_len == 0 || name_offset >= names_size ||
+            name_len >= names_size - name_offset ||
+            names[name_offset + name_len] != '\0' ||
+            memchr(names + name_offset, '\0', name_len)) {
+         ALLEGRO_WARN("%s: entry %u has a bad name\n", al_cstr(pack->path),
+            (unsigned)i);
+         return false;
+      }
+      e->name = names + name_offset;
+
+      if (i > 0 && strcmp(e[-1].name, e->name) >= 0) {
+         ALLEGRO_WARN("%s: %s is out of order\n", al_cstr(pack->path),
+            e->name);
+         return false;
+      }
+
+      if (e->offset > pack->size ||
+            e->stored_size > pack->size - e->offset ||
+            (e->method == PACK_STORED && e->stored_size != e->size) ||
+            (e->method != PACK_STORED && e->method != PACK_LZ4)) {
+         ALLEGRO_WARN("%s: %s is damaged\n", al_cstr(pack->path), e->name);
+         return false;
+      }
+   }
+
+   pack->num_entries = num_entries;
+   return true;
+}
+
+
+/* Index of the first entry whose name is not less than the key. */
+static int lower_bound(const PACK *pack, const char *key)
+{
+   int lo = 0;
+   int hi = pack->num_entries;
+
+   while (lo < hi) {
+      int mid = lo + (hi - lo) / 2;
+      if (strcmp(pack->entries[mid].name, key) < 0)
+         lo = mid + 1;
+      else
+         hi = mid;
+   }
+
+   return lo;
+}
+
+
+static bool has_prefix(const char *name, const char *prefix, size_t len)
+{
+   return strncmp(name, prefix, len) == 0;
+}
+
+
+/* Look up a file in the archives, the last mounted first. */
+static const PACK_ENTRY *find_file(const char *key, PACK **ret_pack)
+{
+   int i;
+
+   for (i = _al_vector_size(&packs) - 1; i >= 0; i--) {
+      PACK **pack = _al_vector_ref(&packs, i);
+      int j = lower_bound(*pack, key);
+
+      if (j < (*pack)->num_entries &&
+            strcmp((*pack)->entries[j].name, key) == 0) {
+         if (ret_pack)
+            *ret_pack = *pack;
+         return &(*pack)->entries[j];
+      }
+   }
+
+   return NULL;
+}
+
+
+/* A directory exists if any file in any archive is inside it. */
+static bool is_directory(const char *key)
+{
+   ALLEGRO_USTR *prefix;
+   bool ret = false;
+   int i;
+
+   if (key[0] == '\0')
+      return true;
+
+   prefix = al_ustr_newf("%s/", key);
+   for (i = _al_vector_size(&packs) - 1; i >= 0 && !ret; i--) {
+      PACK **pack = _al_vector_ref(&packs, i);
+      int j = lower_bound(*pack, al_cstr(prefix));
+
+      ret = j < (*pack)->num_entries &&
+         has_prefix((*pack)->entries[j].name, al_cstr(prefix),
+            al_ustr_size(prefix));
+   }
+   al_ustr_free(prefix);
+
+   return ret;
+}
+
+
+static bool is_separator(int c)
+{
+#ifdef ALLEGRO_WINDOWS
+   return c == '/' || c == '\\';
+#else
+   return c == '/';
+#endif
+}
+
+
+/* Turn a path into the name it has in the index: relative to the current
+ * directory if it is not absolute, with no leading slash and no "." or ".."
+ * components.
+ */
+static ALLEGRO_USTR *make_key(const char *path)
+{
+   ALLEGRO_USTR *full;
+   ALLEGRO_USTR *key;
+   int pos = 0;
+
+   if (is_separator(path[0]))
+      full = al_ustr_new(path);
+   else
+      full = al_ustr_newf("%s%s", fs_pack_cwd, path);
+   key = al_ustr_new("");
+
+   while (pos < (int)al_ustr_size(full)) {
+      const char *s = al_cstr(full) + pos;
+      int len = 0;
+
+      while (s[len] && !is_separator(s[len]))
+         len++;
+
+      if (len == 0 || (len == 1 && s[0] == '.')) {
+         /* Nothing */
+      }
+      else if (len == 2 && s[0] == '.' && s[1] == '.') {
+         int slash = al_ustr_rfind_chr(key, al_ustr_size(key), '/');
+         al_ustr_truncate(key, slash < 0 ? 0 : slash);
+      }
+      else {
+         if (al_ustr_size(key) > 0)
+            al_ustr_append_chr(key, '/');
+         al_ustr_appendf(key, "%.*s", len, s);
+      }
+
+      pos += len + 1;
+   }
+
+   al_ustr_free(full);
+   return key;
+}
+
+
+static void update_entry(ALLEGRO_FS_ENTRY_PACK *e)
+{
+   const PACK_ENTRY *pe = find_file(al_cstr(e->key), NULL);
+
+   if (pe) {
+      e->mode = ALLEGRO_FILEMODE_READ | ALLEGRO_FILEMODE_ISFILE;
+      e->size = pe->size;
+      e->mtime = pe->mtime;
+   }
+   else if (is_directory(al_cstr(e->key))) {
+      e->mode = ALLEGRO_FILEMODE_READ | ALLEGRO_FILEMODE_ISDIR |
+         ALLEGRO_FILEMODE_EXECUTE;
+      e->size = 0;
+      e->mtime = 0;
+   }
+   else {
+      e->mode = 0;
+      e->size = 0;
+      e->mtime = 0;
+   }
+}
+
+
+static ALLEGRO_FS_ENTRY *fs_pack_create_entry(const char *path)
+{
+   ALLEGRO_FS_ENTRY_PACK *e;
+
+   e = al_calloc(1, sizeof *e);
+   if (!e)
+      return NULL;
+   e->fs_entry.vtable = &fs_pack_vtable;
+
+   e->key = make_key(path);
+   e->name = al_ustr_newf("/%s", al_cstr(e->key));
+   _al_vector_init(&e->children, sizeof(ALLEGRO_USTR *));
+   update_entry(e);
+
+   return &e->fs_entry;
+}
+
+
+static char *fs_pack_get_current_directory(void)
+{
+   size_t size = strlen(fs_pack_cwd) + 1;
+   char *s = al_malloc(size);
+   if (s) {
+      memcpy(s, fs_pack_cwd, size);
+   }
+   return s;
+}
+
+
+static bool fs_pack_change_directory(const char *path)
+{
+   ALLEGRO_USTR *key = make_key(path);
+   bool ret = false;
+
+   if (is_directory(al_cstr(key)) &&
+         (size_t)al_ustr_size(key) + 2 < sizeof(fs_pack_cwd)) {
+      fs_pack_cwd[0] = '/';
+      al_ustr_to_buffer(key, fs_pack_cwd + 1, sizeof(fs_pack_cwd) - 1);
+      if (al_ustr_size(key) > 0)
+         strcat(fs_pack_cwd, "/");
+      ret = true;
+   }
+   else {
+      al_set_errno(ENOENT);
+   }
+
+   al_ustr_free(key);
+   return ret;
+}
+
+
+static bool fs_pack_filename_exists(const char *path)
+{
+   ALLEGRO_USTR *key = make_key(path);
+   bool ret;
+
+   ret = find_file(al_cstr(key), NULL) || is_directory(al_cstr(key));
+   al_ustr_free(key);
+   return ret;
+}
+
+
+static bool fs_pack_remove_filename(const char *path)
+{
+   (void)path;
+   al_set_errno(EACCES);
+   return false;
+}
+
+
+static bool fs_pack_make_directory(const char *path)
+{
+   (void)path;
+   al_set_errno(EACCES);
+   return false;
+}
+
+
+static const char *fs_pack_entry_name(ALLEGRO_FS_ENTRY *fse)
+{
+   ALLEGRO_FS_ENTRY_PACK *e = (ALLEGRO_FS_ENTRY_PACK *)fse;
+   return al_cstr(e->name);
+}
+
+
+static bool fs_pack_update_entry(ALLEGRO_FS_ENTRY *fse)
+{
+   ALLEGRO_FS_ENTRY_PACK *e = (ALLEGRO_FS_ENTRY_PACK *)fse;
+   update_entry(e);
+   return e->mode != 0;
+}
+
+
+static off_t fs_pack_entry_size(ALLEGRO_FS_ENTRY *fse)
+{
+   ALLEGRO_FS_ENTRY_PACK *e = (ALLEGRO_FS_ENTRY_PACK *)fse;
+   return e->size;
+}
+
+
+static uint32_t fs_pack_entry_mode(ALLEGRO_FS_ENTRY *fse)
+{
+   ALLEGRO_FS_ENTRY_PACK *e = (ALLEGRO_FS_ENTRY_PACK *)fse;
+   return e->mode;
+}
+
+
+static time_t fs_pack_entry_mtime(ALLEGRO_FS_ENTRY *fse)
+{
+   ALLEGRO_FS_ENTRY_PACK *e = (ALLEGRO_FS_ENTRY_PACK *)fse;
+   return e->mtime;
+}
+
+
+static bool fs_pack_entry_exists(ALLEGRO_FS_ENTRY *fse)
+{
+   ALLEGRO_FS_ENTRY_PACK *e = (ALLEGRO_FS_ENTRY_PACK *)fse;
+   return e->mode != 0;
+}
+
+
+static bool fs_pack_remove_entry(ALLEGRO_FS_ENTRY *fse)
+{
+   (void)fse;
+   al_set_errno(EACCES);
+   return false;
+}
+
+
+static int compare_children(const void *a, const void *b)
+{
+   return al_ustr_compare(*(ALLEGRO_USTR * const *)a,
+      *(ALLEGRO_USTR * const *)b);
+}
+
+
+/* Add the names in the directory of each archive. A subdirectory is all
+ * the entries between "dir/sub/" and "dir/sub0", since '0' follows '/',
+ * so it is skipped with one search.
+ */
+static void list_children(ALLEGRO_FS_ENTRY_PACK *e, const PACK *pack,
+   const ALLEGRO_USTR *prefix)
+{
+   size_t len = al_ustr_size(prefix);
+   int i = lower_bound(pack, al_cstr(prefix));
+
+   while (i < pack->num_entries &&
+         has_prefix(pack->entries[i].name, al_cstr(prefix), len)) {
+      const char *rest = pack->entries[i].name + len;
+      const char *slash = strchr(rest, '/');
+      ALLEGRO_USTR **child = _al_vector_alloc_back(&e->children);
+
+      if (!slash) {
+         *child = al_ustr_new(rest);
+         i++;
+      }
+      else {
+         ALLEGRO_USTR *next = al_ustr_dup(prefix);
+         al_ustr_appendf(next, "%.*s", (int)(slash - rest), rest);
+         al_ustr_append_chr(next, '0');
+         *child = al_ustr_new_from_buffer(rest, slash - rest);
+         i = lower_bound(pack, al_cstr(next));
+         al_ustr_free(next);
+      }
+   }
+}
+
+
+static bool fs_pack_open_directory(ALLEGRO_FS_ENTRY *fse)
+{
+   ALLEGRO_FS_ENTRY_PACK *e = (ALLEGRO_FS_ENTRY_PACK *)fse;
+   ALLEGRO_USTR *prefix;
+   unsigned int i;
+
+   if (!(e->mode & ALLEGRO_FILEMODE_ISDIR)) {
+      al_set_errno(ENOTDIR);
+      return false;
+   }
+
+   if (al_ustr_size(e->key) > 0)
+      prefix = al_ustr_newf("%s/", al_cstr(e->key));
+   else
+      prefix = al_ustr_new("");
+
+   for (i = 0; i < _al_vector_size(&packs); i++) {
+      PACK **pack = _al_vector_ref(&packs, i);
+      list_children(e, *pack, prefix);
+   }
+   al_ustr_free(prefix);
+
+   /* Several archives may have the same directory. */
+   if (_al_vector_size(&packs) > 1 && _al_vector_size(&e->children) > 1) {
+      qsort(_al_vector_ref_front(&e->children),
+         _al_vector_size(&e->children), sizeof(ALLEGRO_USTR *),
+         compare_children);
+   }
+
+   e->next_child = 0;
+   e->is_dir_open = true;
+   return true;
+}
+
+
+static ALLEGRO_FS_ENTRY *fs_pack_read_directory(ALLEGRO_FS_ENTRY *fse)
+{
+   ALLEGRO_FS_ENTRY_PACK *e = (ALLEGRO_FS_ENTRY_PACK *)fse;
+   ALLEGRO_FS_ENTRY *next;
+   ALLEGRO_USTR **child;
+   ALLEGRO_USTR *tmp;
+
+   if (!e->is_dir_open)
+      return NULL;
+
+   /* Skip the duplicates, which are next to each other. */
+   do {
+      if (e->next_child >= _al_vector_size(&e->children))
+         return NULL;
+      child = _al_vector_ref(&e->children, e->next_child++);
+   } while (e->next_child > 1 &&
+      al_ustr_equal(*child, *(ALLEGRO_USTR **)_al_vector_ref(&e->children,
+         e->next_child - 2)));
+
+   tmp = al_ustr_dup(e->name);
+   if (al_ustr_size(e->key) > 0)
+      al_ustr_append_chr(tmp, '/');
+   al_ustr_append(tmp, *child);
+   next = fs_pack_create_entry(al_cstr(tmp));
+   al_ustr_free(tmp);
+
+   return next;
+}
+
+
+static bool fs_pack_close_directory(ALLEGRO_FS_ENTRY *fse)
+{
+   ALLEGRO_FS_ENTRY_PACK *e = (ALLEGRO_FS_ENTRY_PACK *)fse;
+   unsigned int i;
+
+   for (i = 0; i < _al_vector_size(&e->children); i++) {
+      ALLEGRO_USTR **child = _al_vector_ref(&e->children, i);
+      al_ustr_free(*child);
+   }
+   _al_vector_free(&e->children);
+   e->is_dir_open = false;
+   return true;
+}
+
+
+static void fs_pack_destroy_entry(ALLEGRO_FS_ENTRY *fse)
+{
+   ALLEGRO_FS_ENTRY_PACK *e = (ALLEGRO_FS_ENTRY_PACK *)fse;
+   if (e->is_dir_open)
+      fs_pack_close_directory(fse);
+   al_ustr_free(e->key);
+   al_ustr_free(e->name);
+   al_free(e);
+}
+
+
+static ALLEGRO_FILE *fs_pack_open_file(ALLEGRO_FS_ENTRY *fse,
+   const char *mode)
+{
+   return al_fopen_interface(&file_pack_vtable, fs_pack_entry_name(fse),
+      mode);
+}
+
+
+static const ALLEGRO_FS_INTERFACE fs_pack_vtable =
+{
+   fs_pack_create_entry,
+   fs_pack_destroy_entry,
+   fs_pack_entry_name,
+   fs_pack_update_entry,
+   fs_pack_entry_mode,
+   fs_pack_entry_mtime,
+   fs_pack_entry_mtime,
+   fs_pack_entry_mtime,
+   fs_pack_entry_size,
+   fs_pack_entry_exists,
+   fs_pack_remove_entry,
+
+   fs_pack_open_directory,
+   fs_pack_read_directory,
+   fs_pack_close_directory,
+
+   fs_pack_filename_exists,
+   fs_pack_remove_filename,
+   fs_pack_get_current_directory,
+   fs_pack_change_directory,
+   fs_pack_make_directory,
+
+   fs_pack_open_file
+};
+
+
+static void *file_pack_fopen(const char *path, const char *mode)
+{
+   ALLEGRO_USTR *key;
+   const PACK_ENTRY *e;
+   PACK *pack;
+   unsigned char *buf;
+   void *userdata;
+
+   if (mode[0] != 'r' || strchr(mode, '+')) {
+      ALLEGRO_WARN("%s: files in archives can only be read\n", path);
+      al_set_errno(EINVAL);
+      return NULL;
+   }
+
+   key = make_key(path);
+   e = find_file(al_cstr(key), &pack);
+   al_ustr_free(key);
+   if (!e) {
+      al_set_errno(ENOENT);
+      return NULL;
+   }
+
+   /* Stored files are read in place, and keep the archive mapped. */
+   if (e->method == PACK_STORED) {
+      userdata = _al_mmap_view(pack->data + e->offset, e->size,
+         unref_pack, pack);
+      if (userdata)
+         ref_pack(pack);
+      return userdata;
+   }
+
+   if (e->size > (size_t)-1) {
+      al_set_errno(EFBIG);
+      return NULL;
+   }
+
+   buf = al_malloc(e->size ? e->size : 1);
+   if (!buf) {
+      al_set_errno(ENOMEM);
+      return NULL;
+   }
+
+   if (lz4_decompress(pack->data + e->offset, e->stored_size, buf, e->size)
+         != (int64_t)e->size) {
+      ALLEGRO_ERROR("%s: %s is damaged\n", al_cstr(pack->path), e->name);
+      al_free(buf);
+      al_set_errno(EIO);
+      return NULL;
+   }
+
+   userdata = _al_mmap_view(buf, e->size, free_buffer, buf);
+   if (!userdata)
+      al_free(buf);
+   return userdata;
+}
+
+
+static void init_file_vtable(void)
+{
+   if (!file_pack_vtable.fi_fopen) {
+      file_pack_vtable = _al_file_interface_mmap;
+      file_pack_vtable.fi_fopen = file_pack_fopen;
+      _al_register_mapped_file_interface(&file_pack_vtable);
+      _al_mutex_init(&pack_refcount_mutex);
+   }
+}
+
+
+static void unmount_all_packs(void)
+{
+   unsigned int i;
+
+   for (i = 0; i < _al_vector_size(&packs); i++) {
+      PACK **pack = _al_vector_ref(&packs, i);
+      unref_pack(*pack);
+   }
+   _al_vector_free(&packs);
+}
+
+
+/* Function: al_mount_pack
+ */
+bool al_mount_pack(const char *path)
+{
+   PACK *pack;
+   PACK **slot;
+   size_t size;
+   ASSERT(path);
+
+   pack = al_calloc(1, sizeof(*pack));
+   if (!pack) {
+      al_set_errno(ENOMEM);
+      return false;
+   }
+
+   pack->file = al_fopen_interface(&_al_file_interface_mmap, path, "rb");
+   if (!pack->file) {
+      al_free(pack);
+      return false;
+   }
+   pack->path = al_ustr_new(path);
+   pack->refcount = 1;
+
+   pack->data = al_fpeek_buffer(pack->file, &size);
+   pack->size = size;
+   if (!read_index(pack)) {
+      free_pack(pack);
+      al_set_errno(EINVAL);
+      return false;
+   }
+
+   slot = _al_vector_alloc_back(&packs);
+   if (!slot) {
+      free_pack(pack);
+      al_set_errno(ENOMEM);
+      return false;
+   }
+   *slot = pack;
+
+   init_file_vtable();
+   _al_add_exit_func(unmount_all_packs, "unmount_all_packs");
+
+   ALLEGRO_INFO("Mounted %s with %d files\n", path, pack->num_entries);
+   return true;
+}
+
+
+/* Function: al_unmount_pack
+ */
+bool al_unmount_pack(const char *path)
+{
+   int i;
+   ASSERT(path);
+
+   for (i = _al_vector_size(&packs) - 1; i >= 0; i--) {
+      PACK **pack = _al_vector_ref(&packs, i);
+
+      if (strcmp(al_cstr((*pack)->path), path) == 0) {
+         unref_pack(*pack);
+         _al_vector_delete_at(&packs, i);
+         return true;
+      }
+   }
+
+   return false;
+}
+
+
+/* Function: al_set_pack_file_interface
+ */
+void al_set_pack_file_interface(void)
+{
+   init_file_vtable();
+   al_set_new_file_interface(&file_pack_vtable);
+   al_set_fs_interface(&fs_pack_vtable);
+}
+
+
+/* vim: set sts=3 sw=3 et: */
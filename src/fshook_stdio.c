@@ -71,6 +71,14 @@ ALLEGRO_DEBUG_CHANNEL("fshook")
    #endif
 #endif
 
+#ifdef ALLEGRO_FS_STDIO_SCAN
+   #include <fcntl.h>
+   #include <unistd.h>
+   #ifndef O_DIRECTORY
+      #define O_DIRECTORY  0
+   #endif
+#endif
+
 #ifndef S_IRGRP
    #define S_IRGRP   (0)
 #endif
@@ -143,6 +151,7 @@ struct ALLEGRO_FS_ENTRY_STDIO
 };
 
 
+static uint32_t stat_to_mode(const WRAP_STAT_TYPE *st, const WRAP_CHAR *path);
 static void fs_update_stat_mode(ALLEGRO_FS_ENTRY_STDIO *fp_stdio);
 static bool fs_stdio_update_entry(ALLEGRO_FS_ENTRY *fp);
 
@@ -223,7 +232,9 @@ static WRAP_CHAR *make_absolute_path(const char *tail)
 }
 
 
-static ALLEGRO_FS_ENTRY *create_abs_path_entry(const WRAP_CHAR *abs_path)
+/* If st is not NULL it holds the result of stat-ing abs_path already. */
+static ALLEGRO_FS_ENTRY *create_abs_path_entry(const WRAP_CHAR *abs_path,
+   const WRAP_STAT_TYPE *st)
 {
    ALLEGRO_FS_ENTRY_STDIO *fh;
    size_t len;
@@ -255,7 +266,13 @@ static ALLEGRO_FS_ENTRY *create_abs_path_entry(const WRAP_CHAR *abs_path)
 
    ALLEGRO_DEBUG("Creating entry for %s\n", fh->ABS_PATH_UTF8);
 
-   fs_stdio_update_entry((ALLEGRO_FS_ENTRY *) fh);
+   if (st) {
+      fh->st = *st;
+      fs_update_stat_mode(fh);
+   }
+   else {
+      fs_stdio_update_entry((ALLEGRO_FS_ENTRY *) fh);
+   }
 
    return (ALLEGRO_FS_ENTRY *) fh;
 }
@@ -268,7 +285,7 @@ static ALLEGRO_FS_ENTRY *fs_stdio_create_entry(const char *orig_path)
 
    abs_path = make_absolute_path(orig_path);
    if (abs_path) {
-      ret = create_abs_path_entry(abs_path);
+      ret = create_abs_path_entry(abs_path, NULL);
       free(abs_path);
    }
    return ret;
@@ -289,34 +306,34 @@ static bool unix_hidden_file(const char *path)
 #endif
 
 
-static void fs_update_stat_mode(ALLEGRO_FS_ENTRY_STDIO *fp_stdio)
+static uint32_t stat_to_mode(const WRAP_STAT_TYPE *st, const WRAP_CHAR *path)
 {
-   fp_stdio->stat_mode = 0;
+   uint32_t mode = 0;
 
-   if (S_ISDIR(fp_stdio->st.st_mode))
-      fp_stdio->stat_mode |= ALLEGRO_FILEMODE_ISDIR;
+   if (S_ISDIR(st->st_mode))
+      mode |= ALLEGRO_FILEMODE_ISDIR;
    else /* marks special unix files as files... might want to add enum items for symlink, CHAR, BLOCK and SOCKET files. */
-      fp_stdio->stat_mode |= ALLEGRO_FILEMODE_ISFILE;
+      mode |= ALLEGRO_FILEMODE_ISFILE;
 
    /*
-   if (S_ISREG(fh->st.st_mode))
-      fh->stat_mode |= ALLEGRO_FILEMODE_ISFILE;
+   if (S_ISREG(st->st_mode))
+      mode |= ALLEGRO_FILEMODE_ISFILE;
    */
 
-   if (fp_stdio->st.st_mode & (S_IRUSR | S_IRGRP))
-      fp_stdio->stat_mode |= ALLEGRO_FILEMODE_READ;
+   if (st->st_mode & (S_IRUSR | S_IRGRP))
+      mode |= ALLEGRO_FILEMODE_READ;
 
-   if (fp_stdio->st.st_mode & (S_IWUSR | S_IWGRP))
-      fp_stdio->stat_mode |= ALLEGRO_FILEMODE_WRITE;
+   if (st->st_mode & (S_IWUSR | S_IWGRP))
+      mode |= ALLEGRO_FILEMODE_WRITE;
 
-   if (fp_stdio->st.st_mode & (S_IXUSR | S_IXGRP))
-      fp_stdio->stat_mode |= ALLEGRO_FILEMODE_EXECUTE;
+   if (st->st_mode & (S_IXUSR | S_IXGRP))
+      mode |= ALLEGRO_FILEMODE_EXECUTE;
 
 #if defined(ALLEGRO_WINDOWS)
    {
-      DWORD attrib = GetFileAttributes(fp_stdio->abs_path);
+      DWORD attrib = GetFileAttributes(path);
       if (attrib & FILE_ATTRIBUTE_HIDDEN)
-         fp_stdio->stat_mode |= ALLEGRO_FILEMODE_HIDDEN;
+         mode |= ALLEGRO_FILEMODE_HIDDEN;
    }
 #endif
 #if defined(ALLEGRO_MACOSX) && defined(UF_HIDDEN)
@@ -325,17 +342,25 @@ static void fs_update_stat_mode(ALLEGRO_FS_ENTRY_STDIO *fp_stdio)
        * Note that this flag does not exist on all versions of OS X (Tiger
        * doesn't seem to have it) so we need to test for it.
        */
-      if (fp_stdio->st.st_flags & UF_HIDDEN)
-         fp_stdio->stat_mode |= ALLEGRO_FILEMODE_HIDDEN;
+      if (st->st_flags & UF_HIDDEN)
+         mode |= ALLEGRO_FILEMODE_HIDDEN;
    }
 #endif
 #if defined(ALLEGRO_UNIX) || defined(ALLEGRO_MACOSX)
-   if (0 == (fp_stdio->stat_mode & ALLEGRO_FILEMODE_HIDDEN)) {
-      if (unix_hidden_file(fp_stdio->abs_path)) {
-         fp_stdio->stat_mode |= ALLEGRO_FILEMODE_HIDDEN;
+   if (0 == (mode & ALLEGRO_FILEMODE_HIDDEN)) {
+      if (unix_hidden_file(path)) {
+         mode |= ALLEGRO_FILEMODE_HIDDEN;
       }
    }
 #endif
+
+   return mode;
+}
+
+
+static void fs_update_stat_mode(ALLEGRO_FS_ENTRY_STDIO *fp_stdio)
+{
+   fp_stdio->stat_mode = stat_to_mode(&fp_stdio->st, fp_stdio->abs_path);
 }
 
 
@@ -425,7 +450,7 @@ static ALLEGRO_FS_ENTRY *fs_stdio_read_directory(ALLEGRO_FS_ENTRY *fp)
          al_set_errno(ERANGE);
          return NULL;
       }
-      ret = create_abs_path_entry(buf);
+      ret = create_abs_path_entry(buf, NULL);
    }
 #else
    {
@@ -440,7 +465,18 @@ static ALLEGRO_FS_ENTRY *fs_stdio_read_directory(ALLEGRO_FS_ENTRY *fp)
       buf[abs_path_len] = ALLEGRO_NATIVE_PATH_SEP;
       memcpy(buf + abs_path_len + 1, ent->d_name, ent_name_len);
       buf[abs_path_len + 1 + ent_name_len] = '\0';
-      ret = create_abs_path_entry(buf);
+#ifdef ALLEGRO_FS_STDIO_SCAN
+      {
+         /* Only the name needs looking up, not the whole path again. */
+         struct stat st;
+         if (fstatat(dirfd(fp_stdio->dir), ent->d_name, &st, 0) == 0)
+            ret = create_abs_path_entry(buf, &st);
+         else
+            ret = create_abs_path_entry(buf, NULL);
+      }
+#else
+      ret = create_abs_path_entry(buf, NULL);
+#endif
       al_free(buf);
    }
 #endif
@@ -728,6 +764,124 @@ static ALLEGRO_FILE *fs_stdio_open_file(ALLEGRO_FS_ENTRY *fp, const char *mode)
 }
 
 
+#ifdef ALLEGRO_FS_STDIO_SCAN
+
+/* Lists the directory open as fd, which is closed afterwards. name holds the
+ * path of the directory relative to where the scan started.
+ */
+static int scan_directory_at(int fd, ALLEGRO_USTR *name, int flags,
+   int (*callback)(const ALLEGRO_FS_ENTRY_INFO *info, void *extra),
+   void *extra)
+{
+   const int len = al_ustr_size(name);
+   struct dirent *ent;
+   DIR *dir;
+   int result = ALLEGRO_FOR_EACH_FS_ENTRY_OK;
+
+   dir = fdopendir(fd);
+   if (!dir) {
+      al_set_errno(errno);
+      close(fd);
+      return ALLEGRO_FOR_EACH_FS_ENTRY_ERROR;
+   }
+
+   while ((ent = readdir(dir))) {
+      ALLEGRO_FS_ENTRY_INFO info;
+      struct stat st;
+      bool need_stat = true;
+
+      if (0 == strcmp(ent->d_name, ".") || 0 == strcmp(ent->d_name, ".."))
+         continue;
+
+      al_ustr_truncate(name, len);
+      if (len > 0)
+         al_ustr_append_chr(name, ALLEGRO_NATIVE_PATH_SEP);
+      al_ustr_append_cstr(name, ent->d_name);
+
+      memset(&info, 0, sizeof(info));
+      info.name = al_cstr(name);
+
+#ifdef DT_DIR
+      /* Most file systems tell the type while listing, links aside. */
+      if ((flags & ALLEGRO_SCAN_DIRECTORY_TYPES_ONLY) &&
+            ent->d_type != DT_UNKNOWN && ent->d_type != DT_LNK) {
+         if (ent->d_type == DT_DIR)
+            info.mode = ALLEGRO_FILEMODE_ISDIR;
+         else
+            info.mode = ALLEGRO_FILEMODE_ISFILE;
+         if (unix_hidden_file(ent->d_name))
+            info.mode |= ALLEGRO_FILEMODE_HIDDEN;
+         need_stat = false;
+      }
+#endif
+
+      if (need_stat) {
+         if (fstatat(dirfd(dir), ent->d_name, &st, 0) == -1) {
+            /* Removed since it was listed, or a dangling link. */
+            continue;
+         }
+         info.mode = stat_to_mode(&st, ent->d_name);
+         info.size = st.st_size;
+         info.mtime = st.st_mtime;
+      }
+
+      result = callback(&info, extra);
+
+      /* Recurse if requested and needed. Only OK allows recursion. */
+      if (result == ALLEGRO_FOR_EACH_FS_ENTRY_OK &&
+            (info.mode & ALLEGRO_FILEMODE_ISDIR)) {
+         int sub = openat(dirfd(dir), ent->d_name, O_RDONLY | O_DIRECTORY);
+         if (sub == -1) {
+            al_set_errno(errno);
+            result = ALLEGRO_FOR_EACH_FS_ENTRY_ERROR;
+         }
+         else {
+            result = scan_directory_at(sub, name, flags, callback, extra);
+         }
+      }
+
+      if ((result == ALLEGRO_FOR_EACH_FS_ENTRY_STOP) ||
+         (result == ALLEGRO_FOR_EACH_FS_ENTRY_ERROR)) {
+         break;
+      }
+      result = ALLEGRO_FOR_EACH_FS_ENTRY_OK;
+   }
+
+   closedir(dir);
+   al_ustr_truncate(name, len);
+   return result;
+}
+
+
+/* Internal function: _al_fs_stdio_scan_directory
+ *  al_scan_directory for the stdio file system. Each entry is stat-ed
+ *  relative to its open directory, or not at all if the type is all that is
+ *  wanted and readdir already told it.
+ */
+int _al_fs_stdio_scan_directory(const char *path, int flags,
+   int (*callback)(const ALLEGRO_FS_ENTRY_INFO *info, void *extra),
+   void *extra)
+{
+   ALLEGRO_USTR *name;
+   int fd;
+   int result;
+
+   fd = open(path, O_RDONLY | O_DIRECTORY);
+   if (fd == -1) {
+      al_set_errno(errno);
+      return ALLEGRO_FOR_EACH_FS_ENTRY_ERROR;
+   }
+
+   name = al_ustr_new("");
+   result = scan_directory_at(fd, name, flags, callback, extra);
+   al_ustr_free(name);
+
+   return result;
+}
+
+#endif /* ALLEGRO_FS_STDIO_SCAN */
+
+
 struct ALLEGRO_FS_INTERFACE _al_fs_interface_stdio = {
    fs_stdio_create_entry,
    fs_stdio_destroy_entry,
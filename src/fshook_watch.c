@@ -0,0 +1,405 @@
+/*         ______   ___    ___
+ *        /\  _  \ /\_ \  /\_ \
+ *        \ \ \L\ \\//\ \ \//\ \      __     __   _ __   ___
+ *         \ \  __ \ \ \ \  \ \ \   /'__`\ /'_ `\/\`'__\/ __`\
+ *          \ \ \/\ \ \_\ \_ \_\ \_/\  __//\ \L\ \ \ \//\ \L\ \
+ *           \ \_\ \_\/\____\/\____\ \____\ \____ \ \_\\ \____/
+ *            \/_/\/_/\/____/\/____/\/____/\/___L\ \/_/ \/___/
+ *                                           /\____/
+ *                                           \_/__/
+ *
+ *      Watching directory trees for changes.
+ *
+ *      See readme.txt for copyright information.
+ */
+
+#include "allegro5/allegro.h"
+#include "allegro5/internal/aintern.h"
+#include "allegro5/internal/aintern_fshook.h"
+
+ALLEGRO_DEBUG_CHANNEL("fshook")
+
+#if defined(ALLEGRO_HAVE_SYS_INOTIFY_H) && defined(ALLEGRO_FS_STDIO_SCAN)
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+
+#include "allegro5/internal/aintern_vector.h"
+
+/* A file which is written to is only reported once it is closed. Created
+ * files are reported then too, so IN_CREATE only matters for directories.
+ */
+#define WATCH_MASK   (IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_ATTRIB | \
+                      IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR)
+
+
+typedef struct WATCHED_DIR {
+   int wd;
+   ALLEGRO_USTR *path;           /* relative to the root, "" for the root */
+} WATCHED_DIR;
+
+struct ALLEGRO_FS_WATCHER {
+   ALLEGRO_USTR *root;
+   int fd;
+   _AL_VECTOR dirs;              /* WATCHED_DIR, sorted by wd */
+   ALLEGRO_USTR *scratch;
+   ALLEGRO_USTR *change;         /* returned by al_get_next_fs_change */
+   union {
+      struct inotify_event event;
+      char bytes[16 * 1024];
+   } buf;
+   size_t buf_pos;
+   size_t buf_len;
+};
+
+
+/* Returns the index of the watch, or where to insert it. */
+static unsigned int find_dir(ALLEGRO_FS_WATCHER *w, int wd)
+{
+   unsigned int lo = 0;
+   unsigned int hi = _al_vector_size(&w->dirs);
+
+   while (lo < hi) {
+      unsigned int mid = lo + (hi - lo) / 2;
+      WATCHED_DIR *dir = _al_vector_ref(&w->dirs, mid);
+      if (dir->wd < wd)
+         lo = mid + 1;
+      else
+         hi = mid;
+   }
+   return lo;
+}
+
+
+static WATCHED_DIR *lookup_dir(ALLEGRO_FS_WATCHER *w, int wd)
+{
+   unsigned int i = find_dir(w, wd);
+   WATCHED_DIR *dir;
+
+   if (i == _al_vector_size(&w->dirs))
+      return NULL;
+   dir = _al_vector_ref(&w->dirs, i);
+   return (dir->wd == wd) ? dir : NULL;
+}
+
+
+/* Sets w->scratch to the full path of a directory relative to the root. */
+static const char *full_path(ALLEGRO_FS_WATCHER *w, const ALLEGRO_USTR *rel)
+{
+   al_ustr_assign(w->scratch, w->root);
+   if (al_ustr_size(rel) > 0) {
+      al_ustr_append_chr(w->scratch, ALLEGRO_NATIVE_PATH_SEP);
+      al_ustr_append(w->scratch, rel);
+   }
+   return al_cstr(w->scratch);
+}
+
+
+static bool add_watch(ALLEGRO_FS_WATCHER *w, const ALLEGRO_USTR *rel)
+{
+   const char *path = full_path(w, rel);
+   WATCHED_DIR *dir;
+   unsigned int i;
+   int wd;
+
+   wd = inotify_add_watch(w->fd, path, WATCH_MASK);
+   if (wd == -1) {
+      ALLEGRO_WARN("Could not watch %s: %s\n", path, strerror(errno));
+      al_set_errno(errno);
+      return false;
+   }
+
+   /* The same directory gets the same watch again, e.g. after a move. */
+   i = find_dir(w, wd);
+   if (i < _al_vector_size(&w->dirs)) {
+      dir = _al_vector_ref(&w->dirs, i);
+      if (dir->wd == wd) {
+         al_ustr_assign(dir->path, rel);
+         return true;
+      }
+   }
+
+   dir = _al_vector_alloc_mid(&w->dirs, i);
+   dir->wd = wd;
+   dir->path = al_ustr_dup(rel);
+   return true;
+}
+
+
+typedef struct ADD_TREE {
+   ALLEGRO_FS_WATCHER *watcher;
+   const ALLEGRO_USTR *rel;
+   ALLEGRO_USTR *path;
+   bool ok;
+} ADD_TREE;
+
+
+static int add_subdir(const ALLEGRO_FS_ENTRY_INFO *info, void *extra)
+{
+   ADD_TREE *add = extra;
+
+   if (!(info->mode & ALLEGRO_FILEMODE_ISDIR))
+      return ALLEGRO_FOR_EACH_FS_ENTRY_OK;
+
+   al_ustr_assign(add->path, add->rel);
+   if (al_ustr_size(add->path) > 0)
+      al_ustr_append_chr(add->path, ALLEGRO_NATIVE_PATH_SEP);
+   al_ustr_append_cstr(add->path, info->name);
+
+   if (!add_watch(add->watcher, add->path)) {
+      add->ok = false;
+      return ALLEGRO_FOR_EACH_FS_ENTRY_STOP;
+   }
+   return ALLEGRO_FOR_EACH_FS_ENTRY_OK;
+}
+
+
+/* Watches the directory and every directory below it. */
+static bool add_tree(ALLEGRO_FS_WATCHER *w, const ALLEGRO_USTR *rel)
+{
+   ADD_TREE add;
+   char *path;
+
+   if (!add_watch(w, rel))
+      return false;
+
+   add.watcher = w;
+   add.rel = rel;
+   add.path = al_ustr_new("");
+   add.ok = true;
+
+   /* add_watch reuses the scratch buffer. */
+   path = al_cstr_dup(w->scratch);
+   if (_al_fs_stdio_scan_directory(path, ALLEGRO_SCAN_DIRECTORY_TYPES_ONLY,
+         add_subdir, &add) == ALLEGRO_FOR_EACH_FS_ENTRY_ERROR) {
+      /* A directory below could not be listed, so it and whatever came
+       * after it in the scan are not watched.
+       */
+      ALLEGRO_WARN("Could not list all directories below %s\n", path);
+      add.ok = false;
+   }
+   al_free(path);
+   al_ustr_free(add.path);
+
+   return add.ok;
+}
+
+
+/* Stops watching a directory which was moved away, and everything below it.
+ * If it was moved within the tree it is added again under the new name.
+ */
+static void remove_tree(ALLEGRO_FS_WATCHER *w, const ALLEGRO_USTR *rel)
+{
+   size_t len = al_ustr_size(rel);
+   int i;
+
+   for (i = _al_vector_size(&w->dirs) - 1; i >= 0; i--) {
+      WATCHED_DIR *dir = _al_vector_ref(&w->dirs, i);
+      if (al_ustr_has_prefix(dir->path, rel) &&
+            (al_ustr_size(dir->path) == len ||
+             al_ustr_get(dir->path, len) == ALLEGRO_NATIVE_PATH_SEP)) {
+         inotify_rm_watch(w->fd, dir->wd);
+         al_ustr_free(dir->path);
+         _al_vector_delete_at(&w->dirs, i);
+      }
+   }
+}
+
+
+/* Sets w->change for an event. Returns false for events which are not
+ * reported.
+ */
+static bool handle_event(ALLEGRO_FS_WATCHER *w,
+   const struct inotify_event *event)
+{
+   ALLEGRO_USTR *rel;
+   WATCHED_DIR *dir;
+
+   if (event->mask & IN_Q_OVERFLOW) {
+      /* Events were lost, so anything may have changed. Directories created
+       * in the meantime are not watched yet either.
+       */
+      ALLEGRO_WARN("Lost events for %s.\n", al_cstr(w->root));
+      rel = al_ustr_new("");
+      add_tree(w, rel);
+      al_ustr_free(rel);
+      al_ustr_assign(w->change, w->root);
+      return true;
+   }
+
+   if (event->mask & IN_IGNORED) {
+      /* The directory was removed. */
+      dir = lookup_dir(w, event->wd);
+      if (dir) {
+         al_ustr_free(dir->path);
+         _al_vector_delete_at(&w->dirs, find_dir(w, event->wd));
+      }
+      return false;
+   }
+
+   dir = lookup_dir(w, event->wd);
+   if (!dir)
+      return false;
+   if ((event->mask & IN_CREATE) && !(event->mask & IN_ISDIR))
+      return false;
+
+   rel = al_ustr_dup(dir->path);
+   if (event->len > 0) {
+      if (al_ustr_size(rel) > 0)
+         al_ustr_append_chr(rel, ALLEGRO_NATIVE_PATH_SEP);
+      al_ustr_append_cstr(rel, event->name);
+   }
+
+   if (event->mask & IN_ISDIR) {
+      /* Files may appear in a new directory before it is watched, so it
+       * is reported itself and should be scanned again.
+       */
+      if (event->mask & (IN_CREATE | IN_MOVED_TO))
+         add_tree(w, rel);
+      else if (event->mask & IN_MOVED_FROM)
+         remove_tree(w, rel);
+   }
+
+   full_path(w, rel);
+   al_ustr_assign(w->change, w->scratch);
+   al_ustr_free(rel);
+   return true;
+}
+
+
+/* Function: al_create_fs_watcher
+ */
+ALLEGRO_FS_WATCHER *al_create_fs_watcher(const char *path)
+{
+   ALLEGRO_FS_WATCHER *w;
+   ALLEGRO_USTR *rel;
+   bool ok;
+   ASSERT(path);
+
+   w = al_calloc(1, sizeof(*w));
+   if (!w) {
+      al_set_errno(ENOMEM);
+      return NULL;
+   }
+
+   w->fd = inotify_init();
+   if (w->fd == -1) {
+      ALLEGRO_WARN("inotify_init failed: %s\n", strerror(errno));
+      al_set_errno(errno);
+      al_free(w);
+      return NULL;
+   }
+   fcntl(w->fd, F_SETFL, O_NONBLOCK);
+   fcntl(w->fd, F_SETFD, FD_CLOEXEC);
+
+   w->root = al_ustr_new(path);
+   w->scratch = al_ustr_new("");
+   w->change = al_ustr_new("");
+   _al_vector_init(&w->dirs, sizeof(WATCHED_DIR));
+
+   /* Drop a trailing separator so that the reported paths look right. */
+   while (al_ustr_size(w->root) > 1 &&
+         (al_ustr_get(w->root, al_ustr_size(w->root) - 1) == '/' ||
+          al_ustr_get(w->root, al_ustr_size(w->root) - 1) ==
+            ALLEGRO_NATIVE_PATH_SEP)) {
+      al_ustr_truncate(w->root, al_ustr_size(w->root) - 1);
+   }
+
+   rel = al_ustr_new("");
+   ok = add_tree(w, rel);
+   al_ustr_free(rel);
+   if (!ok) {
+      /* Missing changes silently would be worse than no watcher. */
+      al_destroy_fs_watcher(w);
+      return NULL;
+   }
+
+   ALLEGRO_DEBUG("Watching %d directories below %s\n",
+      (int)_al_vector_size(&w->dirs), al_cstr(w->root));
+   return w;
+}
+
+
+/* Function: al_destroy_fs_watcher
+ */
+void al_destroy_fs_watcher(ALLEGRO_FS_WATCHER *w)
+{
+   unsigned int i;
+
+   if (!w)
+      return;
+
+   close(w->fd);
+   for (i = 0; i < _al_vector_size(&w->dirs); i++) {
+      WATCHED_DIR *dir = _al_vector_ref(&w->dirs, i);
+      al_ustr_free(dir->path);
+   }
+   _al_vector_free(&w->dirs);
+   al_ustr_free(w->root);
+   al_ustr_free(w->scratch);
+   al_ustr_free(w->change);
+   al_free(w);
+}
+
+
+/* Function: al_get_next_fs_change
+ */
+const char *al_get_next_fs_change(ALLEGRO_FS_WATCHER *w)
+{
+   ASSERT(w);
+
+   for (;;) {
+      const struct inotify_event *event;
+
+      if (w->buf_pos >= w->buf_len) {
+         ssize_t n = read(w->fd, w->buf.bytes, sizeof(w->buf.bytes));
+         if (n <= 0)
+            return NULL;
+         w->buf_pos = 0;
+         w->buf_len = n;
+      }
+
+      event = (const struct inotify_event *)(w->buf.bytes + w->buf_pos);
+      w->buf_pos += sizeof(struct inotify_event) + event->len;
+
+      if (handle_event(w, event))
+         return al_cstr(w->change);
+   }
+}
+
+
+#else
+
+
+/* Function: al_create_fs_watcher
+ */
+ALLEGRO_FS_WATCHER *al_create_fs_watcher(const char *path)
+{
+   (void)path;
+   ALLEGRO_DEBUG("No change notification on this platform.\n");
+   al_set_errno(ENOSYS);
+   return NULL;
+}
+
+
+/* Function: al_destroy_fs_watcher
+ */
+void al_destroy_fs_watcher(ALLEGRO_FS_WATCHER *w)
+{
+   (void)w;
+}
+
+
+/* Function: al_get_next_fs_change
+ */
+const char *al_get_next_fs_change(ALLEGRO_FS_WATCHER *w)
+{
+   (void)w;
+   return NULL;
+}
+
+
+#endif
+
+/* vim: set sts=3 sw=3 et: */
@@ -22,6 +22,13 @@
 #include "allegro5/internal/aintern_transform.h"
 #include "allegro5/internal/aintern_tri_soft.h"
 #include <math.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+   (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+   #define MEMBLIT_SSE2
+   #include <emmintrin.h>
+#endif
 
 #define MIN _ALLEGRO_MIN
 #define MAX _ALLEGRO_MAX
@@ -33,6 +40,12 @@ static void _al_draw_transformed_scaled_bitmap_memory(
 static void _al_draw_bitmap_region_memory_fast(ALLEGRO_BITMAP *bitmap,
    int sx, int sy, int sw, int sh,
    int dx, int dy, int flags);
+static bool can_draw_bitmap_region_memory_blend(ALLEGRO_BITMAP *bitmap,
+   ALLEGRO_COLOR tint);
+static void _al_draw_bitmap_region_memory_blend(ALLEGRO_BITMAP *bitmap,
+   ALLEGRO_COLOR tint,
+   int sx, int sy, int sw, int sh,
+   int dx, int dy);
 
 
 /* The CLIPPER macro takes pre-clipped coordinates for both the source
@@ -138,19 +151,29 @@ void _al_draw_bitmap_region_memory(ALLEGRO_BITMAP *src,
    int op, src_mode, dst_mode;
    int op_alpha, src_alpha, dst_alpha;
    float xtrans, ytrans;
+   bool translation;
    
    ASSERT(src->parent == NULL);
 
    al_get_separate_blender(&op, &src_mode, &dst_mode, &op_alpha, &src_alpha, &dst_alpha);
+   translation = _al_transform_is_translation(al_get_current_transform(),
+      &xtrans, &ytrans);
 
-   if (_AL_DEST_IS_ZERO && _AL_SRC_NOT_MODIFIED_TINT_WHITE &&
-      _al_transform_is_translation(al_get_current_transform(), &xtrans, &ytrans))
+   if (_AL_DEST_IS_ZERO && _AL_SRC_NOT_MODIFIED_TINT_WHITE && translation)
    {
       _al_draw_bitmap_region_memory_fast(src, sx, sy, sw, sh,
          dx + xtrans, dy + ytrans, flags);
       return;
    }
 
+   if (translation && flags == 0 &&
+      can_draw_bitmap_region_memory_blend(src, tint))
+   {
+      _al_draw_bitmap_region_memory_blend(src, tint, sx, sy, sw, sh,
+         dx + xtrans, dy + ytrans);
+      return;
+   }
+
    /* We used to have special cases for translation/scaling only, but the
     * general version received much more optimisation and ended up being
     * faster.
@@ -302,4 +325,354 @@ static void _al_draw_bitmap_region_memory_fast(ALLEGRO_BITMAP *bitmap,
 }
 
 
+/* Layout of a 32-bit pixel format with 8-bit components, as shifts. The a
+ * shift is that of the X component if the format has no alpha.
+ */
+typedef struct PIXEL_LAYOUT {
+   int r, g, b, a;
+   bool has_alpha;
+} PIXEL_LAYOUT;
+
+
+static bool get_pixel_layout(int format, PIXEL_LAYOUT *l)
+{
+   l->has_alpha = true;
+   switch (format) {
+      case ALLEGRO_PIXEL_FORMAT_ARGB_8888:
+         l->a = 24; l->r = 16; l->g = 8; l->b = 0;
+         return true;
+      case ALLEGRO_PIXEL_FORMAT_RGBA_8888:
+         l->r = 24; l->g = 16; l->b = 8; l->a = 0;
+         return true;
+      case ALLEGRO_PIXEL_FORMAT_ABGR_8888:
+         l->a = 24; l->b = 16; l->g = 8; l->r = 0;
+         return true;
+      case ALLEGRO_PIXEL_FORMAT_ABGR_8888_LE:
+#ifdef ALLEGRO_BIG_ENDIAN
+         l->r = 24; l->g = 16; l->b = 8; l->a = 0;
+#else
+         l->a = 24; l->b = 16; l->g = 8; l->r = 0;
+#endif
+         return true;
+      case ALLEGRO_PIXEL_FORMAT_XRGB_8888:
+         l->a = 24; l->r = 16; l->g = 8; l->b = 0;
+         l->has_alpha = false;
+         return true;
+      case ALLEGRO_PIXEL_FORMAT_RGBX_8888:
+         l->r = 24; l->g = 16; l->b = 8; l->a = 0;
+         l->has_alpha = false;
+         return true;
+      case ALLEGRO_PIXEL_FORMAT_XBGR_8888:
+         l->a = 24; l->b = 16; l->g = 8; l->r = 0;
+         l->has_alpha = false;
+         return true;
+      default:
+         return false;
+   }
+}
+
+
+/* x / 255, rounded down. Exact for x < 255 * 258, larger values come out
+ * above 255 and get clamped anyway.
+ */
+#define DIV255(x)  (((x) + 1 + (((x) + 1) >> 8)) >> 8)
+
+
+/* Blends a span of n pixels with ALLEGRO_ADD and ALLEGRO_INVERSE_ALPHA as
+ * destination factor. The source factors are either ALLEGRO_ONE or
+ * ALLEGRO_ALPHA, for color and alpha separately. The tint is in 8.8 fixed
+ * point, or NULL for white.
+ *
+ * This is the fixed point equivalent of what the scanline drawers do in
+ * floating point, and gets specialised by the compiler for the common
+ * layouts in blend_rows below.
+ */
+static _AL_ALWAYS_INLINE void blend_span(const uint32_t *src, uint32_t *dst,
+   int n, PIXEL_LAYOUT sl, PIXEL_LAYOUT dl, bool color_by_alpha,
+   bool alpha_by_alpha, const int *tint)
+{
+   int i;
+
+   for (i = 0; i < n; i++) {
+      uint32_t sp = src[i];
+      uint32_t dp;
+      int sr = (sp >> sl.r) & 0xff;
+      int sg = (sp >> sl.g) & 0xff;
+      int sb = (sp >> sl.b) & 0xff;
+      int sa = sl.has_alpha ? (int)((sp >> sl.a) & 0xff) : 0xff;
+      int da, inv, fc, fa, r, g, b, a;
+
+      if (tint) {
+         sr = (sr * tint[0]) >> 8;
+         sg = (sg * tint[1]) >> 8;
+         sb = (sb * tint[2]) >> 8;
+         sa = (sa * tint[3]) >> 8;
+      }
+
+      /* Skip pixels which leave the destination alone. */
+      if (sa == 0 && (color_by_alpha || (sr | sg | sb) == 0))
+         continue;
+
+      dp = dst[i];
+      da = dl.has_alpha ? (int)((dp >> dl.a) & 0xff) : 0xff;
+      inv = 0xff - sa;
+      fc = color_by_alpha ? sa : 0xff;
+      fa = alpha_by_alpha ? sa : 0xff;
+
+      r = DIV255(sr * fc + (int)((dp >> dl.r) & 0xff) * inv);
+      g = DIV255(sg * fc + (int)((dp >> dl.g) & 0xff) * inv);
+      b = DIV255(sb * fc + (int)((dp >> dl.b) & 0xff) * inv);
+      a = DIV255(sa * fa + da * inv);
+
+      if (r > 0xff) r = 0xff;
+      if (g > 0xff) g = 0xff;
+      if (b > 0xff) b = 0xff;
+      if (a > 0xff) a = 0xff;
+      if (!dl.has_alpha) a = 0xff;
+
+      dst[i] = ((uint32_t)r << dl.r) | ((uint32_t)g << dl.g) |
+         ((uint32_t)b << dl.b) | ((uint32_t)a << dl.a);
+   }
+}
+
+
+#ifdef MEMBLIT_SSE2
+/* SSE2 version of blend_span for source and destination layouts which only
+ * differ in whether the fourth component is alpha or unused. Returns the
+ * number of pixels done, the rest is left to blend_span.
+ *
+ * Components blended with ALLEGRO_ALPHA compute s * sa + d * (255 - sa),
+ * which fits in 16 bits. For ALLEGRO_ONE, s * 255 is a multiple of 255 so
+ * DIV255(s * 255 + x) is s + DIV255(x), and s gets added afterwards with a
+ * saturating add, which also does the clamping.
+ */
+static int blend_span_sse2(const uint32_t *src, uint32_t *dst, int n,
+   PIXEL_LAYOUT sl, PIXEL_LAYOUT dl, bool color_by_alpha,
+   bool alpha_by_alpha, const int *tint)
+{
+   const __m128i zero = _mm_setzero_si128();
+   const __m128i ff = _mm_set1_epi16(0xff);
+   const __m128i one = _mm_set1_epi16(1);
+   const uint32_t amask = 0xffu << sl.a;
+   const int alane = sl.a / 8;
+   __m128i by_alpha, by_one, src_x, dst_x, tint16 = zero;
+   int i;
+
+   /* Which 16-bit lanes use the ALLEGRO_ALPHA factor, and which bytes
+    * get s added instead.
+    */
+   {
+      short m[4];
+      for (i = 0; i < 4; i++)
+         m[i] = (i == alane ? alpha_by_alpha : color_by_alpha) ? -1 : 0;
+      by_alpha = _mm_set_epi16(m[3], m[2], m[1], m[0], m[3], m[2], m[1], m[0]);
+      by_one = _mm_andnot_si128(_mm_packs_epi16(by_alpha, by_alpha),
+         _mm_set1_epi8(-1));
+   }
+
+   src_x = _mm_set1_epi32(sl.has_alpha ? 0 : (int)amask);
+   dst_x = _mm_set1_epi32(dl.has_alpha ? 0 : (int)amask);
+
+   if (tint) {
+      short t[4];
+      t[sl.r / 8] = tint[0];
+      t[sl.g / 8] = tint[1];
+      t[sl.b / 8] = tint[2];
+      t[alane] = tint[3];
+      tint16 = _mm_set_epi16(t[3], t[2], t[1], t[0], t[3], t[2], t[1], t[0]);
+   }
+
+   for (i = 0; i + 4 <= n; i += 4) {
+      __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+      __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+      __m128i s_lo, s_hi, d_lo, d_hi, a_lo, a_hi, r_lo, r_hi;
+
+      s = _mm_or_si128(s, src_x);
+      s_lo = _mm_unpacklo_epi8(s, zero);
+      s_hi = _mm_unpackhi_epi8(s, zero);
+      d_lo = _mm_unpacklo_epi8(d, zero);
+      d_hi = _mm_unpackhi_epi8(d, zero);
+
+      if (tint) {
+         s_lo = _mm_srli_epi16(_mm_mullo_epi16(s_lo, tint16), 8);
+         s_hi = _mm_srli_epi16(_mm_mullo_epi16(s_hi, tint16), 8);
+         s = _mm_packus_epi16(s_lo, s_hi);
+      }
+
+      /* Broadcast each pixel's alpha to all of its components. */
+      if (alane == 3) {
+         a_lo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s_lo, 0xff), 0xff);
+         a_hi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s_hi, 0xff), 0xff);
+      }
+      else {
+         a_lo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s_lo, 0x00), 0x00);
+         a_hi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s_hi, 0x00), 0x00);
+      }
+
+      /* d * (255 - sa) + s * sa for the ALLEGRO_ALPHA components. */
+      r_lo = _mm_mullo_epi16(d_lo, _mm_sub_epi16(ff, a_lo));
+      r_hi = _mm_mullo_epi16(d_hi, _mm_sub_epi16(ff, a_hi));
+      r_lo = _mm_add_epi16(r_lo,
+         _mm_and_si128(_mm_mullo_epi16(s_lo, a_lo), by_alpha));
+      r_hi = _mm_add_epi16(r_hi,
+         _mm_and_si128(_mm_mullo_epi16(s_hi, a_hi), by_alpha));
+
+      /* DIV255 on unsigned 16-bit lanes. */
+      r_lo = _mm_add_epi16(r_lo, one);
+      r_hi = _mm_add_epi16(r_hi, one);
+      r_lo = _mm_srli_epi16(_mm_add_epi16(r_lo, _mm_srli_epi16(r_lo, 8)), 8);
+      r_hi = _mm_srli_epi16(_mm_add_epi16(r_hi, _mm_srli_epi16(r_hi, 8)), 8);
+
+      /* Add s for the ALLEGRO_ONE components. */
+      d = _mm_packus_epi16(r_lo, r_hi);
+      d = _mm_adds_epu8(d, _mm_and_si128(s, by_one));
+      d = _mm_or_si128(d, dst_x);
+      _mm_storeu_si128((__m128i *)(dst + i), d);
+   }
+
+   return i;
+}
+#endif
+
+
+/* Whether two layouts have their color and fourth components in the same
+ * place.
+ */
+static bool layout_matches(const PIXEL_LAYOUT *l1, const PIXEL_LAYOUT *l2)
+{
+   return l1->r == l2->r && l1->g == l2->g && l1->b == l2->b &&
+      l1->a == l2->a;
+}
+
+
+static void blend_rows(const uint8_t *src, int src_pitch,
+   uint8_t *dst, int dst_pitch, int w, int h,
+   PIXEL_LAYOUT sl, PIXEL_LAYOUT dl, bool color_by_alpha,
+   bool alpha_by_alpha, const int *tint)
+{
+   static const PIXEL_LAYOUT argb = {16, 8, 0, 24, true};
+   static const PIXEL_LAYOUT abgr = {0, 8, 16, 24, true};
+   bool matches = layout_matches(&sl, &dl);
+   bool same = matches && sl.has_alpha && dl.has_alpha;
+   int y;
+
+   for (y = 0; y < h; y++) {
+      const uint32_t *s = (const uint32_t *)(src + y * src_pitch);
+      uint32_t *d = (uint32_t *)(dst + y * dst_pitch);
+      int done = 0;
+
+#ifdef MEMBLIT_SSE2
+      if (matches) {
+         done = blend_span_sse2(s, d, w, sl, dl, color_by_alpha,
+            alpha_by_alpha, tint);
+      }
+#endif
+
+      /* Spell out the layouts most bitmaps use so the compiler can turn
+       * the shifts into constants.
+       */
+      if (same && layout_matches(&sl, &argb)) {
+         blend_span(s + done, d + done, w - done, argb, argb,
+            color_by_alpha, alpha_by_alpha, tint);
+      }
+      else if (same && layout_matches(&sl, &abgr)) {
+         blend_span(s + done, d + done, w - done, abgr, abgr,
+            color_by_alpha, alpha_by_alpha, tint);
+      }
+      else {
+         blend_span(s + done, d + done, w - done, sl, dl,
+            color_by_alpha, alpha_by_alpha, tint);
+      }
+   }
+}
+
+
+/* Whether _al_draw_bitmap_region_memory_blend handles the current blender,
+ * the tint and the pixel formats involved.
+ */
+static bool can_draw_bitmap_region_memory_blend(ALLEGRO_BITMAP *bitmap,
+   ALLEGRO_COLOR tint)
+{
+   int op, src_mode, dst_mode;
+   int op_alpha, src_alpha, dst_alpha;
+   PIXEL_LAYOUT l;
+
+   al_get_separate_blender(&op, &src_mode, &dst_mode,
+      &op_alpha, &src_alpha, &dst_alpha);
+
+   if (op != ALLEGRO_ADD || op_alpha != ALLEGRO_ADD ||
+         dst_mode != ALLEGRO_INVERSE_ALPHA ||
+         dst_alpha != ALLEGRO_INVERSE_ALPHA ||
+         (src_mode != ALLEGRO_ONE && src_mode != ALLEGRO_ALPHA) ||
+         (src_alpha != ALLEGRO_ONE && src_alpha != ALLEGRO_ALPHA)) {
+      return false;
+   }
+
+   /* Tints outside of [0, 1] would need the clamping of the float path. */
+   if (tint.r < 0 || tint.r > 1 || tint.g < 0 || tint.g > 1 ||
+         tint.b < 0 || tint.b > 1 || tint.a < 0 || tint.a > 1) {
+      return false;
+   }
+
+   return get_pixel_layout(al_get_bitmap_format(bitmap), &l) &&
+      get_pixel_layout(al_get_bitmap_format(al_get_target_bitmap()), &l);
+}
+
+
+/* Draws an untransformed bitmap region with the usual alpha blenders
+ * (premultiplied or not, optionally tinted) without going through the
+ * triangle rasteriser.
+ */
+static void _al_draw_bitmap_region_memory_blend(ALLEGRO_BITMAP *bitmap,
+   ALLEGRO_COLOR tint,
+   int sx, int sy, int sw, int sh,
+   int dx, int dy)
+{
+   ALLEGRO_LOCKED_REGION *src_region;
+   ALLEGRO_LOCKED_REGION *dst_region;
+   ALLEGRO_BITMAP *dest = al_get_target_bitmap();
+   int op, src_mode, dst_mode;
+   int op_alpha, src_alpha, dst_alpha;
+   PIXEL_LAYOUT sl, dl;
+   int tint_fixed[4];
+   bool white;
+   int dw = sw, dh = sh;
+
+   ASSERT(bitmap->parent == NULL);
+
+   al_get_separate_blender(&op, &src_mode, &dst_mode,
+      &op_alpha, &src_alpha, &dst_alpha);
+   get_pixel_layout(al_get_bitmap_format(bitmap), &sl);
+   get_pixel_layout(al_get_bitmap_format(dest), &dl);
+
+   white = (tint.r == 1 && tint.g == 1 && tint.b == 1 && tint.a == 1);
+   tint_fixed[0] = (int)(tint.r * 256 + 0.5f);
+   tint_fixed[1] = (int)(tint.g * 256 + 0.5f);
+   tint_fixed[2] = (int)(tint.b * 256 + 0.5f);
+   tint_fixed[3] = (int)(tint.a * 256 + 0.5f);
+
+   CLIPPER(bitmap, sx, sy, sw, sh, dest, dx, dy, dw, dh, 1, 1, 0)
+
+   /* Lock in the bitmap formats, which the layouts were made for. */
+   if (!(src_region = al_lock_bitmap_region(bitmap, sx, sy, sw, sh,
+         al_get_bitmap_format(bitmap), ALLEGRO_LOCK_READONLY))) {
+      return;
+   }
+
+   if (!(dst_region = al_lock_bitmap_region(dest, dx, dy, sw, sh,
+         al_get_bitmap_format(dest), ALLEGRO_LOCK_READWRITE))) {
+      al_unlock_bitmap(bitmap);
+      return;
+   }
+
+   blend_rows(src_region->data, src_region->pitch,
+      dst_region->data, dst_region->pitch, sw, sh, sl, dl,
+      src_mode == ALLEGRO_ALPHA, src_alpha == ALLEGRO_ALPHA,
+      white ? NULL : tint_fixed);
+
+   al_unlock_bitmap(bitmap);
+   al_unlock_bitmap(dest);
+}
+
+
 /* vim: set sts=3 sw=3 et: */
@@ -506,6 +506,147 @@ static void ogl_flush_vertex_cache(ALLEGRO_DISPLAY *disp)
    }
 }
 
+/* Returns the bitmap whose texture a quad is drawn from, and the position
+ * of the region in it, or NULL if the quad can't go into the vertex cache
+ * as it is.
+ */
+static ALLEGRO_BITMAP *get_quad_texture(const _AL_BITMAP_QUAD *q,
+   ALLEGRO_BITMAP *target, float *sx, float *sy)
+{
+   ALLEGRO_BITMAP *bitmap = q->bitmap;
+   ALLEGRO_BITMAP_EXTRA_OPENGL *ogl_bitmap;
+
+   *sx = q->sx;
+   *sy = q->sy;
+   if (bitmap->parent) {
+      *sx += bitmap->xofs;
+      *sy += bitmap->yofs;
+      bitmap = bitmap->parent;
+   }
+
+   if ((al_get_bitmap_flags(bitmap) & ALLEGRO_MEMORY_BITMAP) ||
+         !al_is_compatible_bitmap(bitmap) || bitmap->locked ||
+         bitmap == target)
+      return NULL;
+
+   ogl_bitmap = bitmap->extra;
+   if (ogl_bitmap->is_backbuffer)
+      return NULL;
+
+   /* Regions sticking out of the bitmap would have to be clipped. */
+   if (*sx < 0 || *sy < 0 || *sx + q->sw > bitmap->w ||
+         *sy + q->sh > bitmap->h)
+      return NULL;
+
+   return bitmap;
+}
+
+static ALLEGRO_BITMAP_EXTRA_OPENGL *quad_extra(const _AL_BITMAP_QUAD *q)
+{
+   if (q->bitmap->parent)
+      return q->bitmap->parent->extra;
+   return q->bitmap->extra;
+}
+
+/* Adds all the quads to the vertex cache, with one pass of the current
+ * transformation over them and one flush whenever the texture changes.
+ * Drawing is held by the caller.
+ */
+static bool ogl_draw_bitmap_quads(ALLEGRO_DISPLAY *disp,
+   const _AL_BITMAP_QUAD *quads, int num_quads)
+{
+   ALLEGRO_BITMAP *target = al_get_target_bitmap();
+   const ALLEGRO_TRANSFORM *trans = al_get_current_transform();
+   float m00 = trans->m[0][0], m10 = trans->m[1][0], m30 = trans->m[3][0];
+   float m01 = trans->m[0][1], m11 = trans->m[1][1], m31 = trans->m[3][1];
+   int i, j;
+   ASSERT(disp->cache_enabled);
+
+   if (target->parent)
+      target = target->parent;
+
+   if (target->locked || disp->ogl_extras->opengl_target != target)
+      return false;
+
+   for (i = 0; i < num_quads; i++) {
+      float sx, sy;
+      if (!get_quad_texture(&quads[i], target, &sx, &sy))
+         return false;
+   }
+
+   if (!_al_opengl_set_blender(disp))
+      return false;
+
+   i = 0;
+   while (i < num_quads) {
+      ALLEGRO_BITMAP_EXTRA_OPENGL *ogl_bitmap;
+      ALLEGRO_OGL_BITMAP_VERTEX *verts;
+      int run;
+
+      ogl_bitmap = quad_extra(&quads[i]);
+
+      /* Find how many of the following quads use the same texture. */
+      for (run = 1; i + run < num_quads; run++) {
+         if (quad_extra(&quads[i + run])->texture != ogl_bitmap->texture)
+            break;
+      }
+
+      if (disp->num_cache_vertices != 0 &&
+            ogl_bitmap->texture != disp->cache_texture) {
+         disp->vt->flush_vertex_cache(disp);
+      }
+      disp->cache_texture = ogl_bitmap->texture;
+
+      verts = ogl_prepare_vertex_cache(disp, run * 6);
+
+      for (j = 0; j < run; j++, i++, verts += 6) {
+         const _AL_BITMAP_QUAD *q = &quads[i];
+         float sx, sy;
+         ALLEGRO_BITMAP *bitmap = get_quad_texture(q, target, &sx, &sy);
+         float true_w = ogl_bitmap->true_w;
+         float true_h = ogl_bitmap->true_h;
+         float tex_l = ogl_bitmap->left + sx / true_w;
+         float tex_t = ogl_bitmap->top - sy / true_h;
+         float tex_r = ogl_bitmap->right - (bitmap->w - sx - q->sw) / true_w;
+         float tex_b = ogl_bitmap->bottom + (bitmap->h - sy - q->sh) / true_h;
+         float x1 = q->dx, y1 = q->dy;
+         float x2 = q->dx + q->sw, y2 = q->dy + q->sh;
+         int k;
+
+         verts[0].x = x1 * m00 + y2 * m10 + m30;
+         verts[0].y = x1 * m01 + y2 * m11 + m31;
+         verts[0].tx = tex_l;
+         verts[0].ty = tex_b;
+
+         verts[1].x = x1 * m00 + y1 * m10 + m30;
+         verts[1].y = x1 * m01 + y1 * m11 + m31;
+         verts[1].tx = tex_l;
+         verts[1].ty = tex_t;
+
+         verts[2].x = x2 * m00 + y2 * m10 + m30;
+         verts[2].y = x2 * m01 + y2 * m11 + m31;
+         verts[2].tx = tex_r;
+         verts[2].ty = tex_b;
+
+         verts[4].x = x2 * m00 + y1 * m10 + m30;
+         verts[4].y = x2 * m01 + y1 * m11 + m31;
+         verts[4].tx = tex_r;
+         verts[4].ty = tex_t;
+
+         for (k = 0; k < 5; k++) {
+            verts[k].r = q->tint.r;
+            verts[k].g = q->tint.g;
+            verts[k].b = q->tint.b;
+            verts[k].a = q->tint.a;
+         }
+         verts[3] = verts[1];
+         verts[5] = verts[2];
+      }
+   }
+
+   return true;
+}
+
 static void ogl_update_transformation(ALLEGRO_DISPLAY* disp,
    ALLEGRO_BITMAP *target)
 {
@@ -566,6 +707,7 @@ void _al_ogl_add_drawing_functions(ALLEGRO_DISPLAY_INTERFACE *vt)
    vt->flush_vertex_cache = ogl_flush_vertex_cache;
    vt->prepare_vertex_cache = ogl_prepare_vertex_cache;
    vt->update_transformation = ogl_update_transformation;
+   vt->draw_bitmap_quads = ogl_draw_bitmap_quads;
 }
 
 /* vim: set sts=3 sw=3 et: */
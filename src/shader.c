@@ -501,4 +501,104 @@ fail:
    return NULL;
 }
 
+/* Builds one of the shaders the display keeps next to its default shader.
+ * Returns NULL if it doesn't compile.
+ */
+static ALLEGRO_SHADER *build_builtin_shader(ALLEGRO_SHADER_PLATFORM platform,
+   char const *vertex_source, char const *pixel_source, char const *name)
+{
+   ALLEGRO_SHADER *shader;
+
+   _al_push_destructor_owner();
+   shader = al_create_shader(platform);
+   _al_pop_destructor_owner();
+   if (!shader)
+      return NULL;
+
+   if (!al_attach_shader_source(shader, ALLEGRO_VERTEX_SHADER, vertex_source) ||
+       !al_attach_shader_source(shader, ALLEGRO_PIXEL_SHADER, pixel_source) ||
+       !al_build_shader(shader)) {
+      ALLEGRO_ERROR("Building the %s shader failed: %s\n", name,
+         al_get_shader_log(shader));
+      al_destroy_shader(shader);
+      return NULL;
+   }
+
+   return shader;
+}
+
+/* Internal function: _al_get_sdf_shader
+ *  Returns the shader for drawing signed distance field glyphs on the
+ *  display, building it the first time. Returns NULL if the display
+ *  can't use it.
+ */
+ALLEGRO_SHADER *_al_get_sdf_shader(ALLEGRO_DISPLAY *display)
+{
+   ALLEGRO_SHADER_PLATFORM platform = ALLEGRO_SHADER_AUTO;
+   char const *pixel_source = NULL;
+   ASSERT(display);
+
+   if (display->sdf_shader || display->sdf_shader_failed)
+      return display->sdf_shader;
+
+   if (!(display->flags & ALLEGRO_PROGRAMMABLE_PIPELINE))
+      return NULL;
+
+   if (false) {
+   }
+#ifdef ALLEGRO_CFG_SHADER_GLSL
+   else if (display->flags & ALLEGRO_OPENGL) {
+      platform = ALLEGRO_SHADER_GLSL;
+      pixel_source = sdf_glsl_pixel_source;
+   }
+#endif
+#ifdef ALLEGRO_CFG_SHADER_HLSL
+   else if (display->flags & ALLEGRO_DIRECT3D_INTERNAL) {
+      platform = ALLEGRO_SHADER_HLSL;
+      pixel_source = sdf_hlsl_pixel_source;
+   }
+#endif
+
+   display->sdf_shader_failed = true;
+   if (!pixel_source)
+      return NULL;
+
+   display->sdf_shader = build_builtin_shader(platform,
+      al_get_default_shader_source(platform, ALLEGRO_VERTEX_SHADER),
+      pixel_source, "SDF");
+   display->sdf_shader_failed = (display->sdf_shader == NULL);
+   return display->sdf_shader;
+}
+
+/* Internal function: _al_get_instancing_shader
+ *  Returns the shader for drawing instances of a vertex buffer with the
+ *  per-instance attributes _AL_SHADER_VAR_INSTANCE_*, building it the
+ *  first time. Only OpenGL displays have one.
+ */
+ALLEGRO_SHADER *_al_get_instancing_shader(ALLEGRO_DISPLAY *display)
+{
+   ASSERT(display);
+
+   if (display->instancing_shader || display->instancing_shader_failed)
+      return display->instancing_shader;
+
+   if (!(display->flags & ALLEGRO_PROGRAMMABLE_PIPELINE))
+      return NULL;
+
+   display->instancing_shader_failed = true;
+#ifdef ALLEGRO_CFG_SHADER_GLSL
+   if (display->flags & ALLEGRO_OPENGL) {
+      display->instancing_shader = build_builtin_shader(ALLEGRO_SHADER_GLSL,
+         instancing_glsl_vertex_source,
+         al_get_default_shader_source(ALLEGRO_SHADER_GLSL,
+            ALLEGRO_PIXEL_SHADER),
+         "instancing");
+      display->instancing_shader_failed =
+         (display->instancing_shader == NULL);
+   }
+#endif
+   return display->instancing_shader;
+}
+
+
 /* vim: set sts=3 sw=3 et: */
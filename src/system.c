@@ -34,7 +34,9 @@
 #include "allegro5/internal/aintern_thread.h"
 #include "allegro5/internal/aintern_timer.h"
 #include "allegro5/internal/aintern_tls.h"
+#include "allegro5/internal/aintern_tri_soft.h"
 #include "allegro5/internal/aintern_vector.h"
+#include "allegro5/internal/aintern_workers.h"
 
 ALLEGRO_DEBUG_CHANNEL("system")
 
@@ -263,12 +265,18 @@ bool al_install_system(int version, int (*atexit_ptr)(void (*)(void)))
 
    _al_init_pixels();
 
+   _al_init_convert_funcs();
+
    _al_init_iio_table();
    
    _al_init_convert_bitmap_list();
 
    _al_init_timers();
 
+   _al_init_threaded_rasterizer();
+
+   _al_init_workers();
+
 #ifdef ALLEGRO_CFG_SHADER_GLSL
    _al_glsl_init_shaders();
 #endif
@@ -26,6 +26,8 @@
 #include "allegro5/internal/aintern_system.h"
 #include "allegro5/internal/aintern_timer.h"
 
+ALLEGRO_DEBUG_CHANNEL("timer")
+
 #ifndef ALLEGRO_MSVC
 #ifndef ALLEGRO_BCC32
    #include <sys/time.h>
@@ -34,8 +36,8 @@
 
 
 /* forward declarations */
-static double timer_thread_handle_tick(double interval);
-static void timer_handle_tick(ALLEGRO_TIMER *timer);
+static double timer_thread_handle_tick(double now);
+static void timer_handle_tick(ALLEGRO_TIMER *timer, double now);
 
 
 struct ALLEGRO_TIMER
@@ -44,18 +46,138 @@ struct ALLEGRO_TIMER
    bool started;
    double speed_secs;
    int64_t count;
-   double counter;		/* counts down to zero=blastoff */
+   double counter;		/* time left to the next tick, while stopped */
+   double deadline;		/* time of the next tick, while started */
+   unsigned int heap_index;	/* position in active_timers, while started */
 };
 
 
 
 /*
  * The timer thread that runs in the background to drive the timers.
+ *
+ * The started timers are kept in a binary min-heap ordered by their next
+ * deadline, so the timer thread only looks at the timers which are due
+ * and otherwise sleeps until the earliest deadline. Every timer due by the
+ * time the thread wakes up, or within the coalescing window after that, is
+ * handled in the same wakeup.
  */
 
 static _AL_MUTEX timers_mutex = _AL_MUTEX_UNINITED;
+static _AL_COND timers_cond;
 static _AL_VECTOR active_timers = _AL_VECTOR_INITIALIZER(ALLEGRO_TIMER *);
 static _AL_THREAD * volatile timer_thread = NULL;
+static double coalescing_window = 0.0;
+
+
+
+static ALLEGRO_TIMER *heap_get(unsigned int i)
+{
+   ALLEGRO_TIMER **slot = _al_vector_ref(&active_timers, i);
+   return *slot;
+}
+
+
+
+static void heap_set(unsigned int i, ALLEGRO_TIMER *timer)
+{
+   ALLEGRO_TIMER **slot = _al_vector_ref(&active_timers, i);
+   *slot = timer;
+   timer->heap_index = i;
+}
+
+
+
+/* heap_sift_up:
+ *  Move the timer at position i towards the top of the heap until its
+ *  parent is due no later than it is.
+ */
+static void heap_sift_up(unsigned int i)
+{
+   ALLEGRO_TIMER *timer = heap_get(i);
+
+   while (i > 0) {
+      unsigned int parent = (i - 1) / 2;
+      ALLEGRO_TIMER *parent_timer = heap_get(parent);
+      if (parent_timer->deadline <= timer->deadline)
+         break;
+      heap_set(i, parent_timer);
+      i = parent;
+   }
+
+   heap_set(i, timer);
+}
+
+
+
+/* heap_sift_down:
+ *  Move the timer at position i towards the bottom of the heap until its
+ *  children are due no earlier than it is.
+ */
+static void heap_sift_down(unsigned int i)
+{
+   const unsigned int size = _al_vector_size(&active_timers);
+   ALLEGRO_TIMER *timer = heap_get(i);
+
+   for (;;) {
+      unsigned int child = 2 * i + 1;
+      ALLEGRO_TIMER *child_timer;
+
+      if (child >= size)
+         break;
+      child_timer = heap_get(child);
+      if (child + 1 < size && heap_get(child + 1)->deadline < child_timer->deadline) {
+         child++;
+         child_timer = heap_get(child);
+      }
+      if (timer->deadline <= child_timer->deadline)
+         break;
+      heap_set(i, child_timer);
+      i = child;
+   }
+
+   heap_set(i, timer);
+}
+
+
+
+/* heap_update:
+ *  Restore the heap order after the deadline of a timer changed.
+ */
+static void heap_update(ALLEGRO_TIMER *timer)
+{
+   heap_sift_up(timer->heap_index);
+   heap_sift_down(timer->heap_index);
+}
+
+
+
+static void heap_insert(ALLEGRO_TIMER *timer)
+{
+   ALLEGRO_TIMER **slot = _al_vector_alloc_back(&active_timers);
+   *slot = timer;
+   timer->heap_index = _al_vector_size(&active_timers) - 1;
+   heap_sift_up(timer->heap_index);
+}
+
+
+
+static void heap_remove(ALLEGRO_TIMER *timer)
+{
+   const unsigned int last = _al_vector_size(&active_timers) - 1;
+   const unsigned int i = timer->heap_index;
+
+   ASSERT(heap_get(i) == timer);
+
+   if (i != last) {
+      heap_set(i, heap_get(last));
+      _al_vector_delete_at(&active_timers, last);
+      heap_update(heap_get(i));
+   }
+   else {
+      _al_vector_delete_at(&active_timers, last);
+   }
+}
 
 
 
@@ -94,57 +216,55 @@ static void timer_thread_proc(_AL_THREAD *self, void *unused)
    }
 #endif
 
-   double old_time = al_get_time();
-   double new_time;
-   double interval = 0.032768;
+   ALLEGRO_TIMEOUT timeout;
+   double delay;
 
-   while (!_al_get_thread_should_stop(self)) {
-      al_rest(interval);
-
-      _al_mutex_lock(&timers_mutex);
-      {
-         /* Calculate actual time elapsed.  */
-         new_time = al_get_time();
-         interval = new_time - old_time;
-         old_time = new_time;
+   _al_mutex_lock(&timers_mutex);
 
-         /* Handle a tick.  */
-         interval = timer_thread_handle_tick(interval);
+   while (!_al_get_thread_should_stop(self)) {
+      /* Handle the timers which are due. */
+      delay = timer_thread_handle_tick(al_get_time());
+
+      /* Sleep until the next deadline, or until a timer is started or
+       * changed, or the thread is asked to stop.
+       */
+      if (delay > 0) {
+         al_init_timeout(&timeout, delay);
+         _al_cond_timedwait(&timers_cond, &timers_mutex, &timeout);
       }
-      _al_mutex_unlock(&timers_mutex);
    }
 
+   _al_mutex_unlock(&timers_mutex);
+
    (void)unused;
 }
 
 
 
 /* timer_thread_handle_tick: [timer thread]
- *  Call handle_tick() method of every timer in active_timers, and
- *  returns the duration that the timer thread should try to sleep
- *  next time.
+ *  Call timer_handle_tick() for every tick of the active timers which is
+ *  due at the time now, and returns the duration that the timer thread
+ *  should try to sleep next time.
  */
-static double timer_thread_handle_tick(double interval)
+static double timer_thread_handle_tick(double now)
 {
-   double new_delay = 0.032768;
-   unsigned int i;
+   const double limit = now + coalescing_window;
+   ALLEGRO_TIMER *timer;
 
-   for (i = 0; i < _al_vector_size(&active_timers); i++) {
-      ALLEGRO_TIMER **slot = _al_vector_ref(&active_timers, i);
-      ALLEGRO_TIMER *timer = *slot;
+   while (_al_vector_size(&active_timers) > 0) {
+      timer = heap_get(0);
+      if (timer->deadline > limit)
+         return timer->deadline - now;
 
-      timer->counter -= interval;
-
-      while (timer->counter <= 0) {
-         timer_handle_tick(timer);
-         timer->counter += timer->speed_secs;
+      while (timer->deadline <= limit) {
+         timer_handle_tick(timer, now);
+         timer->deadline += timer->speed_secs;
       }
 
-      if ((timer->counter > 0) && (timer->counter < new_delay))
-         new_delay = timer->counter;
+      heap_sift_down(0);
    }
 
-   return new_delay;
+   return 0.032768;
 }
 
 
@@ -154,11 +274,48 @@ static void shutdown_timers(void)
    ASSERT(_al_vector_size(&active_timers) == 0);
    ASSERT(timer_thread == NULL);
 
+   _al_cond_destroy(&timers_cond);
    _al_mutex_destroy(&timers_mutex);
 }
 
 
 
+/* wake_timer_thread:
+ *  Make the timer thread look at the timers again. Must be called with
+ *  timers_mutex held.
+ */
+static void wake_timer_thread(void)
+{
+   _al_cond_broadcast(&timers_cond);
+}
+
+
+
+/* get_coalescing_window:
+ *  Read how long after a timer is due the timer thread may handle other
+ *  timers early, so that their ticks share a wakeup.
+ */
+static double get_coalescing_window(void)
+{
+   const char *value = al_get_config_value(al_get_system_config(),
+      "timer", "coalescing_window");
+   double window;
+
+   if (!value)
+      return 0.0;
+
+   window = atof(value);
+   if (window < 0.0 || window > 0.1) {
+      ALLEGRO_WARN("Invalid timer coalescing window: %s\n", value);
+      return 0.0;
+   }
+
+   ALLEGRO_DEBUG("Timer coalescing window: %f\n", window);
+   return window;
+}
+
+
+
 // logic common to al_start_timer and al_resume_timer
 // al_start_timer : passes reset_counter = true to start from the beginning
 // al_resume_timer: passes reset_counter = false to preserve the previous time
@@ -173,21 +330,23 @@ static void enable_timer(ALLEGRO_TIMER *timer, bool reset_counter)
 
       _al_mutex_lock(&timers_mutex);
       {
-         ALLEGRO_TIMER **slot;
-
          timer->started = true;
 
          if (reset_counter)
             timer->counter = timer->speed_secs;
 
-         slot = _al_vector_alloc_back(&active_timers);
-         *slot = timer;
+         timer->deadline = al_get_time() + timer->counter;
+         heap_insert(timer);
 
          new_size = _al_vector_size(&active_timers);
+
+         if (new_size > 1 && timer->heap_index == 0)
+            wake_timer_thread();
       }
       _al_mutex_unlock(&timers_mutex);
 
       if (new_size == 1) {
+         coalescing_window = get_coalescing_window();
          timer_thread = al_malloc(sizeof(_AL_THREAD));
          _al_thread_create(timer_thread, timer_thread_proc, NULL);
       }
@@ -199,6 +358,7 @@ static void enable_timer(ALLEGRO_TIMER *timer, bool reset_counter)
 void _al_init_timers(void)
 {
    _al_mutex_init(&timers_mutex);
+   _al_cond_init(&timers_cond);
    _al_add_exit_func(shutdown_timers, "shutdown_timers");
 }
 
@@ -289,8 +449,9 @@ void al_stop_timer(ALLEGRO_TIMER *timer)
 
       _al_mutex_lock(&timers_mutex);
       {
-         _al_vector_find_and_delete(&active_timers, &timer);
+         heap_remove(timer);
          timer->started = false;
+         timer->counter = timer->deadline - al_get_time();
 
          if (_al_vector_size(&active_timers) == 0) {
             _al_vector_free(&active_timers);
@@ -301,6 +462,10 @@ void al_stop_timer(ALLEGRO_TIMER *timer)
       _al_mutex_unlock(&timers_mutex);
 
       if (thread_to_join) {
+         _al_thread_set_should_stop(thread_to_join);
+         _al_mutex_lock(&timers_mutex);
+         wake_timer_thread();
+         _al_mutex_unlock(&timers_mutex);
          _al_thread_join(thread_to_join);
          al_free(thread_to_join);
       }
@@ -341,8 +506,11 @@ void al_set_timer_speed(ALLEGRO_TIMER *timer, double new_speed_secs)
    _al_mutex_lock(&timers_mutex);
    {
       if (timer->started) {
-         timer->counter -= timer->speed_secs;
-         timer->counter += new_speed_secs;
+         timer->deadline -= timer->speed_secs;
+         timer->deadline += new_speed_secs;
+         heap_update(timer);
+         if (timer->heap_index == 0)
+            wake_timer_thread();
       }
 
       timer->speed_secs = new_speed_secs;
@@ -394,9 +562,9 @@ void al_add_timer_count(ALLEGRO_TIMER *timer, int64_t diff)
 
 
 /* timer_handle_tick: [timer thread]
- *  Handle a single tick.
+ *  Handle a single tick, which the timer thread noticed at the time now.
  */
-static void timer_handle_tick(ALLEGRO_TIMER *timer)
+static void timer_handle_tick(ALLEGRO_TIMER *timer, double now)
 {
    /* Lock out event source helper functions (e.g. the release hook
     * could be invoked simultaneously with this function).
@@ -412,7 +580,7 @@ static void timer_handle_tick(ALLEGRO_TIMER *timer)
          event.timer.type = ALLEGRO_EVENT_TIMER;
          event.timer.timestamp = al_get_time();
          event.timer.count = timer->count;
-         event.timer.error = -timer->counter;
+         event.timer.error = now - timer->deadline;
          _al_event_source_emit_event(&timer->es, &event);
       }
    }
@@ -21,9 +21,14 @@
 #include "allegro5/internal/aintern.h"
 #include "allegro5/internal/aintern_bitmap.h"
 #include "allegro5/internal/aintern_blend.h"
+#include "allegro5/internal/aintern_exitfunc.h"
 #include "allegro5/internal/aintern_pixels.h"
+#include "allegro5/internal/aintern_thread.h"
 #include "allegro5/internal/aintern_tri_soft.h"
+#include <limits.h>
 #include <math.h>
+#include <stdlib.h>
+#include <string.h>
 
 ALLEGRO_DEBUG_CHANNEL("tri_soft")
 
@@ -38,12 +43,24 @@ typedef void (*shader_step)(uintptr_t, int);
 typedef struct {
    ALLEGRO_BITMAP *target;
    ALLEGRO_COLOR cur_color;
+   _AL_BLENDER blender;
 } state_solid_any_2d;
 
+/* Resolves the blender for the locked target, once per triangle instead of
+ * once per pixel.
+ */
+static void init_blender(_AL_BLENDER *blender, ALLEGRO_BITMAP *target)
+{
+   if (target->parent)
+      target = target->parent;
+   _al_init_blender(blender, target->locked_region.format);
+}
+
 static void shader_solid_any_init(uintptr_t state, ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX* v2, ALLEGRO_VERTEX* v3)
 {
    state_solid_any_2d* s = (state_solid_any_2d*)state;
    s->target = al_get_target_bitmap();
+   init_blender(&s->blender, s->target);
    s->cur_color = v1->color;
 
    (void)v2;
@@ -132,6 +149,7 @@ static void shader_grad_any_init(uintptr_t state, ALLEGRO_VERTEX* v1, ALLEGRO_VE
    state_grad_any_2d* s = (state_grad_any_2d*)state;
 
    s->solid.target = al_get_target_bitmap();
+   init_blender(&s->solid.blender, s->solid.target);
    
    s->off_x = v1->x - 0.5f;
    s->off_y = v1->y + 0.5f;
@@ -223,6 +241,8 @@ typedef struct {
 
    ALLEGRO_BITMAP* texture;
    int w, h;
+
+   _AL_BLENDER blender;
 } state_texture_solid_any_2d;
 
 static void shader_texture_solid_any_init(uintptr_t state, ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX* v2, ALLEGRO_VERTEX* v3)
@@ -236,6 +256,7 @@ static void shader_texture_solid_any_init(uintptr_t state, ALLEGRO_VERTEX* v1, A
 
    s->target = al_get_target_bitmap();
    s->cur_color = v1->color;
+   init_blender(&s->blender, s->target);
 
    s->off_x = v1->x - 0.5f;
    s->off_y = v1->y + 0.5f;
@@ -321,6 +342,7 @@ static void shader_texture_grad_any_init(uintptr_t state, ALLEGRO_VERTEX* v1, AL
    state_texture_grad_any_2d* s = (state_texture_grad_any_2d*)state;
    
    s->solid.target = al_get_target_bitmap();
+   init_blender(&s->solid.blender, s->solid.target);
    s->solid.w = al_get_bitmap_width(s->solid.texture);
    s->solid.h = al_get_bitmap_height(s->solid.texture);
 
@@ -408,9 +430,13 @@ static void shader_texture_grad_any_step(uintptr_t state, int minor)
 #include "scanline_drawers.inc"
 
 
+/*
+Scanlines from max_y downwards are not visited. init may be NULL if the state has
+already been initialized.
+*/
 static void triangle_stepper(uintptr_t state,
    shader_init init, shader_first first, shader_step step, shader_draw draw,
-   ALLEGRO_VERTEX* vtx1, ALLEGRO_VERTEX* vtx2, ALLEGRO_VERTEX* vtx3)
+   ALLEGRO_VERTEX* vtx1, ALLEGRO_VERTEX* vtx2, ALLEGRO_VERTEX* vtx3, int max_y)
 {
    float Coords[6] = {vtx1->x - 0.5f, vtx1->y + 0.5f, vtx2->x - 0.5f, vtx2->y + 0.5f, vtx3->x - 0.5f, vtx3->y + 0.5f};
    float *V1 = Coords, *V2 = &Coords[2], *V3 = &Coords[4], *s;
@@ -487,7 +513,13 @@ static void triangle_stepper(uintptr_t state,
    else
       major_on_the_left = 0;
 
-   init(state, vtx1, vtx2, vtx3);
+   if (init)
+      init(state, vtx1, vtx2, vtx3);
+
+   if (end_y > max_y)
+      end_y = max_y;
+   if (mid_y > end_y)
+      mid_y = end_y;
 
    /*
    Do the first segment, if it exists
@@ -683,26 +715,78 @@ static void triangle_stepper(uintptr_t state,
    }
 }
 
+/*
+The state of any of the shaders, so that triangles can be set up ahead of
+drawing them (see the threaded rasterizer below)
+*/
+typedef union {
+   state_solid_any_2d solid;
+   state_grad_any_2d grad;
+   state_texture_solid_any_2d texture_solid;
+   state_texture_grad_any_2d texture_grad;
+} state_any_2d;
+
+enum {
+   STATE_SOLID,
+   STATE_GRAD,
+   STATE_TEXTURE_SOLID,
+   STATE_TEXTURE_GRAD
+};
+
+typedef struct {
+   int kind;
+   shader_init init;
+   shader_first first;
+   shader_step step;
+   shader_draw draw;
+} shader_set;
+
+static void set_state_target(state_any_2d* state, int kind, ALLEGRO_BITMAP* target)
+{
+   switch (kind) {
+      case STATE_SOLID:
+         state->solid.target = target;
+         break;
+      case STATE_GRAD:
+         state->grad.solid.target = target;
+         break;
+      case STATE_TEXTURE_SOLID:
+         state->texture_solid.target = target;
+         break;
+      case STATE_TEXTURE_GRAD:
+         state->texture_grad.solid.target = target;
+         break;
+   }
+}
+
+/*
+Returns whether the current blender needs to read the destination
+*/
+static int blender_needs_shading(void)
+{
+   int op, src_mode, dst_mode, op_alpha, src_alpha, dst_alpha;
+
+   al_get_separate_blender(&op, &src_mode, &dst_mode, &op_alpha, &src_alpha, &dst_alpha);
+   if (_AL_DEST_IS_ZERO && _AL_SRC_NOT_MODIFIED) {
+      return 0;
+   }
+   return 1;
+}
+
 /*
 This one will check to see what exactly we need to draw...
-I.e. this will call all of the actual renderers and set the appropriate callbacks
+I.e. this will pick all of the actual renderers and prepare the state for them
 */
-void _al_triangle_2d(ALLEGRO_BITMAP* texture, ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX* v2, ALLEGRO_VERTEX* v3)
+static void choose_shaders(ALLEGRO_BITMAP* texture, int shade, ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX* v2, ALLEGRO_VERTEX* v3,
+   state_any_2d* state, shader_set* set)
 {
-   int shade = 1;
    int grad = 1;
-   int op, src_mode, dst_mode, op_alpha, src_alpha, dst_alpha;
    ALLEGRO_COLOR v1c, v2c, v3c;
 
    v1c = v1->color;
    v2c = v2->color;
    v3c = v3->color;
 
-   al_get_separate_blender(&op, &src_mode, &dst_mode, &op_alpha, &src_alpha, &dst_alpha);
-   if (_AL_DEST_IS_ZERO && _AL_SRC_NOT_MODIFIED) {
-      shade = 0;
-   }
-
    if ((v1c.r == v2c.r && v2c.r == v3c.r) &&
          (v1c.g == v2c.g && v2c.g == v3c.g) &&
          (v1c.b == v2c.b && v2c.b == v3c.b) &&
@@ -712,55 +796,55 @@ void _al_triangle_2d(ALLEGRO_BITMAP* texture, ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX
 
    if (texture) {
       if (grad) {
-         state_texture_grad_any_2d state;
-         state.solid.texture = texture;
-
-         if (shade) {
-            _al_draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_texture_grad_any_init, shader_texture_grad_any_first, shader_texture_grad_any_step, shader_texture_grad_any_draw_shade);
-         } else {
-            _al_draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_texture_grad_any_init, shader_texture_grad_any_first, shader_texture_grad_any_step, shader_texture_grad_any_draw_opaque);
-         }
+         state->texture_grad.solid.texture = texture;
+         set->kind = STATE_TEXTURE_GRAD;
+         set->init = shader_texture_grad_any_init;
+         set->first = shader_texture_grad_any_first;
+         set->step = shader_texture_grad_any_step;
+         set->draw = shade ? shader_texture_grad_any_draw_shade : shader_texture_grad_any_draw_opaque;
       } else {
          int white = 0;
-         state_texture_solid_any_2d state;
 
          if (v1c.r == 1 && v1c.g == 1 && v1c.b == 1 && v1c.a == 1) {
             white = 1;
          }
-         state.texture = texture;
+         state->texture_solid.texture = texture;
+         set->kind = STATE_TEXTURE_SOLID;
+         set->init = shader_texture_solid_any_init;
+         set->first = shader_texture_solid_any_first;
+         set->step = shader_texture_solid_any_step;
          if (shade) {
-            if (white) {
-               _al_draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_texture_solid_any_init, shader_texture_solid_any_first, shader_texture_solid_any_step, shader_texture_solid_any_draw_shade_white);
-            } else {
-               _al_draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_texture_solid_any_init, shader_texture_solid_any_first, shader_texture_solid_any_step, shader_texture_solid_any_draw_shade);
-            }
+            set->draw = white ? shader_texture_solid_any_draw_shade_white : shader_texture_solid_any_draw_shade;
          } else {
-            if (white) {
-               _al_draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_texture_solid_any_init, shader_texture_solid_any_first, shader_texture_solid_any_step, shader_texture_solid_any_draw_opaque_white);
-            } else {
-               _al_draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_texture_solid_any_init, shader_texture_solid_any_first, shader_texture_solid_any_step, shader_texture_solid_any_draw_opaque);
-            }
+            set->draw = white ? shader_texture_solid_any_draw_opaque_white : shader_texture_solid_any_draw_opaque;
          }
       }
    } else {
       if (grad) {
-         state_grad_any_2d state;
-         if (shade) {
-            _al_draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_grad_any_init, shader_grad_any_first, shader_grad_any_step, shader_grad_any_draw_shade);
-         } else {
-            _al_draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_grad_any_init, shader_grad_any_first, shader_grad_any_step, shader_grad_any_draw_opaque);
-         }
+         set->kind = STATE_GRAD;
+         set->init = shader_grad_any_init;
+         set->first = shader_grad_any_first;
+         set->step = shader_grad_any_step;
+         set->draw = shade ? shader_grad_any_draw_shade : shader_grad_any_draw_opaque;
       } else {
-         state_solid_any_2d state;
-         if (shade) {
-            _al_draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_solid_any_init, shader_solid_any_first, shader_solid_any_step, shader_solid_any_draw_shade);
-         } else {
-            _al_draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, shader_solid_any_init, shader_solid_any_first, shader_solid_any_step, shader_solid_any_draw_opaque);
-         }
+         set->kind = STATE_SOLID;
+         set->init = shader_solid_any_init;
+         set->first = shader_solid_any_first;
+         set->step = shader_solid_any_step;
+         set->draw = shade ? shader_solid_any_draw_shade : shader_solid_any_draw_opaque;
       }
    }
 }
 
+void _al_triangle_2d(ALLEGRO_BITMAP* texture, ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX* v2, ALLEGRO_VERTEX* v3)
+{
+   state_any_2d state;
+   shader_set set;
+
+   choose_shaders(texture, blender_needs_shading(), v1, v2, v3, &state, &set);
+   _al_draw_soft_triangle(v1, v2, v3, (uintptr_t)&state, set.init, set.first, set.step, set.draw);
+}
+
 static int bitmap_region_is_locked(ALLEGRO_BITMAP* bmp, int x1, int y1, int w, int h)
 {
    ASSERT(bmp);
@@ -772,6 +856,61 @@ static int bitmap_region_is_locked(ALLEGRO_BITMAP* bmp, int x1, int y1, int w, i
    return 0;
 }
 
+/*
+Computes the region of the target a triangle can touch, clipped to the clipping
+rectangle. Returns 0 if there is nothing to draw.
+*/
+static int triangle_bounds(ALLEGRO_VERTEX* vtx1, ALLEGRO_VERTEX* vtx2, ALLEGRO_VERTEX* vtx3,
+   int clip_min_x, int clip_min_y, int clip_max_x, int clip_max_y,
+   int* min_x, int* min_y, int* max_x, int* max_y)
+{
+   /*
+   The minimum and maximum pixels the rasterizer can touch, with a pixel of
+   margin on each side.
+   */
+   *min_x = (int)floorf(MIN(vtx1->x, MIN(vtx2->x, vtx3->x))) - 1;
+   *min_y = (int)floorf(MIN(vtx1->y, MIN(vtx2->y, vtx3->y))) - 1;
+   *max_x = (int)ceilf(MAX(vtx1->x, MAX(vtx2->x, vtx3->x))) + 1;
+   *max_y = (int)ceilf(MAX(vtx1->y, MAX(vtx2->y, vtx3->y))) + 1;
+
+   if (*min_x >= clip_max_x || *min_y >= clip_max_y)
+      return 0;
+   if (*max_x >= clip_max_x)
+      *max_x = clip_max_x;
+   if (*max_y >= clip_max_y)
+      *max_y = clip_max_y;
+
+   if (*max_x < clip_min_x || *max_y < clip_min_y)
+      return 0;
+   if (*min_x < clip_min_x)
+      *min_x = clip_min_x;
+   if (*min_y < clip_min_y)
+      *min_y = clip_min_y;
+
+   return 1;
+}
+
+/*
+Makes sure the given region of the target is locked. Returns 0 if we can't draw
+to it.
+*/
+static int lock_target_region(ALLEGRO_BITMAP* target, int min_x, int min_y, int max_x, int max_y, int* need_unlock)
+{
+   *need_unlock = 0;
+
+   if (al_is_bitmap_locked(target)) {
+      if (!bitmap_region_is_locked(target, min_x, min_y, max_x - min_x, max_y - min_y) ||
+          _al_pixel_format_is_video_only(target->locked_region.format))
+         return 0;
+   } else {
+      if (!al_lock_bitmap_region(target, min_x, min_y, max_x - min_x, max_y - min_y, ALLEGRO_PIXEL_FORMAT_ANY, 0))
+         return 0;
+      *need_unlock = 1;
+   }
+
+   return 1;
+}
+
 void _al_draw_soft_triangle(
    ALLEGRO_VERTEX* v1, ALLEGRO_VERTEX* v2, ALLEGRO_VERTEX* v3, uintptr_t state,
    void (*init)(uintptr_t, ALLEGRO_VERTEX*, ALLEGRO_VERTEX*, ALLEGRO_VERTEX*),
@@ -782,12 +921,8 @@ void _al_draw_soft_triangle(
    /*
    ALLEGRO_VERTEX copy_v1, copy_v2; <- may be needed for clipping later on
    */
-   ALLEGRO_VERTEX* vtx1 = v1;
-   ALLEGRO_VERTEX* vtx2 = v2;
-   ALLEGRO_VERTEX* vtx3 = v3;
    ALLEGRO_BITMAP *target = al_get_target_bitmap();
-   int need_unlock = 0;
-   ALLEGRO_LOCKED_REGION *lr;
+   int need_unlock;
    int min_x, max_x, min_y, max_y;
    int clip_min_x, clip_min_y, clip_max_x, clip_max_y;
 
@@ -795,53 +930,440 @@ void _al_draw_soft_triangle(
    clip_max_x += clip_min_x;
    clip_max_y += clip_min_y;
 
+   if (!triangle_bounds(v1, v2, v3, clip_min_x, clip_min_y, clip_max_x, clip_max_y,
+         &min_x, &min_y, &max_x, &max_y))
+      return;
+
+   if (!lock_target_region(target, min_x, min_y, max_x, max_y, &need_unlock))
+      return;
+
+   triangle_stepper(state, init, first, step, draw, v1, v2, v3, INT_MAX);
+
+   if (need_unlock)
+      al_unlock_bitmap(target);
+}
+
+/*========================= Threaded Rasterizer ==============================*/
+
+/*
+If enabled in allegro5.cfg, whole batches of triangles are set up on the
+calling thread, binned into horizontal bands of the target and then drawn by a
+pool of worker threads, one band at a time. Every band is drawn by a single
+thread, in submission order, with the lock of the target restricted to the
+band. The drawers only ever clip scanlines at the band edges, which doesn't
+change how the remaining ones are interpolated, so the result is the same as
+that of _al_triangle_2d for any number of threads.
+*/
+
+#define MAX_RASTER_THREADS    64
+#define RASTER_CHUNK_SIZE     4096
+#define MIN_THREADED_TRIANGLES   2
+
+typedef struct {
+   state_any_2d state;
+   shader_set set;
+   ALLEGRO_VERTEX vtx[3];
+   /*
+   Range of bands covered, empty if band1 < band0
+   */
+   int band0, band1;
+} raster_triangle;
+
+typedef struct {
+   ALLEGRO_BITMAP* target;
+   ALLEGRO_BITMAP* root;
+
+   /*
+   The part of the locked region of root we draw to, split into bands
+   */
+   int area_x, area_y, area_w, area_h;
+   int band_height;
+   int num_bands;
+
+   raster_triangle* triangles;
+   int* bin_start;
+   int* bins;
+
+   int next_band;
+} raster_job;
+
+static struct {
+   _AL_MUTEX mutex;
+   _AL_COND work_cond;
+   _AL_COND done_cond;
+   _AL_THREAD threads[MAX_RASTER_THREADS];
+   int num_threads;
+   bool quit;
+
+   /*
+   Incremented every time a job is posted, busy counts the workers which still
+   have to finish it
+   */
+   unsigned int generation;
+   int busy;
+   raster_job* job;
+} raster_pool;
+
+/* Number of threads drawing triangles, including the calling thread. */
+static int raster_threads;
+static int band_height;
+
+/*
+Draws all triangles binned to a band
+*/
+static void draw_band(raster_job* job, int band)
+{
+   ALLEGRO_BITMAP* root = job->root;
+   ALLEGRO_BITMAP root_view;
+   ALLEGRO_BITMAP sub_view;
+   ALLEGRO_BITMAP* view;
+   state_any_2d state;
+   int y, max_y, ii;
+
+   if (job->bin_start[band] == job->bin_start[band + 1])
+      return;
+
+   y = job->area_y + band * job->band_height;
+
    /*
-   TODO: Need to clip them first, make a copy of the vertices first then
+   The drawers clip to the locked region, so a copy of the target locked just
+   at the band keeps them from touching the neighbouring bands
    */
+   root_view = *root;
+   root_view.lock_x = job->area_x;
+   root_view.lock_y = y;
+   root_view.lock_w = job->area_w;
+   root_view.lock_h = MIN(job->band_height, job->area_y + job->area_h - y);
+   root_view.lock_data = (char*)root->lock_data
+      + (y - root->lock_y) * root->locked_region.pitch
+      + (job->area_x - root->lock_x) * root->locked_region.pixel_size;
+   view = &root_view;
 
    /*
-   Lock the region we are drawing to. We are choosing the minimum and maximum
-   possible pixels touched from the formula (easily verified by following the
-   above algorithm.
+   The drawers draw scanline y - 1 (see the generated routines)
    */
+   max_y = y + root_view.lock_h + 1;
+
+   if (job->target->parent) {
+      sub_view = *job->target;
+      sub_view.parent = &root_view;
+      view = &sub_view;
+      max_y -= job->target->yofs;
+   }
+
+   for (ii = job->bin_start[band]; ii < job->bin_start[band + 1]; ii++) {
+      raster_triangle* tri = &job->triangles[job->bins[ii]];
+
+      state = tri->state;
+      set_state_target(&state, tri->set.kind, view);
+      triangle_stepper((uintptr_t)&state, NULL, tri->set.first, tri->set.step, tri->set.draw,
+         &tri->vtx[0], &tri->vtx[1], &tri->vtx[2], max_y);
+   }
+}
 
-   min_x = (int)floorf(MIN(vtx1->x, MIN(vtx2->x, vtx3->x))) - 1;
-   min_y = (int)floorf(MIN(vtx1->y, MIN(vtx2->y, vtx3->y))) - 1;
-   max_x = (int)ceilf(MAX(vtx1->x, MAX(vtx2->x, vtx3->x))) + 1;
-   max_y = (int)ceilf(MAX(vtx1->y, MAX(vtx2->y, vtx3->y))) + 1;
+/*
+Draws bands until there are none left. Called with the pool mutex held.
+*/
+static void draw_bands(raster_job* job)
+{
+   while (job->next_band < job->num_bands) {
+      int band = job->next_band++;
+
+      _al_mutex_unlock(&raster_pool.mutex);
+      draw_band(job, band);
+      _al_mutex_lock(&raster_pool.mutex);
+   }
+}
+
+static void raster_worker_proc(_AL_THREAD* thread, void* arg)
+{
+   unsigned int generation = (unsigned int)(uintptr_t)arg;
+   (void)thread;
+
+   _al_mutex_lock(&raster_pool.mutex);
+
+   for (;;) {
+      while (!raster_pool.quit && raster_pool.generation == generation)
+         _al_cond_wait(&raster_pool.work_cond, &raster_pool.mutex);
+      if (raster_pool.quit)
+         break;
+
+      generation = raster_pool.generation;
+      draw_bands(raster_pool.job);
+
+      if (--raster_pool.busy == 0)
+         _al_cond_broadcast(&raster_pool.done_cond);
+   }
+
+   _al_mutex_unlock(&raster_pool.mutex);
+}
+
+/*
+Draws the bands of a job on all threads. The calling thread helps too.
+*/
+static void run_raster_job(raster_job* job)
+{
+   _al_mutex_lock(&raster_pool.mutex);
 
    /*
-   TODO: This bit is temporary, the min max's will be guaranteed to be within the bitmap
-   once clipping is implemented
+   Another thread may be drawing to a different target
    */
-   if (min_x >= clip_max_x || min_y >= clip_max_y)
+   while (raster_pool.job)
+      _al_cond_wait(&raster_pool.done_cond, &raster_pool.mutex);
+
+   if (job->num_bands > 1) {
+      /*
+      The workers are started on demand, and stay around until shutdown
+      */
+      while (raster_pool.num_threads < raster_threads - 1) {
+         _al_thread_create(&raster_pool.threads[raster_pool.num_threads], raster_worker_proc,
+            (void*)(uintptr_t)raster_pool.generation);
+         raster_pool.num_threads++;
+      }
+
+      raster_pool.job = job;
+      raster_pool.generation++;
+      raster_pool.busy = raster_pool.num_threads;
+      _al_cond_broadcast(&raster_pool.work_cond);
+   }
+
+   draw_bands(job);
+
+   if (raster_pool.job) {
+      while (raster_pool.busy > 0)
+         _al_cond_wait(&raster_pool.done_cond, &raster_pool.mutex);
+      raster_pool.job = NULL;
+      _al_cond_broadcast(&raster_pool.done_cond);
+   }
+
+   _al_mutex_unlock(&raster_pool.mutex);
+}
+
+/*
+Sets up, bins and draws up to RASTER_CHUNK_SIZE triangles
+*/
+static void draw_raster_chunk(raster_job* job, ALLEGRO_BITMAP* texture, int shade,
+   ALLEGRO_VERTEX* vtx, int num_triangles, int clip_min_x, int clip_min_y, int clip_max_x, int clip_max_y)
+{
+   const int yofs = job->target->parent ? job->target->yofs : 0;
+   int num_refs = 0;
+   int ii, band;
+
+   memset(job->bin_start, 0, (job->num_bands + 1) * sizeof(int));
+
+   for (ii = 0; ii < num_triangles; ii++) {
+      raster_triangle* tri = &job->triangles[ii];
+      int min_x, min_y, max_x, max_y;
+
+      tri->band0 = 0;
+      tri->band1 = -1;
+
+      if (!triangle_bounds(&vtx[ii * 3], &vtx[ii * 3 + 1], &vtx[ii * 3 + 2],
+            clip_min_x, clip_min_y, clip_max_x, clip_max_y,
+            &min_x, &min_y, &max_x, &max_y))
+         continue;
+
+      /*
+      Band coordinates are relative to the drawing area, in the root bitmap
+      */
+      min_y = MAX(min_y + yofs - job->area_y, 0);
+      max_y = MIN(max_y + yofs - job->area_y, job->area_h - 1);
+      if (min_y > max_y)
+         continue;
+
+      tri->band0 = min_y / job->band_height;
+      tri->band1 = max_y / job->band_height;
+
+      tri->vtx[0] = vtx[ii * 3];
+      tri->vtx[1] = vtx[ii * 3 + 1];
+      tri->vtx[2] = vtx[ii * 3 + 2];
+      choose_shaders(texture, shade, &tri->vtx[0], &tri->vtx[1], &tri->vtx[2], &tri->state, &tri->set);
+      tri->set.init((uintptr_t)&tri->state, &tri->vtx[0], &tri->vtx[1], &tri->vtx[2]);
+
+      for (band = tri->band0; band <= tri->band1; band++) {
+         job->bin_start[band + 1]++;
+      }
+      num_refs += tri->band1 - tri->band0 + 1;
+   }
+
+   if (num_refs == 0)
       return;
-   if (max_x >= clip_max_x)
-      max_x = clip_max_x;
-   if (max_y >= clip_max_y)
-      max_y = clip_max_y;
 
-   if (max_x < clip_min_x || max_y < clip_min_y)
+   for (ii = 0; ii < job->num_bands; ii++) {
+      job->bin_start[ii + 1] += job->bin_start[ii];
+   }
+
+   /*
+   Fill the bins in submission order, using the start of each bin as a cursor
+   and shifting them back into place afterwards
+   */
+   job->bins = al_malloc(num_refs * sizeof(int));
+   for (ii = 0; ii < num_triangles; ii++) {
+      raster_triangle* tri = &job->triangles[ii];
+      for (band = tri->band0; band <= tri->band1; band++) {
+         job->bins[job->bin_start[band]++] = ii;
+      }
+   }
+   for (ii = job->num_bands; ii > 0; ii--) {
+      job->bin_start[ii] = job->bin_start[ii - 1];
+   }
+   job->bin_start[0] = 0;
+
+   job->next_band = 0;
+   run_raster_job(job);
+
+   al_free(job->bins);
+   job->bins = NULL;
+}
+
+/* Internal function: _al_soft_triangles_are_threaded
+ *  Returns true if _al_draw_soft_triangles draws on several threads.
+ */
+int _al_soft_triangles_are_threaded(void)
+{
+   return raster_threads > 1;
+}
+
+/* Internal function: _al_draw_soft_triangles
+ *  Draws a list of triangles (three vertices each) to the target bitmap. If
+ *  the threaded rasterizer is enabled, they are drawn in parallel, otherwise
+ *  this is the same as calling _al_triangle_2d for each of them.
+ */
+void _al_draw_soft_triangles(ALLEGRO_BITMAP* texture, ALLEGRO_VERTEX* vtx, int num_triangles)
+{
+   ALLEGRO_BITMAP* target;
+   raster_job job;
+   int need_unlock;
+   int min_x, min_y, max_x, max_y;
+   int clip_min_x, clip_min_y, clip_max_x, clip_max_y;
+   int xofs, yofs;
+   int shade;
+   int ii;
+
+   if (raster_threads < 2 || num_triangles < MIN_THREADED_TRIANGLES) {
+      for (ii = 0; ii < num_triangles; ii++) {
+         _al_triangle_2d(texture, &vtx[ii * 3], &vtx[ii * 3 + 1], &vtx[ii * 3 + 2]);
+      }
       return;
-   if (min_x < clip_min_x)
-      min_x = clip_min_x;
-   if (min_y < clip_min_y)
-      min_y = clip_min_y;
+   }
 
-   if (al_is_bitmap_locked(target)) {
-      if (!bitmap_region_is_locked(target, min_x, min_y, max_x - min_x, max_y - min_y) ||
-          _al_pixel_format_is_video_only(target->locked_region.format))
-         return;
-   } else {
-      if (!(lr = al_lock_bitmap_region(target, min_x, min_y, max_x - min_x, max_y - min_y, ALLEGRO_PIXEL_FORMAT_ANY, 0)))
-         return;
-      need_unlock = 1;
+   target = al_get_target_bitmap();
+
+   al_get_clipping_rectangle(&clip_min_x, &clip_min_y, &clip_max_x, &clip_max_y);
+   clip_max_x += clip_min_x;
+   clip_max_y += clip_min_y;
+
+   /*
+   Lock everything the batch can touch at once
+   */
+   min_x = min_y = INT_MAX;
+   max_x = max_y = INT_MIN;
+   for (ii = 0; ii < num_triangles; ii++) {
+      int x1, y1, x2, y2;
+      if (triangle_bounds(&vtx[ii * 3], &vtx[ii * 3 + 1], &vtx[ii * 3 + 2],
+            clip_min_x, clip_min_y, clip_max_x, clip_max_y, &x1, &y1, &x2, &y2)) {
+         min_x = MIN(min_x, x1);
+         min_y = MIN(min_y, y1);
+         max_x = MAX(max_x, x2);
+         max_y = MAX(max_y, y2);
+      }
    }
+   if (min_x > max_x)
+      return;
+
+   if (!lock_target_region(target, min_x, min_y, max_x, max_y, &need_unlock))
+      return;
 
-   triangle_stepper(state, init, first, step, draw, v1, v2, v3);
+   job.target = target;
+   job.root = target->parent ? target->parent : target;
+   xofs = target->parent ? target->xofs : 0;
+   yofs = target->parent ? target->yofs : 0;
+
+   /*
+   If the user locked a bigger region, only draw inside of what we would have
+   locked ourselves, like _al_draw_soft_triangle does for each triangle
+   */
+   job.area_x = MAX(min_x + xofs, job.root->lock_x);
+   job.area_y = MAX(min_y + yofs, job.root->lock_y);
+   job.area_w = MIN(max_x + xofs, job.root->lock_x + job.root->lock_w) - job.area_x;
+   job.area_h = MIN(max_y + yofs, job.root->lock_y + job.root->lock_h) - job.area_y;
+
+   if (job.area_w > 0 && job.area_h > 0) {
+      job.band_height = band_height;
+      job.num_bands = (job.area_h + band_height - 1) / band_height;
+      job.triangles = al_malloc(MIN(num_triangles, RASTER_CHUNK_SIZE) * sizeof(raster_triangle));
+      job.bin_start = al_malloc((job.num_bands + 1) * sizeof(int));
+      job.bins = NULL;
+
+      shade = blender_needs_shading();
+
+      for (ii = 0; ii < num_triangles; ii += RASTER_CHUNK_SIZE) {
+         draw_raster_chunk(&job, texture, shade, &vtx[ii * 3], MIN(num_triangles - ii, RASTER_CHUNK_SIZE),
+            clip_min_x, clip_min_y, clip_max_x, clip_max_y);
+      }
+
+      al_free(job.triangles);
+      al_free(job.bin_start);
+   }
 
    if (need_unlock)
       al_unlock_bitmap(target);
 }
 
+static void shutdown_threaded_rasterizer(void)
+{
+   int ii;
+
+   _al_mutex_lock(&raster_pool.mutex);
+   raster_pool.quit = true;
+   _al_cond_broadcast(&raster_pool.work_cond);
+   _al_mutex_unlock(&raster_pool.mutex);
+
+   for (ii = 0; ii < raster_pool.num_threads; ii++) {
+      _al_thread_join(&raster_pool.threads[ii]);
+   }
+   raster_pool.num_threads = 0;
+
+   _al_cond_destroy(&raster_pool.done_cond);
+   _al_cond_destroy(&raster_pool.work_cond);
+   _al_mutex_destroy(&raster_pool.mutex);
+}
+
+/* Internal function: _al_init_threaded_rasterizer
+ *  Reads the settings of the threaded rasterizer from the system config.
+ */
+void _al_init_threaded_rasterizer(void)
+{
+   ALLEGRO_CONFIG* config = al_get_system_config();
+   const char* value;
+
+   raster_threads = 0;
+   value = al_get_config_value(config, "graphics", "soft_triangle_threads");
+   if (value) {
+      if (!_al_stricmp(value, "auto"))
+         raster_threads = al_get_cpu_count();
+      else
+         raster_threads = atoi(value);
+   }
+   raster_threads = _ALLEGRO_CLAMP(0, raster_threads, MAX_RASTER_THREADS + 1);
+
+   band_height = 32;
+   value = al_get_config_value(config, "graphics", "soft_triangle_band_height");
+   if (value)
+      band_height = _ALLEGRO_CLAMP(1, atoi(value), 4096);
+
+   _al_mutex_init(&raster_pool.mutex);
+   _al_cond_init(&raster_pool.work_cond);
+   _al_cond_init(&raster_pool.done_cond);
+   raster_pool.num_threads = 0;
+   raster_pool.quit = false;
+   raster_pool.job = NULL;
+   _al_add_exit_func(shutdown_threaded_rasterizer, "shutdown_threaded_rasterizer");
+
+   if (raster_threads > 1) {
+      ALLEGRO_INFO("Threaded software rasterizer: %d threads, bands of %d scanlines\n",
+         raster_threads, band_height);
+   }
+}
+
 /* vim: set sts=3 sw=3 et: */
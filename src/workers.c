@@ -0,0 +1,202 @@
+/*         ______   ___    ___
+ *        /\  _  \ /\_ \  /\_ \
+ *        \ \ \L\ \\//\ \ \//\ \      __     __   _ __   ___
+ *         \ \  __ \ \ \ \  \ \ \   /'__`\ /'_ `\/\`'__\/ __`\
+ *          \ \ \/\ \ \_\ \_ \_\ \_/\  __//\ \L\ \ \ \//\ \L\ \
+ *           \ \_\ \_\/\____\/\____\ \____\ \____ \ \_\\ \____/
+ *            \/_/\/_/\/____/\/____/\/____/\/___L\ \/_/ \/___/
+ *                                           /\____/
+ *                                           \_/__/
+ *
+ *      Pool of worker threads for background jobs.
+ *
+ *      See LICENSE.txt for copyright information.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "allegro5/allegro.h"
+#include "allegro5/internal/aintern.h"
+#include "allegro5/internal/aintern_exitfunc.h"
+#include "allegro5/internal/aintern_thread.h"
+#include "allegro5/internal/aintern_vector.h"
+#include "allegro5/internal/aintern_workers.h"
+
+ALLEGRO_DEBUG_CHANNEL("system")
+
+#define MAX_WORKERS  32
+
+
+typedef struct WORKER_JOB
+{
+   void (*proc)(void *arg);
+   void *arg;
+} WORKER_JOB;
+
+
+/* The jobs are run in the order they were queued. The queue is a vector
+ * which is only emptied once all the jobs in it have been taken, so taking
+ * a job is just advancing jobs_head.
+ */
+static struct {
+   _AL_MUTEX mutex;
+   _AL_COND cond;
+   _AL_VECTOR jobs;
+   unsigned int jobs_head;
+   _AL_THREAD threads[MAX_WORKERS];
+   int num_threads;
+   bool quit;
+} workers;
+
+
+
+/* get_num_workers:
+ *  Read the number of worker threads from the configuration, defaulting to
+ *  one per CPU.
+ */
+static int get_num_workers(void)
+{
+   const char *value = al_get_config_value(al_get_system_config(),
+      "system", "worker_threads");
+   int n = 0;
+
+   if (value && strcmp(value, "auto") != 0)
+      n = atoi(value);
+   if (n <= 0)
+      n = al_get_cpu_count();
+   if (n <= 0)
+      n = 1;
+   if (n > MAX_WORKERS)
+      n = MAX_WORKERS;
+
+   return n;
+}
+
+
+
+/* worker_proc: [worker thread]
+ *  Run queued jobs until asked to quit. The jobs still queued at that time
+ *  are run first.
+ */
+static void worker_proc(_AL_THREAD *thread, void *unused)
+{
+   WORKER_JOB job;
+   (void)thread;
+   (void)unused;
+
+   _al_mutex_lock(&workers.mutex);
+
+   for (;;) {
+      WORKER_JOB *slot;
+
+      while (!workers.quit && workers.jobs_head == _al_vector_size(&workers.jobs))
+         _al_cond_wait(&workers.cond, &workers.mutex);
+
+      if (workers.jobs_head == _al_vector_size(&workers.jobs))
+         break;
+
+      slot = _al_vector_ref(&workers.jobs, workers.jobs_head++);
+      job = *slot;
+      if (workers.jobs_head == _al_vector_size(&workers.jobs)) {
+         _al_vector_free(&workers.jobs);
+         workers.jobs_head = 0;
+      }
+
+      _al_mutex_unlock(&workers.mutex);
+      job.proc(job.arg);
+      _al_mutex_lock(&workers.mutex);
+   }
+
+   _al_mutex_unlock(&workers.mutex);
+}
+
+
+
+/* shutdown_workers:
+ *  Finish all queued jobs and stop the worker threads. This is registered
+ *  when the threads are started, so it runs before the shutdown of any
+ *  addon which was initialised before the first job was queued.
+ */
+static void shutdown_workers(void)
+{
+   int i;
+
+   _al_mutex_lock(&workers.mutex);
+   workers.quit = true;
+   _al_cond_broadcast(&workers.cond);
+   _al_mutex_unlock(&workers.mutex);
+
+   for (i = 0; i < workers.num_threads; i++)
+      _al_thread_join(&workers.threads[i]);
+
+   ASSERT(_al_vector_is_empty(&workers.jobs));
+   _al_vector_free(&workers.jobs);
+   workers.jobs_head = 0;
+   workers.num_threads = 0;
+   workers.quit = false;
+}
+
+
+
+static void destroy_workers(void)
+{
+   ASSERT(workers.num_threads == 0);
+
+   _al_cond_destroy(&workers.cond);
+   _al_mutex_destroy(&workers.mutex);
+}
+
+
+
+/* Internal function: _al_init_workers
+ *  Prepare the worker pool. The threads are only started when the first
+ *  job is queued.
+ */
+void _al_init_workers(void)
+{
+   _al_mutex_init(&workers.mutex);
+   _al_cond_init(&workers.cond);
+   _al_vector_init(&workers.jobs, sizeof(WORKER_JOB));
+   workers.jobs_head = 0;
+   workers.num_threads = 0;
+   workers.quit = false;
+   _al_add_exit_func(destroy_workers, "destroy_workers");
+}
+
+
+
+/* Internal function: _al_queue_worker_job
+ *  Have proc(arg) called on one of the worker threads. Jobs are started in
+ *  the order they are queued, but may run concurrently and finish in any
+ *  order. The system shutdown waits for all queued jobs to finish.
+ */
+void _al_queue_worker_job(void (*proc)(void *arg), void *arg)
+{
+   WORKER_JOB *job;
+
+   ASSERT(proc);
+
+   _al_mutex_lock(&workers.mutex);
+
+   if (workers.num_threads == 0) {
+      int n = get_num_workers();
+      ALLEGRO_DEBUG("Starting %d worker threads\n", n);
+      while (workers.num_threads < n) {
+         _al_thread_create(&workers.threads[workers.num_threads], worker_proc,
+            NULL);
+         workers.num_threads++;
+      }
+      _al_add_exit_func(shutdown_workers, "shutdown_workers");
+   }
+
+   job = _al_vector_alloc_back(&workers.jobs);
+   job->proc = proc;
+   job->arg = arg;
+   _al_cond_signal(&workers.cond);
+
+   _al_mutex_unlock(&workers.mutex);
+}
+
+
+/* vim: set sts=3 sw=3 et: */
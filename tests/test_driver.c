@@ -4,6 +4,7 @@
  *    By Peter Wang.
  */
 
+#define ALLEGRO_UNSTABLE
 #include <ctype.h>
 #include <math.h>
 #include <stdarg.h>
@@ -57,6 +58,8 @@ Bitmap            bitmaps[MAX_BITMAPS];
 LockRegion        lock_region;
 Transform         transforms[MAX_TRANS];
 NamedFont         fonts[MAX_FONTS];
+ALLEGRO_TEXT_LAYOUT *text_layout;
+ALLEGRO_FILE      *open_file;
 ALLEGRO_VERTEX    vertices[MAX_VERTICES];
 float             simple_vertices[2 * MAX_VERTICES];
 int               num_simple_vertices;
@@ -109,9 +112,11 @@ int               failed_tests = 0;
 #define C(a)      get_color(V(a))
 #define B(a)      get_bitmap(V(a), bmp_type, target)
 #define SCAN0(fn) \
-      (sscanf(stmt, fn " (" " )") == 0)
+      (sscanf(stmt, fn " ( %1[)]", arg[0]) == 1)
 #define SCAN(fn, arity) \
       (sscanf(stmt, fn " (" PAT##arity " )", ARGS##arity) == arity)
+#define SCANLVAL0(fn) \
+      (sscanf(stmt, PAT " = " fn " ( %1[)]", lval, arg[0]) == 2)
 #define SCANLVAL(fn, arity) \
       (sscanf(stmt, PAT " = " fn " (" PAT##arity " )", lval, ARGS##arity) \
          == 1 + arity)
@@ -222,6 +227,9 @@ static void unload_data(void)
    }
    memset(bitmaps, 0, sizeof(bitmaps));
 
+   al_destroy_text_layout(text_layout);
+   text_layout = NULL;
+
    for (i = 0; i < MAX_FONTS; i++) {
       al_ustr_free(fonts[i].name);
       al_destroy_font(fonts[i].font);
@@ -312,6 +320,14 @@ static int get_draw_bitmap_flag(char const *value)
    return atoi(value);
 }
 
+static int get_seek_whence(char const *value)
+{
+   return streq(value, "ALLEGRO_SEEK_SET") ? ALLEGRO_SEEK_SET
+      : streq(value, "ALLEGRO_SEEK_CUR") ? ALLEGRO_SEEK_CUR
+      : streq(value, "ALLEGRO_SEEK_END") ? ALLEGRO_SEEK_END
+      : atoi(value);
+}
+
 static int get_blender_op(char const *value)
 {
    return streq(value, "ALLEGRO_ADD") ? ALLEGRO_ADD
@@ -472,6 +488,10 @@ static void load_fonts(ALLEGRO_CONFIG const *cfg, const char *section)
          font = al_create_builtin_font();
          load_stmt = true;
       }
+      else if (SCAN("al_set_system_config_value", 3)) {
+         /* Affects the fonts loaded after it. */
+         al_set_config_value(al_get_system_config(), arg[0], arg[1], V(2));
+      }
 
       if (load_stmt) {
          if (!font) {
@@ -1133,6 +1153,15 @@ static void do_test(ALLEGRO_CONFIG *cfg, char const *testname,
          (*bmp) = load_relative_bitmap(V(0), get_load_bitmap_flag(V(1)));
          continue;
       }
+      if (SCANLVAL("al_load_bitmap_f", 1)) {
+         ALLEGRO_BITMAP **bmp = reserve_local_bitmap(lval, bmp_type);
+         (*bmp) = al_load_bitmap_f(open_file, V(0));
+         if (!(*bmp)) {
+            fprintf(stderr, "test_driver: failed to load open file\n");
+            (*bmp) = create_fallback_bitmap();
+         }
+         continue;
+      }
       if (SCAN("al_save_bitmap", 2)) {
          if (!al_save_bitmap(V(0), B(1))) {
             fatal_error("failed to save %s", V(0));
@@ -1224,6 +1253,69 @@ static void do_test(ALLEGRO_CONFIG *cfg, char const *testname,
          continue;
       }
 
+      /* Files */
+      if (SCAN("al_fopen", 2)) {
+         al_fclose(open_file);
+         open_file = al_fopen(V(0), V(1));
+         if (!open_file) {
+            fatal_error("failed to open %s", V(0));
+         }
+         continue;
+      }
+      if (SCAN0("al_fclose")) {
+         al_fclose(open_file);
+         open_file = NULL;
+         continue;
+      }
+      if (SCAN("al_fopen_buffered", 1)) {
+         ALLEGRO_FILE *buffered = al_fopen_buffered(open_file, I(0));
+         if (!buffered) {
+            fatal_error("failed to buffer file");
+         }
+         open_file = buffered;
+         continue;
+      }
+      if (SCAN("al_fseek", 2)) {
+         al_fseek(open_file, I(0), get_seek_whence(V(1)));
+         continue;
+      }
+      if (SCANLVAL0("al_fgetc")) {
+         set_config_int(cfg, testname, lval, al_fgetc(open_file));
+         continue;
+      }
+      if (SCAN("al_fungetc", 1)) {
+         al_fungetc(open_file, I(0));
+         continue;
+      }
+      if (SCANLVAL0("al_feof")) {
+         set_config_int(cfg, testname, lval, al_feof(open_file));
+         continue;
+      }
+      if (SCAN("al_mount_pack", 1)) {
+         if (!al_mount_pack(V(0))) {
+            fatal_error("failed to mount %s", V(0));
+         }
+         continue;
+      }
+      if (SCAN("al_unmount_pack", 1)) {
+         if (!al_unmount_pack(V(0))) {
+            fatal_error("%s was not mounted", V(0));
+         }
+         continue;
+      }
+      if (SCAN0("al_set_pack_file_interface")) {
+         al_set_pack_file_interface();
+         continue;
+      }
+      if (SCAN0("al_set_standard_file_interface")) {
+         al_set_standard_file_interface();
+         continue;
+      }
+      if (SCAN0("al_set_standard_fs_interface")) {
+         al_set_standard_fs_interface();
+         continue;
+      }
+
       /* Fonts */
       if (SCAN("al_draw_text", 6)) {
          al_draw_text(get_font(V(0)), C(1), F(2), F(3), get_font_align(V(4)),
@@ -1268,6 +1360,23 @@ static void do_test(ALLEGRO_CONFIG *cfg, char const *testname,
          al_set_fallback_font(get_font(V(0)), get_font(V(1)));
          continue;
       }
+      if (SCAN("al_create_text_layout", 2)) {
+         ALLEGRO_USTR_INFO info;
+         al_destroy_text_layout(text_layout);
+         text_layout = al_create_text_layout(get_font(V(0)),
+            al_ref_cstr(&info, V(1)));
+         continue;
+      }
+      if (SCAN("al_draw_text_layout", 4)) {
+         al_draw_text_layout(text_layout, C(0), F(1), F(2),
+            get_font_align(V(3)));
+         continue;
+      }
+      if (SCAN0("al_destroy_text_layout")) {
+         al_destroy_text_layout(text_layout);
+         text_layout = NULL;
+         continue;
+      }
 
       /* Primitives */
       if (SCAN("al_draw_line", 6)) {
@@ -0,0 +1,361 @@
+/*         ______   ___    ___
+ *        /\  _  \ /\_ \  /\_ \
+ *        \ \ \L\ \\//\ \ \//\ \      __     __   _ __   ___
+ *         \ \  __ \ \ \ \  \ \ \   /'__`\ /'_ `\/\`'__\/ __`\
+ *          \ \ \/\ \ \_\ \_ \_\ \_/\  __//\ \L\ \ \ \//\ \L\ \
+ *           \ \_\ \_\/\____\/\____\ \____\ \____ \ \_\\ \____/
+ *            \/_/\/_/\/____/\/____/\/____/\/___L\ \/_/ \/___/
+ *                                           /\____/
+ *                                           \_/__/
+ *
+ *      Utility to pack a directory into an archive for al_mount_pack.
+ *
+ *      The format is described in src/fshook_pack.c. Build it with
+ *      something like:
+ *
+ *         cc -o allegro_pack allegro_pack.c `pkg-config --libs allegro-5`
+ *
+ *      See readme.txt for copyright information.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <allegro5/allegro.h>
+
+#define HEADER_SIZE     32
+#define ENTRY_SIZE      40
+
+#define METHOD_STORED   0
+#define METHOD_LZ4      1
+
+#define HASH_BITS       16
+
+
+typedef struct ENTRY {
+   char *name;             /* relative, with '/' separators */
+   char *path;             /* on disk */
+   uint64_t offset;
+   uint64_t size;
+   uint64_t stored_size;
+   int64_t mtime;
+   uint32_t name_offset;
+   int method;
+} ENTRY;
+
+static ENTRY *entries;
+static int num_entries;
+static int max_entries;
+static size_t root_len;
+
+
+/* usage:
+ *  Show usage information.
+ */
+static void usage(char *argv0)
+{
+   printf("Usage: %s [OPTIONS] archive directory\n\n", argv0);
+   printf("  -a N   Align the data of each file to N bytes (16 by default).\n"
+          "  -c     Compress files with LZ4 where that makes them smaller.\n"
+          "  -v     Print the name of each file.\n");
+}
+
+
+static void put16(unsigned char *p, uint32_t x)
+{
+   p[0] = x;
+   p[1] = x >> 8;
+}
+
+
+static void put32(unsigned char *p, uint32_t x)
+{
+   put16(p, x);
+   put16(p + 2, x >> 16);
+}
+
+
+static void put64(unsigned char *p, uint64_t x)
+{
+   put32(p, (uint32_t)x);
+   put32(p + 4, (uint32_t)(x >> 32));
+}
+
+
+static uint32_t read32(const unsigned char *p)
+{
+   uint32_t x;
+   memcpy(&x, p, 4);
+   return x;
+}
+
+
+static unsigned char *put_length(unsigned char *d, size_t len)
+{
+   while (len >= 255) {
+      *d++ = 255;
+      len -= 255;
+   }
+   *d++ = (unsigned char)len;
+   return d;
+}
+
+
+/* lz4_compress:
+ *  Compress into an LZ4 block with a simple greedy search. dst must have
+ *  room for n + n / 255 + 16 bytes. Returns the compressed size.
+ */
+static size_t lz4_compress(const unsigned char *src, size_t n,
+   unsigned char *dst)
+{
+   static int64_t table[1 << HASH_BITS];
+   unsigned char *d = dst;
+   size_t anchor = 0;
+   size_t i = 0;
+   size_t j;
+
+   for (j = 0; j < (1 << HASH_BITS); j++)
+      table[j] = -1;
+
+   /* The last match must start 12 bytes and end 5 bytes before the end. */
+   while (n >= 13 && i < n - 12) {
+      uint32_t seq = read32(src + i);
+      uint32_t h = (seq * 2654435761u) >> (32 - HASH_BITS);
+      int64_t ref = table[h];
+      size_t lit, len;
+      unsigned char *token;
+
+      table[h] = i;
+      if (ref < 0 || i - ref > 65535 || read32(src + ref) != seq) {
+         i++;
+         continue;
+      }
+
+      len = 4;
+      while (i + len < n - 5 && src[ref + len] == src[i + len])
+         len++;
+
+      lit = i - anchor;
+      token = d++;
+      *token = (lit < 15 ? lit : 15) << 4;
+      if (lit >= 15)
+         d = put_length(d, lit - 15);
+      memcpy(d, src + anchor, lit);
+      d += lit;
+
+      put16(d, (uint32_t)(i - ref));
+      d += 2;
+      *token |= (len - 4 < 15 ? len - 4 : 15);
+      if (len - 4 >= 15)
+         d = put_length(d, len - 4 - 15);
+
+      i += len;
+      anchor = i;
+   }
+
+   /* The last literals. */
+   j = n - anchor;
+   *d++ = (j < 15 ? j : 15) << 4;
+   if (j >= 15)
+      d = put_length(d, j - 15);
+   memcpy(d, src + anchor, j);
+   d += j;
+
+   return d - dst;
+}
+
+
+static int add_entry(ALLEGRO_FS_ENTRY *e, void *extra)
+{
+   const char *path = al_get_fs_entry_name(e);
+   ENTRY *entry;
+   char *s;
+   (void)extra;
+
+   if (al_get_fs_entry_mode(e) & ALLEGRO_FILEMODE_ISDIR)
+      return ALLEGRO_FOR_EACH_FS_ENTRY_OK;
+
+   if (num_entries == max_entries) {
+      max_entries = max_entries ? max_entries * 2 : 256;
+      entries = realloc(entries, max_entries * sizeof(ENTRY));
+   }
+   entry = &entries[num_entries++];
+   memset(entry, 0, sizeof(*entry));
+
+   entry->path = strdup(path);
+   entry->name = strdup(path + root_len + 1);
+   for (s = entry->name; *s; s++) {
+      if (*s == ALLEGRO_NATIVE_PATH_SEP)
+         *s = '/';
+   }
+   entry->size = al_get_fs_entry_size(e);
+   entry->mtime = al_get_fs_entry_mtime(e);
+
+   return ALLEGRO_FOR_EACH_FS_ENTRY_OK;
+}
+
+
+static int compare_entries(const void *a, const void *b)
+{
+   return strcmp(((const ENTRY *)a)->name, ((const ENTRY *)b)->name);
+}
+
+
+static void *read_file(const char *path, uint64_t size)
+{
+   ALLEGRO_FILE *f = al_fopen(path, "rb");
+   unsigned char *data = malloc(size ? size : 1);
+
+   if (!f || al_fread(f, data, size) != size) {
+      fprintf(stderr, "Could not read %s\n", path);
+      exit(1);
+   }
+   al_fclose(f);
+   return data;
+}
+
+
+int main(int argc, char *argv[])
+{
+   const char *archive;
+   const char *directory;
+   ALLEGRO_FS_ENTRY *root;
+   ALLEGRO_FILE *out;
+   unsigned char *index;
+   uint32_t names_size = 0;
+   uint64_t pos;
+   uint64_t total = 0;
+   size_t index_size;
+   int alignment = 16;
+   bool compress = false;
+   bool verbose = false;
+   int i;
+
+   for (i = 1; i < argc && argv[i][0] == '-'; i++) {
+      if (strcmp(argv[i], "-a") == 0 && i + 1 < argc) {
+         alignment = atoi(argv[++i]);
+      }
+      else if (strcmp(argv[i], "-c") == 0) {
+         compress = true;
+      }
+      else if (strcmp(argv[i], "-v") == 0) {
+         verbose = true;
+      }
+      else {
+         usage(argv[0]);
+         return 1;
+      }
+   }
+   if (argc - i != 2 || alignment < 1) {
+      usage(argv[0]);
+      return 1;
+   }
+   archive = argv[i];
+   directory = argv[i + 1];
+
+   root = al_create_fs_entry(directory);
+   if (!root || !(al_get_fs_entry_mode(root) & ALLEGRO_FILEMODE_ISDIR)) {
+      fprintf(stderr, "%s is not a directory\n", directory);
+      return 1;
+   }
+   root_len = strlen(al_get_fs_entry_name(root));
+   al_for_each_fs_entry(root, add_entry, NULL);
+   al_destroy_fs_entry(root);
+
+   /* The archive is searched with strcmp. */
+   qsort(entries, num_entries, sizeof(ENTRY), compare_entries);
+   for (i = 0; i < num_entries; i++) {
+      if (strlen(entries[i].name) > 65535) {
+         fprintf(stderr, "%s: name is too long\n", entries[i].name);
+         return 1;
+      }
+      entries[i].name_offset = names_size;
+      names_size += strlen(entries[i].name) + 1;
+   }
+
+   out = al_fopen(archive, "wb");
+   if (!out) {
+      fprintf(stderr, "Could not create %s\n", archive);
+      return 1;
+   }
+
+   /* The index is written last, once the offsets are known. */
+   index_size = HEADER_SIZE + num_entries * ENTRY_SIZE + names_size;
+   index = calloc(1, index_size);
+   al_fwrite(out, index, index_size);
+   pos = index_size;
+
+   for (i = 0; i < num_entries; i++) {
+      ENTRY *e = &entries[i];
+      unsigned char *data = read_file(e->path, e->size);
+      unsigned char *stored = data;
+
+      while (pos % alignment) {
+         al_fputc(out, 0);
+         pos++;
+      }
+
+      e->offset = pos;
+      e->method = METHOD_STORED;
+      e->stored_size = e->size;
+      if (compress && e->size > 0) {
+         unsigned char *packed = malloc(e->size + e->size / 255 + 16);
+         size_t packed_size = lz4_compress(data, e->size, packed);
+         if (packed_size < e->size) {
+            e->method = METHOD_LZ4;
+            e->stored_size = packed_size;
+            stored = packed;
+         }
+         else {
+            free(packed);
+         }
+      }
+
+      if (al_fwrite(out, stored, e->stored_size) != e->stored_size) {
+         fprintf(stderr, "Could not write %s\n", archive);
+         return 1;
+      }
+      pos += e->stored_size;
+      total += e->size;
+
+      if (verbose) {
+         printf("%s %llu -> %llu\n", e->name, (unsigned long long)e->size,
+            (unsigned long long)e->stored_size);
+      }
+
+      if (stored != data)
+         free(stored);
+      free(data);
+   }
+
+   memcpy(index, "ALPK", 4);
+   put32(index + 4, 1);
+   put32(index + 8, num_entries);
+   put32(index + 12, names_size);
+   put32(index + 16, alignment);
+   for (i = 0; i < num_entries; i++) {
+      ENTRY *e = &entries[i];
+      unsigned char *p = index + HEADER_SIZE + i * ENTRY_SIZE;
+      put64(p, e->offset);
+      put64(p + 8, e->size);
+      put64(p + 16, e->stored_size);
+      put64(p + 24, (uint64_t)e->mtime);
+      put32(p + 32, e->name_offset);
+      put16(p + 36, strlen(e->name));
+      p[38] = e->method;
+      strcpy((char *)index + HEADER_SIZE + num_entries * ENTRY_SIZE +
+         e->name_offset, e->name);
+   }
+
+   if (!al_fseek(out, 0, ALLEGRO_SEEK_SET) ||
+         al_fwrite(out, index, index_size) != index_size ||
+         !al_fclose(out)) {
+      fprintf(stderr, "Could not write %s\n", archive);
+      return 1;
+   }
+
+   printf("%d files, %llu bytes packed into %llu bytes\n", num_entries,
+      (unsigned long long)total, (unsigned long long)pos);
+
+   return 0;
+}